@@ -0,0 +1,235 @@
+/**
+ * \brief Program demonstrating compile time binding of INI files to
+ * structures
+ * \file bindsample.cpp
+ * \author Michael Dipperstein (mdipperstein@gmail.com)
+ * \date October 15, 2026
+ *
+ * This file demonstrates ezbind.hpp.  It fills in the same structures as
+ * sample.c's PopulateMyStruct, but the fields are described once and looked
+ * up through a perfect hash table made by the compiler.
+ *
+ * \copyright Copyright (C) 2026 by Michael Dipperstein
+ * (mdipperstein@gmail.com)
+ *
+ * \par
+ * This file is part of the ezini library.
+ *
+ * \license
+ * The ezini library is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * \par
+ * The ezini library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+ * General Public License for more details.
+ *
+ * \par
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \defgroup bindsample Binding Sample
+ * \brief This module contains a program demonstrating how to bind INI files
+ * to structures with ezbind.hpp.
+ * @{
+ */
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <cstdio>
+#include <string>
+#include "ezbind.hpp"
+
+/*!
+  \def bindsample_main
+  \brief Hack so that Doxygen doesn't confuse this with sample.c's main
+*/
+#define bindsample_main main
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+
+/**
+ * \struct my_structs_t
+ * \brief The two structures filled in by sample.c, flattened into one.
+ */
+struct my_structs_t
+{
+    int myInt1;             /*!< [struct 1] int field */
+    float myFloat1;         /*!< [struct 1] float field */
+    char myString1[11];     /*!< [struct 1] str field */
+    int myInt2;             /*!< [struct 2] int field */
+    float myFloat2;         /*!< [struct 2] float field */
+    std::string myString2;  /*!< [struct 2] str field */
+    bool verbose;           /*!< [options] verbose */
+};
+
+/**
+ * \struct colliding_t
+ * \brief Fields held by pairs whose hashes collide.
+ */
+struct colliding_t
+{
+    int fnv1;               /*!< equal FNV-1a hashes, costarring */
+    int fnv2;               /*!< equal FNV-1a hashes, liquid */
+    int joined1;            /*!< equal section + key, [ab] c */
+    int joined2;            /*!< equal section + key, [a] bc */
+    int bucket1;            /*!< equal bucket hashes, [limits] key98359 */
+    int bucket2;            /*!< equal bucket hashes, [limits] key545312 */
+};
+
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+
+/*!
+  \brief The entries holding each field of my_structs_t.
+*/
+constexpr auto schema = ezini::MakeSchema(
+    ezini::Field("struct 1", "int field", &my_structs_t::myInt1),
+    ezini::Field("struct 1", "float field", &my_structs_t::myFloat1),
+    ezini::Field("struct 1", "str field", &my_structs_t::myString1),
+    ezini::Field("struct 2", "int field", &my_structs_t::myInt2),
+    ezini::Field("struct 2", "float field", &my_structs_t::myFloat2),
+    ezini::Field("struct 2", "str field", &my_structs_t::myString2),
+    ezini::Field("options", "verbose", &my_structs_t::verbose));
+
+/*!
+  \brief Pairs that are hard to hash apart.  Valid schemas always compile,
+  whatever their hashes.
+*/
+constexpr auto collisions = ezini::MakeSchema(
+    ezini::Field("", "costarring", &colliding_t::fnv1),
+    ezini::Field("", "liquid", &colliding_t::fnv2),
+    ezini::Field("ab", "c", &colliding_t::joined1),
+    ezini::Field("a", "bc", &colliding_t::joined2),
+    ezini::Field("limits", "key98359", &colliding_t::bucket1),
+    ezini::Field("limits", "key545312", &colliding_t::bucket2));
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static void ShowKeys(const char *what,
+    const std::vector<ezini::bind_key_t> &keys);
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/**
+ * \fn int bindsample_main(int argc, char *argv[])
+ *
+ * \brief This creates bind_struct.ini and binds it to my_structs_t.
+ *
+ * \param argc Not Used
+ *
+ * \param argv Not Used
+ *
+ * \effects
+ * bind_struct.ini is created, its entries are bound to a my_structs_t,
+ * the structure and the binding report are printed, and bind_struct.ini is
+ * deleted.  Then pairs with colliding hashes are bound.
+ *
+ * \returns 0 (regardless of results)
+ */
+int bindsample_main(int argc, char *argv[])
+{
+    my_structs_t my_structs = {};
+    ini_entry_list_t list;
+    ezini::bind_report_t report;
+
+    ((void)(argc));
+    ((void)(argv));
+
+    /* the same entries as sample.c, with one misspelled key */
+    list = NULL;
+    AddEntryToList(&list, "struct 1", "int field", "123");
+    AddEntryToList(&list, "struct 2", "str field", "string2");
+    AddEntryToList(&list, "struct 1", "float field", "456.789");
+    AddEntryToList(&list, "struct 2", "float field", "987.654");
+    AddEntryToList(&list, "struct 1", "str field", "string1");
+    AddEntryToList(&list, "struct 2", "int feild", "321");
+
+    if (0 != MakeINIFile("bind_struct.ini", list))
+    {
+        printf("Error making bind_struct.ini file\n");
+    }
+
+    FreeList(list);
+
+    printf("\nBinding bind_struct.ini\n");
+    printf("=======================\n");
+    report = schema.BindFile("bind_struct.ini", my_structs);
+
+    if (0 != report.result)
+    {
+        printf("Error parsing bind_struct.ini\n");
+    }
+
+    printf("struct 1\n");
+    printf("\tmyInt %d\n", my_structs.myInt1);
+    printf("\tmyFloat %f\n", my_structs.myFloat1);
+    printf("\tmyString %s\n", my_structs.myString1);
+    printf("struct 2\n");
+    printf("\tmyInt %d\n", my_structs.myInt2);
+    printf("\tmyFloat %f\n", my_structs.myFloat2);
+    printf("\tmyString %s\n", my_structs.myString2.c_str());
+
+    ShowKeys("missing", report.missing);
+    ShowKeys("unknown", report.unknown);
+    ShowKeys("invalid", report.invalid);
+    printf("binding is %s\n", report.Ok() ? "complete" : "incomplete");
+
+    remove("bind_struct.ini");
+
+    /* pairs with colliding hashes still bind to their own fields */
+    {
+        static const char text[] = "costarring = 1\nliquid = 2\n"
+            "[ab]\nc = 3\n[a]\nbc = 4\n"
+            "[limits]\nkey98359 = 5\nkey545312 = 6\n";
+        colliding_t colliding = {};
+
+        report = collisions.BindBuffer(text, sizeof(text) - 1, colliding);
+        printf("\ncolliding pairs are %s\n",
+            (report.Ok() && (1 == colliding.fnv1) &&
+            (2 == colliding.fnv2) && (3 == colliding.joined1) &&
+            (4 == colliding.joined2) && (5 == colliding.bucket1) &&
+            (6 == colliding.bucket2)) ? "bound" : "not bound");
+    }
+
+    return 0;
+}
+
+/**
+ * \fn static void ShowKeys(const char *what,
+ *      const std::vector<ezini::bind_key_t> &keys)
+ *
+ * \brief This function prints the entries listed in part of a binding
+ * report.
+ *
+ * \param what The name of the part of the report.
+ *
+ * \param keys The entries in that part.
+ *
+ * \effects Each entry is printed.
+ *
+ * \returns Nothing
+ */
+static void ShowKeys(const char *what,
+    const std::vector<ezini::bind_key_t> &keys)
+{
+    for (const ezini::bind_key_t &key : keys)
+    {
+        printf("%s: [%s] %s\n", what, key.section.c_str(), key.key.c_str());
+    }
+}
+
+/**@}*/
@@ -0,0 +1,168 @@
+/**
+ * \brief Program demonstrating the C++ interface to ezini
+ * \file cppsample.cpp
+ * \author Michael Dipperstein (mdipperstein@gmail.com)
+ * \date October 15, 2026
+ *
+ * This file demonstrates ezini.hpp.  It builds an entry list, writes it to
+ * an INI file, then loads the file as each kind of document and lists its
+ * sections and keys without copying any of them.
+ *
+ * \copyright Copyright (C) 2026 by Michael Dipperstein
+ * (mdipperstein@gmail.com)
+ *
+ * \par
+ * This file is part of the ezini library.
+ *
+ * \license
+ * The ezini library is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * \par
+ * The ezini library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+ * General Public License for more details.
+ *
+ * \par
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \defgroup cppsample C++ Sample
+ * \brief This module contains a program demonstrating how to use ezini from
+ * C++ with ezini.hpp.
+ * @{
+ */
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <cstdio>
+#include <utility>
+#include "ezini.hpp"
+
+/*!
+  \def cppsample_main
+  \brief Hack so that Doxygen doesn't confuse this with sample.c's main
+*/
+#define cppsample_main main
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static void ShowDocument(const char *what, ezini::document_view_t doc);
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/**
+ * \fn int cppsample_main(int argc, char *argv[])
+ *
+ * \brief This creates cpp_sample.ini and reads it back as a normal, lazily
+ * parsed, and cached document.
+ *
+ * \param argc Not Used
+ *
+ * \param argv Not Used
+ *
+ * \effects
+ * cpp_sample.ini and its cache are created, the entries of each document
+ * are printed, and the files are deleted.
+ *
+ * \returns 0 (regardless of results)
+ */
+int cppsample_main(int argc, char *argv[])
+{
+    ((void)(argc));
+    ((void)(argv));
+
+    {
+        ezini::list_t list = ezini::list_t::Arena();
+
+        list.Add("", "title", "cpp sample");
+        list.Add("struct 1", "int field", "123");
+        list.Add("struct 2", "str field", "string2");
+        list.Add("struct 1", "float field", "456.789");
+        list.Add("struct 2", "float field", "987.654");
+        list.Add("struct 1", "str field", "string1");
+        list.Add("struct 2", "int field", "321");
+
+        /* the list may be moved, but only one owner frees it */
+        ezini::list_t owner = std::move(list);
+
+        printf("list has %s [struct 3]\n",
+            owner.HasSection("struct 3") ? "a" : "no");
+
+        if (!owner.Write("cpp_sample.ini"))
+        {
+            printf("Error making cpp_sample.ini file\n");
+        }
+    }
+
+    ShowDocument("document", ezini::document_t::Load("cpp_sample.ini"));
+    ShowDocument("lazy document",
+        ezini::document_t::LoadLazy("cpp_sample.ini"));
+
+    if (0 != CompileINICache("cpp_sample.ini", nullptr))
+    {
+        printf("Error making cpp_sample.ini cache\n");
+    }
+
+    ShowDocument("cached document",
+        ezini::document_t::LoadCached("cpp_sample.ini"));
+
+    remove("cpp_sample.ini");
+    remove("cpp_sample.ini.bin");
+    return 0;
+}
+
+/**
+ * \fn static void ShowDocument(const char *what,
+ *      ezini::document_view_t doc)
+ *
+ * \brief This function prints every entry of a document, and looks one
+ * up.
+ *
+ * \param what The kind of document.
+ *
+ * \param doc The document.
+ *
+ * \effects The document's sections and keys are printed.
+ *
+ * \returns Nothing
+ */
+static void ShowDocument(const char *what, ezini::document_view_t doc)
+{
+    printf("\n%s\n", what);
+
+    if (!doc)
+    {
+        printf("Error loading cpp_sample.ini\n");
+        return;
+    }
+
+    for (const ezini::section_t &section : doc.Sections())
+    {
+        printf("[%.*s]\n", (int)section.name.size(), section.name.data());
+
+        for (const ezini::entry_t &entry : section.keys)
+        {
+            printf("\t%.*s = %.*s\n",
+                (int)entry.key.size(), entry.key.data(),
+                (int)entry.value.size(), entry.value.data());
+        }
+    }
+
+    std::optional<std::string_view> value = doc.Get("struct 2", "int field");
+
+    printf("[struct 2] int field is %.*s\n",
+        value ? (int)value->size() : 4, value ? value->data() : "none");
+}
+
+/**@}*/
@@ -0,0 +1,862 @@
+/**
+ * \brief Compile time binding of INI file entries to structure fields
+ * \file ezbind.hpp
+ * \author Michael Dipperstein (mdipperstein@gmail.com)
+ * \date October 15, 2026
+ *
+ * This file is a C++17 header layered over ezini.h.  A structure's fields
+ * are described once, at compile time, by the (section, key) pair holding
+ * each of them.  The description is compiled into a perfect hash table, so
+ * binding an INI file to a structure costs one hash and one comparison per
+ * entry, and missing, unknown, and malformed entries are reported.
+ *
+ * \copyright Copyright (C) 2026 by Michael Dipperstein
+ * (mdipperstein@gmail.com)
+ *
+ * \par
+ * This file is part of the ezini library.
+ *
+ * \license
+ * The ezini library is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * \par
+ * The ezini library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+ * General Public License for more details.
+ *
+ * \par
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __EZBIND_HPP
+#define __EZBIND_HPP
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <cstdio>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <array>
+#include <charconv>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "ezini.h"
+
+namespace ezini
+{
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+
+/**
+ * \struct bind_key_t
+ * \brief The section and key of an entry reported by a binding.
+ */
+struct bind_key_t
+{
+    std::string section;        /*!< section name */
+    std::string key;            /*!< key name */
+};
+
+/**
+ * \struct bind_report_t
+ * \brief The result of binding an INI file to a structure.
+ */
+struct bind_report_t
+{
+    int result = 0;                     /*!< 0 if the file was parsed, -1 if
+                                            it couldn't be (errno is set) */
+    std::vector<bind_key_t> missing;    /*!< fields without an entry */
+    std::vector<bind_key_t> unknown;    /*!< entries without a field */
+    std::vector<bind_key_t> invalid;    /*!< entries whose values couldn't
+                                            be converted to their field's
+                                            type */
+
+    /**
+     * \brief Returns true if the file was parsed and every field, and only
+     * those fields, were set.
+     */
+    bool Ok() const noexcept
+    {
+        return (0 == result) && missing.empty() && unknown.empty() &&
+            invalid.empty();
+    }
+};
+
+/**
+ * \struct field_t
+ * \brief Describes the (section, key) entry holding a field of T whose
+ * type is M.  Make them with Field.
+ */
+template <typename T, typename M>
+struct field_t
+{
+    std::string_view section;   /*!< section name */
+    std::string_view key;       /*!< key name */
+    M T::*member;               /*!< the field */
+};
+
+/***************************************************************************
+*                            IMPLEMENTATION
+***************************************************************************/
+namespace detail
+{
+
+/*!
+  \brief FNV-1a offset basis, the same as the library's.
+*/
+constexpr std::uint32_t HASH_SEED = 2166136261u;
+
+/*!
+  \brief FNV-1a multiplier, the same as the library's.  It multiplies the
+  bucket hash.
+*/
+constexpr std::uint32_t HASH_PRIME = 16777619u;
+
+/*!
+  \brief The multiplier of the slot hash, which differs from HASH_PRIME so
+  that pairs with equal bucket hashes almost never have equal slot hashes.
+  The same as inihash's.
+*/
+constexpr std::uint32_t SLOT_PRIME = 0x5bd1e995u;
+
+/*!
+  \brief Number of seeds tried before giving up on a table.
+*/
+constexpr std::uint32_t MAX_SEEDS = 32;
+
+/*!
+  \brief Number of displacements tried for a bucket with a seed.
+*/
+constexpr std::uint32_t MAX_DISPLACEMENT = 1u << 16;
+
+/**
+ * \struct pair_hash_t
+ * \brief The two 32 bit hashes of a (section, key) pair.  The bucket hash
+ * chooses the pair's bucket and the slot hash its slot.
+ */
+struct pair_hash_t
+{
+    std::uint32_t bucket;       /*!< FNV-1a hash */
+    std::uint32_t slot;         /*!< FNV-1a hash with SLOT_PRIME */
+};
+
+/**
+ * \brief Returns both hashes of a string, continuing from seed.
+ */
+constexpr pair_hash_t Hash(const char *str, std::size_t length,
+    pair_hash_t seed) noexcept
+{
+    for (std::size_t i = 0; i < length; i++)
+    {
+        seed.bucket ^= static_cast<unsigned char>(str[i]);
+        seed.bucket *= HASH_PRIME;
+        seed.slot ^= static_cast<unsigned char>(str[i]);
+        seed.slot *= SLOT_PRIME;
+    }
+
+    return seed;
+}
+
+/**
+ * \brief Returns the hashes of a section name, continuing from seed.  A
+ * ']', which can't be part of a section name, is hashed after it so that
+ * ("ab", "c") and ("a", "bc") don't hash alike.  A (section, key) pair is
+ * hashed as Hash(key, HashSection(section, seed)).
+ */
+constexpr pair_hash_t HashSection(std::string_view section,
+    pair_hash_t seed) noexcept
+{
+    return Hash("]", 1, Hash(section.data(), section.size(), seed));
+}
+
+/**
+ * \brief Scrambles a hash with a bucket's displacement, giving the slot
+ * candidate for the displacement.
+ */
+constexpr std::uint32_t Mix(std::uint32_t hash, std::uint32_t displacement)
+    noexcept
+{
+    hash ^= displacement * 0x9e3779b9u;
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+/**
+ * \brief Returns the seeds of both hashes for a table building attempt.
+ */
+constexpr pair_hash_t Seed(std::uint32_t attempt) noexcept
+{
+    std::uint32_t bucket = Mix(HASH_SEED, attempt);
+
+    return pair_hash_t{bucket, Mix(bucket, 1)};
+}
+
+/**
+ * \brief Returns the smallest power of 2 that is at least count.
+ */
+constexpr std::size_t PowerOf2(std::size_t count) noexcept
+{
+    std::size_t size = 1;
+
+    while (size < count)
+    {
+        size *= 2;
+    }
+
+    return size;
+}
+
+/**
+ * \class perfect_hash_t
+ * \brief A perfect hash table of N (section, key) pairs built at compile
+ * time by hash and displace: each pair's bucket hash puts it in a bucket,
+ * and every bucket has a displacement that sends the slot hashes of its
+ * pairs to free slots.
+ */
+template <std::size_t N>
+class perfect_hash_t
+{
+public:
+    static constexpr std::size_t SLOTS = PowerOf2(N + (N / 4) + 1);
+    static constexpr std::size_t BUCKETS = (SLOTS < 4) ? 1 : (SLOTS / 4);
+    static constexpr std::size_t EMPTY = N;
+
+    /**
+     * \brief Builds the table.  If no displacement fits a bucket (e.g. two
+     * pairs in it have equal slot hashes), other seeds are tried, so
+     * distinct pairs always build a table.
+     */
+    constexpr explicit perfect_hash_t(const std::array<std::pair<
+        std::string_view, std::string_view>, N> &names)
+    {
+        std::array<pair_hash_t, N> hashes{};
+
+        for (std::uint32_t attempt = 0; attempt < MAX_SEEDS; attempt++)
+        {
+            seed_ = Seed(attempt);
+
+            for (std::size_t i = 0; i < N; i++)
+            {
+                hashes[i] = Hash(names[i].second.data(),
+                    names[i].second.size(),
+                    HashSection(names[i].first, seed_));
+            }
+
+            if (Build(hashes))
+            {
+                return;
+            }
+        }
+
+        throw "ezini: no perfect hash of the (section, key) pairs";
+    }
+
+    /**
+     * \brief Returns the hashes of a section name, to be continued with
+     * the keys of its entries.
+     */
+    constexpr pair_hash_t Start(std::string_view section) const noexcept
+    {
+        return HashSection(section, seed_);
+    }
+
+    /**
+     * \brief Returns the index of the only pair that may have hash, or
+     * EMPTY if there is none.  The caller verifies the match.
+     */
+    constexpr std::size_t Find(const pair_hash_t &hash) const noexcept
+    {
+        return index_[Mix(hash.slot,
+            displacement_[hash.bucket & (BUCKETS - 1)]) & (SLOTS - 1)];
+    }
+
+private:
+    /**
+     * \brief Tries to build the table with the seed the hashes were made
+     * with.  Returns false if a bucket can't be placed.
+     */
+    constexpr bool Build(const std::array<pair_hash_t, N> &hashes)
+    {
+        std::array<std::size_t, BUCKETS + 1> starts{};
+        std::array<std::size_t, N> members{};
+        std::array<std::size_t, N> slots{};
+        std::size_t largest = 0;
+
+        for (std::size_t i = 0; i < SLOTS; i++)
+        {
+            index_[i] = EMPTY;
+        }
+
+        /* sort the pairs by bucket, so each bucket's members are together */
+        for (std::size_t i = 0; i < N; i++)
+        {
+            starts[(hashes[i].bucket & (BUCKETS - 1)) + 1]++;
+        }
+
+        for (std::size_t bucket = 0; bucket < BUCKETS; bucket++)
+        {
+            std::size_t count = starts[bucket + 1];
+            largest = (count > largest) ? count : largest;
+            starts[bucket + 1] += starts[bucket];
+            displacement_[bucket] = 0;
+        }
+
+        {
+            std::array<std::size_t, BUCKETS> next{};
+
+            for (std::size_t i = 0; i < N; i++)
+            {
+                std::size_t bucket = hashes[i].bucket & (BUCKETS - 1);
+                members[starts[bucket] + next[bucket]++] = i;
+            }
+        }
+
+        /* place the largest buckets first, while there are free slots */
+        for (std::size_t size = largest; size > 0; size--)
+        {
+            for (std::size_t bucket = 0; bucket < BUCKETS; bucket++)
+            {
+                if ((starts[bucket + 1] - starts[bucket] == size) &&
+                    !Place(hashes, bucket, &members[starts[bucket]], size,
+                    slots))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * \brief Finds a displacement sending the count pairs of bucket listed
+     * in members to free slots, and fills the slots.  Returns false if
+     * there is none.
+     */
+    constexpr bool Place(const std::array<pair_hash_t, N> &hashes,
+        std::size_t bucket, const std::size_t *members, std::size_t count,
+        std::array<std::size_t, N> &slots)
+    {
+        /* equal slot hashes always share a slot, so don't search */
+        for (std::size_t i = 0; i < count; i++)
+        {
+            for (std::size_t j = i + 1; j < count; j++)
+            {
+                if (hashes[members[i]].slot == hashes[members[j]].slot)
+                {
+                    return false;
+                }
+            }
+        }
+
+        for (std::uint32_t d = 0; d < MAX_DISPLACEMENT; d++)
+        {
+            bool fits = true;
+
+            for (std::size_t i = 0; fits && (i < count); i++)
+            {
+                std::size_t slot = Mix(hashes[members[i]].slot, d) &
+                    (SLOTS - 1);
+                fits = (EMPTY == index_[slot]);
+
+                for (std::size_t j = 0; fits && (j < i); j++)
+                {
+                    fits = (slots[j] != slot);
+                }
+
+                slots[i] = slot;
+            }
+
+            if (fits)
+            {
+                for (std::size_t i = 0; i < count; i++)
+                {
+                    index_[slots[i]] = members[i];
+                }
+
+                displacement_[bucket] = d;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    pair_hash_t seed_{};
+    std::array<std::uint32_t, BUCKETS> displacement_{};
+    std::array<std::size_t, SLOTS> index_{};
+};
+
+/*!
+  \brief Makes static_assert in a discarded if constexpr branch depend on M.
+*/
+template <typename M>
+constexpr bool UNSUPPORTED = false;
+
+/**
+ * \brief Converts an integer wider than long (e.g. std::int64_t on 64 bit
+ * Windows) by the same rules as ConvertINILong and ConvertINIULong, and
+ * stores it in a field.  Returns false if the value is malformed or doesn't
+ * fit.
+ */
+template <typename M>
+bool AssignWide(M &field, const char *value, std::size_t length)
+{
+    const char *ptr = value;
+    const char *end = value + length;
+    bool negative = false;
+    int base = 10;
+    unsigned long long magnitude;
+
+    if ((ptr < end) && ((*ptr == '-') || (*ptr == '+')))
+    {
+        negative = (*ptr == '-');
+        ptr++;
+    }
+
+    if ((end - ptr > 2) && (ptr[0] == '0') &&
+        ((ptr[1] == 'x') || (ptr[1] == 'X')) &&
+        std::isxdigit(static_cast<unsigned char>(ptr[2])))
+    {
+        base = 16;
+        ptr += 2;
+    }
+
+    /* from_chars takes no white space or sign, just like ParseULong */
+    std::from_chars_result parsed = std::from_chars(ptr, end, magnitude, base);
+
+    if ((std::errc() != parsed.ec) || (end != parsed.ptr))
+    {
+        return false;
+    }
+
+    if constexpr (std::is_signed_v<M>)
+    {
+        using U = std::make_unsigned_t<M>;
+
+        if (magnitude > static_cast<U>(std::numeric_limits<M>::max()) +
+            (negative ? 1U : 0U))
+        {
+            return false;
+        }
+
+        if (!negative)
+        {
+            field = static_cast<M>(magnitude);
+        }
+        else if (0 == magnitude)
+        {
+            field = 0;
+        }
+        else
+        {
+            /* -(magnitude - 1) - 1 doesn't overflow for the minimum */
+            field = -static_cast<M>(magnitude - 1) - 1;
+        }
+    }
+    else
+    {
+        if ((negative && (0 != magnitude)) ||
+            (magnitude > std::numeric_limits<M>::max()))
+        {
+            return false;
+        }
+
+        field = static_cast<M>(magnitude);
+    }
+
+    return true;
+}
+
+/**
+ * \brief Converts a value with the library's typed conversions and stores
+ * it in a field.  Returns false if the value is malformed or doesn't fit.
+ */
+template <typename M>
+bool Assign(M &field, const char *value, std::size_t length)
+{
+    if constexpr (std::is_same_v<M, bool>)
+    {
+        int converted;
+
+        if (0 != ConvertINIBool(value, length, &converted))
+        {
+            return false;
+        }
+
+        field = (0 != converted);
+    }
+    else if constexpr (std::is_integral_v<M> && (sizeof(M) > sizeof(long)))
+    {
+        return AssignWide(field, value, length);
+    }
+    else if constexpr (std::is_integral_v<M> && std::is_signed_v<M>)
+    {
+        long converted;
+
+        if ((0 != ConvertINILong(value, length, &converted)) ||
+            (converted < std::numeric_limits<M>::min()) ||
+            (converted > std::numeric_limits<M>::max()))
+        {
+            return false;
+        }
+
+        field = static_cast<M>(converted);
+    }
+    else if constexpr (std::is_integral_v<M>)
+    {
+        unsigned long converted;
+
+        if ((0 != ConvertINIULong(value, length, &converted)) ||
+            (converted > std::numeric_limits<M>::max()))
+        {
+            return false;
+        }
+
+        field = static_cast<M>(converted);
+    }
+    else if constexpr (std::is_floating_point_v<M>)
+    {
+        double converted;
+
+        if (0 != ConvertINIDouble(value, length, &converted))
+        {
+            return false;
+        }
+
+        field = static_cast<M>(converted);
+    }
+    else if constexpr (std::is_same_v<M, std::string>)
+    {
+        field.assign(value, length);
+    }
+    else if constexpr (std::is_array_v<M> &&
+        std::is_same_v<std::remove_extent_t<M>, char>)
+    {
+        /* NULL terminated, truncated to fit */
+        std::size_t copy = (length < std::extent_v<M>) ? length :
+            (std::extent_v<M> - 1);
+
+        std::memcpy(field, value, copy);
+        field[copy] = '\0';
+    }
+    else
+    {
+        static_assert(UNSUPPORTED<M>, "ezini: unsupported field type");
+    }
+
+    return true;
+}
+
+}   /* namespace detail */
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/**
+ * \fn template <typename T, typename M> constexpr field_t<T, M>
+ * Field(std::string_view section, std::string_view key, M T::*member)
+ *
+ * \brief This function describes the (section, key) entry holding a field.
+ *
+ * \param section The section name.  Use "" for entries preceding the
+ * first section.
+ *
+ * \param key The key name.
+ *
+ * \param member A pointer to the field.  Its type may be bool, an integer
+ * type, a floating point type, std::string, or a char array (the value is
+ * truncated to fit and NULL terminated).
+ *
+ * \returns The field description.
+ */
+template <typename T, typename M>
+constexpr field_t<T, M> Field(std::string_view section,
+    std::string_view key, M T::*member) noexcept
+{
+    return field_t<T, M>{section, key, member};
+}
+
+/**
+ * \class schema_t
+ * \brief The fields of T and the entries that hold them, compiled into a
+ * perfect hash table.  Make them with MakeSchema.
+ *
+ * Schemas should be constexpr, so that the table is built by the compiler.
+ * A schema naming the same (section, key) pair twice doesn't compile.
+ */
+template <typename T, typename... M>
+class schema_t
+{
+public:
+    static constexpr std::size_t COUNT = sizeof...(M);
+
+    /**
+     * \brief Makes a schema from the description of each field.
+     */
+    constexpr explicit schema_t(field_t<T, M>... fields) :
+        fields_(fields...),
+        names_{{{fields.section, fields.key}...}},
+        table_(Unique(names_))
+    {
+    }
+
+    /**
+     * \fn bind_report_t BindFile(const char *iniFile, T &object) const
+     *
+     * \brief This function reads an INI file into the fields of a
+     * structure.
+     *
+     * \param iniFile The name of the INI file.
+     *
+     * \param object The structure receiving the values.
+     *
+     * \effects The file is parsed by ParseINIFile.  Each entry with a
+     * field is converted and stored in it; fields without entries are left
+     * unchanged.
+     *
+     * \returns A report of the result and of the missing, unknown, and
+     * invalid entries.
+     */
+    bind_report_t BindFile(const char *iniFile, T &object) const
+    {
+        bind_report_t report;
+        state_t state(*this, object, report);
+        ini_handler_t handler = {OnSection, OnEntry, &state};
+
+        report.result = ParseINIFile(iniFile, &handler);
+        Finish(state);
+        return report;
+    }
+
+    /**
+     * \fn bind_report_t BindBuffer(const char *data, std::size_t size,
+     * T &object) const
+     *
+     * \brief This function reads INI file text in memory into the fields
+     * of a structure.
+     *
+     * \param data A pointer to the text.
+     *
+     * \param size The number of characters in data.
+     *
+     * \param object The structure receiving the values.
+     *
+     * \effects See BindFile.
+     *
+     * \returns See BindFile.
+     */
+    bind_report_t BindBuffer(const char *data, std::size_t size,
+        T &object) const
+    {
+        bind_report_t report;
+        state_t state(*this, object, report);
+        ini_handler_t handler = {OnSection, OnEntry, &state};
+
+        report.result = ParseINIBuffer(data, size, &handler);
+        Finish(state);
+        return report;
+    }
+
+private:
+    using setter_t = bool (*)(const std::tuple<field_t<T, M>...> &fields,
+        T &object, const char *value, std::size_t length);
+
+    /**
+     * \struct state_t
+     * \brief The state of a binding, passed to the handler functions.
+     */
+    struct state_t
+    {
+        state_t(const schema_t &s, T &o, bind_report_t &r) :
+            schema(s), object(o), report(r)
+        {
+        }
+
+        const schema_t &schema;             /*!< schema being bound */
+        T &object;                          /*!< structure being filled */
+        bind_report_t &report;              /*!< report being made */
+        std::string section;                /*!< current section name */
+        detail::pair_hash_t sectionHash =
+            schema.table_.Start(std::string_view());
+                                            /*!< hashes of section */
+        std::array<bool, COUNT> seen{};     /*!< fields that were set */
+        bool failed = false;                /*!< out of memory */
+    };
+
+    /**
+     * \brief Returns names after checking that no (section, key) pair is
+     * named twice, so the check comes before the table is built.
+     */
+    static constexpr const std::array<std::pair<std::string_view,
+        std::string_view>, COUNT> &Unique(const std::array<std::pair<
+        std::string_view, std::string_view>, COUNT> &names)
+    {
+        for (std::size_t i = 0; i < COUNT; i++)
+        {
+            for (std::size_t j = i + 1; j < COUNT; j++)
+            {
+                if (names[i] == names[j])
+                {
+                    throw "ezini: a (section, key) pair is bound twice";
+                }
+            }
+        }
+
+        return names;
+    }
+
+    template <std::size_t I>
+    static bool Set(const std::tuple<field_t<T, M>...> &fields, T &object,
+        const char *value, std::size_t length)
+    {
+        return detail::Assign(object.*(std::get<I>(fields).member), value,
+            length);
+    }
+
+    template <std::size_t... I>
+    static constexpr std::array<setter_t, COUNT> MakeSetters(
+        std::index_sequence<I...>) noexcept
+    {
+        return {{&Set<I>...}};
+    }
+
+    /**
+     * \brief ParseINI handler function for section names.
+     */
+    static int OnSection(const char *name, std::size_t length, void *user)
+    {
+        state_t *state = static_cast<state_t *>(user);
+
+        try
+        {
+            state->section.assign(name, length);
+        }
+        catch (...)
+        {
+            state->failed = true;
+            return 1;
+        }
+
+        state->sectionHash = state->schema.table_.Start(
+            std::string_view(name, length));
+        return 0;
+    }
+
+    /**
+     * \brief ParseINI handler function for entries.  One hash finds the
+     * only field the entry may belong to, and one comparison verifies it.
+     */
+    static int OnEntry(const char *key, std::size_t keyLength,
+        const char *value, std::size_t valueLength, void *user)
+    {
+        static constexpr std::array<setter_t, COUNT> setters =
+            MakeSetters(std::index_sequence_for<M...>());
+
+        state_t *state = static_cast<state_t *>(user);
+        const schema_t &schema = state->schema;
+        std::size_t i = schema.table_.Find(detail::Hash(key, keyLength,
+            state->sectionHash));
+
+        try
+        {
+            if ((COUNT == i) || (schema.names_[i].second != std::string_view(key,
+                    keyLength)) ||
+                (schema.names_[i].first != state->section))
+            {
+                state->report.unknown.push_back(
+                    {state->section, std::string(key, keyLength)});
+            }
+            else if (setters[i](schema.fields_, state->object, value,
+                valueLength))
+            {
+                state->seen[i] = true;
+            }
+            else
+            {
+                state->report.invalid.push_back(
+                    {state->section, std::string(key, keyLength)});
+            }
+        }
+        catch (...)
+        {
+            state->failed = true;
+            return 1;
+        }
+
+        return 0;
+    }
+
+    /**
+     * \brief Finishes a report by listing the fields that weren't set.
+     */
+    void Finish(state_t &state) const
+    {
+        if (state.failed)
+        {
+            state.report.result = -1;
+            errno = ENOMEM;
+            return;
+        }
+
+        for (std::size_t i = 0; i < COUNT; i++)
+        {
+            if (!state.seen[i])
+            {
+                state.report.missing.push_back(
+                    {std::string(names_[i].first),
+                    std::string(names_[i].second)});
+            }
+        }
+    }
+
+    std::tuple<field_t<T, M>...> fields_;
+    std::array<std::pair<std::string_view, std::string_view>, COUNT> names_;
+    detail::perfect_hash_t<COUNT> table_;
+};
+
+/**
+ * \fn template <typename T, typename... M> constexpr schema_t<T, M...>
+ * MakeSchema(field_t<T, M>... fields)
+ *
+ * \brief This function makes the schema of a structure from the
+ * descriptions of its fields.
+ *
+ * \param fields The fields, described by Field.
+ *
+ * \returns The schema.  Declare it constexpr, e.g.\n
+ * constexpr auto schema = ezini::MakeSchema(\n
+ *     ezini::Field("server", "port", &config_t::port),\n
+ *     ezini::Field("server", "name", &config_t::name));
+ */
+template <typename T, typename... M>
+constexpr schema_t<T, M...> MakeSchema(field_t<T, M>... fields)
+{
+    return schema_t<T, M...>(fields...);
+}
+
+}   /* namespace ezini */
+
+#endif  /* ndef __EZBIND_HPP */
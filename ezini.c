@@ -41,17 +41,363 @@
 /***************************************************************************
 *                             INCLUDED FILES
 ***************************************************************************/
+#if defined(__unix__) || defined(__unix) || \
+    (defined(__APPLE__) && defined(__MACH__))
+/*!
+  \def EZINI_POSIX
+  \brief Defined when POSIX functions (mmap) are available.
+*/
+#define EZINI_POSIX
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+/*!
+  \def EZINI_X86_SIMD
+  \brief Defined when the SSE2 and AVX2 scan kernels can be built.  They
+  are only used if the CPU supports them.
+*/
+#define EZINI_X86_SIMD
+#endif
+
 #include <stdio.h>
 #include <ctype.h>
 #include <string.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <limits.h>
+#include <locale.h>
+#include <math.h>
+#include <time.h>
+
+#ifdef EZINI_POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
+
+#ifdef EZINI_POSIX
+#include <pthread.h>
+#endif
+
+#ifdef EZINI_X86_SIMD
+#include <immintrin.h>
+#endif
+
 #include "ezini.h"
 
+/***************************************************************************
+*                                 MACROS
+***************************************************************************/
+#if defined(__GNUC__) && \
+    ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 7)))
+/*!
+  \def LOAD_ACQUIRE
+  \brief Atomically read an int with acquire semantics.
+*/
+#define LOAD_ACQUIRE(p)         __atomic_load_n((p), __ATOMIC_ACQUIRE)
+
+/*!
+  \def STORE_RELEASE
+  \brief Atomically write an int with release semantics.
+*/
+#define STORE_RELEASE(p, v)     __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+/*!
+  \def CLAIM
+  \brief Atomically change an int from old to new.  Evaluates to non-zero
+  if the int was old.
+*/
+#define CLAIM(p, old, new)      __extension__ ({ int expected_ = (old); \
+    __atomic_compare_exchange_n((p), &expected_, (new), 0, \
+        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED); })
+
+/*!
+  \def ADD_RELAXED
+  \brief Atomically add to an unsigned long without ordering other memory
+  accesses.
+*/
+#define ADD_RELAXED(p, n)       __atomic_fetch_add((p), (n), __ATOMIC_RELAXED)
+
+/*!
+  \def LOAD_RELAXED
+  \brief Atomically read an unsigned long without ordering other memory
+  accesses.
+*/
+#define LOAD_RELAXED(p)         __atomic_load_n((p), __ATOMIC_RELAXED)
+
+/*!
+  \def STORE_RELAXED
+  \brief Atomically write an unsigned long without ordering other memory
+  accesses.
+*/
+#define STORE_RELAXED(p, v)     __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+
+/*!
+  \def RELAXED_ATOMICS
+  \brief Defined when ADD_RELAXED, LOAD_RELAXED, and STORE_RELAXED are
+  atomic.
+*/
+#define RELAXED_ATOMICS
+#else
+/* no atomic operations, typed value caching isn't thread safe */
+#define LOAD_ACQUIRE(p)         (*(p))
+#define STORE_RELEASE(p, v)     (*(p) = (v))
+#define CLAIM(p, old, new)      ((*(p) == (old)) ? ((*(p) = (new)), 1) : 0)
+#define ADD_RELAXED(p, n)       (*(p) += (n))
+#define LOAD_RELAXED(p)         (*(p))
+#define STORE_RELAXED(p, v)     (*(p) = (v))
+#endif
+
+#if defined(EZINI_STATS) && defined(EZINI_POSIX) && defined(RELAXED_ATOMICS)
+/*!
+  \def THREAD_STATS
+  \brief Defined when each thread keeps its own statistics, so that counting
+  doesn't need atomic read-modify-write operations.
+*/
+#define THREAD_STATS
+#endif
+
+#ifdef EZINI_STATS
+#ifdef THREAD_STATS
+/*!
+  \def COUNT
+  \brief Add n to one of the statistics counters.  Only this thread writes
+  its block, so no read-modify-write is needed.
+*/
+#define COUNT(counter, n)   ((NULL != threadStats) ? \
+    STORE_RELAXED(&(threadStats->counts[(counter)]), \
+        LOAD_RELAXED(&(threadStats->counts[(counter)])) + \
+        (unsigned long)(n)) : \
+    CountStat((counter), (unsigned long)(n)))
+#else
+#define COUNT(counter, n)   CountStat((counter), (unsigned long)(n))
+#endif
+
+/*!
+  \def TIMER
+  \brief Declare a variable holding the start time of a timed call.  Use it
+  after the other declarations, without a semicolon.
+*/
+#define TIMER(t)            double t;
+
+/*!
+  \def START_TIMER
+  \brief Record the start time of a timed call.
+*/
+#define START_TIMER(t)      ((t) = Now())
+
+/*!
+  \def STOP_TIMER
+  \brief Add a call and the time since START_TIMER to a stat_timer_t.
+*/
+#define STOP_TIMER(t, timer)    AddCallTime((timer), Now() - (t))
+
+#ifdef THREAD_STATS
+/*!
+  \def LOCK_STATS
+  \brief Lock the list of statistics blocks and the reset totals.
+*/
+#define LOCK_STATS()        pthread_mutex_lock(&statsLock)
+
+/*!
+  \def UNLOCK_STATS
+  \brief Unlock the list of statistics blocks and the reset totals.
+*/
+#define UNLOCK_STATS()      pthread_mutex_unlock(&statsLock)
+#else
+#define LOCK_STATS()        ((void)0)
+#define UNLOCK_STATS()      ((void)0)
+#endif
+#else
+/* statistics are compiled out */
+#define COUNT(counter, n)       ((void)0)
+#define TIMER(t)
+#define START_TIMER(t)          ((void)0)
+#define STOP_TIMER(t, timer)    ((void)0)
+#endif
+
 /***************************************************************************
 *                            TYPE DEFINITIONS
 ***************************************************************************/
 
+/**
+ * \def HASH_SEED
+ * \brief Initial value used when hashing section names (the FNV-1a offset
+ * basis).
+ */
+#define HASH_SEED       2166136261UL
+
+/**
+ * \def HASH_PRIME
+ * \brief Multiplier used by the FNV-1a hash.
+ */
+#define HASH_PRIME      16777619UL
+
+/**
+ * \def MIN_INDEX_SIZE
+ * \brief Number of slots in a newly allocated hash index.  Must be a power
+ * of 2.
+ */
+#define MIN_INDEX_SIZE  16
+
+/**
+ * \def LINE_BLANK
+ * \brief ParseLine return value for blank lines and comments.
+ */
+#define LINE_BLANK      0
+
+/**
+ * \def LINE_SECTION
+ * \brief ParseLine return value for [section] lines.
+ */
+#define LINE_SECTION    1
+
+/**
+ * \def LINE_ENTRY
+ * \brief ParseLine return value for key = value lines.
+ */
+#define LINE_ENTRY      2
+
+/**
+ * \def LAZY_UNPARSED
+ * \brief State of a lazily parsed section that hasn't been accessed.
+ */
+#define LAZY_UNPARSED   0
+
+/**
+ * \def LAZY_PARSED
+ * \brief State of a lazily parsed section whose entries have been parsed.
+ */
+#define LAZY_PARSED     1
+
+/**
+ * \def LAZY_FAILED
+ * \brief State of a lazily parsed section whose text couldn't be parsed.
+ */
+#define LAZY_FAILED     2
+
+/**
+ * \def MIN_LINE_SIZE
+ * \brief Initial buffer size of a reader that reads a line at a time.
+ */
+#define MIN_LINE_SIZE   128
+
+/**
+ * \def SPARE_LINE_SIZE
+ * \brief Largest line buffer that GetEntryFromFile keeps for its next call.
+ */
+#define SPARE_LINE_SIZE 4096
+
+/**
+ * \def READ_BLOCK_SIZE
+ * \brief Initial buffer size of a reader that reads in blocks.
+ */
+#define READ_BLOCK_SIZE 65536
+
+/*!
+  \def MIN_CHUNK_SIZE
+  \brief Smallest part of a file worth parsing on its own thread.
+*/
+#define MIN_CHUNK_SIZE  262144
+
+/*!
+  \def WRITE_BUFFER_SIZE
+  \brief Size of the buffer used to collect serialized text before it is
+  written.
+*/
+#define WRITE_BUFFER_SIZE   65536
+
+/**
+ * \enum value_type_t
+ * \brief Types that values may be converted to by the typed getters, and
+ * cached as.
+ */
+typedef enum
+{
+    VALUE_NONE = 0,     /*!< nothing cached */
+    VALUE_BUSY,         /*!< a cache entry is being written */
+    VALUE_LONG,         /*!< converted to long */
+    VALUE_ULONG,        /*!< converted to unsigned long */
+    VALUE_DOUBLE,       /*!< converted to double */
+    VALUE_BOOL,         /*!< converted to boolean int */
+    VALUE_SIZE          /*!< converted to size_t with K/M/G suffixes */
+} value_type_t;
+
+/**
+ * \enum stat_counter_t
+ * \brief The statistics counters kept when EZINI_STATS is defined.  They
+ * are reported in the same order by GetINIStats.
+ */
+typedef enum
+{
+    STAT_LINES = 0,     /*!< lines parsed */
+    STAT_BYTES,         /*!< characters in the lines parsed */
+    STAT_ENTRIES,       /*!< key = value lines parsed */
+    STAT_ALLOCS,        /*!< heap allocations and reallocations */
+    STAT_ALLOC_BYTES,   /*!< bytes requested by them */
+    STAT_LINE_REALLOCS, /*!< line and entry buffers enlarged */
+    STAT_WRITES,        /*!< blocks written to files */
+    STAT_COUNTERS       /*!< number of counters */
+} stat_counter_t;
+
+/**
+ * \enum stat_timer_t
+ * \brief The functions that are timed when EZINI_STATS is defined.
+ */
+typedef enum
+{
+    TIMER_GET_ENTRY = 0,    /*!< GetEntryFromFile */
+    TIMER_ADD_TO_LIST,      /*!< AddEntryToList */
+    TIMER_MAKE_FILE,        /*!< MakeINIFile */
+    TIMER_ADD_TO_FILE,      /*!< AddEntryToFile */
+    TIMER_DELETE,           /*!< DeleteEntryFromFile */
+    STAT_TIMERS             /*!< number of timers */
+} stat_timer_t;
+
+/**
+ * \struct ini_stats_block_t
+ * \brief The statistics kept by a thread.  Without THREAD_STATS a single
+ * block is shared by every thread.
+ */
+typedef struct ini_stats_block_t
+{
+    unsigned long counts[STAT_COUNTERS];    /*!< by stat_counter_t */
+    unsigned long calls[STAT_TIMERS];       /*!< calls by stat_timer_t */
+    double seconds[STAT_TIMERS];            /*!< time by stat_timer_t */
+    struct ini_stats_block_t *next;         /*!< next block of statsBlocks */
+    int released;                           /*!< non-zero when the thread
+                                                owning the block exited */
+} ini_stats_block_t;
+
+/**
+ * \union ini_value_t
+ * \brief A value converted from its string representation
+ */
+
+/**
+ * \typedef union ini_value_t
+ * \brief A shortcut for union ini_value_t
+ */
+
+typedef union ini_value_t
+{
+    long l;             /*!< VALUE_LONG */
+    unsigned long ul;   /*!< VALUE_ULONG */
+    double d;           /*!< VALUE_DOUBLE */
+    int b;              /*!< VALUE_BOOL */
+    size_t size;        /*!< VALUE_SIZE */
+} ini_value_t;
+
+/**
+ * \def ARENA_BLOCK_SIZE
+ * \brief Minimum number of bytes allocated for each block of an arena backed
+ * entry list.
+ */
+#define ARENA_BLOCK_SIZE    65536
+
 /**
  * \struct ini_key_list_t
  * \brief A structure used for creating linked lists of key/value pairs
@@ -70,6 +416,16 @@ typedef struct ini_key_list_t
     char *value;                /*!< pointer to a NULL terminated string
                                     containing key value for this entry Use
                                     ASCII strings to represent numbers */
+    size_t keyLength;           /*!< number of characters in key */
+    size_t valueLength;         /*!< number of characters in value */
+    int cacheType;              /*!< value_type_t of cache, VALUE_NONE if
+                                    nothing has been cached */
+    int cacheError;             /*!< errno from converting the cached value,
+                                    0 if it converted without error */
+    ini_value_t cache;          /*!< value converted by a typed getter */
+    unsigned long hash;         /*!< hash of the (section, key) pair */
+    struct ini_section_t *section;  /*!< pointer to the section containing
+                                    this key/value pair */
     struct ini_key_list_t *next;/*!< pointer to the next key/value pair in
                                     in this section */
 
@@ -77,957 +433,11175 @@ typedef struct ini_key_list_t
 
 
 /**
- * \struct ini_section_list_t
+ * \struct ini_section_t
  * \brief A structure used for creating linked lists of sections, each
  *  maintaining its own list of key/value pairs.
  */
 
 /**
- * \typedef struct ini_section_list_t
- * \brief A shortcut for struct ini_section_list_t
+ * \typedef struct ini_section_t
+ * \brief A shortcut for struct ini_section_t
  */
 
-typedef struct ini_section_list_t
+typedef struct ini_section_t
 {
     char *section;                      /*!< pointer to a NULL terminated string
                                             containing the section name */
+    size_t length;                      /*!< number of characters in
+                                            section */
+    unsigned long hash;                 /*!< hash of the section name */
     ini_key_list_t *members;            /*!< pointer to the list of all key/value
                                             pairs in this section */
-    struct ini_section_list_t *next;    /*!< pointer to the next section in
+    ini_key_list_t *last;               /*!< pointer to the last key/value
+                                            pair in this section */
+    struct ini_section_t *next;         /*!< pointer to the next section in
                                             the list of entries */
 
-} ini_section_list_t;
+} ini_section_t;
 
 
-/***************************************************************************
-*                               PROTOTYPES
-***************************************************************************/
+/**
+ * \typedef scan_kernel_t
+ * \brief A function returning a pointer to the first character in
+ * [ptr, end) that is c1 or c2, or end if there is none.
+ */
+typedef const char *(*scan_kernel_t)(const char *ptr, const char *end,
+    int c1, int c2);
 
-/* allocate */
-static ini_key_list_t *NewKeyList(const char *key, const char *value);
-static ini_section_list_t *NewSectionList(const char *section, const char *key,
-    const char *value);
 
-/* free */
-static void FreeKeyList(ini_key_list_t *list);
-static void FreeEntry(ini_entry_t *entry);
+/**
+ * \typedef split_kernel_t
+ * \brief A function returning a pointer to the first '\\n' in [line, end),
+ * or end if there is none, and setting *equals to the first '=' before it
+ * (or to the returned pointer if there is none).  See SplitLine.
+ */
+typedef const char *(*split_kernel_t)(const char *line, const char *end,
+    const char **equals);
 
-/* utilities */
-static char *SkipWS(const char *str);
-static char *DupStr(const char *src);
-static char *GetLine(FILE *fp);
 
-/***************************************************************************
-*                                FUNCTIONS
-***************************************************************************/
+/**
+ * \struct ini_slot_t
+ * \brief A single slot in an open addressing hash index.  Empty slots have
+ * a NULL node.
+ */
 
 /**
- * \fn int AddEntryToList(ini_entry_list_t *list, const char *section,
- * const char *key, const char *value)
- *
- * \brief This function adds a (section, key, value) entry to an entry list.
- *
- * \param list A pointer to an ini_entry_list_t that points to the
- * head of entry list being modified.  Pass a pointer to an ini_entry_list_t
- * pointing to NULL if the list needs to be created.
- *
- * \param section A NULL terminated string containing the name of the
- * section for the entry being added.
- *
- * \param key A NULL terminated string containing the name of the key for
- * the entry being added.
- *
- * \param value A NULL terminated string containing the value of the key for
- * the entry being added.  All values must be represented as strings.  They may
- * be converted to/from strings by the calling program.
- *
- * \effects
- * Information used to generate an entry structure containing copies of
- * the (section, key, value) entry is added to the list passed as a parameter.
- * Memory will be dynamically allocated as needed.
- *
- * \returns 0 for success, Non-zero on error.  Error type is contained in
- * errno.
- *
- * This function adds information used to create a (section, key, value) entry
- * to an entry list.
- *
- * If an entry containing the same section name and key already exists,
- * the new value will overwrite the old value.
+ * \typedef struct ini_slot_t
+ * \brief A shortcut for struct ini_slot_t
+ */
+
+typedef struct ini_slot_t
+{
+    unsigned long hash;                 /*!< hash of the indexed node */
+    void *node;                         /*!< pointer to the ini_section_t or
+                                            ini_key_list_t being indexed */
+} ini_slot_t;
+
+
+/**
+ * \struct ini_index_t
+ * \brief An open addressing (linear probing) hash index.
+ */
+
+/**
+ * \typedef struct ini_index_t
+ * \brief A shortcut for struct ini_index_t
+ */
+
+typedef struct ini_index_t
+{
+    ini_slot_t *slots;                  /*!< array of size slots */
+    size_t size;                        /*!< number of slots, a power of 2 */
+    size_t count;                       /*!< number of slots in use */
+} ini_index_t;
+
+
+/**
+ * \union ini_align_t
+ * \brief A union of the types with the strictest alignment requirements.
+ * Arena allocations are rounded up to a multiple of its size.
+ */
+
+/**
+ * \typedef union ini_align_t
+ * \brief A shortcut for union ini_align_t
+ */
+
+typedef union ini_align_t
+{
+    long l;
+    double d;
+    void *p;
+} ini_align_t;
+
+
+/**
+ * \struct ini_block_t
+ * \brief A block of memory in an arena.  Allocations are carved out of the
+ * memory following the block header.
+ */
+
+/**
+ * \typedef struct ini_block_t
+ * \brief A shortcut for struct ini_block_t
+ */
+
+typedef struct ini_block_t
+{
+    struct ini_block_t *next;           /*!< pointer to the previously
+                                            allocated block */
+    size_t size;                        /*!< number of bytes that may be
+                                            allocated from this block */
+    size_t used;                        /*!< number of bytes already
+                                            allocated from this block */
+    ini_align_t data[1];                /*!< start of the allocatable memory */
+} ini_block_t;
+
+
+/**
+ * \struct ini_section_list_t
+ * \brief A structure holding the list of sections in an entry list, along
+ * with hash indices of its sections and (section, key) pairs.
  *
- * If the entry is for an existing section, it will be added to the end of the
- * list for that section.
+ * The linked lists preserve the order that sections and keys were added,
+ * the indices make finding them O(1).
+ */
+
+/**
+ * \typedef struct ini_section_list_t
+ * \brief A shortcut for struct ini_section_list_t
+ */
+
+typedef struct ini_section_list_t
+{
+    ini_section_t *first;               /*!< pointer to the first section in
+                                            the list of entries */
+    ini_section_t *last;                /*!< pointer to the last section in
+                                            the list of entries */
+    ini_index_t sections;               /*!< index of sections by name */
+    ini_index_t keys;                   /*!< index of keys by (section, key) */
+    int useArena;                       /*!< non-zero if nodes and strings
+                                            are allocated from arena */
+    ini_block_t *arena;                 /*!< pointer to the most recently
+                                            allocated arena block */
+    unsigned long allocs;               /*!< number of heap allocations made
+                                            on behalf of this list */
+
+} ini_section_list_t;
+
+
+/**
+ * \struct ini_reader_t
+ * \brief A structure used to read lines from a file into a buffer that is
+ * reused from line to line.
  *
- * If the entry is for a new section, a new section will be added to the list of
- * sections, and the key/value pair will be the first entry of the section.
+ * buffer holds [start, end) of file data that hasn't been returned yet.
+ * [start, scanned) is known not to contain the end of line.
  */
-int AddEntryToList(ini_entry_list_t *list, const char *section,
-    const char *key, const char *value)
+
+struct ini_reader_t
 {
-    ini_section_list_t *next;
-    int result;
+    FILE *fp;                           /*!< file being read */
+    char *buffer;                       /*!< buffer holding file data */
+    size_t size;                        /*!< size of buffer, grows by
+                                            doubling */
+    size_t start;                       /*!< offset of the next line */
+    size_t scanned;                     /*!< offset of first character not
+                                            searched for the end of line */
+    size_t end;                         /*!< offset of the end of the data */
+    int blocks;                         /*!< non-zero if reads may go past
+                                            the current line */
+    int eof;                            /*!< non-zero at the end of fp */
+};
 
-    /* handle empty list */
-    if (NULL == *list)
-    {
-        /* add the first entry to the list */
-        *list = NewSectionList(section, key, value);
 
-        if (NULL == *list)
-        {
-            return -1;
-        }
+/**
+ * \struct ini_edit_t
+ * \brief A structure describing a change to the contents of a file.  The
+ * characters [offset, offset + length) are replaced by textLength
+ * characters of replacement text.
+ */
 
-        return 0;
-    }
+/**
+ * \typedef struct ini_edit_t
+ * \brief A shortcut for struct ini_edit_t
+ */
 
-    next = *list;
-    result = 1;
+typedef struct ini_edit_t
+{
+    size_t offset;                      /*!< offset of the replaced text */
+    size_t length;                      /*!< number of characters replaced */
+    size_t text;                        /*!< offset of the replacement text
+                                            in the edit list's text */
+    size_t textLength;                  /*!< length of the replacement text */
+    size_t order;                       /*!< order the edit was added, keeps
+                                            edits at the same offset in
+                                            order */
+} ini_edit_t;
 
-    while (1)
-    {
-        result = strcmp(section, next->section);
 
-        if (0 == result)
-        {
-            break;      /* match, insert here */
-        }
+/**
+ * \struct ini_edits_t
+ * \brief A structure holding a growable array of edits and a single
+ * growable buffer holding all of their replacement text.
+ */
 
-        if (NULL == next->next)
-        {
-            break;      /* no match, create new section here */
-        }
+/**
+ * \typedef struct ini_edits_t
+ * \brief A shortcut for struct ini_edits_t
+ */
 
-        next = next->next;
-    }
+typedef struct ini_edits_t
+{
+    ini_edit_t *edits;                  /*!< array of edits */
+    size_t count;                       /*!< number of edits in use */
+    size_t size;                        /*!< number of edits allocated */
+    char *text;                         /*!< replacement text of all edits */
+    size_t textLength;                  /*!< characters of text in use */
+    size_t textSize;                    /*!< characters of text allocated */
+} ini_edits_t;
 
-    if (0 == result)
-    {
-        ini_key_list_t *member;
 
-        member = next->members;
+/**
+ * \struct ini_output_t
+ * \brief A structure describing a file being written by MakeINIFile or
+ * ApplyEdits.  In atomic write mode the data goes to a temporary file.
+ */
 
-        while (1)
-        {
-            result = strcmp(key, member->key);
+/**
+ * \typedef struct ini_output_t
+ * \brief A shortcut for struct ini_output_t
+ */
 
-            if (0 == result)
-            {
-                break;      /* match, insert here */
-            }
+typedef struct ini_output_t
+{
+    FILE *fp;                           /*!< file being written */
+    const char *iniFile;                /*!< name of the file being replaced */
+    char *tempName;                     /*!< name of the temporary file, NULL
+                                            if iniFile is written directly */
+    int mode;                           /*!< INI_WRITE_... and WRITE_BINARY
+                                            flags used for this file */
+} ini_output_t;
 
-            if (NULL == member->next)
-            {
-                break;      /* no match, create new section here */
-            }
 
-            member = member->next;
-        }
+/**
+ * \struct ini_serializer_t
+ * \brief A structure used to collect serialized INI file text in a buffer
+ * and pass it to a writer in large blocks.
+ */
 
-        if (0 == result)
-        {
-            /* key exists, change value */
-            free(member->value);
-            member->value = DupStr(value);
+/**
+ * \typedef struct ini_serializer_t
+ * \brief A shortcut for struct ini_serializer_t
+ */
 
-            if (NULL == member->value)
-            {
-                return -1;
-            }
-        }
-        else
-        {
-            /* new key, add to list */
-            member->next = NewKeyList(key, value);
+typedef struct ini_serializer_t
+{
+    char *data;                         /*!< output buffer */
+    size_t size;                        /*!< size of the output buffer */
+    size_t used;                        /*!< characters in the buffer */
+    ini_writer_t writer;                /*!< function receiving full
+                                            buffers, NULL if the buffer is
+                                            big enough for everything */
+    void *user;                         /*!< passed through to writer */
+} ini_serializer_t;
 
-            if (NULL == member->next)
-            {
-                return -1;
-            }
-        }
-    }
-    else
+
+/**
+ * \struct ini_parser_t
+ * \brief A structure holding the state of a push parser between feeds.
+ *
+ * Only a partial line at the end of a feed is copied.  partial never
+ * contains a '\n', so it doesn't need to be searched again when more data
+ * arrives.
+ */
+
+struct ini_parser_t
+{
+    ini_callback_t callback;            /*!< function receiving entries */
+    void *user;                         /*!< passed through to callback */
+    char *partial;                      /*!< start of an incomplete line */
+    size_t length;                      /*!< characters in partial */
+    size_t size;                        /*!< size of partial */
+    char *section;                      /*!< copy of current section name */
+    size_t sectionLength;               /*!< characters in section */
+    size_t sectionSize;                 /*!< size of section */
+    int inSection;                      /*!< non-zero after first section */
+    int stopped;                        /*!< 0 while parsing, otherwise -1
+                                            or the callback's stop value */
+};
+
+
+/**
+ * \struct ini_chunk_t
+ * \brief A structure describing part of an INI file parsed by one thread of
+ * LoadListParallel.  Every chunk but the first starts with a section line.
+ */
+
+/**
+ * \typedef struct ini_chunk_t
+ * \brief A shortcut for struct ini_chunk_t
+ */
+
+typedef struct ini_chunk_t
+{
+    const char *data;                   /*!< first character of the chunk */
+    size_t size;                        /*!< characters in the chunk */
+    ini_section_list_t *list;           /*!< arena list of the chunk's
+                                            entries */
+    int error;                          /*!< errno if parsing failed, or 0 */
+} ini_chunk_t;
+
+
+/**
+ * \def WRITE_BINARY
+ * \brief A flag OR'd with the INI_WRITE_... flags passed to OpenOutput when
+ * the file being written isn't text.
+ */
+#define WRITE_BINARY        0x100
+
+/**
+ * \def IMAGE_MAGIC
+ * \brief The first 8 bytes of a binary cache image.
+ */
+#define IMAGE_MAGIC         "EZINIBIN"
+
+/**
+ * \def IMAGE_VERSION
+ * \brief Version of the binary cache image layout.  Images with any other
+ * version are stale.
+ */
+#define IMAGE_VERSION       1
+
+/**
+ * \def IMAGE_BYTE_ORDER
+ * \brief Value stored in native byte order, so images made on machines with
+ * another byte order are recognized as stale.
+ */
+#define IMAGE_BYTE_ORDER    0x01020304UL
+
+/**
+ * \def IMAGE_EMPTY
+ * \brief Record number marking an unused slot of an image hash index, and
+ * a source time that isn't known.
+ */
+#define IMAGE_EMPTY         0xFFFFFFFFUL
+
+/**
+ * \typedef ini_u32_t
+ * \brief An unsigned integer of exactly 32 bits, used for all of the fields
+ * of a binary cache image.
+ */
+typedef unsigned int ini_u32_t;
+
+/**
+ * \typedef ini_u32_check_t
+ * \brief Fails to compile if ini_u32_t isn't 32 bits.
+ */
+typedef char ini_u32_check_t[(0xFFFFFFFFUL == UINT_MAX) ? 1 : -1];
+
+
+/**
+ * \struct ini_image_t
+ * \brief The header of a binary cache image.
+ *
+ * An image is a parsed INI file laid out so that it may be memory mapped
+ * and queried without any allocations.  All offsets are from the start of
+ * the header, so the image may be mapped anywhere.  The header is followed
+ * by a section table (ini_image_section_t), a key table (ini_image_key_t)
+ * with each section's keys in order, hash indices of the sections and
+ * (section, key) pairs (ini_image_slot_t), and a table of NULL terminated
+ * strings.
+ */
+
+/**
+ * \typedef struct ini_image_t
+ * \brief A shortcut for struct ini_image_t
+ */
+
+typedef struct ini_image_t
+{
+    char magic[8];                      /*!< IMAGE_MAGIC */
+    ini_u32_t version;                  /*!< IMAGE_VERSION */
+    ini_u32_t byteOrder;                /*!< IMAGE_BYTE_ORDER */
+    ini_u32_t size;                     /*!< number of bytes in the image */
+    ini_u32_t sourceSize[2];            /*!< low and high 32 bits of the
+                                            size of the INI file */
+    ini_u32_t sourceTime[2];            /*!< low and high 32 bits of the INI
+                                            file's modification time, or
+                                            IMAGE_EMPTY if it isn't known */
+    ini_u32_t sourceHash;               /*!< FNV-1a hash of the INI file */
+    ini_u32_t sectionCount;             /*!< number of sections */
+    ini_u32_t keyCount;                 /*!< number of keys */
+    ini_u32_t sectionIndexSize;         /*!< slots in the section index, a
+                                            power of 2 */
+    ini_u32_t keyIndexSize;             /*!< slots in the key index, a power
+                                            of 2 */
+    ini_u32_t sections;                 /*!< offset of the section table */
+    ini_u32_t keys;                     /*!< offset of the key table */
+    ini_u32_t sectionIndex;             /*!< offset of the section index */
+    ini_u32_t keyIndex;                 /*!< offset of the key index */
+    ini_u32_t strings;                  /*!< offset of the string table */
+    ini_u32_t stringsSize;              /*!< bytes in the string table */
+} ini_image_t;
+
+
+/**
+ * \struct ini_image_section_t
+ * \brief A section in a binary cache image.
+ */
+
+/**
+ * \typedef struct ini_image_section_t
+ * \brief A shortcut for struct ini_image_section_t
+ */
+
+typedef struct ini_image_section_t
+{
+    ini_u32_t name;                     /*!< string table offset of name */
+    ini_u32_t length;                   /*!< number of characters in name */
+    ini_u32_t hash;                     /*!< hash of the section name */
+    ini_u32_t first;                    /*!< key table index of the first
+                                            key in this section */
+    ini_u32_t count;                    /*!< number of keys in section */
+} ini_image_section_t;
+
+
+/**
+ * \struct ini_image_key_t
+ * \brief A key/value pair in a binary cache image.
+ */
+
+/**
+ * \typedef struct ini_image_key_t
+ * \brief A shortcut for struct ini_image_key_t
+ */
+
+typedef struct ini_image_key_t
+{
+    ini_u32_t key;                      /*!< string table offset of key */
+    ini_u32_t keyLength;                /*!< number of characters in key */
+    ini_u32_t value;                    /*!< string table offset of value */
+    ini_u32_t valueLength;              /*!< number of characters in value */
+    ini_u32_t hash;                     /*!< hash of the (section, key) pair */
+    ini_u32_t section;                  /*!< section table index of the
+                                            section containing this key */
+} ini_image_key_t;
+
+
+/**
+ * \struct ini_image_slot_t
+ * \brief A slot of an open addressing (linear probing) hash index in a
+ * binary cache image.
+ */
+
+/**
+ * \typedef struct ini_image_slot_t
+ * \brief A shortcut for struct ini_image_slot_t
+ */
+
+typedef struct ini_image_slot_t
+{
+    ini_u32_t hash;                     /*!< hash of the indexed record */
+    ini_u32_t record;                   /*!< section or key table index, or
+                                            IMAGE_EMPTY */
+} ini_image_slot_t;
+
+
+/**
+ * \struct ini_lazy_piece_t
+ * \brief The text following one section line of a lazily parsed document.
+ * A section appearing more than once has a piece for each appearance.
+ */
+
+/**
+ * \typedef struct ini_lazy_piece_t
+ * \brief A shortcut for struct ini_lazy_piece_t
+ */
+
+typedef struct ini_lazy_piece_t
+{
+    ini_view_t name;                    /*!< view of the section name in
+                                            the INI file text */
+    unsigned long hash;                 /*!< hash of the section name */
+    size_t offset;                      /*!< offset of the line following
+                                            the section line */
+    size_t length;                      /*!< number of characters before
+                                            the next section line */
+    size_t next;                        /*!< index of the section's next
+                                            piece, 0 if this is the last */
+} ini_lazy_piece_t;
+
+
+/**
+ * \struct ini_lazy_section_t
+ * \brief A section of a lazily parsed document.  Its pieces are parsed the
+ * first time it is accessed.
+ */
+
+/**
+ * \typedef struct ini_lazy_section_t
+ * \brief A shortcut for struct ini_lazy_section_t
+ */
+
+typedef struct ini_lazy_section_t
+{
+    size_t first;                       /*!< index of the first piece */
+    size_t last;                        /*!< index of the last piece */
+    int state;                          /*!< LAZY_UNPARSED, LAZY_PARSED, or
+                                            LAZY_FAILED */
+    int error;                          /*!< errno from a failed parse */
+    ini_section_t *here;                /*!< parsed section, NULL if it has
+                                            no entries */
+    ini_index_t keys;                   /*!< index of the parsed section's
+                                            keys */
+} ini_lazy_section_t;
+
+
+/**
+ * \struct ini_lazy_t
+ * \brief The section directory of a lazily parsed document.
+ *
+ * Pieces are kept in the order that they appear in the file.  Piece 0 is
+ * the text preceding the first section line, which belongs to the section
+ * with an empty name.  Sections are kept in the order of their first
+ * entry.
+ */
+
+/**
+ * \typedef struct ini_lazy_t
+ * \brief A shortcut for struct ini_lazy_t
+ */
+
+typedef struct ini_lazy_t
+{
+    ini_buffer_t buffer;                /*!< the memory mapped INI file */
+    ini_lazy_piece_t *pieces;           /*!< array of pieces */
+    size_t pieceCount;                  /*!< number of pieces in use */
+    size_t pieceSize;                   /*!< number of pieces allocated */
+    ini_lazy_section_t *sections;       /*!< array of sections */
+    size_t sectionCount;                /*!< number of sections */
+    ini_index_t index;                  /*!< index of sections by name */
+#ifdef EZINI_POSIX
+    pthread_mutex_t lock;               /*!< held while parsing a section */
+#endif
+} ini_lazy_t;
+
+
+/**
+ * \struct ini_document_t
+ * \brief A structure holding all of the entries of a parsed INI file.
+ *
+ * A document either holds an entry list, or a binary cache image loaded by
+ * LoadCachedDocument.  The entry list of a document loaded by
+ * LoadLazyDocument only holds the sections that have been accessed.
+ */
+
+struct ini_document_t
+{
+    ini_entry_list_t list;              /*!< arena backed, indexed list of
+                                            the document's entries, NULL if
+                                            image is used */
+    const ini_image_t *image;           /*!< binary cache image of the
+                                            document's entries, or NULL */
+    int mapped;                         /*!< non-zero if image is memory
+                                            mapped rather than allocated */
+    ini_lazy_t *lazy;                   /*!< section directory of a lazily
+                                            parsed document, or NULL */
+};
+
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+
+/* allocate */
+static int AddViewToList(ini_entry_list_t *list, const ini_view_t *section,
+    const ini_view_t *key, const ini_view_t *value);
+static ini_section_list_t *NewEntryList(int useArena);
+static ini_key_list_t *NewKeyList(ini_section_list_t *list,
+    const ini_view_t *key, const ini_view_t *value);
+static ini_section_t *NewSectionList(ini_section_list_t *list,
+    const ini_view_t *section, const ini_view_t *key,
+    const ini_view_t *value);
+static void *ListAlloc(ini_section_list_t *list, size_t size);
+static char *ListDupView(ini_section_list_t *list, const ini_view_t *src);
+static void ListFree(ini_section_list_t *list, void *ptr);
+static int AddBufferToList(ini_buffer_t *buffer, ini_entry_list_t *list);
+
+/* free */
+static void FreeArena(ini_block_t *arena);
+static void FreeSectionList(ini_section_t *list);
+static void FreeKeyList(ini_key_list_t *list);
+static void FreeEntry(ini_entry_t *entry);
+
+/* hash index */
+static unsigned long HashView(const ini_view_t *view, unsigned long seed);
+static int ReserveIndex(ini_section_list_t *list, ini_index_t *index,
+    size_t count);
+static void AddToIndex(ini_index_t *index, void *node, unsigned long hash);
+static void RemoveFromIndex(ini_index_t *index, const void *node,
+    unsigned long hash);
+static ini_section_t *FindSection(const ini_section_list_t *list,
+    const ini_view_t *section, unsigned long hash);
+static ini_key_list_t *FindKey(const ini_index_t *index,
+    const ini_section_t *section, const ini_view_t *key, unsigned long hash);
+static ini_key_list_t *FindEntry(const ini_section_list_t *list,
+    const ini_view_t *section, const ini_view_t *key);
+
+/* parsing */
+static int GetEntry(ini_reader_t *reader, ini_entry_t *entry);
+static int GetEntryInto(ini_reader_t *reader, ini_entry_buffer_t *buffer);
+static int CopyView(char **dest, size_t *size, const ini_view_t *src);
+static int ParseLine(const char *line, size_t length,
+    ini_entry_view_t *parsed);
+static int ParseLineAt(const char *line, size_t length, const char *equals,
+    ini_entry_view_t *parsed);
+static const char *SplitLine(const char *line, const char *end,
+    const char **equals);
+
+/* scan kernels */
+static const char *ScanAuto(const char *ptr, const char *end, int c1, int c2);
+static const char *SplitAuto(const char *line, const char *end,
+    const char **equals);
+static const char *ScanScalar(const char *ptr, const char *end, int c1,
+    int c2);
+static const char *SplitScalar(const char *line, const char *end,
+    const char **equals);
+static const char *SplitTail(const char *ptr, const char *end,
+    const char *found, const char **equals);
+#ifdef EZINI_X86_SIMD
+static const char *ScanSSE2(const char *ptr, const char *end, int c1,
+    int c2);
+static const char *SplitSSE2(const char *line, const char *end,
+    const char **equals);
+static const char *ScanAVX2(const char *ptr, const char *end, int c1,
+    int c2);
+static const char *SplitAVX2(const char *line, const char *end,
+    const char **equals);
+#endif
+
+/* push parsing */
+static int ParseFedLine(ini_parser_t *parser, const char *line,
+    size_t length, const char *equals);
+static int GrowBuffer(char **buffer, size_t *size, size_t needed);
+static int HandleLine(const ini_handler_t *handler, const char *line,
+    size_t length, const char *equals);
+
+/* parallel loading */
+static void *ParseChunk(void *chunk);
+static size_t NextSectionLine(const char *data, size_t size, size_t offset);
+static int MergeLists(ini_section_list_t *into, ini_section_list_t *from);
+
+/* lazily parsed documents */
+static int IndexLazySections(ini_lazy_t *lazy, ini_section_list_t *list);
+static int AddLazyPiece(ini_lazy_t *lazy, const ini_view_t *name,
+    size_t offset);
+static int LazyPieceHasLines(const char *text, size_t length);
+static ini_lazy_section_t *FindLazySection(const ini_lazy_t *lazy,
+    const ini_view_t *section, unsigned long hash);
+static ini_lazy_section_t *GetLazySection(const ini_document_t *doc,
+    const ini_view_t *section);
+static int LoadLazySection(const ini_document_t *doc,
+    ini_lazy_section_t *lazy);
+static int ParseLazySection(ini_document_t *doc, ini_lazy_section_t *lazy);
+static ini_key_list_t *FindLazyEntry(const ini_document_t *doc,
+    const ini_view_t *section, const ini_view_t *key);
+static void FreeLazy(ini_lazy_t *lazy);
+
+/* binary cache images */
+static char *CacheName(const char *iniFile, const char *cacheFile);
+static void GetSourceTime(const char *iniFile, ini_u32_t *stamp);
+static void SplitU32(unsigned long value, ini_u32_t *split);
+static ini_image_t *BuildImage(const ini_section_list_t *list,
+    const char *data, size_t size, const ini_u32_t *stamp);
+static void AddToImageIndex(ini_image_slot_t *index, ini_u32_t size,
+    ini_u32_t hash, ini_u32_t record);
+static int MapImage(const char *cacheFile, const ini_image_t **image,
+    int *mapped);
+static int ValidImage(const ini_image_t *image, size_t size);
+static int TableFits(const ini_image_t *image, ini_u32_t offset,
+    ini_u32_t count, size_t recordSize);
+static int ValidRecords(const ini_image_t *image);
+static void FreeImage(const ini_image_t *image, int mapped);
+static int ImageIsFresh(const ini_image_t *image, const char *iniFile);
+static const char *ImageString(const ini_image_t *image, ini_u32_t offset,
+    ini_u32_t length);
+static const ini_image_section_t *FindImageSection(const ini_image_t *image,
+    const ini_view_t *section, unsigned long hash);
+static const ini_image_key_t *FindImageEntry(const ini_image_t *image,
+    const ini_view_t *section, const ini_view_t *key);
+static void SetImageCursor(const ini_image_t *image,
+    const ini_image_section_t *section, ini_cursor_t *cursor);
+static int GetImageKey(ini_cursor_t *cursor, ini_view_t *key,
+    ini_view_t *value);
+
+/* typed values */
+static int GetTypedValue(const ini_section_list_t *list, const char *section,
+    const char *key, value_type_t type, ini_value_t *value);
+static int GetMemberValue(ini_key_list_t *member, value_type_t type,
+    ini_value_t *value);
+static int GetTypedFromDocument(const ini_document_t *doc,
+    const char *section, const char *key, value_type_t type,
+    ini_value_t *value);
+static int ConvertValue(const char *str, size_t length, value_type_t type,
+    ini_value_t *value);
+static int ConvertString(const char *str, size_t length, value_type_t type,
+    ini_value_t *value);
+static int ParseULong(const char **str, const char *end, unsigned long *value);
+static int ParseDouble(const char *str, size_t length, double *value);
+static int ParseBool(const char *str, size_t length, int *value);
+
+/* in place file edits */
+static void InitEdits(ini_edits_t *edits);
+static int AddEdit(ini_edits_t *edits, size_t offset, size_t length,
+    const char *text, size_t textLength);
+static int AppendEditText(ini_edits_t *edits, const char *text,
+    size_t textLength);
+static void FreeEdits(ini_edits_t *edits);
+static int CompareEdits(const void *a, const void *b);
+static int ApplyEdits(const char *iniFile, const char *data, size_t size,
+    ini_edits_t *edits);
+static int WriteEdits(FILE *fp, const char *data, size_t size,
+    const ini_edits_t *edits, size_t first, size_t from);
+static int WriteBytes(FILE *fp, const char *data, size_t length);
+
+/* serialization */
+static int SerializeList(ini_serializer_t *out,
+    const ini_section_list_t *list);
+static int Emit(ini_serializer_t *out, const char *str, size_t length);
+static int FlushSerializer(ini_serializer_t *out);
+static int WriteToFile(const char *data, size_t length, void *user);
+
+/* file output */
+static int OpenOutput(ini_output_t *out, const char *iniFile, int mode);
+static int CloseOutput(ini_output_t *out, int failed);
+static int SyncFile(FILE *fp);
+static int SyncDirectory(const char *path);
+#ifdef EZINI_POSIX
+static void AddSync(double seconds);
+#endif
+static double Now(void);
+
+/* statistics and memory */
+#ifdef EZINI_STATS
+static void CountStat(stat_counter_t counter, unsigned long n);
+static void AddCallTime(stat_timer_t timer, double seconds);
+static void SumStats(ini_stats_block_t *totals);
+#ifdef THREAD_STATS
+static ini_stats_block_t *GetStatsBlock(void);
+static void MakeStatsKey(void);
+static void ReleaseStatsBlock(void *block);
+#endif
+#endif
+static void *Allocate(size_t size);
+static void *AllocateZeroed(size_t count, size_t size);
+static void *Reallocate(void *ptr, size_t size);
+static void Release(void *ptr);
+static void *DefaultAllocate(size_t size, void *user);
+static void *DefaultReallocate(void *ptr, size_t size, void *user);
+static void DefaultRelease(void *ptr, void *user);
+
+/* utilities */
+static char *DupView(const ini_view_t *view);
+static int LoadFile(const char *iniFile, char **data, size_t *size);
+static size_t SlotOf(const ini_index_t *index, const void *node,
+    unsigned long hash);
+static int InitReader(ini_reader_t *reader, FILE *fp, int blocks);
+static void AttachReader(ini_reader_t *reader, FILE *fp, int blocks,
+    char *buffer, size_t size);
+static int GrowReader(ini_reader_t *reader);
+static int FillReader(ini_reader_t *reader);
+static int ReadLine(ini_reader_t *reader, const char **line, size_t *length);
+static int TakeSpareLine(ini_reader_t *reader, FILE *fp);
+static void KeepSpareLine(ini_reader_t *reader, int done);
+static void ReleaseSpareLine(void);
+
+/***************************************************************************
+*                            GLOBAL VARIABLES
+***************************************************************************/
+
+static int writeMode = 0;               /* INI_WRITE_... flags */
+static unsigned long syncCount = 0;     /* number of fsync calls made */
+static double syncSeconds = 0.0;        /* total time spent syncing */
+#ifdef EZINI_POSIX
+static pthread_mutex_t syncLock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* functions used to allocate memory, see SetINIAllocator */
+static ini_allocator_t currentAllocator =
+{
+    DefaultAllocate, DefaultReallocate, DefaultRelease, NULL
+};
+
+#ifdef EZINI_STATS
+static ini_stats_block_t statsBase;     /* totals when stats were reset */
+#ifdef THREAD_STATS
+static __thread ini_stats_block_t *threadStats = NULL;  /* this thread's */
+static ini_stats_block_t *statsBlocks = NULL;   /* every thread's block */
+static pthread_mutex_t statsLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t statsOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t statsKey;          /* releases blocks at thread exit */
+#else
+static ini_stats_block_t sharedStats;   /* every thread's statistics */
+#endif
+#endif
+
+/* line buffer kept by GetEntryFromFile between calls, NULL while in use */
+static char *spareLine = NULL;
+static size_t spareLineSize = 0;
+#ifdef EZINI_POSIX
+static pthread_mutex_t spareLock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* kernel used to scan text, selected on first use */
+static scan_kernel_t scanKernel = ScanAuto;
+static split_kernel_t splitKernel = SplitAuto;
+static int scanKernelId = INI_SCAN_AUTO;
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/**
+ * \fn int AddEntryToList(ini_entry_list_t *list, const char *section,
+ * const char *key, const char *value)
+ *
+ * \brief This function adds a (section, key, value) entry to an entry list.
+ *
+ * \param list A pointer to an ini_entry_list_t that points to the
+ * head of entry list being modified.  Pass a pointer to an ini_entry_list_t
+ * pointing to NULL if the list needs to be created.
+ *
+ * \param section A NULL terminated string containing the name of the
+ * section for the entry being added.
+ *
+ * \param key A NULL terminated string containing the name of the key for
+ * the entry being added.
+ *
+ * \param value A NULL terminated string containing the value of the key for
+ * the entry being added.  All values must be represented as strings.  They may
+ * be converted to/from strings by the calling program.
+ *
+ * \effects
+ * Information used to generate an entry structure containing copies of
+ * the (section, key, value) entry is added to the list passed as a parameter.
+ * Memory will be dynamically allocated as needed.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ *
+ * This function adds information used to create a (section, key, value) entry
+ * to an entry list.
+ *
+ * If an entry containing the same section name and key already exists,
+ * the new value will overwrite the old value.
+ *
+ * If the entry is for an existing section, it will be added to the end of the
+ * list for that section.
+ *
+ * If the entry is for a new section, a new section will be added to the list of
+ * sections, and the key/value pair will be the first entry of the section.
+ *
+ * Sections and (section, key) pairs are found through hash indices kept with
+ * the list, so adding an entry takes amortized O(1) time regardless of the
+ * size of the list.
+ */
+int AddEntryToList(ini_entry_list_t *list, const char *section,
+    const char *key, const char *value)
+{
+    ini_view_t sectionView;
+    ini_view_t keyView;
+    ini_view_t valueView;
+    int result;
+    TIMER(start)
+
+    START_TIMER(start);
+    sectionView.str = section;
+    sectionView.length = strlen(section);
+    keyView.str = key;
+    keyView.length = strlen(key);
+    valueView.str = value;
+    valueView.length = strlen(value);
+
+    result = AddViewToList(list, &sectionView, &keyView, &valueView);
+    STOP_TIMER(start, TIMER_ADD_TO_LIST);
+    return result;
+}
+
+
+/**
+ * \fn int DeleteEntryFromList(ini_entry_list_t *list, const char *section,
+ * const char *key)
+ *
+ * \brief This function deletes an entry from an entry list.
+ *
+ * \param list A pointer to the ini_entry_list_t containing the entry.
+ *
+ * \param section A pointer to a NULL terminated string containing the name
+ * of the section of the entry to be deleted.
+ *
+ * \param key A pointer to a NULL terminated string containing the name of
+ * the key of the entry to be deleted.
+ *
+ * \effects
+ * The entry is removed from the list and its hash index, and its memory is
+ * freed (arena backed lists reclaim it when the list is freed).  A section
+ * left without entries is deleted too, since entry lists never hold empty
+ * sections.  The order of the remaining entries is unchanged.
+ *
+ * \returns 0 for success, Non-zero on error.  errno is ENOENT if there is
+ * no such entry, or EINVAL if a pointer is NULL.
+ *
+ * Finding the entry is O(1), but unlinking it walks the keys of its section
+ * (and the sections, if its section is deleted), since they are singly
+ * linked.
+ */
+int DeleteEntryFromList(ini_entry_list_t *list, const char *section,
+    const char *key)
+{
+    ini_view_t sectionView;
+    ini_view_t keyView;
+    ini_section_t *here;
+    ini_section_t *prevSection;
+    ini_key_list_t *member;
+    ini_key_list_t *prev;
+
+    if ((NULL == list) || (NULL == section) || (NULL == key))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    sectionView.str = section;
+    sectionView.length = strlen(section);
+    keyView.str = key;
+    keyView.length = strlen(key);
+    member = FindEntry(*list, &sectionView, &keyView);
+
+    if (NULL == member)
+    {
+        errno = ENOENT;
+        return -1;
+    }
+
+    /* unlink the key from its section */
+    here = member->section;
+    prev = NULL;
+
+    if (here->members == member)
+    {
+        here->members = member->next;
+    }
+    else
+    {
+        for (prev = here->members; prev->next != member; prev = prev->next)
+        {
+            /* find the key before this one */
+        }
+
+        prev->next = member->next;
+    }
+
+    if (here->last == member)
+    {
+        here->last = prev;
+    }
+
+    RemoveFromIndex(&((*list)->keys), member, member->hash);
+    ListFree(*list, member->key);
+    ListFree(*list, member->value);
+    ListFree(*list, member);
+
+    if (NULL != here->members)
+    {
+        return 0;
+    }
+
+    /* the section is empty, unlink it from the list */
+    prevSection = NULL;
+
+    if ((*list)->first == here)
+    {
+        (*list)->first = here->next;
+    }
+    else
+    {
+        for (prevSection = (*list)->first; prevSection->next != here;
+            prevSection = prevSection->next)
+        {
+            /* find the section before this one */
+        }
+
+        prevSection->next = here->next;
+    }
+
+    if ((*list)->last == here)
+    {
+        (*list)->last = prevSection;
+    }
+
+    RemoveFromIndex(&((*list)->sections), here, here->hash);
+    ListFree(*list, here->section);
+    ListFree(*list, here);
+    return 0;
+}
+
+
+/**
+ * \fn void FreeList(ini_entry_list_t list)
+ *
+ * \brief This function frees all of the members of an entry list.
+ *
+ * \param list A pointer to the head of an ini_entry_list_t
+ *
+ * \effects
+ * All of the memory allocated for all of the entries in an entry
+ * list will be freed.
+ *
+ * \returns Nothing
+ *
+ * This function frees the sections of the list, then the hash indices and
+ * the list itself.  The sections of an arena backed list are freed a block
+ * at a time.
+ */
+void FreeList(ini_entry_list_t list)
+{
+    if (NULL == list)
+    {
+        return;
+    }
+
+    if (list->useArena)
+    {
+        /* nodes and strings are all in the arena blocks */
+        FreeArena(list->arena);
+    }
+    else if (list->first != NULL)
+    {
+        FreeSectionList(list->first);
+    }
+
+    Release(list->sections.slots);
+    Release(list->keys.slots);
+    Release(list);
+}
+
+
+/**
+ * \fn int NewArenaList(ini_entry_list_t *list)
+ *
+ * \brief This function creates an empty entry list whose entries are
+ * allocated from an arena.
+ *
+ * \param list A pointer to an ini_entry_list_t that will point to the new
+ * list.  It must point to NULL.
+ *
+ * \effects
+ * An empty entry list is allocated.  Entries subsequently added to the list
+ * with AddEntryToList will have their nodes and strings carved out of large
+ * blocks of memory instead of being individually allocated.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ *
+ * An arena backed list is used like any other entry list, but building it
+ * costs one allocation per block instead of up to four per entry, and
+ * FreeList releases it a block at a time.  The trade-off is that memory for
+ * values overwritten by longer values isn't reclaimed until the list is
+ * freed.
+ */
+int NewArenaList(ini_entry_list_t *list)
+{
+    if ((NULL == list) || (NULL != *list))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    *list = NewEntryList(1);
+
+    if (NULL == *list)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * \fn unsigned long GetListAllocCount(const ini_entry_list_t list)
+ *
+ * \brief This function returns the number of heap allocations that have
+ * been made to build an entry list.
+ *
+ * \param list The entry list being queried.
+ *
+ * \effects None
+ *
+ * \returns The number of times that memory was allocated on behalf of the
+ * list, including the memory for the list itself and its hash indices.
+ * 0 is returned for an empty (NULL) list.
+ */
+unsigned long GetListAllocCount(const ini_entry_list_t list)
+{
+    if (NULL == list)
+    {
+        return 0;
+    }
+
+    return list->allocs;
+}
+
+
+/**
+ * \fn void SetINIWriteMode(int mode)
+ *
+ * \brief This function sets how INI files are written by MakeINIFile,
+ * AddEntryToFile, DeleteEntryFromFile, and DeleteEntriesFromFile.
+ *
+ * \param mode 0 or a combination of the flags INI_WRITE_ATOMIC,
+ * INI_WRITE_SYNC, and INI_WRITE_SYNC_DIR.
+ *
+ * \effects The write mode used by all future writes is changed.
+ *
+ * \returns Nothing
+ *
+ * By default (mode 0) files are rewritten or edited in place, so a reader
+ * or a crash in the middle of a write may see a partially written file.
+ *
+ * With INI_WRITE_ATOMIC, the new contents are written to a temporary file
+ * in the same directory, which is then renamed over the original.  Readers
+ * see either the old file or the new one, never a mix.  The temporary file
+ * is given the original file's permissions.  On systems without POSIX
+ * rename semantics the original is removed before the rename, so the
+ * replacement is not atomic there.
+ *
+ * INI_WRITE_SYNC flushes files to disk (fsync) before they are closed or
+ * renamed, and INI_WRITE_SYNC_DIR also flushes the directory after an
+ * atomic rename so the rename survives a crash.  The cost of syncing may be
+ * measured with GetINISyncStats.
+ *
+ * The write mode is shared by all threads.  It should be set before files
+ * are written.
+ */
+void SetINIWriteMode(int mode)
+{
+    writeMode = mode;
+}
+
+
+/**
+ * \fn int GetINIWriteMode(void)
+ *
+ * \brief This function returns the current write mode.
+ *
+ * \effects None
+ *
+ * \returns The INI_WRITE_... flags set by SetINIWriteMode.
+ */
+int GetINIWriteMode(void)
+{
+    return writeMode;
+}
+
+
+/**
+ * \fn void GetINISyncStats(unsigned long *count, double *seconds)
+ *
+ * \brief This function reports the number of file and directory syncs
+ * made by the library, and the time spent making them.
+ *
+ * \param count Set to the number of syncs made since the statistics were
+ * last reset.  May be NULL.
+ *
+ * \param seconds Set to the total number of seconds spent syncing.  May be
+ * NULL.
+ *
+ * \effects None
+ *
+ * \returns Nothing
+ *
+ * Only calls to fsync are counted, so the count is always 0 on systems
+ * without POSIX, where files are only flushed.  The statistics are shared
+ * by all threads and updated under a lock.  They are the syncs and
+ * syncSeconds reported by GetINIStats.
+ */
+void GetINISyncStats(unsigned long *count, double *seconds)
+{
+    ini_stats_t stats;
+
+    GetINIStats(&stats);    /* the sync fields are kept without EZINI_STATS */
+
+    if (NULL != count)
+    {
+        *count = stats.syncs;
+    }
+
+    if (NULL != seconds)
+    {
+        *seconds = stats.syncSeconds;
+    }
+}
+
+
+/**
+ * \fn void ResetINISyncStats(void)
+ *
+ * \brief This function resets the statistics reported by GetINISyncStats.
+ *
+ * \effects The sync count and time are set to 0.  Other statistics
+ * reported by GetINIStats aren't changed.
+ *
+ * \returns Nothing
+ */
+void ResetINISyncStats(void)
+{
+#ifdef EZINI_POSIX
+    pthread_mutex_lock(&syncLock);
+#endif
+    syncCount = 0;
+    syncSeconds = 0.0;
+#ifdef EZINI_POSIX
+    pthread_mutex_unlock(&syncLock);
+#endif
+}
+
+/**
+ * \fn int GetINIStats(ini_stats_t *stats)
+ *
+ * \brief This function reports the counters and timers kept by the
+ * library.
+ *
+ * \param stats A pointer to the structure receiving the statistics.
+ *
+ * \effects stats is filled in.  Everything but the sync count and time is
+ * 0 if the library was built without EZINI_STATS.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.  ENOSYS means that the library was built without EZINI_STATS.
+ *
+ * Statistics are only kept when the library is compiled with EZINI_STATS
+ * defined, otherwise counting and timing compile to nothing.  They are
+ * totals for the whole process since it started or ResetINIStats was last
+ * called.  Counters are updated with relaxed atomic operations when the
+ * compiler supports them, so each value is exact, but values that are read
+ * while other threads are using the library may not be from the same
+ * instant.
+ */
+int GetINIStats(ini_stats_t *stats)
+{
+#ifdef EZINI_STATS
+    ini_stats_block_t totals;
+    ini_call_stats_t *calls[STAT_TIMERS];
+    int i;
+#endif
+
+    if (NULL == stats)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    memset(stats, 0, sizeof(ini_stats_t));
+
+    /* syncs are always counted, see GetINISyncStats */
+#ifdef EZINI_POSIX
+    pthread_mutex_lock(&syncLock);
+#endif
+    stats->syncs = syncCount;
+    stats->syncSeconds = syncSeconds;
+#ifdef EZINI_POSIX
+    pthread_mutex_unlock(&syncLock);
+#endif
+
+#ifdef EZINI_STATS
+    LOCK_STATS();
+    SumStats(&totals);
+
+    for (i = 0; i < STAT_COUNTERS; i++)
+    {
+        totals.counts[i] -= statsBase.counts[i];
+    }
+
+    for (i = 0; i < STAT_TIMERS; i++)
+    {
+        totals.calls[i] -= statsBase.calls[i];
+        totals.seconds[i] -= statsBase.seconds[i];
+    }
+
+    UNLOCK_STATS();
+    stats->linesRead = totals.counts[STAT_LINES];
+    stats->bytesScanned = totals.counts[STAT_BYTES];
+    stats->entriesEmitted = totals.counts[STAT_ENTRIES];
+    stats->allocations = totals.counts[STAT_ALLOCS];
+    stats->bytesAllocated = totals.counts[STAT_ALLOC_BYTES];
+    stats->lineReallocs = totals.counts[STAT_LINE_REALLOCS];
+    stats->writes = totals.counts[STAT_WRITES];
+
+    calls[TIMER_GET_ENTRY] = &(stats->getEntryFromFile);
+    calls[TIMER_ADD_TO_LIST] = &(stats->addEntryToList);
+    calls[TIMER_MAKE_FILE] = &(stats->makeINIFile);
+    calls[TIMER_ADD_TO_FILE] = &(stats->addEntryToFile);
+    calls[TIMER_DELETE] = &(stats->deleteEntryFromFile);
+
+    for (i = 0; i < STAT_TIMERS; i++)
+    {
+        calls[i]->calls = totals.calls[i];
+        calls[i]->seconds = totals.seconds[i];
+    }
+
+    return 0;
+#else
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+/**
+ * \fn void ResetINIStats(void)
+ *
+ * \brief This function resets the statistics reported by GetINIStats.
+ *
+ * \effects All of the counters and timers are set to 0.
+ *
+ * \returns Nothing
+ *
+ * The counters themselves keep counting, the current totals are recorded
+ * and subtracted from the totals reported by GetINIStats.
+ */
+void ResetINIStats(void)
+{
+    ResetINISyncStats();
+
+#ifdef EZINI_STATS
+    LOCK_STATS();
+    SumStats(&statsBase);
+    UNLOCK_STATS();
+#endif
+}
+
+/**
+ * \fn int SetINIAllocator(const ini_allocator_t *allocator)
+ *
+ * \brief This function sets the functions used to allocate and free all of
+ * the library's memory.
+ *
+ * \param allocator A pointer to the functions and the user pointer passed
+ * to them.  NULL restores the default allocator (malloc, realloc, and
+ * free).
+ *
+ * \effects The allocator is copied and used for every later allocation.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ *
+ * Every list, document, reader, parser, watcher, buffer, and string that
+ * the library allocates is allocated and freed with these functions, so
+ * memory may come from a pool or arena, or be counted.  Memory must be
+ * freed by the allocator that allocated it, so set the allocator before
+ * the library allocates anything, or after everything it allocated has
+ * been freed.  Changing it while other threads are using the library
+ * isn't safe.
+ *
+ * Strings returned by MakeINIString and the strings of an ini_entry_t
+ * should be freed with FreeINIMemory.  The line buffer that
+ * GetEntryFromFile keeps between calls is freed before the allocator is
+ * changed.
+ */
+int SetINIAllocator(const ini_allocator_t *allocator)
+{
+    if (NULL == allocator)
+    {
+        ReleaseSpareLine();
+        currentAllocator.allocate = DefaultAllocate;
+        currentAllocator.reallocate = DefaultReallocate;
+        currentAllocator.release = DefaultRelease;
+        currentAllocator.user = NULL;
+        return 0;
+    }
+
+    if ((NULL == allocator->allocate) || (NULL == allocator->reallocate) ||
+        (NULL == allocator->release))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    ReleaseSpareLine();
+    currentAllocator = *allocator;
+    return 0;
+}
+
+/**
+ * \fn void GetINIAllocator(ini_allocator_t *allocator)
+ *
+ * \brief This function reports the functions used to allocate and free the
+ * library's memory.
+ *
+ * \param allocator A pointer to the structure receiving the functions.
+ *
+ * \effects allocator is filled in.  The default allocator's functions call
+ * malloc, realloc, and free, so they may be wrapped by a new allocator.
+ *
+ * \returns Nothing
+ */
+void GetINIAllocator(ini_allocator_t *allocator)
+{
+    if (NULL != allocator)
+    {
+        *allocator = currentAllocator;
+    }
+}
+
+/**
+ * \fn void *AllocateINIMemory(size_t size)
+ *
+ * \brief This function allocates memory with the library's allocator.
+ *
+ * \param size The number of bytes to allocate.
+ *
+ * \effects Memory is allocated by the allocator set with SetINIAllocator.
+ *
+ * \returns A pointer to the memory, or NULL on error.  Free it with
+ * FreeINIMemory.
+ */
+void *AllocateINIMemory(size_t size)
+{
+    return Allocate(size);
+}
+
+/**
+ * \fn void FreeINIMemory(void *ptr)
+ *
+ * \brief This function frees memory allocated by the library, such as the
+ * strings returned by MakeINIString.
+ *
+ * \param ptr A pointer to the memory, or NULL.
+ *
+ * \effects The memory is freed by the allocator set with SetINIAllocator.
+ *
+ * \returns Nothing
+ */
+void FreeINIMemory(void *ptr)
+{
+    Release(ptr);
+}
+
+/**
+ * \fn int MakeINIFile(const char *iniFile, const ini_entry_list_t list)
+ *
+ * \brief This function creates the specified INI file from the list of
+ * entries passed as an argument.
+ *
+ * \param iniFile The name of the INI file to be created.  stdout will be
+ * used if iniFile is NULL.
+ *
+ * \param list A pointer to a list of that will be used to construct
+ * (section, key, value) entries.
+ *
+ * \effects
+ * The specified file is created and the (section, key, value)
+ * triples generated from the entry list are written to the file.  If the
+ * specified file already exists, it will be overwritten.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ *
+ * This function creates the specified INI file from the list of entries
+ * passed as an argument.  Any existing INI file with the same name in the
+ * same path will be overwritten.  See SetINIWriteMode for ways to make the
+ * replacement atomic and durable.
+ */
+int MakeINIFile(const char *iniFile, const ini_entry_list_t list)
+{
+    ini_output_t out;
+    int result;
+    TIMER(start)
+
+    if (NULL == list)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    START_TIMER(start);
+
+    if (NULL == iniFile)
+    {
+        result = WriteINIList(list, WriteToFile, stdout);
+
+        if ((0 == result) && (0 != fflush(stdout)))
+        {
+            result = -1;
+        }
+    }
+    else if (0 != OpenOutput(&out, iniFile, writeMode))
+    {
+        result = -1;
+    }
+    else
+    {
+        result = WriteINIList(list, WriteToFile, out.fp);
+        result = CloseOutput(&out, result);
+    }
+
+    STOP_TIMER(start, TIMER_MAKE_FILE);
+    return result;
+}
+
+
+/**
+ * \fn int WriteINIList(const ini_entry_list_t list, ini_writer_t writer,
+ *      void *user)
+ *
+ * \brief This function serializes an entry list as INI file text and
+ * passes the text to a writer function.
+ *
+ * \param list A pointer to a list of that will be used to construct
+ * (section, key, value) entries.
+ *
+ * \param writer A function that will be called with each block of text.
+ *
+ * \param user A pointer passed through to writer.
+ *
+ * \effects writer is called with blocks of text that together make the
+ * same INI file as MakeINIFile.
+ *
+ * \returns 0 for success, Non-zero on error.  If writer returns non-zero,
+ * writing stops and its return value is returned.  Otherwise the error
+ * type is contained in errno.
+ *
+ * The text is copied into a 64K buffer using the stored lengths of each
+ * string, so writer is normally called once per 64K of text.  Strings that
+ * don't fit in the buffer are passed to writer directly.
+ */
+int WriteINIList(const ini_entry_list_t list, ini_writer_t writer,
+    void *user)
+{
+    ini_serializer_t out;
+    int result;
+
+    if ((NULL == list) || (NULL == writer))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    out.data = (char *)Allocate(WRITE_BUFFER_SIZE);
+
+    if (NULL == out.data)
+    {
+        return -1;
+    }
+
+    out.size = WRITE_BUFFER_SIZE;
+    out.used = 0;
+    out.writer = writer;
+    out.user = user;
+
+    result = SerializeList(&out, list);
+
+    if (0 == result)
+    {
+        result = FlushSerializer(&out);
+    }
+
+    Release(out.data);
+    return result;
+}
+
+
+/**
+ * \fn char *MakeINIString(const ini_entry_list_t list, size_t *length)
+ *
+ * \brief This function serializes an entry list as INI file text in
+ * memory.
+ *
+ * \param list A pointer to a list of that will be used to construct
+ * (section, key, value) entries.
+ *
+ * \param length Set to the number of characters in the text, not counting
+ * the terminating '\0'.  May be NULL.
+ *
+ * \effects Memory is allocated for the text.  The caller must free it
+ * with FreeINIMemory.
+ *
+ * \returns A pointer to a NULL terminated string containing the same text
+ * that MakeINIFile would write, or NULL on error.  Error type is contained
+ * in errno.
+ *
+ * The size of the text is computed first, so it is built in a single
+ * allocation.
+ */
+char *MakeINIString(const ini_entry_list_t list, size_t *length)
+{
+    ini_serializer_t out;
+    const ini_section_t *section;
+    const ini_key_list_t *member;
+    size_t size;
+
+    if (NULL == list)
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    /* "[section]\n" ... "\n" and "key = value\n" */
+    size = 1;
+
+    for (section = list->first; NULL != section; section = section->next)
+    {
+        size += section->length + 4;
+
+        for (member = section->members; NULL != member; member = member->next)
+        {
+            size += member->keyLength + member->valueLength + 4;
+        }
+    }
+
+    out.data = (char *)Allocate(size);
+
+    if (NULL == out.data)
+    {
+        return NULL;
+    }
+
+    out.size = size;
+    out.used = 0;
+    out.writer = NULL;
+    out.user = NULL;
+
+    SerializeList(&out, list);      /* can't fail, the buffer fits */
+    out.data[out.used] = '\0';
+
+    if (NULL != length)
+    {
+        *length = out.used;
+    }
+
+    return out.data;
+}
+
+
+/**
+ * \fn int AddEntryToFile(const char *iniFile, const ini_entry_list_t list)
+ *
+ * \brief This function adds (section, key, value) entries in an entry list
+ * to an INI file.
+ *
+ * \param iniFile The name of the INI file to be modified.
+ *
+ * \param list A pointer to a list of entries to be added to the INI file.
+ *
+ * \effects
+ * The INI file is updated in place to contain the results of adding the
+ * entries in the entry list to the entries already contained in the INI
+ * file.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ *
+ * This function adds (section, key, value) entries in an entry list to an
+ * INI file.  Section order will be maintained with new sections added to the
+ * end of the INI file.  If an entry containing the same section name and key
+ * already exists, the new value will overwrite the old value.
+ *
+ * Only the affected parts of the file are changed.  Existing values are
+ * replaced where they are, new keys are added after the last key of the
+ * last occurrence of their section, and new sections are appended.  All
+ * other lines, including comments and formatting, are left byte for byte
+ * as they were.  A last line without a '\n' only gets one if text is added
+ * after it.  If the changes don't change the size of the file, only the
+ * changed bytes are written, otherwise the file is rewritten from the first
+ * change to the end.
+ */
+int AddEntryToFile(const char *iniFile, const ini_entry_list_t list)
+{
+    ini_edits_t edits;
+    ini_entry_view_t parsed;
+    ini_section_t *here;
+    ini_key_list_t *member;
+    char *data;
+    size_t size;
+    size_t offset;
+    size_t length;
+    size_t next;
+    size_t *insertAt;       /* where to add keys, by section slot */
+    char *found;            /* non-zero if key is in file, by key slot */
+    const char *line;
+    const char *eol;
+    const char *equals;
+    int unterminated;
+    int pass;
+    int type;
+    int result;
+    TIMER(start)
+
+    if (NULL == iniFile)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (NULL == list)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    START_TIMER(start);
+
+    if (0 != LoadFile(iniFile, &data, &size))
+    {
+        STOP_TIMER(start, TIMER_ADD_TO_FILE);
+        return -1;
+    }
+
+    /* per section and per key bookkeeping, indexed by hash index slot */
+    insertAt = (size_t *)Allocate((list->sections.size + 1) *
+        sizeof(size_t));
+    found = (char *)AllocateZeroed(list->keys.size + 1, sizeof(char));
+
+    if ((NULL == insertAt) || (NULL == found))
+    {
+        Release(insertAt);
+        Release(found);
+        Release(data);
+        STOP_TIMER(start, TIMER_ADD_TO_FILE);
+        return -1;
+    }
+
+    InitEdits(&edits);
+
+    for (offset = 0; offset < list->sections.size; offset++)
+    {
+        insertAt[offset] = (size_t)-1;      /* not in the file */
+    }
+
+    /* find the existing keys and sections */
+    here = NULL;
+    result = 0;
+
+    for (offset = 0; offset < size; offset = next)
+    {
+        line = data + offset;
+        eol = SplitLine(line, data + size, &equals);
+        length = eol - line;
+        next = offset + length + ((eol < data + size) ? 1 : 0);
+        type = ParseLineAt(line, length, equals, &parsed);
+
+        if (type < 0)
+        {
+            result = -1;
+            break;
+        }
+        else if (LINE_SECTION == type)
+        {
+            here = FindSection(list, &parsed.section,
+                HashView(&parsed.section, HASH_SEED));
+
+            if (NULL != here)
+            {
+                /* new keys go after the header until keys are found */
+                insertAt[SlotOf(&(list->sections), here, here->hash)] = next;
+            }
+        }
+        else if ((LINE_ENTRY == type) && (NULL != here))
+        {
+            insertAt[SlotOf(&(list->sections), here, here->hash)] = next;
+            member = FindKey(&(list->keys), here, &parsed.key,
+                HashView(&parsed.key, here->hash));
+
+            if (NULL != member)
+            {
+                /* replace the value where it is */
+                found[SlotOf(&(list->keys), member, member->hash)] = 1;
+                result = AddEdit(&edits, parsed.value.str - data,
+                    parsed.value.length, member->value, member->valueLength);
+
+                if (0 != result)
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    /* an unterminated last line gets a '\n' only if text follows it */
+    unterminated = (size > 0) && (data[size - 1] != '\n');
+
+    /* add missing keys to existing sections, then add the new sections */
+    for (pass = 0; (0 == result) && (pass < 2); pass++)
+    {
+        for (here = list->first; (0 == result) && (NULL != here);
+            here = here->next)
+        {
+            size_t at;
+
+            at = insertAt[SlotOf(&(list->sections), here, here->hash)];
+
+            if (((size_t)-1 == at) != (1 == pass))
+            {
+                continue;       /* not handled by this pass */
+            }
+
+            for (member = here->members; NULL != member;
+                member = member->next)
+            {
+                if (!found[SlotOf(&(list->keys), member, member->hash)])
+                {
+                    break;
+                }
+            }
+
+            if (NULL == member)
+            {
+                continue;       /* only replaced values, nothing to add */
+            }
+
+            if ((size_t)-1 == at)
+            {
+                /* new section goes at the end of the file */
+                result = AddEdit(&edits, size, 0, NULL, 0);
+
+                if ((0 == result) && unterminated)
+                {
+                    result = AppendEditText(&edits, "\n", 1);
+                    unterminated = 0;
+                }
+
+                if (0 == result)
+                {
+                    result = AppendEditText(&edits, "[", 1);
+                }
+
+                if (0 == result)
+                {
+                    result = AppendEditText(&edits, here->section,
+                        here->length);
+                }
+
+                if (0 == result)
+                {
+                    result = AppendEditText(&edits, "]\n", 2);
+                }
+            }
+            else
+            {
+                result = AddEdit(&edits, at, 0, NULL, 0);
+
+                if ((0 == result) && unterminated && (at == size))
+                {
+                    result = AppendEditText(&edits, "\n", 1);
+                    unterminated = 0;
+                }
+            }
+
+            for (member = here->members; (0 == result) && (NULL != member);
+                member = member->next)
+            {
+                if (found[SlotOf(&(list->keys), member, member->hash)])
+                {
+                    continue;
+                }
+
+                result = AppendEditText(&edits, member->key,
+                    member->keyLength);
+
+                if (0 == result)
+                {
+                    result = AppendEditText(&edits, " = ", 3);
+                }
+
+                if (0 == result)
+                {
+                    result = AppendEditText(&edits, member->value,
+                        member->valueLength);
+                }
+
+                if (0 == result)
+                {
+                    result = AppendEditText(&edits, "\n", 1);
+                }
+            }
+
+            if ((0 == result) && ((size_t)-1 == at))
+            {
+                /* blank line after the section, like MakeINIFile */
+                result = AppendEditText(&edits, "\n", 1);
+            }
+        }
+    }
+
+    if (0 == result)
+    {
+        result = ApplyEdits(iniFile, data, size, &edits);
+    }
+
+    Release(insertAt);
+    Release(found);
+    FreeEdits(&edits);
+    Release(data);
+    STOP_TIMER(start, TIMER_ADD_TO_FILE);
+    return result;
+}
+
+/**
+ * \fn int DeleteEntryFromFile(const char *iniFile, const char *section,
+ * const char *key)
+ *
+ * \brief This function deletes all entries from an INI file that match the
+ * section and key passed as an argument.
+ *
+ * \param iniFile The name of the INI file containing the entry to be
+ * deleted.
+ *
+ * \param section A pointer to a NULL terminated string containing the name
+ * of the section of the entry to be deleted.
+ *
+ * \param key A pointer to a NULL terminated string containing the name of
+ * the key of the entry to be deleted.
+ *
+ * \effects
+ * The INI file will be re-written without any entries that match
+ * the section and key to be deleted.  Empty sections will not be deleted.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ *
+ * This function deletes all entries from an INI file that match the section
+ * and key passed as an argument.  Empty sections will not be deleted.
+ *
+ * \note There will never be more than one matching entry in INI files
+ * created by this library.
+ */
+int DeleteEntryFromFile(const char *iniFile, const char *section,
+    const char *key)
+{
+    ini_entry_list_t pairs;
+    int result;
+    TIMER(start)
+
+    if (NULL == iniFile)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (NULL == section)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (NULL == key)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    START_TIMER(start);
+    pairs = NULL;
+
+    if (0 != AddEntryToList(&pairs, section, key, ""))
+    {
+        STOP_TIMER(start, TIMER_DELETE);
+        return -1;
+    }
+
+    result = DeleteEntriesFromFile(iniFile, pairs, NULL, NULL, NULL);
+    FreeList(pairs);
+
+    STOP_TIMER(start, TIMER_DELETE);
+    return result;
+}
+
+/**
+ * \fn int DeleteEntriesFromFile(const char *iniFile,
+ *      const ini_entry_list_t pairs, const char *const *sections,
+ *      ini_filter_t filter, void *user)
+ *
+ * \brief This function removes a batch of entries and/or whole sections
+ * from an INI file in a single pass.
+ *
+ * \param iniFile The name of the INI file to be modified.
+ *
+ * \param pairs A list of the (section, key) pairs to be removed.  Values
+ * are ignored.  May be NULL.
+ *
+ * \param sections A NULL terminated array of the names of sections to be
+ * removed with all of their entries.  May be NULL.
+ *
+ * \param filter A function called with each remaining entry.  The entry is
+ * removed if it returns non-zero.  May be NULL.
+ *
+ * \param user A pointer passed through to filter.
+ *
+ * \effects
+ * The lines of the matching entries are removed from the INI file.  Removed
+ * sections lose their header and every line up to the next section.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ *
+ * The file is read once and each entry is looked up in hash indices of
+ * pairs and sections, so the time taken is linear in the size of the file
+ * no matter how many entries are removed.  Only the removed lines are
+ * changed; comments, formatting, and the headers of sections that are left
+ * empty are preserved.  The file is rewritten from the first removed line.
+ */
+int DeleteEntriesFromFile(const char *iniFile, const ini_entry_list_t pairs,
+    const char *const *sections, ini_filter_t filter, void *user)
+{
+    ini_edits_t edits;
+    ini_entry_view_t parsed;
+    ini_entry_list_t whole;     /* sections to be deleted */
+    const ini_section_t *here;
+    ini_view_t view;
+    ini_edit_t *last;
+    char *data;
+    size_t size;
+    size_t offset;
+    size_t length;
+    size_t next;
+    const char *line;
+    const char *eol;
+    const char *equals;
+    int inWhole;                /* non-zero while in a deleted section */
+    int drop;
+    int type;
+    int result;
+
+    if (NULL == iniFile)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* index the names of sections being deleted */
+    whole = NULL;
+
+    if (NULL != sections)
+    {
+        const char *const *name;
+
+        if (0 != NewArenaList(&whole))
+        {
+            return -1;
+        }
+
+        view.str = "";
+        view.length = 0;
+
+        for (name = sections; NULL != *name; name++)
+        {
+            ini_view_t section;
+
+            section.str = *name;
+            section.length = strlen(*name);
+
+            if (0 != AddViewToList(&whole, &section, &view, &view))
+            {
+                FreeList(whole);
+                return -1;
+            }
+        }
+    }
+
+    if (0 != LoadFile(iniFile, &data, &size))
+    {
+        FreeList(whole);
+        return -1;
+    }
+
+    InitEdits(&edits);
+    here = NULL;
+    inWhole = 0;
+    parsed.section.str = NULL;
+    parsed.section.length = 0;
+    result = 0;
+
+    for (offset = 0; offset < size; offset = next)
+    {
+        line = data + offset;
+        eol = SplitLine(line, data + size, &equals);
+        length = eol - line;
+        next = offset + length + ((eol < data + size) ? 1 : 0);
+        view = parsed.section;      /* ParseLine only sets it for headers */
+        type = ParseLineAt(line, length, equals, &parsed);
+
+        if (type < 0)
+        {
+            result = -1;
+            break;
+        }
+
+        if (LINE_SECTION == type)
+        {
+            unsigned long hash;
+
+            hash = HashView(&parsed.section, HASH_SEED);
+            here = (NULL == pairs) ? NULL :
+                FindSection(pairs, &parsed.section, hash);
+            inWhole = (NULL != whole) &&
+                (NULL != FindSection(whole, &parsed.section, hash));
+            drop = inWhole;
+        }
+        else if (LINE_ENTRY == type)
+        {
+            parsed.section = view;
+            drop = inWhole;
+
+            if ((!drop) && (NULL != here))
+            {
+                drop = (NULL != FindKey(&(pairs->keys), here, &parsed.key,
+                    HashView(&parsed.key, here->hash)));
+            }
+
+            if ((!drop) && (NULL != filter))
+            {
+                drop = filter(&parsed, user);
+            }
+        }
+        else
+        {
+            parsed.section = view;
+            drop = inWhole;   /* comments in a deleted section go too */
+        }
+
+        if (!drop)
+        {
+            continue;
+        }
+
+        /* join removals of consecutive lines into a single edit */
+        last = (0 == edits.count) ? NULL : &(edits.edits[edits.count - 1]);
+
+        if ((NULL != last) && (last->offset + last->length == offset))
+        {
+            last->length += next - offset;
+        }
+        else if (0 != AddEdit(&edits, offset, next - offset, NULL, 0))
+        {
+            result = -1;
+            break;
+        }
+    }
+
+    if (0 == result)
+    {
+        result = ApplyEdits(iniFile, data, size, &edits);
+    }
+
+    FreeEdits(&edits);
+    Release(data);
+    FreeList(whole);
+    return result;
+}
+
+/**
+ * \fn int GetEntryFromFile(FILE *iniFile, ini_entry_t *entry)
+ *
+ * \brief This function parses an INI file stream passed as an input,
+ * searching for the next (section, key, value) triple.
+ *
+ * \param iniFile A pointer to the INI file to be parsed.  It must be
+ * opened for reading.
+ *
+ * \param entry A pointer to the entry structure used to store the discovered
+ * (section, key, value) triple.
+ *
+ * \effects
+ * The specified file is read until it discovers an entry.
+ *
+ * \returns 1 when an entry is found\n
+ *          0 when no more entries can be found\n
+ *         -1 for an error.  Error type is contained in errno.
+ *
+ * This function parses an INI file stream passed as an input, searching for
+ * the next (section, key, value) triple.  The resulting triple will be used
+ * to populate the entry structure passed as a parameter.
+ *
+ * Lines are parsed by ParseLine, so files are interpreted the same way here
+ * and by GetEntryFromBuffer.
+ *
+ * The file is read a line at a time so that the caller may use it between
+ * calls, and the entry's key and value are allocated for every entry.  A
+ * line buffer is kept from one call to the next and freed at the end of
+ * the file.  Use a reader (NewReader and GetEntryFromReader or
+ * ReadEntryFromReader) to read many entries in large blocks, or
+ * ReadEntryFromFile to read them without allocating for each entry.
+ */
+int GetEntryFromFile(FILE *iniFile, ini_entry_t *entry)
+{
+    ini_reader_t reader;
+    int result;
+    TIMER(start)
+
+    if (NULL == iniFile)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (NULL == entry)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    START_TIMER(start);
+
+    /* read a line at a time, the caller may be using iniFile for more */
+    if (0 != TakeSpareLine(&reader, iniFile))
+    {
+        STOP_TIMER(start, TIMER_GET_ENTRY);
+        return -1;
+    }
+
+    result = GetEntry(&reader, entry);
+    KeepSpareLine(&reader, result <= 0);
+    STOP_TIMER(start, TIMER_GET_ENTRY);
+    return result;
+}
+
+
+/**
+ * \fn ini_reader_t *NewReader(FILE *iniFile)
+ *
+ * \brief This function creates a reader for quickly reading a sequence of
+ * entries from an INI file stream.
+ *
+ * \param iniFile A pointer to the INI file to be parsed.  It must be
+ * opened for reading.
+ *
+ * \effects
+ * Memory is allocated for the reader and its buffer.
+ *
+ * \returns A pointer to the new reader.  NULL is returned on error, and the
+ * error type is contained in errno.
+ *
+ * A reader reads the INI file in large blocks and keeps its buffer between
+ * calls to GetEntryFromReader.  Because it reads ahead, iniFile shouldn't
+ * be read by anything else while the reader is in use.  Call FreeReader
+ * when done.
+ */
+ini_reader_t *NewReader(FILE *iniFile)
+{
+    ini_reader_t *reader;
+
+    if (NULL == iniFile)
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    reader = (ini_reader_t *)Allocate(sizeof(ini_reader_t));
+
+    if (NULL == reader)
+    {
+        return NULL;
+    }
+
+    if (0 != InitReader(reader, iniFile, 1))
+    {
+        Release(reader);
+        return NULL;
+    }
+
+    return reader;
+}
+
+
+/**
+ * \fn int GetEntryFromReader(ini_reader_t *reader, ini_entry_t *entry)
+ *
+ * \brief This function searches an INI file stream for the next
+ * (section, key, value) triple using a reader created by NewReader.
+ *
+ * \param reader A pointer to the reader for the INI file being parsed.
+ *
+ * \param entry A pointer to the entry structure used to store the discovered
+ * (section, key, value) triple.
+ *
+ * \effects
+ * The file is read until it discovers an entry.
+ *
+ * \returns 1 when an entry is found\n
+ *          0 when no more entries can be found\n
+ *         -1 for an error.  Error type is contained in errno.
+ *
+ * This function behaves exactly like GetEntryFromFile, but reads the file
+ * in large blocks through the reader's buffer.
+ */
+int GetEntryFromReader(ini_reader_t *reader, ini_entry_t *entry)
+{
+    if ((NULL == reader) || (NULL == entry))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    return GetEntry(reader, entry);
+}
+
+
+/**
+ * \fn void FreeReader(ini_reader_t *reader)
+ *
+ * \brief This function frees a reader created by NewReader.
+ *
+ * \param reader A pointer to the reader being freed.
+ *
+ * \effects The memory allocated for the reader is freed.  The file that it
+ * was reading is not closed.
+ *
+ * \returns Nothing
+ */
+void FreeReader(ini_reader_t *reader)
+{
+    if (NULL == reader)
+    {
+        return;
+    }
+
+    Release(reader->buffer);
+    Release(reader);
+}
+
+
+/**
+ * \fn void InitEntryBuffer(ini_entry_buffer_t *buffer)
+ *
+ * \brief This function initializes an entry buffer so that it is empty.
+ *
+ * \param buffer A pointer to the entry buffer being initialized.
+ *
+ * \effects All of the buffer's strings are set to NULL.  Nothing is
+ * allocated.
+ *
+ * \returns Nothing
+ */
+void InitEntryBuffer(ini_entry_buffer_t *buffer)
+{
+    memset(buffer, 0, sizeof(ini_entry_buffer_t));
+    buffer->entry.section = NULL;
+    buffer->entry.key = NULL;
+    buffer->entry.value = NULL;
+    buffer->section = NULL;
+    buffer->line = NULL;
+}
+
+
+/**
+ * \fn int ReadEntryFromFile(FILE *iniFile, ini_entry_buffer_t *buffer)
+ *
+ * \brief This function searches an INI file stream for the next
+ * (section, key, value) triple and copies it into an entry buffer.
+ *
+ * \param iniFile A pointer to the INI file to be parsed.  It must be
+ * opened for reading.
+ *
+ * \param buffer A pointer to an entry buffer initialized by
+ * InitEntryBuffer.
+ *
+ * \effects
+ * The specified file is read until it discovers an entry.  The buffer's
+ * memory grows to fit the longest line, section, key, and value read.
+ *
+ * \returns 1 when an entry is found\n
+ *          0 when no more entries can be found\n
+ *         -1 for an error.  Error type is contained in errno.
+ *
+ * This function behaves like GetEntryFromFile, except that the entry's
+ * strings are copied into memory owned by the buffer instead of newly
+ * allocated memory, and the buffer keeps its memory at the end of the file
+ * so that it may be used to read another file.  Once the buffer's memory
+ * is big enough, reading an entry doesn't allocate anything.
+ *
+ * As with GetEntryFromFile, the file isn't read past the end of the
+ * entry's line.  Use ReadEntryFromReader to read files in large blocks.
+ * Call FreeEntryBuffer when done.
+ */
+int ReadEntryFromFile(FILE *iniFile, ini_entry_buffer_t *buffer)
+{
+    ini_reader_t reader;
+    int result;
+
+    if ((NULL == iniFile) || (NULL == buffer))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (0 != GrowBuffer(&(buffer->line), &(buffer->lineSize),
+        MIN_LINE_SIZE))
+    {
+        return -1;
+    }
+
+    /* read a line at a time through the buffer's line memory */
+    AttachReader(&reader, iniFile, 0, buffer->line, buffer->lineSize);
+    result = GetEntryInto(&reader, buffer);
+    buffer->line = reader.buffer;       /* may have grown */
+    buffer->lineSize = reader.size;
+    return result;
+}
+
+
+/**
+ * \fn int ReadEntryFromReader(ini_reader_t *reader,
+ *      ini_entry_buffer_t *buffer)
+ *
+ * \brief This function searches an INI file stream for the next
+ * (section, key, value) triple using a reader created by NewReader, and
+ * copies it into an entry buffer.
+ *
+ * \param reader A pointer to the reader for the INI file being parsed.
+ *
+ * \param buffer A pointer to an entry buffer initialized by
+ * InitEntryBuffer.
+ *
+ * \effects
+ * The file is read until it discovers an entry.  The buffer's memory grows
+ * to fit the longest section, key, and value read.
+ *
+ * \returns 1 when an entry is found\n
+ *          0 when no more entries can be found\n
+ *         -1 for an error.  Error type is contained in errno.
+ *
+ * This function behaves like ReadEntryFromFile, but reads the file in
+ * large blocks through the reader's buffer.
+ */
+int ReadEntryFromReader(ini_reader_t *reader, ini_entry_buffer_t *buffer)
+{
+    if ((NULL == reader) || (NULL == buffer))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    return GetEntryInto(reader, buffer);
+}
+
+
+/**
+ * \fn void FreeEntryBuffer(ini_entry_buffer_t *buffer)
+ *
+ * \brief This function frees the memory held by an entry buffer.
+ *
+ * \param buffer A pointer to the entry buffer being freed.
+ *
+ * \effects
+ * The buffer's memory is freed and it is left empty, as if it had just
+ * been initialized by InitEntryBuffer.
+ *
+ * \returns Nothing
+ */
+void FreeEntryBuffer(ini_entry_buffer_t *buffer)
+{
+    if (NULL == buffer)
+    {
+        return;
+    }
+
+    Release(buffer->section);
+    Release(buffer->entry.key);
+    Release(buffer->entry.value);
+    Release(buffer->line);
+    InitEntryBuffer(buffer);
+}
+
+
+/**
+ * \fn int OpenINIBuffer(const char *iniFile, ini_buffer_t *buffer)
+ *
+ * \brief This function maps an INI file into memory so that it may be
+ * parsed with GetEntryFromBuffer.
+ *
+ * \param iniFile The name of the INI file to be mapped.
+ *
+ * \param buffer A pointer to the buffer structure that will be used to
+ * parse the file.
+ *
+ * \effects
+ * The file is memory mapped (read into memory on systems without mmap) and
+ * buffer is initialized to parse it from the beginning.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ *
+ * This function maps an INI file into memory so that it may be parsed with
+ * GetEntryFromBuffer.  Call CloseINIBuffer when done with the buffer.  The
+ * views returned by GetEntryFromBuffer point into the mapping and are only
+ * valid until the buffer is closed.
+ */
+int OpenINIBuffer(const char *iniFile, ini_buffer_t *buffer)
+{
+#ifdef EZINI_POSIX
+    struct stat status;
+    int fd;
+    void *map;
+#else
+    char *data;
+    size_t size;
+#endif
+
+    if ((NULL == iniFile) || (NULL == buffer))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+#ifdef EZINI_POSIX
+    fd = open(iniFile, O_RDONLY);
+
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    if (0 != fstat(fd, &status))
+    {
+        close(fd);
+        return -1;
+    }
+
+    if (0 == status.st_size)
+    {
+        /* nothing to map */
+        close(fd);
+        InitINIBuffer(buffer, "", 0);
+        return 0;
+    }
+
+    map = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (MAP_FAILED == map)
+    {
+        return -1;
+    }
+
+    InitINIBuffer(buffer, (const char *)map, (size_t)status.st_size);
+    buffer->map = map;
+    buffer->mapSize = (size_t)status.st_size;
+#else
+    /* no mmap, read the whole file into memory instead */
+    if (0 != LoadFile(iniFile, &data, &size))
+    {
+        return -1;
+    }
+
+    InitINIBuffer(buffer, data, size);
+    buffer->map = data;
+    buffer->mapSize = size;
+#endif
+
+    return 0;
+}
+
+
+/**
+ * \fn void InitINIBuffer(ini_buffer_t *buffer, const char *data,
+ * size_t size)
+ *
+ * \brief This function prepares a caller supplied buffer containing INI
+ * file text to be parsed with GetEntryFromBuffer.
+ *
+ * \param buffer A pointer to the buffer structure that will be used to
+ * parse the data.
+ *
+ * \param data A pointer to the INI file text.  It does not need to be NULL
+ * terminated.
+ *
+ * \param size The number of characters in data.
+ *
+ * \effects buffer is initialized to parse data from the beginning.
+ *
+ * \returns Nothing
+ *
+ * The data is not copied, it must remain valid for as long as the buffer and
+ * any views returned by GetEntryFromBuffer are in use.  CloseINIBuffer does
+ * not need to be called for caller supplied data.
+ */
+void InitINIBuffer(ini_buffer_t *buffer, const char *data, size_t size)
+{
+    buffer->data = data;
+    buffer->size = size;
+    buffer->offset = 0;
+    buffer->section.str = NULL;
+    buffer->section.length = 0;
+    buffer->map = NULL;
+    buffer->mapSize = 0;
+}
+
+
+/**
+ * \fn int GetEntryFromBuffer(ini_buffer_t *buffer, ini_entry_view_t *entry)
+ *
+ * \brief This function parses INI file text in memory, searching for the
+ * next (section, key, value) triple.
+ *
+ * \param buffer A pointer to a buffer structure initialized by
+ * OpenINIBuffer or InitINIBuffer.
+ *
+ * \param entry A pointer to the entry view structure used to store the
+ * discovered (section, key, value) triple.
+ *
+ * \effects
+ * The buffer is parsed until it discovers an entry.  Nothing is allocated
+ * or copied; the views in entry point into the buffer's data.
+ *
+ * \returns 1 when an entry is found\n
+ *          0 when no more entries can be found\n
+ *         -1 for an error.  Error type is contained in errno.
+ *
+ * This function follows the same comment, white space, and section rules as
+ * GetEntryFromFile.  Entries that precede the first section have a section
+ * view with a NULL str.
+ */
+int GetEntryFromBuffer(ini_buffer_t *buffer, ini_entry_view_t *entry)
+{
+    const char *line;
+    const char *end;
+    const char *eol;
+    const char *equals;
+    size_t length;
+    int type;
+
+    if ((NULL == buffer) || (NULL == entry))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    end = buffer->data + buffer->size;
+
+    while (buffer->offset < buffer->size)
+    {
+        /* find the end of the next line and its '=' in one pass */
+        line = buffer->data + buffer->offset;
+        eol = SplitLine(line, end, &equals);
+        length = eol - line;
+        buffer->offset += length + ((eol < end) ? 1 : 0);
+
+        type = ParseLineAt(line, length, equals, entry);
+
+        if (type < 0)
+        {
+            return -1;
+        }
+        else if (LINE_SECTION == type)
+        {
+            buffer->section = entry->section;
+        }
+        else if (LINE_ENTRY == type)
+        {
+            entry->section = buffer->section;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+/**
+ * \fn int SetScanKernel(int kernel)
+ *
+ * \brief This function chooses the kernel used to scan INI file text for
+ * line ends and other structural characters.
+ *
+ * \param kernel INI_SCAN_AUTO, INI_SCAN_SCALAR, INI_SCAN_SSE2, or
+ * INI_SCAN_AVX2.
+ *
+ * \effects All future parsing uses the chosen kernel.
+ *
+ * \returns 0 for success, Non-zero if the kernel isn't supported by this
+ * build or CPU.  errno is set to EINVAL.
+ *
+ * INI_SCAN_AUTO, the default, uses the fastest kernel the CPU supports.
+ * The kernel is shared by all threads; it should only be changed when
+ * nothing is being parsed.  This is mostly useful for benchmarks and
+ * testing, all kernels return the same results.
+ */
+int SetScanKernel(int kernel)
+{
+#ifdef EZINI_X86_SIMD
+    __builtin_cpu_init();
+
+    if (INI_SCAN_AUTO == kernel)
+    {
+        if (__builtin_cpu_supports("avx2"))
+        {
+            kernel = INI_SCAN_AVX2;
+        }
+        else if (__builtin_cpu_supports("sse2"))
+        {
+            kernel = INI_SCAN_SSE2;
+        }
+    }
+
+    if ((INI_SCAN_AVX2 == kernel) && __builtin_cpu_supports("avx2"))
+    {
+        scanKernel = ScanAVX2;
+        splitKernel = SplitAVX2;
+        scanKernelId = kernel;
+        return 0;
+    }
+
+    if ((INI_SCAN_SSE2 == kernel) && __builtin_cpu_supports("sse2"))
+    {
+        scanKernel = ScanSSE2;
+        splitKernel = SplitSSE2;
+        scanKernelId = kernel;
+        return 0;
+    }
+#endif
+
+    if ((INI_SCAN_AUTO == kernel) || (INI_SCAN_SCALAR == kernel))
+    {
+        scanKernel = ScanScalar;
+        splitKernel = SplitScalar;
+        scanKernelId = INI_SCAN_SCALAR;
+        return 0;
+    }
+
+    errno = EINVAL;
+    return -1;
+}
+
+
+/**
+ * \fn int GetScanKernel(void)
+ *
+ * \brief This function returns the kernel used to scan INI file text.
+ *
+ * \effects If no kernel has been chosen yet, the best one for the CPU is.
+ *
+ * \returns INI_SCAN_SCALAR, INI_SCAN_SSE2, or INI_SCAN_AVX2.
+ */
+int GetScanKernel(void)
+{
+    if (INI_SCAN_AUTO == scanKernelId)
+    {
+        SetScanKernel(INI_SCAN_AUTO);
+    }
+
+    return scanKernelId;
+}
+
+
+/**
+ * \fn ini_parser_t *NewParser(ini_callback_t callback, void *user)
+ *
+ * \brief This function creates a push parser that is fed INI file text in
+ * chunks of any size and passes each entry it finds to a callback.
+ *
+ * \param callback The function called with each entry.
+ *
+ * \param user A pointer passed through to callback.
+ *
+ * \effects Memory is allocated for the parser.
+ *
+ * \returns A pointer to the new parser, or NULL on error.  Error type is
+ * contained in errno.
+ *
+ * Feed text to the parser with FeedParser as it arrives, then call
+ * FinishParser at the end of the text.  The parser never reads on its
+ * own, so it may be driven by an event loop.  Call FreeParser when done.
+ */
+ini_parser_t *NewParser(ini_callback_t callback, void *user)
+{
+    ini_parser_t *parser;
+
+    if (NULL == callback)
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    parser = (ini_parser_t *)Allocate(sizeof(ini_parser_t));
+
+    if (NULL == parser)
+    {
+        return NULL;
+    }
+
+    parser->callback = callback;
+    parser->user = user;
+    parser->partial = NULL;
+    parser->length = 0;
+    parser->size = 0;
+    parser->section = NULL;
+    parser->sectionLength = 0;
+    parser->sectionSize = 0;
+    parser->inSection = 0;
+    parser->stopped = 0;
+    return parser;
+}
+
+
+/**
+ * \fn int FeedParser(ini_parser_t *parser, const char *data, size_t length)
+ *
+ * \brief This function passes the next chunk of INI file text to a push
+ * parser.
+ *
+ * \param parser A pointer to the parser being fed.
+ *
+ * \param data A pointer to the text.  It does not need to be NULL
+ * terminated, and lines may be split across chunks anywhere.
+ *
+ * \param length The number of characters in data.
+ *
+ * \effects
+ * The callback is called with each entry completed by data.  A line that
+ * is incomplete at the end of data is saved until the next feed.
+ *
+ * \returns 0 for success\n
+ *         -1 for an error.  Error type is contained in errno.\n
+ *          Otherwise the value returned by the callback to stop parsing.
+ *
+ * The views passed to the callback are only valid during the callback.
+ * Complete lines are parsed where they are in data; only the partial line
+ * at the end of a chunk is copied.  Once parsing has stopped because of an
+ * error or the callback, feeds are ignored and return the same value.
+ */
+int FeedParser(ini_parser_t *parser, const char *data, size_t length)
+{
+    const char *eol;
+    const char *equals;
+    size_t used;
+
+    if ((NULL == parser) || ((NULL == data) && (0 != length)))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (0 != parser->stopped)
+    {
+        return parser->stopped;
+    }
+
+    if (0 != parser->length)
+    {
+        /* complete the saved partial line */
+        eol = (const char *)memchr(data, '\n', length);
+        used = (NULL == eol) ? length : (size_t)(eol - data);
+
+        if (0 != GrowBuffer(&(parser->partial), &(parser->size),
+            parser->length + used))
+        {
+            parser->stopped = -1;
+            return -1;
+        }
+
+        memcpy(parser->partial + parser->length, data, used);
+        parser->length += used;
+
+        if (NULL == eol)
+        {
+            return 0;
+        }
+
+        used = parser->length;
+        parser->length = 0;
+
+        if (0 != ParseFedLine(parser, parser->partial, used, NULL))
+        {
+            return parser->stopped;
+        }
+
+        used = eol - data;
+
+        data += used + 1;
+        length -= used + 1;
+    }
+
+    /* parse complete lines in place */
+    while ((eol = SplitLine(data, data + length, &equals)) < data + length)
+    {
+        used = eol - data;
+
+        if (0 != ParseFedLine(parser, data, used, equals))
+        {
+            return parser->stopped;
+        }
+
+        data += used + 1;
+        length -= used + 1;
+    }
+
+    /* save what's left for the next feed */
+    if (0 != length)
+    {
+        if (0 != GrowBuffer(&(parser->partial), &(parser->size), length))
+        {
+            parser->stopped = -1;
+            return -1;
+        }
+
+        memcpy(parser->partial, data, length);
+        parser->length = length;
+    }
+
+    return 0;
+}
+
+
+/**
+ * \fn int FinishParser(ini_parser_t *parser)
+ *
+ * \brief This function tells a push parser that the end of the text has
+ * been reached.
+ *
+ * \param parser A pointer to the parser being finished.
+ *
+ * \effects
+ * A final line without a trailing '\n' is parsed.  The parser is then
+ * reset, so it may be used to parse another text.
+ *
+ * \returns 0 for success\n
+ *         -1 for an error.  Error type is contained in errno.\n
+ *          Otherwise the value returned by the callback to stop parsing.
+ */
+int FinishParser(ini_parser_t *parser)
+{
+    int result;
+
+    if (NULL == parser)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if ((0 == parser->stopped) && (0 != parser->length))
+    {
+        ParseFedLine(parser, parser->partial, parser->length, NULL);
+    }
+
+    result = parser->stopped;
+
+    /* ready for another text */
+    parser->length = 0;
+    parser->inSection = 0;
+    parser->stopped = 0;
+    return result;
+}
+
+
+/**
+ * \fn void FreeParser(ini_parser_t *parser)
+ *
+ * \brief This function frees a push parser created by NewParser.
+ *
+ * \param parser A pointer to the parser being freed.  May be NULL.
+ *
+ * \effects All memory allocated for the parser is freed.
+ *
+ * \returns Nothing
+ */
+void FreeParser(ini_parser_t *parser)
+{
+    if (NULL == parser)
+    {
+        return;
+    }
+
+    Release(parser->partial);
+    Release(parser->section);
+    Release(parser);
+}
+
+
+/**
+ * \fn int ParseINIFile(const char *iniFile, const ini_handler_t *handler)
+ *
+ * \brief This function parses an INI file, calling handler functions with
+ * each section name and entry instead of returning entries.
+ *
+ * \param iniFile The name of the INI file to be parsed.
+ *
+ * \param handler A pointer to the functions to be called, and the user
+ * pointer passed to them.
+ *
+ * \effects
+ * The file is memory mapped and parsed by ParseINIBuffer.
+ *
+ * \returns 0 for success\n
+ *         -1 for an error.  Error type is contained in errno.\n
+ *          Otherwise the value returned by a handler function to stop
+ *          parsing.
+ *
+ * Nothing is allocated for the entries.  The names and values passed to
+ * the handler point into the mapping and are only valid during the call.
+ */
+int ParseINIFile(const char *iniFile, const ini_handler_t *handler)
+{
+    ini_buffer_t buffer;
+    int result;
+
+    if ((NULL == iniFile) || (NULL == handler))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (0 != OpenINIBuffer(iniFile, &buffer))
+    {
+        return -1;
+    }
+
+    result = ParseINIBuffer(buffer.data, buffer.size, handler);
+    CloseINIBuffer(&buffer);
+    return result;
+}
+
+
+/**
+ * \fn int ParseINIBuffer(const char *data, size_t size,
+ * const ini_handler_t *handler)
+ *
+ * \brief This function parses INI file text in memory, calling handler
+ * functions with each section name and entry.
+ *
+ * \param data A pointer to the INI file text.  It does not need to be NULL
+ * terminated.
+ *
+ * \param size The number of characters in data.
+ *
+ * \param handler A pointer to the functions to be called, and the user
+ * pointer passed to them.
+ *
+ * \effects
+ * handler->onSection is called with the name of each section line and
+ * handler->onEntry is called with the key and value of each entry, in the
+ * order they appear in the text.
+ *
+ * \returns 0 for success\n
+ *         -1 for an error.  Error type is contained in errno.\n
+ *          Otherwise the value returned by a handler function to stop
+ *          parsing.
+ *
+ * Names and values are passed as (pointer, length) views into data, with
+ * white space trimmed as GetEntryFromBuffer trims it.  Entries preceding
+ * the first section line are passed without a call to onSection.  Parsing
+ * stops at the first malformed line (errno is EILSEQ), after the entries
+ * before it have been passed to the handler.
+ */
+int ParseINIBuffer(const char *data, size_t size,
+    const ini_handler_t *handler)
+{
+    const char *line;
+    const char *end;
+    const char *eol;
+    const char *equals;
+    int result;
+
+    if (((NULL == data) && (0 != size)) || (NULL == handler))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    line = data;
+    end = data + size;
+    result = 0;
+
+    while ((line < end) && (0 == result))
+    {
+        /* find the end of the next line and its '=' in one pass */
+        eol = SplitLine(line, end, &equals);
+        result = HandleLine(handler, line, eol - line, equals);
+        line = eol + ((eol < end) ? 1 : 0);
+    }
+
+    return result;
+}
+
+
+/**
+ * \fn int ParseINIStream(FILE *iniFile, const ini_handler_t *handler)
+ *
+ * \brief This function reads an open INI file, calling handler functions
+ * with each section name and entry.
+ *
+ * \param iniFile A pointer to the INI file to be read.  It must be open for
+ * reading.
+ *
+ * \param handler A pointer to the functions to be called, and the user
+ * pointer passed to them.
+ *
+ * \effects
+ * The file is read from its current position to the end in large blocks,
+ * and the handler is called as described for ParseINIBuffer.
+ *
+ * \returns 0 for success\n
+ *         -1 for an error.  Error type is contained in errno.\n
+ *          Otherwise the value returned by a handler function to stop
+ *          parsing.
+ *
+ * Only the block buffer is allocated, lines are parsed where they were
+ * read.  The file is read ahead of the line being parsed, so if parsing
+ * stops early the file position is past the line that stopped it.
+ */
+int ParseINIStream(FILE *iniFile, const ini_handler_t *handler)
+{
+    ini_reader_t reader;
+    const char *line;
+    size_t length;
+    int result;
+
+    if ((NULL == iniFile) || (NULL == handler))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (0 != InitReader(&reader, iniFile, 1))
+    {
+        return -1;
+    }
+
+    while ((result = ReadLine(&reader, &line, &length)) > 0)
+    {
+        result = HandleLine(handler, line, length, NULL);
+
+        if (0 != result)
+        {
+            break;
+        }
+    }
+
+    Release(reader.buffer);
+    return result;
+}
+
+
+/**
+ * \fn void CloseINIBuffer(ini_buffer_t *buffer)
+ *
+ * \brief This function releases the memory mapping of an INI file opened by
+ * OpenINIBuffer.
+ *
+ * \param buffer A pointer to the buffer structure being closed.
+ *
+ * \effects
+ * The file mapping is released.  Views into the buffer may no longer be
+ * used.
+ *
+ * \returns Nothing
+ */
+void CloseINIBuffer(ini_buffer_t *buffer)
+{
+    if ((NULL == buffer) || (NULL == buffer->map))
+    {
+        return;
+    }
+
+#ifdef EZINI_POSIX
+    munmap(buffer->map, buffer->mapSize);
+#else
+    Release(buffer->map);
+#endif
+
+    InitINIBuffer(buffer, "", 0);
+}
+
+
+/**
+ * \fn ini_document_t *LoadDocument(const char *iniFile)
+ *
+ * \brief This function parses an INI file into a document that may be
+ * queried for values without reading the file again.
+ *
+ * \param iniFile The name of the INI file to be loaded.
+ *
+ * \effects
+ * The INI file is parsed and all of its entries are stored in an arena
+ * backed entry list, which is indexed by section and (section, key).
+ *
+ * \returns A pointer to the loaded document.  NULL is returned on error,
+ * and the error type is contained in errno.
+ *
+ * Entries are merged the same way AddEntryToList merges them: later values
+ * for a (section, key) pair overwrite earlier ones, and a section appearing
+ * more than once is treated as one section.  Entries preceding the first
+ * section are stored in a section with an empty name.  Call FreeDocument
+ * when done with the document.
+ *
+ * Documents aren't modified by queries, so any number of threads may query
+ * the same document at once.
+ */
+ini_document_t *LoadDocument(const char *iniFile)
+{
+    ini_document_t *doc;
+    ini_buffer_t buffer;
+    int result;
+
+    if (NULL == iniFile)
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    doc = (ini_document_t *)Allocate(sizeof(ini_document_t));
+
+    if (NULL == doc)
+    {
+        return NULL;
+    }
+
+    doc->image = NULL;
+    doc->mapped = 0;
+    doc->lazy = NULL;
+    doc->list = NewEntryList(1);
+
+    if (NULL == doc->list)
+    {
+        Release(doc);
+        return NULL;
+    }
+
+    if (0 != OpenINIBuffer(iniFile, &buffer))
+    {
+        FreeDocument(doc);
+        return NULL;
+    }
+
+    result = AddBufferToList(&buffer, &(doc->list));
+    CloseINIBuffer(&buffer);
+
+    if (0 != result)
+    {
+        FreeDocument(doc);
+        return NULL;
+    }
+
+    return doc;
+}
+
+
+/**
+ * \fn ini_document_t *LoadLazyDocument(const char *iniFile)
+ *
+ * \brief This function loads an INI file into a document whose sections
+ * are parsed the first time that they are accessed.
+ *
+ * \param iniFile The name of the INI file to be loaded.
+ *
+ * \effects
+ * The INI file is memory mapped and scanned once for section lines.  The
+ * offset and length of the text following each section line is recorded
+ * in a section directory, which is indexed by section name.
+ *
+ * \returns A pointer to the loaded document.  NULL is returned on error,
+ * and the error type is contained in errno.
+ *
+ * The document is queried like one made by LoadDocument.  The first query
+ * of a section parses its entries (from every place it appears in the
+ * file, merged the same way AddEntryToList merges them) into the document,
+ * so only the pages of the file holding the sections that are used are
+ * read after the first scan.  Malformed entries are found when their
+ * section is parsed; the queries of that section fail with errno set to
+ * EILSEQ.
+ *
+ * The INI file stays mapped until FreeDocument is called.  Any number of
+ * threads may query the document at once; sections are parsed under a
+ * lock, and parsed sections are read without locking.
+ */
+ini_document_t *LoadLazyDocument(const char *iniFile)
+{
+    ini_document_t *doc;
+    ini_lazy_t *lazy;
+
+    if (NULL == iniFile)
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    doc = (ini_document_t *)AllocateZeroed(1, sizeof(ini_document_t));
+
+    if (NULL == doc)
+    {
+        return NULL;
+    }
+
+    doc->list = NewEntryList(1);
+    lazy = (ini_lazy_t *)AllocateZeroed(1, sizeof(ini_lazy_t));
+
+    if ((NULL == doc->list) || (NULL == lazy))
+    {
+        Release(lazy);
+        FreeDocument(doc);
+        return NULL;
+    }
+
+#ifdef EZINI_POSIX
+    if (0 != pthread_mutex_init(&(lazy->lock), NULL))
+    {
+        Release(lazy);
+        FreeDocument(doc);
+        return NULL;
+    }
+#endif
+
+    doc->lazy = lazy;
+
+    if (0 != OpenINIBuffer(iniFile, &(lazy->buffer)))
+    {
+        InitINIBuffer(&(lazy->buffer), "", 0);
+        FreeDocument(doc);
+        return NULL;
+    }
+
+    if (0 != IndexLazySections(lazy, doc->list))
+    {
+        FreeDocument(doc);
+        return NULL;
+    }
+
+    return doc;
+}
+
+
+/**
+ * \fn int CompileINICache(const char *iniFile, const char *cacheFile)
+ *
+ * \brief This function parses an INI file and saves its entries in a
+ * binary cache image that LoadCachedDocument can use without parsing.
+ *
+ * \param iniFile The name of the INI file to be compiled.
+ *
+ * \param cacheFile The name of the cache file to write.  If NULL, ".bin" is
+ * appended to iniFile.
+ *
+ * \effects
+ * The cache file is created or replaced.  It holds the document's string,
+ * section, and key tables and hash indices, along with the size,
+ * modification time, and hash of the INI file it was compiled from.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ *
+ * The cache file is always written to a temporary file and renamed over
+ * the old one (see INI_WRITE_ATOMIC), because other processes may have
+ * the old one mapped.  INI_WRITE_SYNC and INI_WRITE_SYNC_DIR are honored.
+ *
+ * Images use the byte order of the machine that compiled them.  Images
+ * from a machine with another byte order are treated as stale.
+ */
+int CompileINICache(const char *iniFile, const char *cacheFile)
+{
+    ini_entry_list_t list;
+    ini_buffer_t buffer;
+    ini_output_t out;
+    ini_image_t *image;
+    ini_u32_t stamp[2];
+    char *name;
+    char *data;
+    size_t size;
+    int result;
+
+    if (NULL == iniFile)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* time first, so a change while reading makes the cache stale */
+    GetSourceTime(iniFile, stamp);
+
+    if (0 != LoadFile(iniFile, &data, &size))
+    {
+        return -1;
+    }
+
+    list = NewEntryList(1);
+
+    if (NULL == list)
+    {
+        Release(data);
+        return -1;
+    }
+
+    InitINIBuffer(&buffer, data, size);
+    image = NULL;
+
+    if (0 == AddBufferToList(&buffer, &list))
+    {
+        image = BuildImage(list, data, size, stamp);
+    }
+
+    FreeList(list);
+    Release(data);
+
+    if (NULL == image)
+    {
+        return -1;
+    }
+
+    name = CacheName(iniFile, cacheFile);
+
+    if ((NULL == name) || (0 != OpenOutput(&out, name,
+        writeMode | INI_WRITE_ATOMIC | WRITE_BINARY)))
+    {
+        Release(name);
+        Release(image);
+        return -1;
+    }
+
+    COUNT(STAT_WRITES, 1);
+    result = (fwrite(image, 1, image->size, out.fp) != image->size);
+    result = CloseOutput(&out, result);
+    Release(name);
+    Release(image);
+    return result;
+}
+
+
+/**
+ * \fn int CheckINICache(const char *iniFile, const char *cacheFile)
+ *
+ * \brief This function determines if the binary cache image of an INI file
+ * is up to date.
+ *
+ * \param iniFile The name of the INI file.
+ *
+ * \param cacheFile The name of the cache file.  If NULL, ".bin" is
+ * appended to iniFile.
+ *
+ * \effects None
+ *
+ * \returns 1 if the cache may be used\n
+ *          0 if it is missing, damaged, or stale\n
+ *         -1 if the INI file can't be read.  Error type is contained in
+ *         errno.
+ *
+ * See LoadCachedDocument for how staleness is determined.
+ */
+int CheckINICache(const char *iniFile, const char *cacheFile)
+{
+    const ini_image_t *image;
+    char *name;
+    int mapped;
+    int result;
+
+    if (NULL == iniFile)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    name = CacheName(iniFile, cacheFile);
+
+    if (NULL == name)
+    {
+        return -1;
+    }
+
+    result = MapImage(name, &image, &mapped);
+    Release(name);
+
+    if (0 != result)
+    {
+        return 0;
+    }
+
+    result = ImageIsFresh(image, iniFile);
+    FreeImage(image, mapped);
+    return result;
+}
+
+
+/**
+ * \fn ini_document_t *LoadCachedDocument(const char *iniFile,
+ *      const char *cacheFile)
+ *
+ * \brief This function loads a document from the binary cache image of an
+ * INI file, or parses the INI file if the cache can't be used.
+ *
+ * \param iniFile The name of the INI file to be loaded.
+ *
+ * \param cacheFile The name of the cache file made by CompileINICache.  If
+ * NULL, ".bin" is appended to iniFile.
+ *
+ * \effects
+ * The cache file is memory mapped.  If it is missing, damaged, or stale,
+ * the INI file is loaded with LoadDocument instead.
+ *
+ * \returns A pointer to the loaded document.  NULL is returned on error,
+ * and the error type is contained in errno.
+ *
+ * Loading a cache maps the file and checks its header; nothing is parsed
+ * or allocated per entry.  The document may be queried and freed like one
+ * returned by LoadDocument.
+ *
+ * A cache is stale if the INI file's size differs from the size it was
+ * compiled from.  If the size matches but the modification time doesn't
+ * (or wasn't known when the cache was compiled), the INI file is read and
+ * hashed, and the cache is used if the hash matches.
+ */
+ini_document_t *LoadCachedDocument(const char *iniFile,
+    const char *cacheFile)
+{
+    ini_document_t *doc;
+    const ini_image_t *image;
+    char *name;
+    int mapped;
+    int result;
+
+    if (NULL == iniFile)
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    name = CacheName(iniFile, cacheFile);
+
+    if (NULL == name)
+    {
+        return NULL;
+    }
+
+    result = MapImage(name, &image, &mapped);
+    Release(name);
+
+    if (0 == result)
+    {
+        if (1 == ImageIsFresh(image, iniFile))
+        {
+            doc = (ini_document_t *)Allocate(sizeof(ini_document_t));
+
+            if (NULL == doc)
+            {
+                FreeImage(image, mapped);
+                return NULL;
+            }
+
+            doc->list = NULL;
+            doc->image = image;
+            doc->mapped = mapped;
+            doc->lazy = NULL;
+            return doc;
+        }
+
+        FreeImage(image, mapped);
+    }
+
+    /* no usable cache, parse the text */
+    return LoadDocument(iniFile);
+}
+
+
+/**
+ * \fn int LoadListParallel(const char *iniFile, int threads,
+ *      ini_entry_list_t *list)
+ *
+ * \brief This function parses an INI file into an entry list using several
+ * threads.
+ *
+ * \param iniFile The name of the INI file to be loaded.
+ *
+ * \param threads The number of threads to use.  If it is 0 or less, one
+ * thread per online processor is used.
+ *
+ * \param list A pointer to an ini_entry_list_t that will point to the new
+ * list.  It must point to NULL.
+ *
+ * \effects
+ * The file is memory mapped and split into chunks that start at section
+ * lines.  Each chunk is parsed into its own arena list by its own thread,
+ * then the chunk lists are merged in file order.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ *
+ * The resulting arena backed list is the same as the one built by adding
+ * the file's entries to a list with AddEntryToList: later values for a
+ * (section, key) pair overwrite earlier ones, a section appearing more than
+ * once is one section, and sections and keys are in the order they first
+ * appear.  Entries preceding the first section are stored in a section with
+ * an empty name.
+ *
+ * Merging moves nodes and arena blocks between lists without copying any
+ * strings.  Files too small to split are parsed by a single thread.
+ * Without POSIX threads the chunks are parsed one after another.
+ */
+int LoadListParallel(const char *iniFile, int threads,
+    ini_entry_list_t *list)
+{
+    ini_buffer_t buffer;
+    ini_chunk_t *chunks;
+#ifdef EZINI_POSIX
+    pthread_t *workers;
+    int *started;
+#endif
+    size_t offset;
+    int count;
+    int i;
+    int result;
+
+    if ((NULL == iniFile) || (NULL == list) || (NULL != *list))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (threads <= 0)
+    {
+        threads = 1;
+#if defined(EZINI_POSIX) && defined(_SC_NPROCESSORS_ONLN)
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+        if (threads <= 0)
+        {
+            threads = 1;
+        }
+#endif
+    }
+
+    if (0 != OpenINIBuffer(iniFile, &buffer))
+    {
+        return -1;
+    }
+
+    /* don't make chunks too small to be worth a thread */
+    if ((size_t)threads > (buffer.size / MIN_CHUNK_SIZE) + 1)
+    {
+        threads = (int)(buffer.size / MIN_CHUNK_SIZE) + 1;
+    }
+
+    chunks = (ini_chunk_t *)AllocateZeroed(threads, sizeof(ini_chunk_t));
+#ifdef EZINI_POSIX
+    workers = (pthread_t *)Allocate(threads * sizeof(pthread_t));
+    started = (int *)AllocateZeroed(threads, sizeof(int));
+
+    if ((NULL == chunks) || (NULL == workers) || (NULL == started))
+    {
+        Release(chunks);
+        Release(workers);
+        Release(started);
+        CloseINIBuffer(&buffer);
+        return -1;
+    }
+#else
+    if (NULL == chunks)
+    {
+        CloseINIBuffer(&buffer);
+        return -1;
+    }
+#endif
+
+    /* split the file at the first section line after each 1/threads */
+    count = 0;
+    offset = 0;
+
+    for (i = 0; (i < threads) && (offset < buffer.size); i++)
+    {
+        size_t end;
+
+        end = (i + 1 == threads) ? buffer.size :
+            NextSectionLine(buffer.data, buffer.size,
+            (buffer.size / threads) * (i + 1));
+
+        if (end <= offset)
+        {
+            continue;       /* previous chunk already covers this one */
+        }
+
+        chunks[count].data = buffer.data + offset;
+        chunks[count].size = end - offset;
+        count++;
+        offset = end;
+    }
+
+    /* choose the scan kernel before threads race to do it */
+    GetScanKernel();
+
+#ifdef EZINI_POSIX
+    for (i = 1; i < count; i++)
+    {
+        started[i] = (0 == pthread_create(&workers[i], NULL, ParseChunk,
+            &chunks[i]));
+    }
+
+    /* parse the first chunk on this thread, and any that didn't start */
+    for (i = 0; i < count; i++)
+    {
+        if (!started[i])
+        {
+            ParseChunk(&chunks[i]);
+        }
+    }
+
+    for (i = 1; i < count; i++)
+    {
+        if (started[i])
+        {
+            pthread_join(workers[i], NULL);
+        }
+    }
+
+    Release(workers);
+    Release(started);
+#else
+    for (i = 0; i < count; i++)
+    {
+        ParseChunk(&chunks[i]);
+    }
+#endif
+
+    CloseINIBuffer(&buffer);
+
+    /* merge the chunks in file order */
+    result = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        if ((0 == result) && (0 != chunks[i].error))
+        {
+            errno = chunks[i].error;
+            result = -1;
+        }
+
+        if (0 != result)
+        {
+            FreeList(chunks[i].list);
+        }
+        else if (NULL == *list)
+        {
+            *list = chunks[i].list;
+        }
+        else if (0 != MergeLists(*list, chunks[i].list))
+        {
+            FreeList(chunks[i].list);
+            result = -1;
+        }
+    }
+
+    Release(chunks);
+
+    if (0 != result)
+    {
+        FreeList(*list);
+        *list = NULL;
+    }
+    else if (NULL == *list)
+    {
+        /* empty file */
+        *list = NewEntryList(1);
+        result = (NULL == *list) ? -1 : 0;
+    }
+
+    return result;
+}
+
+
+/**
+ * \fn ini_document_t *LoadDocumentParallel(const char *iniFile,
+ *      int threads)
+ *
+ * \brief This function parses an INI file into a document using several
+ * threads.
+ *
+ * \param iniFile The name of the INI file to be loaded.
+ *
+ * \param threads The number of threads to use.  If it is 0 or less, one
+ * thread per online processor is used.
+ *
+ * \effects The INI file is parsed by LoadListParallel.
+ *
+ * \returns A pointer to the loaded document.  NULL is returned on error,
+ * and the error type is contained in errno.
+ *
+ * The document is the same as the one made by LoadDocument.  Call
+ * FreeDocument when done with the document.
+ */
+ini_document_t *LoadDocumentParallel(const char *iniFile, int threads)
+{
+    ini_document_t *doc;
+
+    doc = (ini_document_t *)Allocate(sizeof(ini_document_t));
+
+    if (NULL == doc)
+    {
+        return NULL;
+    }
+
+    doc->list = NULL;
+    doc->image = NULL;
+    doc->mapped = 0;
+    doc->lazy = NULL;
+
+    if (0 != LoadListParallel(iniFile, threads, &(doc->list)))
+    {
+        Release(doc);
+        return NULL;
+    }
+
+    return doc;
+}
+
+
+/**
+ * \fn void FreeDocument(ini_document_t *doc)
+ *
+ * \brief This function frees a document created by LoadDocument,
+ * LoadLazyDocument, LoadDocumentParallel, or LoadCachedDocument.
+ *
+ * \param doc A pointer to the document being freed.
+ *
+ * \effects All of the memory allocated for the document is freed.  Strings
+ * returned by queries on the document may no longer be used.
+ *
+ * \returns Nothing
+ */
+void FreeDocument(ini_document_t *doc)
+{
+    if (NULL == doc)
+    {
+        return;
+    }
+
+    FreeLazy(doc->lazy);
+    FreeList(doc->list);
+    FreeImage(doc->image, doc->mapped);
+    Release(doc);
+}
+
+
+/**
+ * \fn const char *GetValueFromDocument(const ini_document_t *doc,
+ * const char *section, const char *key)
+ *
+ * \brief This function looks up the value of a (section, key) pair in a
+ * document.
+ *
+ * \param doc A pointer to the document being queried.
+ *
+ * \param section A NULL terminated string containing the section name.
+ *
+ * \param key A NULL terminated string containing the key name.
+ *
+ * \effects The section is parsed if the document is lazily parsed and the
+ * section hasn't been accessed yet.
+ *
+ * \returns A pointer to a NULL terminated string containing the value.  It
+ * belongs to the document and is valid until the document is freed.  NULL
+ * is returned if the document doesn't have a matching entry, or if its
+ * section couldn't be parsed (errno is set).
+ *
+ * The lookup takes O(1) time using the document's hash indices.
+ */
+const char *GetValueFromDocument(const ini_document_t *doc,
+    const char *section, const char *key)
+{
+    ini_view_t sectionView;
+    ini_view_t keyView;
+    ini_view_t value;
+
+    if ((NULL == doc) || (NULL == section) || (NULL == key))
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    sectionView.str = section;
+    sectionView.length = strlen(section);
+    keyView.str = key;
+    keyView.length = strlen(key);
+
+    if (0 != GetViewFromDocument(doc, &sectionView, &keyView, &value))
+    {
+        return NULL;
+    }
+
+    return value.str;
+}
+
+
+/**
+ * \fn int FindSectionInDocument(const ini_document_t *doc,
+ * const char *section, ini_cursor_t *cursor)
+ *
+ * \brief This function determines if a document contains a section, and
+ * optionally prepares to enumerate the section's keys.
+ *
+ * \param doc A pointer to the document being queried.
+ *
+ * \param section A NULL terminated string containing the section name.
+ *
+ * \param cursor A pointer to a cursor that will be set to the first
+ * key/value pair of the section.  Pass NULL to just test for the section.
+ *
+ * \effects cursor is initialized for use by GetKeyFromSection.  The
+ * section is parsed if the document is lazily parsed and the section hasn't
+ * been accessed yet.
+ *
+ * \returns 1 if the section exists, 0 if it doesn't (or couldn't be
+ * parsed).
+ */
+int FindSectionInDocument(const ini_document_t *doc, const char *section,
+    ini_cursor_t *cursor)
+{
+    ini_view_t view;
+
+    if (NULL == section)
+    {
+        return FindSectionViewInDocument(doc, NULL, cursor);
+    }
+
+    view.str = section;
+    view.length = strlen(section);
+    return FindSectionViewInDocument(doc, &view, cursor);
+}
+
+
+/**
+ * \fn int GetKeyFromSection(ini_cursor_t *cursor, const char **key,
+ * const char **value)
+ *
+ * \brief This function returns the next key/value pair in the section
+ * being enumerated.
+ *
+ * \param cursor A pointer to a cursor initialized by FindSectionInDocument.
+ *
+ * \param key Set to point to the NULL terminated key name.
+ *
+ * \param value Set to point to the NULL terminated value.
+ *
+ * \effects cursor is advanced to the next key/value pair.
+ *
+ * \returns 1 when a key/value pair is returned\n
+ *          0 when there are no more key/value pairs in the section
+ *
+ * Keys are returned in the order that they were first found in the INI
+ * file.
+ */
+int GetKeyFromSection(ini_cursor_t *cursor, const char **key,
+    const char **value)
+{
+    ini_view_t keyView;
+    ini_view_t valueView;
+
+    if (0 == GetKeyViewFromSection(cursor, &keyView, &valueView))
+    {
+        return 0;
+    }
+
+    if (NULL != key)
+    {
+        *key = keyView.str;
+    }
+
+    if (NULL != value)
+    {
+        *value = valueView.str;
+    }
+
+    return 1;
+}
+
+
+/**
+ * \fn int GetViewFromList(const ini_entry_list_t list,
+ * const ini_view_t *section, const ini_view_t *key, ini_view_t *value)
+ *
+ * \brief This function looks up the value of a (section, key) pair in an
+ * entry list without copying or allocating anything.
+ *
+ * \param list The entry list being queried.
+ *
+ * \param section A pointer to a view of the section name.  Use a length of
+ * 0 for entries preceding the first section.
+ *
+ * \param key A pointer to a view of the key name.
+ *
+ * \param value Set to a view of the value.  It belongs to the list, and
+ * its string is NULL terminated.
+ *
+ * \effects None
+ *
+ * \returns 0 for success\n
+ *         -1 on error.  errno is ENOENT if there is no such entry, or
+ *         EINVAL if a pointer is NULL.
+ *
+ * The view is valid until the entry is changed or the list is freed.
+ */
+int GetViewFromList(const ini_entry_list_t list, const ini_view_t *section,
+    const ini_view_t *key, ini_view_t *value)
+{
+    const ini_key_list_t *member;
+
+    if ((NULL == section) || (NULL == key) || (NULL == value))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    member = FindEntry(list, section, key);
+
+    if (NULL == member)
+    {
+        errno = ENOENT;
+        return -1;
+    }
+
+    value->str = member->value;
+    value->length = member->valueLength;
+    return 0;
+}
+
+
+/**
+ * \fn int GetViewFromDocument(const ini_document_t *doc,
+ * const ini_view_t *section, const ini_view_t *key, ini_view_t *value)
+ *
+ * \brief This function looks up the value of a (section, key) pair in a
+ * document without copying or allocating anything.
+ *
+ * \param doc A pointer to the document being queried.
+ *
+ * \param section A pointer to a view of the section name.  Use a length of
+ * 0 for entries preceding the first section.
+ *
+ * \param key A pointer to a view of the key name.
+ *
+ * \param value Set to a view of the value.  It belongs to the document,
+ * and its string is NULL terminated.
+ *
+ * \effects The section is parsed if the document is lazily parsed and the
+ * section hasn't been accessed yet.
+ *
+ * \returns 0 for success\n
+ *         -1 on error.  errno is ENOENT if there is no such entry, EINVAL
+ *         if a pointer is NULL, or describes why the section couldn't be
+ *         parsed.
+ *
+ * The view is valid until the document is freed.
+ */
+int GetViewFromDocument(const ini_document_t *doc, const ini_view_t *section,
+    const ini_view_t *key, ini_view_t *value)
+{
+    const ini_key_list_t *member;
+    const ini_image_key_t *record;
+
+    if ((NULL == doc) || (NULL == section) || (NULL == key) ||
+        (NULL == value))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (NULL != doc->image)
+    {
+        record = FindImageEntry(doc->image, section, key);
+        value->str = (NULL == record) ? NULL :
+            ImageString(doc->image, record->value, record->valueLength);
+
+        if (NULL == value->str)
+        {
+            errno = ENOENT;
+            return -1;
+        }
+
+        value->length = record->valueLength;
+        return 0;
+    }
+
+    if (NULL != doc->lazy)
+    {
+        member = FindLazyEntry(doc, section, key);
+
+        if (NULL == member)
+        {
+            return -1;      /* errno was set by FindLazyEntry */
+        }
+    }
+    else
+    {
+        member = FindEntry(doc->list, section, key);
+
+        if (NULL == member)
+        {
+            errno = ENOENT;
+            return -1;
+        }
+    }
+
+    value->str = member->value;
+    value->length = member->valueLength;
+    return 0;
+}
+
+
+/**
+ * \fn int FindSectionViewInList(const ini_entry_list_t list,
+ * const ini_view_t *section, ini_cursor_t *cursor)
+ *
+ * \brief This function determines if an entry list contains a section, and
+ * optionally prepares to enumerate the section's keys.
+ *
+ * \param list The entry list being queried.
+ *
+ * \param section A pointer to a view of the section name.
+ *
+ * \param cursor A pointer to a cursor that will be set to the first
+ * key/value pair of the section.  Pass NULL to just test for the section.
+ *
+ * \effects cursor is initialized for use by GetKeyViewFromSection (or
+ * GetKeyFromSection).
+ *
+ * \returns 1 if the section exists, 0 if it doesn't.
+ *
+ * The cursor is valid until the list is changed or freed.
+ */
+int FindSectionViewInList(const ini_entry_list_t list,
+    const ini_view_t *section, ini_cursor_t *cursor)
+{
+    const ini_section_t *here;
+
+    if (NULL != cursor)
+    {
+        cursor->next = NULL;
+        cursor->image = NULL;
+    }
+
+    if ((NULL == list) || (NULL == section))
+    {
+        return 0;
+    }
+
+    here = FindSection(list, section, HashView(section, HASH_SEED));
+
+    if (NULL == here)
+    {
+        return 0;
+    }
+
+    if (NULL != cursor)
+    {
+        cursor->next = here->members;
+    }
+
+    return 1;
+}
+
+
+/**
+ * \fn int FindSectionViewInDocument(const ini_document_t *doc,
+ * const ini_view_t *section, ini_cursor_t *cursor)
+ *
+ * \brief This function is FindSectionInDocument for a section name that
+ * isn't NULL terminated.
+ *
+ * \param doc A pointer to the document being queried.
+ *
+ * \param section A pointer to a view of the section name.
+ *
+ * \param cursor A pointer to a cursor that will be set to the first
+ * key/value pair of the section.  Pass NULL to just test for the section.
+ *
+ * \effects cursor is initialized for use by GetKeyViewFromSection (or
+ * GetKeyFromSection).  The section is parsed if the document is lazily
+ * parsed and the section hasn't been accessed yet.
+ *
+ * \returns 1 if the section exists, 0 if it doesn't (or couldn't be
+ * parsed).
+ */
+int FindSectionViewInDocument(const ini_document_t *doc,
+    const ini_view_t *section, ini_cursor_t *cursor)
+{
+    const ini_section_t *here;
+    const ini_lazy_section_t *lazy;
+    const ini_image_section_t *record;
+
+    if (NULL != cursor)
+    {
+        cursor->next = NULL;
+        cursor->image = NULL;
+    }
+
+    if ((NULL == doc) || (NULL == section))
+    {
+        return 0;
+    }
+
+    if (NULL != doc->image)
+    {
+        record = FindImageSection(doc->image, section,
+            HashView(section, HASH_SEED));
+
+        if (NULL == record)
+        {
+            return 0;
+        }
+
+        SetImageCursor(doc->image, record, cursor);
+        return 1;
+    }
+
+    if (NULL == doc->lazy)
+    {
+        return FindSectionViewInList(doc->list, section, cursor);
+    }
+
+    lazy = GetLazySection(doc, section);
+    here = (NULL == lazy) ? NULL : lazy->here;
+
+    if (NULL == here)
+    {
+        return 0;
+    }
+
+    if (NULL != cursor)
+    {
+        cursor->next = here->members;
+    }
+
+    return 1;
+}
+
+
+/**
+ * \fn int GetKeyViewFromSection(ini_cursor_t *cursor, ini_view_t *key,
+ * ini_view_t *value)
+ *
+ * \brief This function returns views of the next key/value pair in the
+ * section being enumerated.
+ *
+ * \param cursor A pointer to a cursor initialized by FindSectionInDocument,
+ * FindSectionViewInList, FindSectionViewInDocument, or
+ * GetSectionFromCursor.
+ *
+ * \param key Set to a view of the key name.  Its string is NULL
+ * terminated.
+ *
+ * \param value Set to a view of the value.  Its string is NULL terminated.
+ *
+ * \effects cursor is advanced to the next key/value pair.
+ *
+ * \returns 1 when a key/value pair is returned\n
+ *          0 when there are no more key/value pairs in the section
+ *
+ * Keys are returned in the order that they were first found in the INI
+ * file.
+ */
+int GetKeyViewFromSection(ini_cursor_t *cursor, ini_view_t *key,
+    ini_view_t *value)
+{
+    const ini_key_list_t *member;
+
+    if ((NULL == cursor) || (NULL == cursor->next))
+    {
+        return 0;
+    }
+
+    if (NULL != cursor->image)
+    {
+        return GetImageKey(cursor, key, value);
+    }
+
+    member = (const ini_key_list_t *)cursor->next;
+    cursor->next = member->next;
+
+    if (NULL != key)
+    {
+        key->str = member->key;
+        key->length = member->keyLength;
+    }
+
+    if (NULL != value)
+    {
+        value->str = member->value;
+        value->length = member->valueLength;
+    }
+
+    return 1;
+}
+
+
+/**
+ * \fn void EnumerateListSections(const ini_entry_list_t list,
+ * ini_section_cursor_t *cursor)
+ *
+ * \brief This function prepares to enumerate the sections of an entry
+ * list.
+ *
+ * \param list The entry list being enumerated.
+ *
+ * \param cursor A pointer to the cursor that will be set to the list's
+ * first section.
+ *
+ * \effects cursor is initialized for use by GetSectionFromCursor.
+ *
+ * \returns Nothing
+ *
+ * The cursor is valid until the list is changed or freed.
+ */
+void EnumerateListSections(const ini_entry_list_t list,
+    ini_section_cursor_t *cursor)
+{
+    if (NULL == cursor)
+    {
+        return;
+    }
+
+    cursor->next = (NULL == list) ? NULL : list->first;
+    cursor->doc = NULL;
+    cursor->index = 0;
+}
+
+
+/**
+ * \fn void EnumerateDocumentSections(const ini_document_t *doc,
+ * ini_section_cursor_t *cursor)
+ *
+ * \brief This function prepares to enumerate the sections of a document.
+ *
+ * \param doc A pointer to the document being enumerated.
+ *
+ * \param cursor A pointer to the cursor that will be set to the document's
+ * first section.
+ *
+ * \effects cursor is initialized for use by GetSectionFromCursor.
+ *
+ * \returns Nothing
+ */
+void EnumerateDocumentSections(const ini_document_t *doc,
+    ini_section_cursor_t *cursor)
+{
+    if (NULL == cursor)
+    {
+        return;
+    }
+
+    if ((NULL == doc) || ((NULL == doc->image) && (NULL == doc->lazy)))
+    {
+        EnumerateListSections((NULL == doc) ? NULL : doc->list, cursor);
+        return;
+    }
+
+    cursor->next = NULL;
+    cursor->doc = doc;
+    cursor->index = 0;
+}
+
+
+/**
+ * \fn int GetSectionFromCursor(ini_section_cursor_t *cursor,
+ * ini_view_t *section, ini_cursor_t *keys)
+ *
+ * \brief This function returns the next section of the entry list or
+ * document being enumerated.
+ *
+ * \param cursor A pointer to a cursor initialized by EnumerateListSections
+ * or EnumerateDocumentSections.
+ *
+ * \param section Set to a view of the section name.  Its string is NULL
+ * terminated, and its length is 0 for entries preceding the first section.
+ *
+ * \param keys A pointer to a cursor that will be set to the first
+ * key/value pair of the section, for use by GetKeyViewFromSection.  It may
+ * be NULL.
+ *
+ * \effects cursor is advanced to the next section.  Each section of a
+ * lazily parsed document is parsed, if it hasn't been accessed yet, to
+ * find out whether it has any entries.
+ *
+ * \returns 1 when a section is returned\n
+ *          0 when there are no more sections\n
+ *         -1 if a section of a lazily parsed document couldn't be parsed
+ *         (errno is set).  The next call continues with the following
+ *         section.
+ *
+ * Sections are returned in the order that they were first found in the INI
+ * file (or added to the list).  Sections without entries are skipped.
+ */
+int GetSectionFromCursor(ini_section_cursor_t *cursor, ini_view_t *section,
+    ini_cursor_t *keys)
+{
+    const ini_section_t *here;
+    const ini_image_t *image;
+    const ini_image_section_t *record;
+    ini_lazy_t *lazy;
+
+    if (NULL != keys)
+    {
+        keys->next = NULL;
+        keys->image = NULL;
+    }
+
+    if (NULL == cursor)
+    {
+        return 0;
+    }
+
+    here = NULL;
+
+    if (NULL == cursor->doc)
+    {
+        /* entry list */
+        here = (const ini_section_t *)cursor->next;
+
+        while ((NULL != here) && (NULL == here->members))
+        {
+            here = here->next;
+        }
+
+        if (NULL == here)
+        {
+            cursor->next = NULL;
+            return 0;
+        }
+
+        cursor->next = here->next;
+    }
+    else if (NULL != cursor->doc->image)
+    {
+        image = cursor->doc->image;
+        record = NULL;
+
+        for (; cursor->index < image->sectionCount; cursor->index++)
+        {
+            record = (const ini_image_section_t *)((const char *)image +
+                image->sections) + cursor->index;
+
+            if ((0 != record->count) &&
+                (NULL != ImageString(image, record->name, record->length)))
+            {
+                break;
+            }
+        }
+
+        if (cursor->index >= image->sectionCount)
+        {
+            return 0;
+        }
+
+        cursor->index++;
+
+        if (NULL != section)
+        {
+            section->str = ImageString(image, record->name, record->length);
+            section->length = record->length;
+        }
+
+        SetImageCursor(image, record, keys);
+        return 1;
+    }
+    else
+    {
+        lazy = cursor->doc->lazy;
+
+        while ((NULL == here) && (cursor->index < lazy->sectionCount))
+        {
+            cursor->index++;
+
+            if (0 != LoadLazySection(cursor->doc,
+                lazy->sections + cursor->index - 1))
+            {
+                return -1;
+            }
+
+            here = lazy->sections[cursor->index - 1].here;
+        }
+
+        if (NULL == here)
+        {
+            return 0;
+        }
+    }
+
+    if (NULL != section)
+    {
+        section->str = here->section;
+        section->length = here->length;
+    }
+
+    if (NULL != keys)
+    {
+        keys->next = here->members;
+    }
+
+    return 1;
+}
+
+
+/**
+ * \fn int GetLongFromList(const ini_entry_list_t list,
+ * const char *section, const char *key, long *value)
+ *
+ * \brief This function gets the value of a (section, key) pair as a long.
+ *
+ * \param list The entry list containing the value.
+ *
+ * \param section A NULL terminated string containing the section name.
+ *
+ * \param key A NULL terminated string containing the key name.
+ *
+ * \param value A pointer to the long that will receive the value.
+ *
+ * \effects The converted value is cached.
+ *
+ * \returns 0 for success\n
+ *         -1 on error.  errno is ENOENT if there is no such entry,
+ *         EINVAL if the value is malformed, or ERANGE if it is out
+ *         of range.
+ *
+ * The value is parsed as a signed decimal (or 0x prefixed hexadecimal)
+ * integer.  long is the platform's width, which is 32 bits on 64 bit
+ * Windows, and values that don't fit are out of range.
+ *
+ * The converted value is cached with the entry, so repeated reads don't
+ * parse it again.  The cache is cleared when AddEntryToList changes the
+ * value.
+ */
+int GetLongFromList(const ini_entry_list_t list, const char *section,
+    const char *key, long *value)
+{
+    ini_value_t converted;
+
+    if (0 != GetTypedValue(list, section, key, VALUE_LONG, &converted))
+    {
+        return -1;
+    }
+
+    *value = converted.l;
+    return 0;
+}
+
+
+/**
+ * \fn int GetLongFromDocument(const ini_document_t *doc,
+ * const char *section, const char *key, long *value)
+ *
+ * \brief This function gets the value of a (section, key) pair as a long.
+ *
+ * \param doc A pointer to the document containing the value.
+ *
+ * \param section A NULL terminated string containing the section name.
+ *
+ * \param key A NULL terminated string containing the key name.
+ *
+ * \param value A pointer to the long that will receive the value.
+ *
+ * \effects The converted value is cached.
+ *
+ * \returns 0 for success\n
+ *         -1 on error.  errno is ENOENT if there is no such entry,
+ *         EINVAL if the value is malformed, or ERANGE if it is out
+ *         of range.
+ *
+ * See GetLongFromList.  Documents loaded from a binary cache are read
+ * only, so their values are converted each time they are read.
+ */
+int GetLongFromDocument(const ini_document_t *doc,
+    const char *section, const char *key, long *value)
+{
+    ini_value_t converted;
+
+    if (0 != GetTypedFromDocument(doc, section, key, VALUE_LONG, &converted))
+    {
+        return -1;
+    }
+
+    *value = converted.l;
+    return 0;
+}
+
+
+/**
+ * \fn int GetULongFromList(const ini_entry_list_t list,
+ * const char *section, const char *key, unsigned long *value)
+ *
+ * \brief This function gets the value of a (section, key) pair as a unsigned long.
+ *
+ * \param list The entry list containing the value.
+ *
+ * \param section A NULL terminated string containing the section name.
+ *
+ * \param key A NULL terminated string containing the key name.
+ *
+ * \param value A pointer to the unsigned long that will receive the value.
+ *
+ * \effects The converted value is cached.
+ *
+ * \returns 0 for success\n
+ *         -1 on error.  errno is ENOENT if there is no such entry,
+ *         EINVAL if the value is malformed, or ERANGE if it is out
+ *         of range.
+ *
+ * The value is parsed as an unsigned decimal (or 0x prefixed hexadecimal)
+ * integer.  unsigned long is the platform's width, which is 32 bits on 64
+ * bit Windows, and values that don't fit are out of range.
+ *
+ * The converted value is cached with the entry, so repeated reads don't
+ * parse it again.  The cache is cleared when AddEntryToList changes the
+ * value.
+ */
+int GetULongFromList(const ini_entry_list_t list, const char *section,
+    const char *key, unsigned long *value)
+{
+    ini_value_t converted;
+
+    if (0 != GetTypedValue(list, section, key, VALUE_ULONG, &converted))
+    {
+        return -1;
+    }
+
+    *value = converted.ul;
+    return 0;
+}
+
+
+/**
+ * \fn int GetULongFromDocument(const ini_document_t *doc,
+ * const char *section, const char *key, unsigned long *value)
+ *
+ * \brief This function gets the value of a (section, key) pair as a unsigned long.
+ *
+ * \param doc A pointer to the document containing the value.
+ *
+ * \param section A NULL terminated string containing the section name.
+ *
+ * \param key A NULL terminated string containing the key name.
+ *
+ * \param value A pointer to the unsigned long that will receive the value.
+ *
+ * \effects The converted value is cached.
+ *
+ * \returns 0 for success\n
+ *         -1 on error.  errno is ENOENT if there is no such entry,
+ *         EINVAL if the value is malformed, or ERANGE if it is out
+ *         of range.
+ *
+ * See GetULongFromList.
+ */
+int GetULongFromDocument(const ini_document_t *doc,
+    const char *section, const char *key, unsigned long *value)
+{
+    ini_value_t converted;
+
+    if (0 != GetTypedFromDocument(doc, section, key, VALUE_ULONG, &converted))
+    {
+        return -1;
+    }
+
+    *value = converted.ul;
+    return 0;
+}
+
+
+/**
+ * \fn int GetDoubleFromList(const ini_entry_list_t list,
+ * const char *section, const char *key, double *value)
+ *
+ * \brief This function gets the value of a (section, key) pair as a double.
+ *
+ * \param list The entry list containing the value.
+ *
+ * \param section A NULL terminated string containing the section name.
+ *
+ * \param key A NULL terminated string containing the key name.
+ *
+ * \param value A pointer to the double that will receive the value.
+ *
+ * \effects The converted value is cached.
+ *
+ * \returns 0 for success\n
+ *         -1 on error.  errno is ENOENT if there is no such entry,
+ *         EINVAL if the value is malformed, or ERANGE if it is out
+ *         of range.
+ *
+ * The value is parsed as a decimal floating point number. The decimal point
+ * is always '.', regardless of locale.  Values too small to be normal are
+ * returned as subnormal numbers, only values that overflow or underflow
+ * to zero are out of range.
+ *
+ * The converted value is cached with the entry, so repeated reads don't
+ * parse it again.  The cache is cleared when AddEntryToList changes the
+ * value.
+ */
+int GetDoubleFromList(const ini_entry_list_t list, const char *section,
+    const char *key, double *value)
+{
+    ini_value_t converted;
+
+    if (0 != GetTypedValue(list, section, key, VALUE_DOUBLE, &converted))
+    {
+        return -1;
+    }
+
+    *value = converted.d;
+    return 0;
+}
+
+
+/**
+ * \fn int GetDoubleFromDocument(const ini_document_t *doc,
+ * const char *section, const char *key, double *value)
+ *
+ * \brief This function gets the value of a (section, key) pair as a double.
+ *
+ * \param doc A pointer to the document containing the value.
+ *
+ * \param section A NULL terminated string containing the section name.
+ *
+ * \param key A NULL terminated string containing the key name.
+ *
+ * \param value A pointer to the double that will receive the value.
+ *
+ * \effects The converted value is cached.
+ *
+ * \returns 0 for success\n
+ *         -1 on error.  errno is ENOENT if there is no such entry,
+ *         EINVAL if the value is malformed, or ERANGE if it is out
+ *         of range.
+ *
+ * See GetDoubleFromList.
+ */
+int GetDoubleFromDocument(const ini_document_t *doc,
+    const char *section, const char *key, double *value)
+{
+    ini_value_t converted;
+
+    if (0 != GetTypedFromDocument(doc, section, key, VALUE_DOUBLE, &converted))
+    {
+        return -1;
+    }
+
+    *value = converted.d;
+    return 0;
+}
+
+
+/**
+ * \fn int GetBoolFromList(const ini_entry_list_t list,
+ * const char *section, const char *key, int *value)
+ *
+ * \brief This function gets the value of a (section, key) pair as a int.
+ *
+ * \param list The entry list containing the value.
+ *
+ * \param section A NULL terminated string containing the section name.
+ *
+ * \param key A NULL terminated string containing the key name.
+ *
+ * \param value A pointer to the int that will receive the value.
+ *
+ * \effects The converted value is cached.
+ *
+ * \returns 0 for success\n
+ *         -1 on error.  errno is ENOENT if there is no such entry,
+ *         EINVAL if the value is malformed.
+ *
+ * The value is parsed as one of 1, true, yes, on (stored as 1) or 0, false,
+ * no, off (stored as 0). Case is ignored.
+ *
+ * The converted value is cached with the entry, so repeated reads don't
+ * parse it again.  The cache is cleared when AddEntryToList changes the
+ * value.
+ */
+int GetBoolFromList(const ini_entry_list_t list, const char *section,
+    const char *key, int *value)
+{
+    ini_value_t converted;
+
+    if (0 != GetTypedValue(list, section, key, VALUE_BOOL, &converted))
+    {
+        return -1;
+    }
+
+    *value = converted.b;
+    return 0;
+}
+
+
+/**
+ * \fn int GetBoolFromDocument(const ini_document_t *doc,
+ * const char *section, const char *key, int *value)
+ *
+ * \brief This function gets the value of a (section, key) pair as a int.
+ *
+ * \param doc A pointer to the document containing the value.
+ *
+ * \param section A NULL terminated string containing the section name.
+ *
+ * \param key A NULL terminated string containing the key name.
+ *
+ * \param value A pointer to the int that will receive the value.
+ *
+ * \effects The converted value is cached.
+ *
+ * \returns 0 for success\n
+ *         -1 on error.  errno is ENOENT if there is no such entry,
+ *         EINVAL if the value is malformed.
+ *
+ * See GetBoolFromList.
+ */
+int GetBoolFromDocument(const ini_document_t *doc,
+    const char *section, const char *key, int *value)
+{
+    ini_value_t converted;
+
+    if (0 != GetTypedFromDocument(doc, section, key, VALUE_BOOL, &converted))
+    {
+        return -1;
+    }
+
+    *value = converted.b;
+    return 0;
+}
+
+
+/**
+ * \fn int GetSizeFromList(const ini_entry_list_t list,
+ * const char *section, const char *key, size_t *value)
+ *
+ * \brief This function gets the value of a (section, key) pair as a size_t.
+ *
+ * \param list The entry list containing the value.
+ *
+ * \param section A NULL terminated string containing the section name.
+ *
+ * \param key A NULL terminated string containing the key name.
+ *
+ * \param value A pointer to the size_t that will receive the value.
+ *
+ * \effects The converted value is cached.
+ *
+ * \returns 0 for success\n
+ *         -1 on error.  errno is ENOENT if there is no such entry,
+ *         EINVAL if the value is malformed, or ERANGE if it is out
+ *         of range.
+ *
+ * The value is parsed as an unsigned integer optionally followed by a K, M,
+ * G, or T suffix (multiples of 1024, optionally followed by B or iB). Case
+ * is ignored.
+ *
+ * The converted value is cached with the entry, so repeated reads don't
+ * parse it again.  The cache is cleared when AddEntryToList changes the
+ * value.
+ */
+int GetSizeFromList(const ini_entry_list_t list, const char *section,
+    const char *key, size_t *value)
+{
+    ini_value_t converted;
+
+    if (0 != GetTypedValue(list, section, key, VALUE_SIZE, &converted))
+    {
+        return -1;
+    }
+
+    *value = converted.size;
+    return 0;
+}
+
+
+/**
+ * \fn int GetSizeFromDocument(const ini_document_t *doc,
+ * const char *section, const char *key, size_t *value)
+ *
+ * \brief This function gets the value of a (section, key) pair as a size_t.
+ *
+ * \param doc A pointer to the document containing the value.
+ *
+ * \param section A NULL terminated string containing the section name.
+ *
+ * \param key A NULL terminated string containing the key name.
+ *
+ * \param value A pointer to the size_t that will receive the value.
+ *
+ * \effects The converted value is cached.
+ *
+ * \returns 0 for success\n
+ *         -1 on error.  errno is ENOENT if there is no such entry,
+ *         EINVAL if the value is malformed, or ERANGE if it is out
+ *         of range.
+ *
+ * See GetSizeFromList.
+ */
+int GetSizeFromDocument(const ini_document_t *doc,
+    const char *section, const char *key, size_t *value)
+{
+    ini_value_t converted;
+
+    if (0 != GetTypedFromDocument(doc, section, key, VALUE_SIZE, &converted))
+    {
+        return -1;
+    }
+
+    *value = converted.size;
+    return 0;
+}
+
+
+/**
+ * \fn int ConvertINILong(const char *str, size_t length,
+ * long *value)
+ *
+ * \brief This function converts a value string to a long.
+ *
+ * \param str A pointer to the value.  It does not need to be NULL
+ * terminated.
+ *
+ * \param length The number of characters in str.
+ *
+ * \param value A pointer to the long that will receive the value.
+ *
+ * \effects None
+ *
+ * \returns 0 for success\n
+ *         -1 on error.  errno is EINVAL if the value is malformed, or
+ *         ERANGE if it is out of range.
+ *
+ * See GetLongFromList for the format.  This converts values passed to
+ * ParseINIFile handlers the same way the typed getters convert entries.
+ */
+int ConvertINILong(const char *str, size_t length, long *value)
+{
+    ini_value_t converted;
+
+    if (0 != ConvertString(str, length, VALUE_LONG, &converted))
+    {
+        return -1;
+    }
+
+    *value = converted.l;
+    return 0;
+}
+
+
+/**
+ * \fn int ConvertINIULong(const char *str, size_t length,
+ * unsigned long *value)
+ *
+ * \brief This function converts a value string to an unsigned long.
+ *
+ * \param str A pointer to the value.  It does not need to be NULL
+ * terminated.
+ *
+ * \param length The number of characters in str.
+ *
+ * \param value A pointer to the unsigned long that will receive the value.
+ *
+ * \effects None
+ *
+ * \returns 0 for success\n
+ *         -1 on error.  errno is EINVAL if the value is malformed, or
+ *         ERANGE if it is out of range.
+ *
+ * See GetULongFromList for the format.  This converts values passed to
+ * ParseINIFile handlers the same way the typed getters convert entries.
+ */
+int ConvertINIULong(const char *str, size_t length, unsigned long *value)
+{
+    ini_value_t converted;
+
+    if (0 != ConvertString(str, length, VALUE_ULONG, &converted))
+    {
+        return -1;
+    }
+
+    *value = converted.ul;
+    return 0;
+}
+
+
+/**
+ * \fn int ConvertINIDouble(const char *str, size_t length,
+ * double *value)
+ *
+ * \brief This function converts a value string to a double.
+ *
+ * \param str A pointer to the value.  It does not need to be NULL
+ * terminated.
+ *
+ * \param length The number of characters in str.
+ *
+ * \param value A pointer to the double that will receive the value.
+ *
+ * \effects None
+ *
+ * \returns 0 for success\n
+ *         -1 on error.  errno is EINVAL if the value is malformed, or
+ *         ERANGE if it is out of range.
+ *
+ * See GetDoubleFromList for the format.  This converts values passed to
+ * ParseINIFile handlers the same way the typed getters convert entries.
+ */
+int ConvertINIDouble(const char *str, size_t length, double *value)
+{
+    ini_value_t converted;
+
+    if (0 != ConvertString(str, length, VALUE_DOUBLE, &converted))
+    {
+        return -1;
+    }
+
+    *value = converted.d;
+    return 0;
+}
+
+
+/**
+ * \fn int ConvertINIBool(const char *str, size_t length,
+ * int *value)
+ *
+ * \brief This function converts a value string to a boolean.
+ *
+ * \param str A pointer to the value.  It does not need to be NULL
+ * terminated.
+ *
+ * \param length The number of characters in str.
+ *
+ * \param value A pointer to the int that will be set to 1 for true and 0 for false.
+ *
+ * \effects None
+ *
+ * \returns 0 for success\n
+ *         -1 on error.  errno is EINVAL if the value is malformed, or
+ *         ERANGE if it is out of range.
+ *
+ * See GetBoolFromList for the format.  This converts values passed to
+ * ParseINIFile handlers the same way the typed getters convert entries.
+ */
+int ConvertINIBool(const char *str, size_t length, int *value)
+{
+    ini_value_t converted;
+
+    if (0 != ConvertString(str, length, VALUE_BOOL, &converted))
+    {
+        return -1;
+    }
+
+    *value = converted.b;
+    return 0;
+}
+
+
+/**
+ * \fn int ConvertINISize(const char *str, size_t length,
+ * size_t *value)
+ *
+ * \brief This function converts a value string to a size_t.
+ *
+ * \param str A pointer to the value.  It does not need to be NULL
+ * terminated.
+ *
+ * \param length The number of characters in str.
+ *
+ * \param value A pointer to the size_t that will receive the value.
+ *
+ * \effects None
+ *
+ * \returns 0 for success\n
+ *         -1 on error.  errno is EINVAL if the value is malformed, or
+ *         ERANGE if it is out of range.
+ *
+ * See GetSizeFromList for the format.  This converts values passed to
+ * ParseINIFile handlers the same way the typed getters convert entries.
+ */
+int ConvertINISize(const char *str, size_t length, size_t *value)
+{
+    ini_value_t converted;
+
+    if (0 != ConvertString(str, length, VALUE_SIZE, &converted))
+    {
+        return -1;
+    }
+
+    *value = converted.size;
+    return 0;
+}
+
+
+/**
+ * \fn static int AddViewToList(ini_entry_list_t *list,
+ *      const ini_view_t *section, const ini_view_t *key,
+ *      const ini_view_t *value)
+ *
+ * \brief This function adds a (section, key, value) entry, made up of
+ * string views, to an entry list.
+ *
+ * \param list A pointer to an ini_entry_list_t that points to the
+ * head of entry list being modified.  Pass a pointer to an ini_entry_list_t
+ * pointing to NULL if the list needs to be created.
+ *
+ * \param section A view of the section name for the entry being added.
+ *
+ * \param key A view of the key name for the entry being added.
+ *
+ * \param value A view of the value for the entry being added.
+ *
+ * \effects
+ * See AddEntryToList.  The views don't need to be NULL terminated, the list
+ * keeps NULL terminated copies of them.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ */
+static int AddViewToList(ini_entry_list_t *list, const ini_view_t *section,
+    const ini_view_t *key, const ini_view_t *value)
+{
+    ini_section_t *here;
+    ini_key_list_t *member;
+    unsigned long hash;
+
+    /* handle empty list */
+    if (NULL == *list)
+    {
+        *list = NewEntryList(0);
+
+        if (NULL == *list)
+        {
+            return -1;
+        }
+    }
+
+    /* make room for a new section and key before allocating them */
+    if (0 != ReserveIndex(*list, &((*list)->sections), 1))
+    {
+        return -1;
+    }
+
+    if (0 != ReserveIndex(*list, &((*list)->keys), 1))
+    {
+        return -1;
+    }
+
+    hash = HashView(section, HASH_SEED);
+    here = FindSection(*list, section, hash);
+
+    if (NULL == here)
+    {
+        /* add the section to the list with this key and value */
+        here = NewSectionList(*list, section, key, value);
+
+        if (NULL == here)
+        {
+            return -1;
+        }
+
+        here->hash = hash;
+        here->members->hash = HashView(key, hash);
+
+        if (NULL == (*list)->last)
+        {
+            (*list)->first = here;
+        }
+        else
+        {
+            (*list)->last->next = here;
+        }
+
+        (*list)->last = here;
+        AddToIndex(&((*list)->sections), here, here->hash);
+        AddToIndex(&((*list)->keys), here->members, here->members->hash);
+        return 0;
+    }
+
+    hash = HashView(key, hash);
+    member = FindKey(&((*list)->keys), here, key, hash);
+
+    if (NULL != member)
+    {
+        /* key exists, change value */
+        char *value_copy;
+
+        if ((*list)->useArena && (value->length <= member->valueLength))
+        {
+            /* arena memory can't be freed, reuse it if the value fits */
+            memcpy(member->value, value->str, value->length);
+            member->value[value->length] = '\0';
+            member->valueLength = value->length;
+            member->cacheType = VALUE_NONE;
+            return 0;
+        }
+
+        value_copy = ListDupView(*list, value);
+
+        if (NULL == value_copy)
+        {
+            return -1;
+        }
+
+        ListFree(*list, member->value);
+        member->value = value_copy;
+        member->valueLength = value->length;
+        member->cacheType = VALUE_NONE;
+    }
+    else
+    {
+        /* new key, add to the end of the section */
+        member = NewKeyList(*list, key, value);
+
+        if (NULL == member)
+        {
+            return -1;
+        }
+
+        member->hash = hash;
+        member->section = here;
+        here->last->next = member;
+        here->last = member;
+        AddToIndex(&((*list)->keys), member, hash);
+    }
+
+    return 0;
+}
+
+
+/**
+ * \fn static int AddBufferToList(ini_buffer_t *buffer,
+ *      ini_entry_list_t *list)
+ *
+ * \brief This function adds all of the remaining entries in an INI buffer
+ * to an entry list.
+ *
+ * \param buffer A pointer to the buffer being parsed.
+ *
+ * \param list A pointer to the ini_entry_list_t being added to.
+ *
+ * \effects
+ * The entries are added as AddEntryToList would add them.  Entries
+ * preceding the first section are added to a section with an empty name.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ */
+static int AddBufferToList(ini_buffer_t *buffer, ini_entry_list_t *list)
+{
+    ini_entry_view_t entry;
+    int result;
+
+    while ((result = GetEntryFromBuffer(buffer, &entry)) > 0)
+    {
+        if (NULL == entry.section.str)
+        {
+            /* entry before the first section */
+            entry.section.str = "";
+        }
+
+        if (0 != AddViewToList(list, &entry.section, &entry.key,
+            &entry.value))
+        {
+            return -1;
+        }
+    }
+
+    return (result < 0) ? -1 : 0;
+}
+
+
+/**
+ * \fn ini_section_list_t *NewEntryList(int useArena)
+ *
+ * \brief This function allocates memory for a new, empty entry list.
+ *
+ * \param useArena Non-zero if the nodes and strings of the list should be
+ * allocated from an arena.
+ *
+ * \effects
+ * Memory will be allocated for a new ini_section_list_t with no sections
+ * and empty hash indices.
+ *
+ * \returns A pointer to the ini_section_list_t that was allocated.  The
+ * pointer will be NULL if an error occurs.
+ */
+static ini_section_list_t *NewEntryList(int useArena)
+{
+    ini_section_list_t *list;
+
+    list = (ini_section_list_t *)Allocate(sizeof(ini_section_list_t));
+
+    if (NULL == list)
+    {
+        return NULL;
+    }
+
+    list->first = NULL;
+    list->last = NULL;
+    list->sections.slots = NULL;
+    list->sections.size = 0;
+    list->sections.count = 0;
+    list->keys.slots = NULL;
+    list->keys.size = 0;
+    list->keys.count = 0;
+    list->useArena = useArena;
+    list->arena = NULL;
+    list->allocs = 1;
+
+    return list;
+}
+
+
+/**
+ * \fn ini_key_list_t *NewKeyList(ini_section_list_t *list,
+ *      const ini_view_t *key, const ini_view_t *value)
+ *
+ * \brief This function allocates memory for a new ini_key_list_t type
+ * variable and populates it with the data passed as parameters
+ *
+ * \param list A pointer to the entry list that the key will belong to.
+ *
+ * \param key A pointer to a view of the key name
+ *
+ * \param value A pointer to a view of the value of this key.  Use ASCII
+ * strings to represent numbers.
+ *
+ * \effects
+ * Memory will be allocated for a new ini_key_list_t and copies
+ * of the key and value strings passed as a parameter.  key and value are
+ * copied into the appropriate fields and the next pointer is set to NULL.
+ *
+ * \returns A pointer to the ini_key_list_t item that was allocated.  The
+ * pointer will be NULL if an error occurs.
+ *
+ * This function allocates memory for a new ini_key_list_t and copies
+ * of the key and value strings passed as a parameter.  The next pointer
+ * will be set to NULL.
+ */
+static ini_key_list_t *NewKeyList(ini_section_list_t *list,
+    const ini_view_t *key, const ini_view_t *value)
+{
+    ini_key_list_t *item;
+
+    item = (ini_key_list_t *)ListAlloc(list, sizeof(ini_key_list_t));
+
+    if (NULL == item)
+    {
+        return NULL;
+    }
+
+    /* allocation succeeded copy key and value */
+    item->next = NULL;
+    item->section = NULL;
+    item->hash = 0;
+
+    item->key = ListDupView(list, key);
+
+    if (NULL == item->key)
+    {
+        ListFree(list, item);
+        return NULL;
+    }
+
+    item->value = ListDupView(list, value);
+
+    if (NULL == item->value)
+    {
+        ListFree(list, item->key);
+        ListFree(list, item);
+        return NULL;
+    }
+
+    item->keyLength = key->length;
+    item->valueLength = value->length;
+    item->cacheType = VALUE_NONE;
+    return item;
+}
+
+
+/**
+ * \fn ini_section_t *NewSectionList(ini_section_list_t *list,
+ *      const ini_view_t *section, const ini_view_t *key,
+ *      const ini_view_t *value)
+ *
+ * \brief This function allocates memory for a new ini_section_t type
+ * variable and populates it with the data passed as parameters
+ *
+ * \param list A pointer to the entry list that the section will belong to.
+ *
+ * \param section A pointer to a view of the section name
+ *
+ * \param key A pointer to a view of the key name
+ *
+ * \param value A pointer to a view of the value of this key.  Use ASCII
+ * strings to represent numbers.
+ *
+ * \effects
+ * Memory will be allocated for a new ini_section_t and copies
+ * of the section, key, value strings passed as a parameter.  section is
+ * copied to the appropriate field and a new key list items is created fo
+ * the key and value strings.  The next pointer will be set to NULL.
+ *
+ * \returns A pointer to the ini_section_t item that was allocated.  The
+ * pointer will be NULL if an error occurs.
+ *
+ * This function allocates memory for a new ini_section_t and copies
+ * of the section, key, value strings passed as a parameter.  A ini_key_list_t
+ * is allocated for the key and value strings.  The next pointer is set to NULL.
+ * The caller is responsible for setting the hash values of the section and
+ * its key.
+ */
+static ini_section_t *NewSectionList(ini_section_list_t *list,
+    const ini_view_t *section, const ini_view_t *key,
+    const ini_view_t *value)
+{
+    ini_section_t *item;
+
+    item = (ini_section_t *)ListAlloc(list, sizeof(ini_section_t));
+
+    if (NULL == item)
+    {
+        return NULL;
+    }
+
+    /* now populate item */
+    item->next = NULL;
+    item->section = ListDupView(list, section);
+    item->length = section->length;
+
+    if (NULL == item->section)
+    {
+        ListFree(list, item);
+        return NULL;
+    }
+
+    /* start a member list with the current key and value */
+    item->members = NewKeyList(list, key, value);
+
+    if (NULL == item->members)
+    {
+        ListFree(list, item->section);
+        ListFree(list, item);
+        return NULL;
+    }
+
+    item->members->section = item;
+    item->last = item->members;
+    item->hash = 0;
+    return item;
+}
+
+
+/**
+ * \fn void *ListAlloc(ini_section_list_t *list, size_t size)
+ *
+ * \brief This function allocates memory for a node or string belonging to an
+ * entry list.
+ *
+ * \param list A pointer to the entry list that the memory belongs to.
+ *
+ * \param size The number of bytes to allocate.
+ *
+ * \effects
+ * For arena backed lists the memory is carved out of the current arena
+ * block, and a new block is allocated if the current block is full.  For
+ * other lists the memory is allocated with Allocate().
+ *
+ * \returns A pointer to the allocated memory, NULL on failure.
+ */
+static void *ListAlloc(ini_section_list_t *list, size_t size)
+{
+    ini_block_t *block;
+    void *ptr;
+
+    if (!list->useArena)
+    {
+        ptr = Allocate(size);
+
+        if (NULL != ptr)
+        {
+            list->allocs++;
+        }
+
+        return ptr;
+    }
+
+    /* keep every allocation aligned */
+    size = (size + sizeof(ini_align_t) - 1) & ~(sizeof(ini_align_t) - 1);
+    block = list->arena;
+
+    if ((NULL == block) || (block->size - block->used < size))
+    {
+        size_t blockSize;
+
+        blockSize = (size > ARENA_BLOCK_SIZE) ? size : ARENA_BLOCK_SIZE;
+        block = (ini_block_t *)Allocate(sizeof(ini_block_t) + blockSize);
+
+        if (NULL == block)
+        {
+            return NULL;
+        }
+
+        list->allocs++;
+        block->size = blockSize;
+        block->used = 0;
+        block->next = list->arena;
+        list->arena = block;
+    }
+
+    ptr = (char *)block->data + block->used;
+    block->used += size;
+    return ptr;
+}
+
+
+/**
+ * \fn char *ListDupView(ini_section_list_t *list, const ini_view_t *src)
+ *
+ * \brief This function returns a NULL terminated copy of a string view
+ * belonging to an entry list.
+ *
+ * \param list A pointer to the entry list that the copy belongs to.
+ *
+ * \param src A pointer to the view being being copied.
+ *
+ * \effects Memory is allocated by ListAlloc to hold a copy of the view.
+ *
+ * \returns A copy of src is returned on success.  NULL is returned on
+ * failure.
+ */
+static char *ListDupView(ini_section_list_t *list, const ini_view_t *src)
+{
+    char *dest;
+
+    dest = (char *)ListAlloc(list, src->length + 1);
+
+    if (NULL != dest)
+    {
+        memcpy(dest, src->str, src->length);
+        dest[src->length] = '\0';
+    }
+
+    return dest;
+}
+
+
+/**
+ * \fn void ListFree(ini_section_list_t *list, void *ptr)
+ *
+ * \brief This function frees memory allocated by ListAlloc.
+ *
+ * \param list A pointer to the entry list that the memory belongs to.
+ *
+ * \param ptr A pointer to the memory being freed.
+ *
+ * \effects
+ * Memory belonging to heap backed lists is freed.  Memory belonging to
+ * arena backed lists is freed when the entire arena is freed, so nothing
+ * is done for them.
+ *
+ * \returns Nothing
+ */
+static void ListFree(ini_section_list_t *list, void *ptr)
+{
+    if (!list->useArena)
+    {
+        Release(ptr);
+    }
+}
+
+
+/**
+ * \fn void FreeArena(ini_block_t *arena)
+ *
+ * \brief This function frees all of the blocks in an arena.
+ *
+ * \param arena A pointer to the most recently allocated block in the arena.
+ *
+ * \effects All of the blocks in the arena will be freed.
+ *
+ * \returns Nothing
+ */
+static void FreeArena(ini_block_t *arena)
+{
+    ini_block_t *next;
+
+    while (arena != NULL)
+    {
+        next = arena->next;
+        Release(arena);
+        arena = next;
+    }
+}
+
+
+/**
+ * \fn void FreeSectionList(ini_section_t *list)
+ *
+ * \brief This function frees all of the sections in a section list.
+ *
+ * \param list A pointer to the head of a list of ini_section_t
+ *
+ * \effects
+ * All of the memory allocated for the sections in the list and their
+ * key/value pairs will be freed.
+ *
+ * \returns Nothing
+ *
+ * This function walks the list from head to tail, freeing each section
+ * after saving its next pointer, so it uses constant stack space no matter
+ * how long the list is.
+ */
+static void FreeSectionList(ini_section_t *list)
+{
+    ini_section_t *next;
+
+    while (list != NULL)
+    {
+        next = list->next;
+
+        if (list->section != NULL)
+        {
+            /* free the section name */
+            Release(list->section);
+        }
+
+        if (list->members != NULL)
+        {
+            FreeKeyList(list->members);
+        }
+
+        Release(list);
+        list = next;
+    }
+}
+
+
+/**
+ * \fn void FreeKeyList(ini_key_list_t *list)
+ *
+ * \brief This function frees all of the members of a key list.
+ *
+ * \param list A pointer to the head of an ini_key_list_t
+ *
+ * \effects All of the memory allocated for all of the key/value pairs in
+ * a key list will be freed.
+ *
+ * \returns Nothing
+ *
+ * This function walks the list from head to tail, so it uses constant stack
+ * space no matter how many keys are in the list.
+ */
+static void FreeKeyList(ini_key_list_t *list)
+{
+    ini_key_list_t *next;
+
+    while (list != NULL)
+    {
+        next = list->next;
+        Release(list->key);
+        Release(list->value);
+        Release(list);
+        list = next;
+    }
+}
+
+
+/**
+ * \fn static void FreeEntry(ini_entry_t *entry)
+ *
+ * \brief This function frees the allocated memory that is pointed to by the
+ * members of an ini_entry_t structure.
+ *
+ * \param entry A pointer to the entry structure containing the members
+ * pointing to the memory to be freed.
+ *
+ * \effects Dynamically allocated memory is freed and entry data is set
+ * to NULL.
+ *
+ * \returns Nothing
+ */
+static void FreeEntry(ini_entry_t *entry)
+{
+    Release(entry->section);
+    Release(entry->key);
+    Release(entry->value);
+
+    entry->section = NULL;
+    entry->key = NULL;
+    entry->value = NULL;
+}
+
+/**
+ * \fn static unsigned long HashView(const ini_view_t *view,
+ *      unsigned long seed)
+ *
+ * \brief This function computes the 32 bit FNV-1a hash of a string view.
+ *
+ * \param view A pointer to the view of the string being hashed.
+ *
+ * \param seed The initial hash value.  Use HASH_SEED for section names and
+ * the section's hash for keys, so that keys hash as (section, key) pairs.
+ *
+ * \effects None
+ *
+ * \returns The hash of the string.
+ */
+static unsigned long HashView(const ini_view_t *view, unsigned long seed)
+{
+    const unsigned char *c;
+    const unsigned char *end;
+    unsigned long hash;
+
+    hash = seed;
+    end = (const unsigned char *)view->str + view->length;
+
+    for (c = (const unsigned char *)view->str; c < end; c++)
+    {
+        hash ^= *c;
+        hash = (hash * HASH_PRIME) & 0xFFFFFFFFUL;
+    }
+
+    return hash;
+}
+
+/**
+ * \fn static int ReserveIndex(ini_section_list_t *list, ini_index_t *index,
+ *      size_t count)
+ *
+ * \brief This function makes sure that there is room to add more nodes to
+ * a hash index.
+ *
+ * \param list A pointer to the entry list that owns the index.
+ *
+ * \param index A pointer to the hash index that will be added to.
+ *
+ * \param count The number of nodes that will be added.
+ *
+ * \effects
+ * If adding the nodes would make the index more than 3/4 full, the index is
+ * doubled in size until they fit and all of its nodes are rehashed into the
+ * new slots.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ *
+ * Growing the index geometrically keeps the amortized cost of additions
+ * O(1), and keeping it no more than 3/4 full keeps the linear probes short.
+ */
+static int ReserveIndex(ini_section_list_t *list, ini_index_t *index,
+    size_t count)
+{
+    ini_slot_t *old;
+    size_t oldSize;
+    size_t i;
+
+    if ((index->count + count) * 4 <= index->size * 3)
+    {
+        return 0;       /* there's already room */
+    }
+
+    old = index->slots;
+    oldSize = index->size;
+
+    index->size = (0 == oldSize) ? MIN_INDEX_SIZE : (oldSize * 2);
+
+    while ((index->count + count) * 4 > index->size * 3)
+    {
+        index->size *= 2;
+    }
+    index->slots = (ini_slot_t *)AllocateZeroed(index->size,
+        sizeof(ini_slot_t));
+
+    if (NULL == index->slots)
+    {
+        index->slots = old;
+        index->size = oldSize;
+        return -1;
+    }
+
+    list->allocs++;
+
+    /* rehash the old nodes into the new slots */
+    index->count = 0;
+
+    for (i = 0; i < oldSize; i++)
+    {
+        if (old[i].node != NULL)
+        {
+            AddToIndex(index, old[i].node, old[i].hash);
+        }
+    }
+
+    Release(old);
+    return 0;
+}
+
+/**
+ * \fn static void AddToIndex(ini_index_t *index, void *node,
+ *      unsigned long hash)
+ *
+ * \brief This function adds a node to a hash index.
+ *
+ * \param index A pointer to the hash index being added to.  ReserveIndex
+ * must have been called to make room for the node.
+ *
+ * \param node A pointer to the ini_section_t or ini_key_list_t being added.
+ *
+ * \param hash The hash of the node being added.
+ *
+ * \effects The node is stored in the first free slot at or after its hash.
+ *
+ * \returns Nothing
+ */
+static void AddToIndex(ini_index_t *index, void *node, unsigned long hash)
+{
+    size_t i;
+
+    i = hash & (index->size - 1);
+
+    while (index->slots[i].node != NULL)
+    {
+        i = (i + 1) & (index->size - 1);
+    }
+
+    index->slots[i].hash = hash;
+    index->slots[i].node = node;
+    index->count++;
+}
+
+/**
+ * \fn static void RemoveFromIndex(ini_index_t *index, const void *node,
+ *      unsigned long hash)
+ *
+ * \brief This function removes a node from a hash index.
+ *
+ * \param index A pointer to the hash index being removed from.
+ *
+ * \param node A pointer to the ini_section_t or ini_key_list_t being
+ * removed.  It must be in the index.
+ *
+ * \param hash The hash of the node being removed.
+ *
+ * \effects
+ * The node's slot is freed, and the nodes probed for after it are shifted
+ * back so that no probe stops at the hole before reaching them.
+ *
+ * \returns Nothing
+ *
+ * Shifting back instead of leaving a marker in the slot keeps lookups as
+ * fast after deletions as before them.
+ */
+static void RemoveFromIndex(ini_index_t *index, const void *node,
+    unsigned long hash)
+{
+    size_t mask;
+    size_t hole;
+    size_t i;
+    size_t home;
+
+    mask = index->size - 1;
+    hole = hash & mask;
+
+    while (index->slots[hole].node != node)
+    {
+        hole = (hole + 1) & mask;
+    }
+
+    for (i = (hole + 1) & mask; index->slots[i].node != NULL;
+        i = (i + 1) & mask)
+    {
+        home = index->slots[i].hash & mask;
+
+        /* move it if its probe from home passes through the hole */
+        if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+            index->slots[hole] = index->slots[i];
+            hole = i;
+        }
+    }
+
+    index->slots[hole].node = NULL;
+    index->slots[hole].hash = 0;
+    index->count--;
+}
+
+/**
+ * \fn static ini_section_t *FindSection(const ini_section_list_t *list,
+ *      const ini_view_t *section, unsigned long hash)
+ *
+ * \brief This function uses the section index of an entry list to find a
+ * section by name.
+ *
+ * \param list A pointer to the entry list being searched.
+ *
+ * \param section A pointer to a view of the name of the section being
+ * searched for.
+ *
+ * \param hash The hash of the section name (see HashView).
+ *
+ * \effects None
+ *
+ * \returns A pointer to the matching section, or NULL if there is none.
+ */
+static ini_section_t *FindSection(const ini_section_list_t *list,
+    const ini_view_t *section, unsigned long hash)
+{
+    const ini_index_t *index;
+    size_t i;
+
+    index = &(list->sections);
+
+    if (0 == index->size)
+    {
+        return NULL;
+    }
+
+    i = hash & (index->size - 1);
+
+    while (index->slots[i].node != NULL)
+    {
+        if (index->slots[i].hash == hash)
+        {
+            ini_section_t *here;
+
+            here = (ini_section_t *)index->slots[i].node;
+
+            if ((here->length == section->length) &&
+                (0 == memcmp(section->str, here->section, section->length)))
+            {
+                return here;
+            }
+        }
+
+        i = (i + 1) & (index->size - 1);
+    }
+
+    return NULL;
+}
+
+/**
+ * \fn static ini_key_list_t *FindKey(const ini_index_t *index,
+ *      const ini_section_t *section, const ini_view_t *key,
+ *      unsigned long hash)
+ *
+ * \brief This function uses a key index to find a key in a section.
+ *
+ * \param index A pointer to the key index being searched, normally the
+ * keys index of the entry list containing section.
+ *
+ * \param section A pointer to the section containing the key.
+ *
+ * \param key A pointer to a view of the name of the key being searched
+ * for.
+ *
+ * \param hash The hash of the (section, key) pair (see HashView).
+ *
+ * \effects None
+ *
+ * \returns A pointer to the matching key/value pair, or NULL if there is
+ * none.
+ */
+static ini_key_list_t *FindKey(const ini_index_t *index,
+    const ini_section_t *section, const ini_view_t *key, unsigned long hash)
+{
+    size_t i;
+
+    if (0 == index->size)
+    {
+        return NULL;
+    }
+
+    i = hash & (index->size - 1);
+
+    while (index->slots[i].node != NULL)
+    {
+        if (index->slots[i].hash == hash)
+        {
+            ini_key_list_t *here;
+
+            here = (ini_key_list_t *)index->slots[i].node;
+
+            if ((here->section == section) &&
+                (here->keyLength == key->length) &&
+                (0 == memcmp(key->str, here->key, key->length)))
+            {
+                return here;
+            }
+        }
+
+        i = (i + 1) & (index->size - 1);
+    }
+
+    return NULL;
+}
+
+/**
+ * \fn static ini_key_list_t *FindEntry(const ini_section_list_t *list,
+ *      const ini_view_t *section, const ini_view_t *key)
+ *
+ * \brief This function finds the key/value pair of a (section, key) entry
+ * in an entry list.
+ *
+ * \param list A pointer to the entry list being searched.  It may be NULL.
+ *
+ * \param section A pointer to a view of the section name.
+ *
+ * \param key A pointer to a view of the key name.
+ *
+ * \effects None
+ *
+ * \returns A pointer to the matching key/value pair, or NULL if there is
+ * none.
+ */
+static ini_key_list_t *FindEntry(const ini_section_list_t *list,
+    const ini_view_t *section, const ini_view_t *key)
+{
+    const ini_section_t *here;
+    unsigned long hash;
+
+    if (NULL == list)
+    {
+        return NULL;
+    }
+
+    hash = HashView(section, HASH_SEED);
+    here = FindSection(list, section, hash);
+
+    if (NULL == here)
+    {
+        return NULL;
+    }
+
+    return FindKey(&(list->keys), here, key, HashView(key, hash));
+}
+
+/**
+ * \fn static int ParseFedLine(ini_parser_t *parser, const char *line,
+ *      size_t length, const char *equals)
+ *
+ * \brief This function parses a complete line of text fed to a push parser.
+ *
+ * \param parser A pointer to the parser the line was fed to.
+ *
+ * \param line A pointer to the start of the line.
+ *
+ * \param length The number of characters in the line, excluding the
+ * trailing '\\n'.
+ *
+ * \param equals The first '=' in the line as found by SplitLine, or NULL if
+ * the line hasn't been searched (see ParseLineAt).
+ *
+ * \effects
+ * Section names are copied into the parser.  Entries are passed to the
+ * callback.  parser->stopped is set if there is an error or the callback
+ * asks to stop.
+ *
+ * \returns 0 to continue parsing, non-zero if parsing has stopped.
+ */
+static int ParseFedLine(ini_parser_t *parser, const char *line,
+    size_t length, const char *equals)
+{
+    ini_entry_view_t entry;
+    int type;
+
+    type = ParseLineAt(line, length, equals, &entry);
+
+    if (type < 0)
+    {
+        parser->stopped = -1;
+    }
+    else if (LINE_SECTION == type)
+    {
+        /* the line may not be around later, keep a copy of the name */
+        if (0 != GrowBuffer(&(parser->section), &(parser->sectionSize),
+            entry.section.length))
+        {
+            parser->stopped = -1;
+        }
+        else
+        {
+            memcpy(parser->section, entry.section.str, entry.section.length);
+            parser->sectionLength = entry.section.length;
+            parser->inSection = 1;
+        }
+    }
+    else if (LINE_ENTRY == type)
+    {
+        entry.section.str = parser->inSection ? parser->section : NULL;
+        entry.section.length = parser->sectionLength;
+        parser->stopped = parser->callback(&entry, parser->user);
+    }
+
+    return parser->stopped;
+}
+
+/**
+ * \fn static int GrowBuffer(char **buffer, size_t *size, size_t needed)
+ *
+ * \brief This function makes sure that a buffer is big enough to hold a
+ * number of characters.
+ *
+ * \param buffer A pointer to the buffer.  It may point to NULL.
+ *
+ * \param size A pointer to the size of the buffer.
+ *
+ * \param needed The number of characters the buffer must hold.
+ *
+ * \effects The buffer is doubled in size until it is big enough.  Its
+ * contents are preserved.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ */
+static int GrowBuffer(char **buffer, size_t *size, size_t needed)
+{
+    size_t newSize;
+    char *newBuffer;
+
+    if ((NULL != *buffer) && (needed <= *size))
+    {
+        return 0;
+    }
+
+    newSize = (0 == *size) ? MIN_LINE_SIZE : *size;
+
+    while (newSize < needed)
+    {
+        newSize *= 2;
+    }
+
+    newBuffer = (char *)Reallocate(*buffer, newSize);
+
+    if (NULL == newBuffer)
+    {
+        return -1;
+    }
+
+    COUNT(STAT_LINE_REALLOCS, 1);
+
+    *buffer = newBuffer;
+    *size = newSize;
+    return 0;
+}
+
+/**
+ * \fn static int HandleLine(const ini_handler_t *handler, const char *line,
+ *      size_t length, const char *equals)
+ *
+ * \brief This function parses a line of INI file text and passes its
+ * section name or entry to a handler.
+ *
+ * \param handler A pointer to the handler functions.
+ *
+ * \param line A pointer to the start of the line.
+ *
+ * \param length The number of characters in the line, excluding the
+ * trailing '\\n'.
+ *
+ * \param equals The first '=' in the line as found by SplitLine, or NULL if
+ * the line hasn't been searched (see ParseLineAt).
+ *
+ * \effects The matching handler function, if any, is called.
+ *
+ * \returns 0 to continue parsing, -1 for an error (errno is set), or the
+ * non-zero value returned by the handler function.
+ */
+static int HandleLine(const ini_handler_t *handler, const char *line,
+    size_t length, const char *equals)
+{
+    ini_entry_view_t parsed;
+    int type;
+
+    type = ParseLineAt(line, length, equals, &parsed);
+
+    if (type < 0)
+    {
+        return -1;
+    }
+    else if ((LINE_SECTION == type) && (NULL != handler->onSection))
+    {
+        return handler->onSection(parsed.section.str, parsed.section.length,
+            handler->user);
+    }
+    else if ((LINE_ENTRY == type) && (NULL != handler->onEntry))
+    {
+        return handler->onEntry(parsed.key.str, parsed.key.length,
+            parsed.value.str, parsed.value.length, handler->user);
+    }
+
+    return 0;
+}
+
+/**
+ * \fn static void *ParseChunk(void *chunk)
+ *
+ * \brief This function parses one chunk of a file being loaded by
+ * LoadListParallel.  It is the thread start routine.
+ *
+ * \param chunk A pointer to the ini_chunk_t being parsed.
+ *
+ * \effects
+ * The chunk's entries are added to a new arena list.  If anything fails,
+ * the chunk's error is set to errno.
+ *
+ * \returns NULL
+ */
+static void *ParseChunk(void *chunk)
+{
+    ini_chunk_t *here;
+    ini_buffer_t buffer;
+    ini_entry_view_t entry;
+    int result;
+
+    here = (ini_chunk_t *)chunk;
+    here->list = NewEntryList(1);
+
+    if (NULL == here->list)
+    {
+        here->error = (0 == errno) ? ENOMEM : errno;
+        return NULL;
+    }
+
+    InitINIBuffer(&buffer, here->data, here->size);
+
+    while ((result = GetEntryFromBuffer(&buffer, &entry)) > 0)
+    {
+        if (NULL == entry.section.str)
+        {
+            /* entry before the first section */
+            entry.section.str = "";
+        }
+
+        if (0 != AddViewToList(&(here->list), &entry.section, &entry.key,
+            &entry.value))
+        {
+            result = -1;
+            break;
+        }
+    }
+
+    if (result < 0)
+    {
+        here->error = (0 == errno) ? EIO : errno;
+    }
+
+    return NULL;
+}
+
+/**
+ * \fn static size_t NextSectionLine(const char *data, size_t size,
+ *      size_t offset)
+ *
+ * \brief This function finds the first section line starting at or after
+ * an offset in INI file text.
+ *
+ * \param data A pointer to the INI file text.
+ *
+ * \param size The number of characters in data.
+ *
+ * \param offset The offset to start searching from.  If it is in the
+ * middle of a line, the search starts on the next line.
+ *
+ * \effects None
+ *
+ * \returns The offset of the start of the first line whose first non white
+ * space character is '[', or size if there is none.
+ */
+static size_t NextSectionLine(const char *data, size_t size, size_t offset)
+{
+    const char *ptr;
+    const char *end;
+
+    end = data + size;
+    ptr = data + offset;
+
+    if ((offset > 0) && ('\n' != data[offset - 1]))
+    {
+        /* start at the next line */
+        ptr = scanKernel(ptr, end, '\n', '\n');
+        ptr += (ptr < end) ? 1 : 0;
+    }
+
+    while (ptr < end)
+    {
+        const char *c;
+
+        /* jump to the next '[', section lines are rare */
+        ptr = scanKernel(ptr, end, '[', '[');
+
+        if (ptr == end)
+        {
+            break;
+        }
+
+        for (c = ptr; (c > data) && ('\n' != *(c - 1)) &&
+            isspace((unsigned char)*(c - 1)); c--)
+        {
+            /* back up over leading white space */
+        }
+
+        if ((c == data) || ('\n' == *(c - 1)))
+        {
+            return c - data;
+        }
+
+        ptr++;
+    }
+
+    return size;
+}
+
+/**
+ * \fn static int MergeLists(ini_section_list_t *into,
+ *      ini_section_list_t *from)
+ *
+ * \brief This function merges one arena backed entry list into another as
+ * if from's entries were added to into with AddEntryToList.
+ *
+ * \param into A pointer to the arena list being merged into.
+ *
+ * \param from A pointer to the arena list being merged.  It is freed.
+ *
+ * \effects
+ * New sections are moved to the end of into with their keys, new keys are
+ * moved to the end of their section, and the values of existing keys are
+ * replaced.  from's arena blocks are handed to into, so no strings are
+ * copied.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.  On error the lists are unchanged.
+ */
+static int MergeLists(ini_section_list_t *into, ini_section_list_t *from)
+{
+    ini_section_t *section;
+    ini_section_t *nextSection;
+    ini_section_t *here;
+    ini_key_list_t *member;
+    ini_key_list_t *nextMember;
+    ini_key_list_t *found;
+    ini_block_t *block;
+    ini_view_t view;
+
+    /* make room for everything up front so nothing can fail half way */
+    if ((0 != ReserveIndex(into, &(into->sections), from->sections.count)) ||
+        (0 != ReserveIndex(into, &(into->keys), from->keys.count)))
+    {
+        return -1;
+    }
+
+    for (section = from->first; NULL != section; section = nextSection)
+    {
+        nextSection = section->next;
+        view.str = section->section;
+        view.length = section->length;
+        here = FindSection(into, &view, section->hash);
+
+        if (NULL == here)
+        {
+            /* move the whole section */
+            section->next = NULL;
+
+            if (NULL == into->last)
+            {
+                into->first = section;
+            }
+            else
+            {
+                into->last->next = section;
+            }
+
+            into->last = section;
+            AddToIndex(&(into->sections), section, section->hash);
+
+            for (member = section->members; NULL != member;
+                member = member->next)
+            {
+                AddToIndex(&(into->keys), member, member->hash);
+            }
+
+            continue;
+        }
+
+        for (member = section->members; NULL != member; member = nextMember)
+        {
+            nextMember = member->next;
+            view.str = member->key;
+            view.length = member->keyLength;
+            found = FindKey(&(into->keys), here, &view, member->hash);
+
+            if (NULL != found)
+            {
+                /* later value wins, its string stays in from's arena */
+                found->value = member->value;
+                found->valueLength = member->valueLength;
+                found->cacheType = VALUE_NONE;
+            }
+            else
+            {
+                /* move the key to the end of the existing section */
+                member->next = NULL;
+                member->section = here;
+                here->last->next = member;
+                here->last = member;
+                AddToIndex(&(into->keys), member, member->hash);
+            }
+        }
+    }
+
+    /* into now owns from's arena blocks, keep allocating from its own */
+    if (NULL != from->arena)
+    {
+        if (NULL == into->arena)
+        {
+            into->arena = from->arena;
+        }
+        else
+        {
+            for (block = from->arena; NULL != block->next; block = block->next)
+            {
+                /* find the oldest block */
+            }
+
+            block->next = into->arena->next;
+            into->arena->next = from->arena;
+        }
+    }
+
+    into->allocs += from->allocs;
+    Release(from->sections.slots);
+    Release(from->keys.slots);
+    Release(from);
+    return 0;
+}
+
+/**
+ * \fn static int IndexLazySections(ini_lazy_t *lazy,
+ *      ini_section_list_t *list)
+ *
+ * \brief This function scans the text of a lazily parsed document for
+ * section lines and builds its section directory.
+ *
+ * \param lazy A pointer to the lazy document's directory.  Its buffer holds
+ * the INI file text.
+ *
+ * \param list A pointer to the document's entry list, which is charged for
+ * the directory's index.
+ *
+ * \effects
+ * A piece is recorded for the text preceding the first section line and
+ * for the text following each section line.  Pieces of the same section
+ * are chained together in file order, and the sections are indexed by
+ * name.  Pieces with only blank and comment lines are left out, so
+ * sections are ordered by their first entry like every other document.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ *
+ * Only section lines are parsed, the scan jumps from one '[' to the next.
+ */
+static int IndexLazySections(ini_lazy_t *lazy, ini_section_list_t *list)
+{
+    ini_lazy_section_t *here;
+    ini_lazy_piece_t *piece;
+    ini_entry_view_t entry;
+    const char *data;
+    const char *end;
+    const char *eol;
+    size_t offset;
+    size_t size;
+    size_t i;
+
+    data = lazy->buffer.data;
+    size = lazy->buffer.size;
+    end = data + size;
+
+    /* piece 0 holds any entries preceding the first section */
+    entry.section.str = "";
+    entry.section.length = 0;
+
+    if (0 != AddLazyPiece(lazy, &(entry.section), 0))
+    {
+        return -1;
+    }
+
+    offset = NextSectionLine(data, size, 0);
+    lazy->pieces[0].length = offset;
+
+    while (offset < size)
+    {
+        eol = scanKernel(data + offset, end, '\n', '\n');
+
+        if (LINE_SECTION != ParseLineAt(data + offset,
+            eol - (data + offset), NULL, &entry))
+        {
+            return -1;      /* a '[' without a ']' */
+        }
+
+        offset = (eol - data) + ((eol < end) ? 1 : 0);
+
+        if (0 != AddLazyPiece(lazy, &(entry.section), offset))
+        {
+            return -1;
+        }
+
+        piece = lazy->pieces + (lazy->pieceCount - 1);
+        offset = NextSectionLine(data, size, offset);
+        piece->length = offset - piece->offset;
+    }
+
+    /* there are never more sections than pieces, so this doesn't move */
+    lazy->sections = (ini_lazy_section_t *)AllocateZeroed(lazy->pieceCount,
+        sizeof(ini_lazy_section_t));
+
+    if ((NULL == lazy->sections) ||
+        (0 != ReserveIndex(list, &(lazy->index), lazy->pieceCount)))
+    {
+        return -1;
+    }
+
+    for (i = 0; i < lazy->pieceCount; i++)
+    {
+        piece = lazy->pieces + i;
+
+        if (!LazyPieceHasLines(data + piece->offset, piece->length))
+        {
+            continue;       /* contributes no entries */
+        }
+
+        here = FindLazySection(lazy, &(piece->name), piece->hash);
+
+        if (NULL == here)
+        {
+            here = lazy->sections + lazy->sectionCount;
+            lazy->sectionCount++;
+            here->first = i;
+            AddToIndex(&(lazy->index), here, piece->hash);
+        }
+        else
+        {
+            lazy->pieces[here->last].next = i;
+        }
+
+        here->last = i;
+    }
+
+    return 0;
+}
+
+/**
+ * \fn static int AddLazyPiece(ini_lazy_t *lazy, const ini_view_t *name,
+ *      size_t offset)
+ *
+ * \brief This function adds a piece to the end of a lazy document's
+ * directory.
+ *
+ * \param lazy A pointer to the lazy document's directory.
+ *
+ * \param name A pointer to a view of the name of the piece's section.
+ *
+ * \param offset The offset of the text following the section line.
+ *
+ * \effects
+ * The array of pieces is grown if it is full.  The new piece has no
+ * length and no next piece.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ */
+static int AddLazyPiece(ini_lazy_t *lazy, const ini_view_t *name,
+    size_t offset)
+{
+    ini_lazy_piece_t *piece;
+
+    if (lazy->pieceCount == lazy->pieceSize)
+    {
+        size_t size;
+
+        size = (0 == lazy->pieceSize) ? MIN_INDEX_SIZE : 2 * lazy->pieceSize;
+
+        if (size > ((size_t)-1) / sizeof(ini_lazy_piece_t))
+        {
+            errno = ENOMEM;
+            return -1;
+        }
+
+        piece = (ini_lazy_piece_t *)Reallocate(lazy->pieces,
+            size * sizeof(ini_lazy_piece_t));
+
+        if (NULL == piece)
+        {
+            return -1;
+        }
+
+        lazy->pieces = piece;
+        lazy->pieceSize = size;
+    }
+
+    piece = lazy->pieces + lazy->pieceCount;
+    piece->name = *name;
+    piece->hash = HashView(name, HASH_SEED);
+    piece->offset = offset;
+    piece->length = 0;
+    piece->next = 0;
+    lazy->pieceCount++;
+    return 0;
+}
+
+/**
+ * \fn static int LazyPieceHasLines(const char *text, size_t length)
+ *
+ * \brief This function determines if the text of a lazy document's piece
+ * has any lines other than blank and comment lines.
+ *
+ * \param text A pointer to the piece's text.
+ *
+ * \param length The number of characters in text.
+ *
+ * \effects None
+ *
+ * \returns 1 if the text has an entry (or malformed) line, otherwise 0.
+ *
+ * Only the start of each line is examined, and the scan stops at the first
+ * line that isn't blank or a comment, so this is usually the first line.
+ */
+static int LazyPieceHasLines(const char *text, size_t length)
+{
+    const char *end;
+
+    end = text + length;
+
+    while (text < end)
+    {
+        if (isspace((unsigned char)*text))
+        {
+            text++;
+        }
+        else if ((';' == *text) || ('#' == *text))
+        {
+            text = scanKernel(text, end, '\n', '\n');
+        }
+        else
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * \fn static ini_lazy_section_t *FindLazySection(const ini_lazy_t *lazy,
+ *      const ini_view_t *section, unsigned long hash)
+ *
+ * \brief This function uses the index of a lazy document's directory to
+ * find a section by name.
+ *
+ * \param lazy A pointer to the lazy document's directory.
+ *
+ * \param section A pointer to a view of the name of the section being
+ * searched for.
+ *
+ * \param hash The hash of the section name (see HashView).
+ *
+ * \effects None
+ *
+ * \returns A pointer to the matching section, or NULL if there is none.
+ */
+static ini_lazy_section_t *FindLazySection(const ini_lazy_t *lazy,
+    const ini_view_t *section, unsigned long hash)
+{
+    const ini_index_t *index;
+    size_t i;
+
+    index = &(lazy->index);
+
+    if (0 == index->size)
+    {
+        return NULL;
+    }
+
+    i = hash & (index->size - 1);
+
+    while (index->slots[i].node != NULL)
+    {
+        if (index->slots[i].hash == hash)
+        {
+            ini_lazy_section_t *here;
+            const ini_view_t *name;
+
+            here = (ini_lazy_section_t *)index->slots[i].node;
+            name = &(lazy->pieces[here->first].name);
+
+            if ((name->length == section->length) &&
+                (0 == memcmp(section->str, name->str, section->length)))
+            {
+                return here;
+            }
+        }
+
+        i = (i + 1) & (index->size - 1);
+    }
+
+    return NULL;
+}
+
+/**
+ * \fn static ini_lazy_section_t *GetLazySection(const ini_document_t *doc,
+ *      const ini_view_t *section)
+ *
+ * \brief This function finds a section of a lazily parsed document,
+ * parsing it if it hasn't been accessed before.
+ *
+ * \param doc A pointer to the lazily parsed document.
+ *
+ * \param section A pointer to a view of the section name.
+ *
+ * \effects The section is parsed into the document's entry list if this is
+ * its first access.
+ *
+ * \returns A pointer to the parsed section.  NULL is returned if the
+ * document doesn't have the section (errno is ENOENT) or the section
+ * couldn't be parsed (errno describes why).
+ */
+static ini_lazy_section_t *GetLazySection(const ini_document_t *doc,
+    const ini_view_t *section)
+{
+    ini_lazy_section_t *here;
+
+    here = FindLazySection(doc->lazy, section, HashView(section, HASH_SEED));
+
+    if (NULL == here)
+    {
+        errno = ENOENT;
+        return NULL;
+    }
+
+    return (0 == LoadLazySection(doc, here)) ? here : NULL;
+}
+
+/**
+ * \fn static int LoadLazySection(const ini_document_t *doc,
+ *      ini_lazy_section_t *lazy)
+ *
+ * \brief This function parses a section of a lazily parsed document if it
+ * hasn't been accessed before.
+ *
+ * \param doc A pointer to the lazily parsed document.
+ *
+ * \param lazy A pointer to the section.
+ *
+ * \effects The section is parsed into the document's entry list if this is
+ * its first access.
+ *
+ * \returns 0 if the section has been parsed, -1 (with errno set) if it
+ * couldn't be.
+ *
+ * Parsing doesn't change the entries a document holds, only when they are
+ * found, so the document is logically const.
+ */
+static int LoadLazySection(const ini_document_t *doc,
+    ini_lazy_section_t *lazy)
+{
+    int state;
+
+    state = LOAD_ACQUIRE(&(lazy->state));
+
+    if (LAZY_UNPARSED == state)
+    {
+#ifdef EZINI_POSIX
+        pthread_mutex_lock(&(doc->lazy->lock));
+#endif
+
+        /* another thread may have parsed it while we waited */
+        state = LOAD_ACQUIRE(&(lazy->state));
+
+        if (LAZY_UNPARSED == state)
+        {
+            state = (0 == ParseLazySection((ini_document_t *)doc, lazy)) ?
+                LAZY_PARSED : LAZY_FAILED;
+            STORE_RELEASE(&(lazy->state), state);
+        }
+
+#ifdef EZINI_POSIX
+        pthread_mutex_unlock(&(doc->lazy->lock));
+#endif
+    }
+
+    if (LAZY_FAILED == state)
+    {
+        errno = lazy->error;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * \fn static int ParseLazySection(ini_document_t *doc,
+ *      ini_lazy_section_t *lazy)
+ *
+ * \brief This function parses every piece of a section of a lazily parsed
+ * document into the document's entry list.
+ *
+ * \param doc A pointer to the lazily parsed document.  The caller must
+ * hold its lock.
+ *
+ * \param lazy A pointer to the section being parsed.
+ *
+ * \effects
+ * The section's entries are added to the entry list as AddEntryToList
+ * would add them, in file order.  The section's key index is built, and
+ * its error is set if parsing fails.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ *
+ * Other threads may be reading sections that have already been parsed, so
+ * those are never changed.  Keys are found through the section's own key
+ * index rather than the list's, because adding entries to the list may
+ * grow the list's index while it is being read.
+ */
+static int ParseLazySection(ini_document_t *doc, ini_lazy_section_t *lazy)
+{
+    const ini_lazy_piece_t *piece;
+    const char *data;
+    ini_buffer_t buffer;
+    ini_entry_view_t entry;
+    ini_key_list_t *member;
+    size_t count;
+    size_t i;
+    int result;
+
+    data = doc->lazy->buffer.data;
+    i = lazy->first;
+    result = 0;
+
+    do
+    {
+        piece = doc->lazy->pieces + i;
+        InitINIBuffer(&buffer, data + piece->offset, piece->length);
+
+        while ((result = GetEntryFromBuffer(&buffer, &entry)) > 0)
+        {
+            result = AddViewToList(&(doc->list), &(piece->name), &(entry.key),
+                &(entry.value));
+
+            if (0 != result)
+            {
+                break;
+            }
+        }
+
+        i = piece->next;
+    } while ((0 == result) && (0 != i));
+
+    if (0 == result)
+    {
+        piece = doc->lazy->pieces + lazy->first;
+        lazy->here = FindSection(doc->list, &(piece->name), piece->hash);
+    }
+
+    if ((0 == result) && (NULL != lazy->here))
+    {
+        /* index the section's keys */
+        count = 0;
+
+        for (member = lazy->here->members; NULL != member;
+            member = member->next)
+        {
+            count++;
+        }
+
+        result = ReserveIndex(doc->list, &(lazy->keys), count);
+
+        for (member = lazy->here->members; (0 == result) && (NULL != member);
+            member = member->next)
+        {
+            AddToIndex(&(lazy->keys), member, member->hash);
+        }
+    }
+
+    if (0 != result)
+    {
+        lazy->here = NULL;
+        lazy->error = errno;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * \fn static ini_key_list_t *FindLazyEntry(const ini_document_t *doc,
+ *      const ini_view_t *section, const ini_view_t *key)
+ *
+ * \brief This function finds the key/value pair of a (section, key) entry
+ * in a lazily parsed document.
+ *
+ * \param doc A pointer to the lazily parsed document.
+ *
+ * \param section A pointer to a view of the section name.
+ *
+ * \param key A pointer to a view of the key name.
+ *
+ * \effects The section is parsed if this is its first access.
+ *
+ * \returns A pointer to the matching key/value pair.  NULL is returned if
+ * there is none (errno is ENOENT) or the section couldn't be parsed (errno
+ * describes why).
+ */
+static ini_key_list_t *FindLazyEntry(const ini_document_t *doc,
+    const ini_view_t *section, const ini_view_t *key)
+{
+    const ini_lazy_section_t *lazy;
+    ini_key_list_t *member;
+
+    lazy = GetLazySection(doc, section);
+
+    if ((NULL == lazy) || (NULL == lazy->here))
+    {
+        if (NULL != lazy)
+        {
+            errno = ENOENT;
+        }
+
+        return NULL;
+    }
+
+    member = FindKey(&(lazy->keys), lazy->here, key,
+        HashView(key, lazy->here->hash));
+
+    if (NULL == member)
+    {
+        errno = ENOENT;
+    }
+
+    return member;
+}
+
+/**
+ * \fn static void FreeLazy(ini_lazy_t *lazy)
+ *
+ * \brief This function frees the section directory of a lazily parsed
+ * document and unmaps its INI file.
+ *
+ * \param lazy A pointer to the directory being freed.  It may be NULL.
+ *
+ * \effects All of the memory allocated for the directory is freed.  The
+ * parsed entries belong to the document's entry list.
+ *
+ * \returns Nothing
+ */
+static void FreeLazy(ini_lazy_t *lazy)
+{
+    size_t i;
+
+    if (NULL == lazy)
+    {
+        return;
+    }
+
+    for (i = 0; (NULL != lazy->sections) && (i < lazy->sectionCount); i++)
+    {
+        Release(lazy->sections[i].keys.slots);
+    }
+
+#ifdef EZINI_POSIX
+    pthread_mutex_destroy(&(lazy->lock));
+#endif
+
+    CloseINIBuffer(&(lazy->buffer));
+    Release(lazy->sections);
+    Release(lazy->pieces);
+    Release(lazy->index.slots);
+    Release(lazy);
+}
+
+/**
+ * \fn static char *CacheName(const char *iniFile, const char *cacheFile)
+ *
+ * \brief This function returns the name of the binary cache file of an INI
+ * file.
+ *
+ * \param iniFile The name of the INI file.
+ *
+ * \param cacheFile The name of the cache file, or NULL to use iniFile with
+ * ".bin" appended.
+ *
+ * \effects Memory is allocated for the name.
+ *
+ * \returns A pointer to the name, which must be freed, or NULL on error.
+ */
+static char *CacheName(const char *iniFile, const char *cacheFile)
+{
+    char *name;
+    ini_view_t view;
+
+    if (NULL != cacheFile)
+    {
+        view.str = cacheFile;
+        view.length = strlen(cacheFile);
+        return DupView(&view);
+    }
+
+    name = (char *)Allocate(strlen(iniFile) + 5);
+
+    if (NULL != name)
+    {
+        strcpy(name, iniFile);
+        strcat(name, ".bin");
+    }
+
+    return name;
+}
+
+/**
+ * \fn static void GetSourceTime(const char *iniFile, ini_u32_t *stamp)
+ *
+ * \brief This function gets the modification time of an INI file for
+ * storing in a binary cache image.
+ *
+ * \param iniFile The name of the INI file.
+ *
+ * \param stamp An array of 2 that is set to the low and high 32 bits of the
+ * modification time, or to IMAGE_EMPTY if it isn't known.
+ *
+ * \effects None
+ *
+ * \returns Nothing
+ *
+ * A file modified in the current second could be modified again without
+ * changing its modification time, so its time is treated as unknown.
+ */
+static void GetSourceTime(const char *iniFile, ini_u32_t *stamp)
+{
+#ifdef EZINI_POSIX
+    struct stat status;
+    time_t now;
+
+    now = time(NULL);
+
+    if ((0 == stat(iniFile, &status)) && (status.st_mtime < now))
+    {
+        SplitU32((unsigned long)status.st_mtime, stamp);
+        return;
+    }
+#else
+    (void)iniFile;
+#endif
+
+    stamp[0] = IMAGE_EMPTY;
+    stamp[1] = IMAGE_EMPTY;
+}
+
+/**
+ * \fn static void SplitU32(unsigned long value, ini_u32_t *split)
+ *
+ * \brief This function splits a value into its low and high 32 bits.
+ *
+ * \param value The value being split.
+ *
+ * \param split An array of 2 that is set to the low and high 32 bits.
+ *
+ * \effects None
+ *
+ * \returns Nothing
+ */
+static void SplitU32(unsigned long value, ini_u32_t *split)
+{
+    split[0] = (ini_u32_t)(value & 0xFFFFFFFFUL);
+    split[1] = (ini_u32_t)((value >> 16) >> 16);    /* long may be 32 bits */
+}
+
+/**
+ * \fn static ini_image_t *BuildImage(const ini_section_list_t *list,
+ *      const char *data, size_t size, const ini_u32_t *stamp)
+ *
+ * \brief This function lays out the entries of an entry list as a binary
+ * cache image.
+ *
+ * \param list A pointer to the entry list.
+ *
+ * \param data A pointer to the text of the INI file the list was parsed
+ * from.
+ *
+ * \param size The number of characters in data.
+ *
+ * \param stamp The modification time of the INI file from GetSourceTime.
+ *
+ * \effects Memory is allocated for the image.
+ *
+ * \returns A pointer to the image, which must be freed, or NULL on error.
+ * Error type is contained in errno (ERANGE if the image would be larger
+ * than 4GB).
+ */
+static ini_image_t *BuildImage(const ini_section_list_t *list,
+    const char *data, size_t size, const ini_u32_t *stamp)
+{
+    ini_image_t *image;
+    ini_image_section_t *sections;
+    ini_image_key_t *keys;
+    ini_image_slot_t *index;
+    const ini_section_t *here;
+    const ini_key_list_t *member;
+    ini_view_t text;
+    char *strings;
+    unsigned long sectionCount;
+    unsigned long keyCount;
+    unsigned long stringsSize;
+    unsigned long sectionIndexSize;
+    unsigned long keyIndexSize;
+    unsigned long i;
+    unsigned long k;
+    ini_u32_t used;
+    double total;
+
+    sectionCount = 0;
+    keyCount = 0;
+    stringsSize = 0;
+
+    for (here = list->first; NULL != here; here = here->next)
+    {
+        sectionCount++;
+        stringsSize += here->length + 1;
+
+        for (member = here->members; NULL != member; member = member->next)
+        {
+            keyCount++;
+            stringsSize += member->keyLength + member->valueLength + 2;
+        }
+    }
+
+    /* at most half full, so probes are short and always find a free slot */
+    for (sectionIndexSize = 1; sectionIndexSize <= sectionCount * 2;
+        sectionIndexSize <<= 1)
+    {
+    }
+
+    for (keyIndexSize = 1; keyIndexSize <= keyCount * 2; keyIndexSize <<= 1)
+    {
+    }
+
+    total = (double)sizeof(ini_image_t) +
+        (double)sectionCount * sizeof(ini_image_section_t) +
+        (double)keyCount * sizeof(ini_image_key_t) +
+        (double)(sectionIndexSize + keyIndexSize) * sizeof(ini_image_slot_t) +
+        (double)stringsSize;
+
+    if (total > 4294967295.0)
+    {
+        errno = ERANGE;
+        return NULL;
+    }
+
+    image = (ini_image_t *)Allocate((size_t)total);
+
+    if (NULL == image)
+    {
+        return NULL;
+    }
+
+    memcpy(image->magic, IMAGE_MAGIC, sizeof(image->magic));
+    image->version = IMAGE_VERSION;
+    image->byteOrder = (ini_u32_t)IMAGE_BYTE_ORDER;
+    image->size = (ini_u32_t)total;
+    SplitU32((unsigned long)size, image->sourceSize);
+    image->sourceTime[0] = stamp[0];
+    image->sourceTime[1] = stamp[1];
+    text.str = data;
+    text.length = size;
+    image->sourceHash = (ini_u32_t)HashView(&text, HASH_SEED);
+    image->sectionCount = (ini_u32_t)sectionCount;
+    image->keyCount = (ini_u32_t)keyCount;
+    image->sectionIndexSize = (ini_u32_t)sectionIndexSize;
+    image->keyIndexSize = (ini_u32_t)keyIndexSize;
+    image->sections = sizeof(ini_image_t);
+    image->keys = image->sections +
+        (ini_u32_t)(sectionCount * sizeof(ini_image_section_t));
+    image->sectionIndex = image->keys +
+        (ini_u32_t)(keyCount * sizeof(ini_image_key_t));
+    image->keyIndex = image->sectionIndex +
+        (ini_u32_t)(sectionIndexSize * sizeof(ini_image_slot_t));
+    image->strings = image->keyIndex +
+        (ini_u32_t)(keyIndexSize * sizeof(ini_image_slot_t));
+    image->stringsSize = (ini_u32_t)stringsSize;
+
+    sections = (ini_image_section_t *)((char *)image + image->sections);
+    keys = (ini_image_key_t *)((char *)image + image->keys);
+    index = (ini_image_slot_t *)((char *)image + image->sectionIndex);
+    strings = (char *)image + image->strings;
+
+    /* all bits set marks every slot of both indices empty */
+    memset(index, 0xFF,
+        (size_t)(sectionIndexSize + keyIndexSize) * sizeof(ini_image_slot_t));
+
+    used = 0;
+    k = 0;
+
+    for (here = list->first, i = 0; NULL != here; here = here->next, i++)
+    {
+        sections[i].name = used;
+        sections[i].length = (ini_u32_t)here->length;
+        sections[i].hash = (ini_u32_t)here->hash;
+        sections[i].first = (ini_u32_t)k;
+        memcpy(strings + used, here->section, here->length + 1);
+        used += (ini_u32_t)here->length + 1;
+        AddToImageIndex(index, image->sectionIndexSize, sections[i].hash,
+            (ini_u32_t)i);
+
+        for (member = here->members; NULL != member; member = member->next)
+        {
+            keys[k].key = used;
+            keys[k].keyLength = (ini_u32_t)member->keyLength;
+            memcpy(strings + used, member->key, member->keyLength + 1);
+            used += (ini_u32_t)member->keyLength + 1;
+            keys[k].value = used;
+            keys[k].valueLength = (ini_u32_t)member->valueLength;
+            memcpy(strings + used, member->value, member->valueLength + 1);
+            used += (ini_u32_t)member->valueLength + 1;
+            keys[k].hash = (ini_u32_t)member->hash;
+            keys[k].section = (ini_u32_t)i;
+            AddToImageIndex(index + sectionIndexSize, image->keyIndexSize,
+                keys[k].hash, (ini_u32_t)k);
+            k++;
+        }
+
+        sections[i].count = (ini_u32_t)k - sections[i].first;
+    }
+
+    return image;
+}
+
+/**
+ * \fn static void AddToImageIndex(ini_image_slot_t *index, ini_u32_t size,
+ *      ini_u32_t hash, ini_u32_t record)
+ *
+ * \brief This function adds a record to a hash index of an image being
+ * built.
+ *
+ * \param index A pointer to the first slot of the index.
+ *
+ * \param size The number of slots in the index, a power of 2.
+ *
+ * \param hash The hash of the record.
+ *
+ * \param record The section or key table index of the record.
+ *
+ * \effects The record is stored in the first free slot at or after its
+ * hash.
+ *
+ * \returns Nothing
+ */
+static void AddToImageIndex(ini_image_slot_t *index, ini_u32_t size,
+    ini_u32_t hash, ini_u32_t record)
+{
+    ini_u32_t slot;
+
+    slot = hash & (size - 1);
+
+    while (IMAGE_EMPTY != index[slot].record)
+    {
+        slot = (slot + 1) & (size - 1);
+    }
+
+    index[slot].hash = hash;
+    index[slot].record = record;
+}
+
+/**
+ * \fn static int MapImage(const char *cacheFile, const ini_image_t **image,
+ *      int *mapped)
+ *
+ * \brief This function memory maps a binary cache image and checks that it
+ * was made by this version of the library on a compatible machine.
+ *
+ * \param cacheFile The name of the cache file.
+ *
+ * \param image Set to point to the image.
+ *
+ * \param mapped Set to non-zero if the image is memory mapped, or zero if
+ * it was read into allocated memory (on systems without mmap).
+ *
+ * \effects The cache file is mapped.  Free it with FreeImage.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno (EINVAL if the file isn't a usable image).
+ */
+static int MapImage(const char *cacheFile, const ini_image_t **image,
+    int *mapped)
+{
+    void *data;
+    size_t size;
+#ifdef EZINI_POSIX
+    struct stat status;
+    int fd;
+
+    fd = open(cacheFile, O_RDONLY);
+
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    if ((0 != fstat(fd, &status)) ||
+        (status.st_size < (off_t)sizeof(ini_image_t)) ||
+        ((unsigned long)status.st_size > 0xFFFFFFFFUL))
+    {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+
+    size = (size_t)status.st_size;
+    data = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (MAP_FAILED == data)
+    {
+        return -1;
+    }
+
+    *mapped = 1;
+#else
+    char *text;
+
+    if (0 != LoadFile(cacheFile, &text, &size))
+    {
+        return -1;
+    }
+
+    data = text;
+    *mapped = 0;
+#endif
+
+    *image = (const ini_image_t *)data;
+
+    if (!ValidImage(*image, size))
+    {
+#ifdef EZINI_POSIX
+        munmap(data, size);
+#else
+        Release(data);
+#endif
+        errno = EINVAL;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * \fn static int ValidImage(const ini_image_t *image, size_t size)
+ *
+ * \brief This function checks the header of a binary cache image.
+ *
+ * \param image A pointer to the image.
+ *
+ * \param size The number of bytes in the image file.
+ *
+ * \effects None
+ *
+ * \returns Non-zero if the header is for this image layout and byte order,
+ * all of the tables lie within the image, and every record is valid (see
+ * ValidRecords).
+ *
+ * Checking the records reads the whole image, but a damaged cache is
+ * rejected when it is loaded (and the INI file is parsed instead) rather
+ * than returning bad entries later.
+ */
+static int ValidImage(const ini_image_t *image, size_t size)
+{
+    const char *strings;
+
+    if ((size < sizeof(ini_image_t)) ||
+        (0 != memcmp(image->magic, IMAGE_MAGIC, sizeof(image->magic))) ||
+        (IMAGE_VERSION != image->version) ||
+        (IMAGE_BYTE_ORDER != image->byteOrder) || (size != image->size))
+    {
+        return 0;
+    }
+
+    if (!TableFits(image, image->sections, image->sectionCount,
+            sizeof(ini_image_section_t)) ||
+        !TableFits(image, image->keys, image->keyCount,
+            sizeof(ini_image_key_t)) ||
+        !TableFits(image, image->sectionIndex, image->sectionIndexSize,
+            sizeof(ini_image_slot_t)) ||
+        !TableFits(image, image->keyIndex, image->keyIndexSize,
+            sizeof(ini_image_slot_t)) ||
+        !TableFits(image, image->strings, image->stringsSize, 1))
+    {
+        return 0;
+    }
+
+    /* indices must be powers of 2 with free slots */
+    if ((0 != (image->sectionIndexSize & (image->sectionIndexSize - 1))) ||
+        (0 != (image->keyIndexSize & (image->keyIndexSize - 1))) ||
+        (image->sectionIndexSize <= image->sectionCount) ||
+        (image->keyIndexSize <= image->keyCount))
+    {
+        return 0;
+    }
+
+    strings = (const char *)image + image->strings;
+
+    if ((0 != image->stringsSize) &&
+        ('\0' != strings[image->stringsSize - 1]))
+    {
+        return 0;
+    }
+
+    return ValidRecords(image);
+}
+
+/**
+ * \fn static int ValidRecords(const ini_image_t *image)
+ *
+ * \brief This function checks every record of an image whose tables lie
+ * within it.
+ *
+ * \param image A pointer to the image.
+ *
+ * \effects None
+ *
+ * \returns Non-zero if every name, key, and value is a NULL terminated
+ * string of its recorded length in the string table, each section's keys
+ * are in the key table and belong to it, and every index slot is empty or
+ * refers to a record.
+ */
+static int ValidRecords(const ini_image_t *image)
+{
+    const ini_image_section_t *sections;
+    const ini_image_key_t *keys;
+    const ini_image_slot_t *index;
+    ini_u32_t i;
+    ini_u32_t j;
+
+    sections = (const ini_image_section_t *)((const char *)image +
+        image->sections);
+    keys = (const ini_image_key_t *)((const char *)image + image->keys);
+
+    for (i = 0; i < image->sectionCount; i++)
+    {
+        if ((NULL == ImageString(image, sections[i].name,
+                sections[i].length)) ||
+            (sections[i].first > image->keyCount) ||
+            (sections[i].count > image->keyCount - sections[i].first))
+        {
+            return 0;
+        }
+
+        for (j = sections[i].first; j < sections[i].first +
+            sections[i].count; j++)
+        {
+            if (keys[j].section != i)
+            {
+                return 0;
+            }
+        }
+    }
+
+    for (i = 0; i < image->keyCount; i++)
+    {
+        if ((keys[i].section >= image->sectionCount) ||
+            (NULL == ImageString(image, keys[i].key, keys[i].keyLength)) ||
+            (NULL == ImageString(image, keys[i].value, keys[i].valueLength)))
+        {
+            return 0;
+        }
+    }
+
+    index = (const ini_image_slot_t *)((const char *)image +
+        image->sectionIndex);
+
+    for (i = 0; i < image->sectionIndexSize; i++)
+    {
+        if ((IMAGE_EMPTY != index[i].record) &&
+            (index[i].record >= image->sectionCount))
+        {
+            return 0;
+        }
+    }
+
+    index = (const ini_image_slot_t *)((const char *)image +
+        image->keyIndex);
+
+    for (i = 0; i < image->keyIndexSize; i++)
+    {
+        if ((IMAGE_EMPTY != index[i].record) &&
+            (index[i].record >= image->keyCount))
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * \fn static int TableFits(const ini_image_t *image, ini_u32_t offset,
+ *      ini_u32_t count, size_t recordSize)
+ *
+ * \brief This function checks that a table lies within an image.
+ *
+ * \param image A pointer to the image.
+ *
+ * \param offset The offset of the table.
+ *
+ * \param count The number of records in the table.
+ *
+ * \param recordSize The size of each record.  Tables of records larger
+ * than a byte must be aligned for ini_u32_t.
+ *
+ * \effects None
+ *
+ * \returns Non-zero if the table fits.
+ */
+static int TableFits(const ini_image_t *image, ini_u32_t offset,
+    ini_u32_t count, size_t recordSize)
+{
+    if ((offset > image->size) ||
+        (count > (image->size - offset) / recordSize))
+    {
+        return 0;
+    }
+
+    return (1 == recordSize) || (0 == (offset % sizeof(ini_u32_t)));
+}
+
+/**
+ * \fn static void FreeImage(const ini_image_t *image, int mapped)
+ *
+ * \brief This function frees an image returned by MapImage.
+ *
+ * \param image A pointer to the image.  May be NULL.
+ *
+ * \param mapped The value MapImage set mapped to.
+ *
+ * \effects The image is unmapped or freed.
+ *
+ * \returns Nothing
+ */
+static void FreeImage(const ini_image_t *image, int mapped)
+{
+    if (NULL == image)
+    {
+        return;
+    }
+
+#ifdef EZINI_POSIX
+    if (mapped)
+    {
+        munmap((void *)image, image->size);
+        return;
+    }
+#else
+    (void)mapped;
+#endif
+
+    Release((void *)image);
+}
+
+/**
+ * \fn static int ImageIsFresh(const ini_image_t *image, const char *iniFile)
+ *
+ * \brief This function determines if a binary cache image matches the
+ * current contents of its INI file.
+ *
+ * \param image A pointer to the image.
+ *
+ * \param iniFile The name of the INI file.
+ *
+ * \effects None
+ *
+ * \returns 1 if the image matches, 0 if it is stale, -1 if the INI file
+ * can't be read.  Error type is contained in errno.
+ *
+ * Matching size and modification time are enough.  Otherwise, if the size
+ * matches, the file is hashed and compared to the hash of the text the
+ * image was compiled from.
+ */
+static int ImageIsFresh(const ini_image_t *image, const char *iniFile)
+{
+    ini_u32_t split[2];
+    ini_view_t text;
+    char *data;
+    size_t size;
+    int fresh;
+#ifdef EZINI_POSIX
+    struct stat status;
+
+    if (0 != stat(iniFile, &status))
+    {
+        return -1;
+    }
+
+    SplitU32((unsigned long)status.st_size, split);
+
+    if ((split[0] != image->sourceSize[0]) ||
+        (split[1] != image->sourceSize[1]))
+    {
+        return 0;
+    }
+
+    SplitU32((unsigned long)status.st_mtime, split);
+
+    if ((split[0] == image->sourceTime[0]) &&
+        (split[1] == image->sourceTime[1]))
+    {
+        return 1;
+    }
+#endif
+
+    if (0 != LoadFile(iniFile, &data, &size))
+    {
+        return -1;
+    }
+
+    SplitU32((unsigned long)size, split);
+    text.str = data;
+    text.length = size;
+    fresh = (split[0] == image->sourceSize[0]) &&
+        (split[1] == image->sourceSize[1]) &&
+        ((ini_u32_t)HashView(&text, HASH_SEED) == image->sourceHash);
+    Release(data);
+    return fresh;
+}
+
+/**
+ * \fn static const char *ImageString(const ini_image_t *image,
+ *      ini_u32_t offset, ini_u32_t length)
+ *
+ * \brief This function returns a string from the string table of an image.
+ *
+ * \param image A pointer to the image.
+ *
+ * \param offset The string table offset of the string.
+ *
+ * \param length The number of characters in the string.
+ *
+ * \effects None
+ *
+ * \returns A pointer to the NULL terminated string, or NULL if the offset
+ * and length don't describe a string in the table.
+ */
+static const char *ImageString(const ini_image_t *image, ini_u32_t offset,
+    ini_u32_t length)
+{
+    const char *str;
+
+    if ((offset >= image->stringsSize) ||
+        (length >= image->stringsSize - offset))
+    {
+        return NULL;
+    }
+
+    str = (const char *)image + image->strings + offset;
+    return ('\0' == str[length]) ? str : NULL;
+}
+
+/**
+ * \fn static const ini_image_section_t *FindImageSection(
+ *      const ini_image_t *image, const ini_view_t *section,
+ *      unsigned long hash)
+ *
+ * \brief This function finds a section in a binary cache image.
+ *
+ * \param image A pointer to the image being searched.
+ *
+ * \param section A pointer to a view of the section name.
+ *
+ * \param hash The hash of the section name.
+ *
+ * \effects None
+ *
+ * \returns A pointer to the section's record, or NULL if there is none.
+ */
+static const ini_image_section_t *FindImageSection(const ini_image_t *image,
+    const ini_view_t *section, unsigned long hash)
+{
+    const ini_image_slot_t *index;
+    const ini_image_section_t *sections;
+    const ini_image_section_t *here;
+    const char *name;
+    ini_u32_t slot;
+    ini_u32_t probes;
+
+    index = (const ini_image_slot_t *)((const char *)image +
+        image->sectionIndex);
+    sections = (const ini_image_section_t *)((const char *)image +
+        image->sections);
+    slot = (ini_u32_t)hash & (image->sectionIndexSize - 1);
+
+    for (probes = 0; probes < image->sectionIndexSize; probes++)
+    {
+        if (IMAGE_EMPTY == index[slot].record)
+        {
+            break;
+        }
+
+        if ((index[slot].hash == (ini_u32_t)hash) &&
+            (index[slot].record < image->sectionCount))
+        {
+            here = sections + index[slot].record;
+            name = ImageString(image, here->name, here->length);
+
+            if ((NULL != name) && (here->length == section->length) &&
+                (0 == memcmp(name, section->str, section->length)))
+            {
+                return here;
+            }
+        }
+
+        slot = (slot + 1) & (image->sectionIndexSize - 1);
+    }
+
+    return NULL;
+}
+
+/**
+ * \fn static const ini_image_key_t *FindImageEntry(const ini_image_t *image,
+ *      const ini_view_t *section, const ini_view_t *key)
+ *
+ * \brief This function finds the key/value pair of a (section, key) entry
+ * in a binary cache image.
+ *
+ * \param image A pointer to the image being searched.
+ *
+ * \param section A pointer to a view of the section name.
+ *
+ * \param key A pointer to a view of the key name.
+ *
+ * \effects None
+ *
+ * \returns A pointer to the key's record, or NULL if there is none.
+ */
+static const ini_image_key_t *FindImageEntry(const ini_image_t *image,
+    const ini_view_t *section, const ini_view_t *key)
+{
+    const ini_image_slot_t *index;
+    const ini_image_section_t *here;
+    const ini_image_key_t *keys;
+    const ini_image_key_t *member;
+    const char *name;
+    ini_u32_t owner;
+    ini_u32_t hash;
+    ini_u32_t slot;
+    ini_u32_t probes;
+
+    hash = (ini_u32_t)HashView(section, HASH_SEED);
+    here = FindImageSection(image, section, hash);
+
+    if (NULL == here)
+    {
+        return NULL;
+    }
+
+    owner = (ini_u32_t)(here - (const ini_image_section_t *)
+        ((const char *)image + image->sections));
+    hash = (ini_u32_t)HashView(key, hash);
+    index = (const ini_image_slot_t *)((const char *)image + image->keyIndex);
+    keys = (const ini_image_key_t *)((const char *)image + image->keys);
+    slot = hash & (image->keyIndexSize - 1);
+
+    for (probes = 0; probes < image->keyIndexSize; probes++)
+    {
+        if (IMAGE_EMPTY == index[slot].record)
+        {
+            break;
+        }
+
+        if ((index[slot].hash == hash) &&
+            (index[slot].record < image->keyCount))
+        {
+            member = keys + index[slot].record;
+            name = ImageString(image, member->key, member->keyLength);
+
+            if ((member->section == owner) && (NULL != name) &&
+                (member->keyLength == key->length) &&
+                (0 == memcmp(name, key->str, key->length)))
+            {
+                return member;
+            }
+        }
+
+        slot = (slot + 1) & (image->keyIndexSize - 1);
+    }
+
+    return NULL;
+}
+
+/**
+ * \fn static void SetImageCursor(const ini_image_t *image,
+ *      const ini_image_section_t *section, ini_cursor_t *cursor)
+ *
+ * \brief This function prepares to enumerate the keys of a section of a
+ * binary cache image.
+ *
+ * \param image A pointer to the image.
+ *
+ * \param section A pointer to the section's record.
+ *
+ * \param cursor A pointer to the cursor being set.  It may be NULL.
+ *
+ * \effects cursor is set to the section's first key, or to the end if it
+ * has none.
+ *
+ * \returns Nothing
+ */
+static void SetImageCursor(const ini_image_t *image,
+    const ini_image_section_t *section, ini_cursor_t *cursor)
+{
+    const ini_image_key_t *keys;
+
+    if (NULL == cursor)
+    {
+        return;
+    }
+
+    cursor->next = NULL;
+    cursor->image = NULL;
+
+    if ((0 != section->count) && (section->first < image->keyCount))
+    {
+        keys = (const ini_image_key_t *)((const char *)image + image->keys);
+        cursor->next = keys + section->first;
+        cursor->image = image;
+    }
+}
+
+/**
+ * \fn static int GetImageKey(ini_cursor_t *cursor, ini_view_t *key,
+ *      ini_view_t *value)
+ *
+ * \brief This function returns the next key/value pair of a section of a
+ * binary cache image being enumerated.
+ *
+ * \param cursor A pointer to a cursor set by FindSectionViewInDocument.
+ *
+ * \param key Set to a view of the key name.  Its string is NULL
+ * terminated.
+ *
+ * \param value Set to a view of the value.  Its string is NULL terminated.
+ *
+ * \effects cursor is advanced to the next key/value pair.
+ *
+ * \returns 1 when a key/value pair is returned\n
+ *          0 if the pair's strings aren't in the image (which ValidImage
+ *          rules out), ending the enumeration
+ *
+ * A section's keys are consecutive in the key table, so the cursor stops
+ * at the first key belonging to another section.
+ */
+static int GetImageKey(ini_cursor_t *cursor, ini_view_t *key,
+    ini_view_t *value)
+{
+    const ini_image_t *image;
+    const ini_image_key_t *member;
+    const ini_image_key_t *end;
+    const char *keyStr;
+    const char *valueStr;
+
+    image = (const ini_image_t *)cursor->image;
+    member = (const ini_image_key_t *)cursor->next;
+    end = (const ini_image_key_t *)((const char *)image + image->keys) +
+        image->keyCount;
+    keyStr = ImageString(image, member->key, member->keyLength);
+    valueStr = ImageString(image, member->value, member->valueLength);
+
+    if ((NULL == keyStr) || (NULL == valueStr))
+    {
+        cursor->next = NULL;
+        return 0;
+    }
+
+    if (NULL != key)
+    {
+        key->str = keyStr;
+        key->length = member->keyLength;
+    }
+
+    if (NULL != value)
+    {
+        value->str = valueStr;
+        value->length = member->valueLength;
+    }
+
+    if ((member + 1 < end) && (member[1].section == member->section))
+    {
+        cursor->next = member + 1;
+    }
+    else
+    {
+        cursor->next = NULL;
+    }
+
+    return 1;
+}
+
+
+/**
+ * \fn static int GetTypedValue(const ini_section_list_t *list,
+ *      const char *section, const char *key, value_type_t type,
+ *      ini_value_t *value)
+ *
+ * \brief This function finds a (section, key) entry in an entry list and
+ * converts its value to the requested type, using the entry's cached
+ * conversion when there is one.
+ *
+ * \param list A pointer to the entry list being searched.
+ *
+ * \param section A NULL terminated string containing the section name.
+ *
+ * \param key A NULL terminated string containing the key name.
+ *
+ * \param type The type that the value should be converted to.
+ *
+ * \param value A pointer to the union that will receive the converted
+ * value.
+ *
+ * \effects
+ * If the entry doesn't have a cached conversion, the result of this
+ * conversion (including a failure) is cached with it.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ */
+static int GetTypedValue(const ini_section_list_t *list, const char *section,
+    const char *key, value_type_t type, ini_value_t *value)
+{
+    ini_view_t sectionView;
+    ini_view_t keyView;
+
+    if ((NULL == section) || (NULL == key) || (NULL == value))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    sectionView.str = section;
+    sectionView.length = strlen(section);
+    keyView.str = key;
+    keyView.length = strlen(key);
+    return GetMemberValue(FindEntry(list, &sectionView, &keyView), type,
+        value);
+}
+
+/**
+ * \fn static int GetMemberValue(ini_key_list_t *member, value_type_t type,
+ *      ini_value_t *value)
+ *
+ * \brief This function converts the value of a key/value pair to the
+ * requested type, using the pair's cached conversion when there is one.
+ *
+ * \param member A pointer to the key/value pair, or NULL if the entry
+ * wasn't found.
+ *
+ * \param type The type that the value should be converted to.
+ *
+ * \param value A pointer to the union that will receive the converted
+ * value.
+ *
+ * \effects
+ * If the pair doesn't have a cached conversion, the result of this
+ * conversion (including a failure) is cached with it.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno, which is ENOENT if member is NULL.
+ *
+ * Each entry caches the first type that it is converted to.  The cache is
+ * claimed atomically and published after it is written, so concurrent
+ * readers of a document either see a complete cache entry or convert the
+ * value themselves.
+ */
+static int GetMemberValue(ini_key_list_t *member, value_type_t type,
+    ini_value_t *value)
+{
+    int error;
+
+    if (NULL == member)
+    {
+        errno = ENOENT;
+        return -1;
+    }
+
+    if (LOAD_ACQUIRE(&(member->cacheType)) == (int)type)
+    {
+        error = member->cacheError;
+        *value = member->cache;
+    }
+    else
+    {
+        error = ConvertValue(member->value, member->valueLength, type, value);
+
+        if (CLAIM(&(member->cacheType), VALUE_NONE, VALUE_BUSY))
+        {
+            member->cache = *value;
+            member->cacheError = error;
+            STORE_RELEASE(&(member->cacheType), (int)type);
+        }
+    }
+
+    if (0 != error)
+    {
+        errno = error;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * \fn static int GetTypedFromDocument(const ini_document_t *doc,
+ *      const char *section, const char *key, value_type_t type,
+ *      ini_value_t *value)
+ *
+ * \brief This function finds a (section, key) entry in a document and
+ * converts its value to the requested type.
+ *
+ * \param doc A pointer to the document being searched.
+ *
+ * \param section A NULL terminated string containing the section name.
+ *
+ * \param key A NULL terminated string containing the key name.
+ *
+ * \param type The type that the value should be converted to.
+ *
+ * \param value A pointer to the union that will receive the converted
+ * value.
+ *
+ * \effects
+ * Conversions of documents holding entry lists are cached as described
+ * for GetTypedValue.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ *
+ * Binary cache images are read only, so their values are converted every
+ * time.
+ */
+static int GetTypedFromDocument(const ini_document_t *doc,
+    const char *section, const char *key, value_type_t type,
+    ini_value_t *value)
+{
+    const ini_image_key_t *record;
+    ini_key_list_t *member;
+    const char *str;
+    ini_view_t sectionView;
+    ini_view_t keyView;
+    int error;
+
+    if (NULL == doc)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if ((NULL == doc->image) && (NULL == doc->lazy))
+    {
+        return GetTypedValue(doc->list, section, key, type, value);
+    }
+
+    if ((NULL == section) || (NULL == key))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    sectionView.str = section;
+    sectionView.length = strlen(section);
+    keyView.str = key;
+    keyView.length = strlen(key);
+
+    if (NULL != doc->lazy)
+    {
+        member = FindLazyEntry(doc, &sectionView, &keyView);
+
+        if (NULL == member)
+        {
+            return -1;      /* errno was set by FindLazyEntry */
+        }
+
+        return GetMemberValue(member, type, value);
+    }
+
+    record = FindImageEntry(doc->image, &sectionView, &keyView);
+    str = (NULL == record) ? NULL :
+        ImageString(doc->image, record->value, record->valueLength);
+
+    if (NULL == str)
+    {
+        errno = ENOENT;
+        return -1;
+    }
+
+    error = ConvertValue(str, record->valueLength, type, value);
+
+    if (0 != error)
+    {
+        errno = error;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * \fn static int ConvertString(const char *str, size_t length,
+ *      value_type_t type, ini_value_t *value)
+ *
+ * \brief This function converts a value string passed to a public
+ * conversion function.
+ *
+ * \param str A pointer to the value string.  It may not be NULL unless
+ * length is 0.
+ *
+ * \param length The number of characters in str.
+ *
+ * \param type The type that the value should be converted to.
+ *
+ * \param value A pointer to the union that will receive the converted
+ * value.
+ *
+ * \effects None
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ */
+static int ConvertString(const char *str, size_t length, value_type_t type,
+    ini_value_t *value)
+{
+    int error;
+
+    if ((NULL == str) && (0 != length))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    error = ConvertValue((NULL == str) ? "" : str, length, type, value);
+
+    if (0 != error)
+    {
+        errno = error;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * \fn static int ConvertValue(const char *str, size_t length,
+ *      value_type_t type, ini_value_t *value)
+ *
+ * \brief This function converts a value string to the requested type.
+ *
+ * \param str A pointer to the value string.
+ *
+ * \param length The number of characters in str.
+ *
+ * \param type The type that the value should be converted to.
+ *
+ * \param value A pointer to the union that will receive the converted
+ * value.
+ *
+ * \effects None
+ *
+ * \returns 0 for success, otherwise the errno value describing the error:
+ * EINVAL for malformed values and ERANGE for values out of range.
+ *
+ * Integers are parsed by hand and doubles take a fast path that doesn't
+ * depend on the locale, so conversions are faster than the strtol family
+ * and always use '.' as the decimal point.  Values of every type are
+ * malformed if they start or end with white space.  Values read from INI
+ * files are already trimmed.
+ */
+static int ConvertValue(const char *str, size_t length, value_type_t type,
+    ini_value_t *value)
+{
+    const char *ptr;
+    const char *end;
+    unsigned long magnitude;
+    int negative;
+    int result;
+
+    ptr = str;
+    end = str + length;
+    memset(value, 0, sizeof(ini_value_t));
+
+    /* the same rule for every type, strtod would skip leading spaces */
+    if ((ptr < end) &&
+        (isspace((unsigned char)*ptr) || isspace((unsigned char)*(end - 1))))
+    {
+        return EINVAL;
+    }
+
+    switch (type)
+    {
+        case VALUE_LONG:
+        case VALUE_ULONG:
+            negative = 0;
+
+            if ((ptr < end) && ((*ptr == '-') || (*ptr == '+')))
+            {
+                negative = (*ptr == '-');
+                ptr++;
+            }
+
+            result = ParseULong(&ptr, end, &magnitude);
+
+            if (0 != result)
+            {
+                return result;
+            }
+
+            if (ptr != end)
+            {
+                return EINVAL;      /* trailing junk */
+            }
+
+            if (VALUE_ULONG == type)
+            {
+                if (negative && (0 != magnitude))
+                {
+                    return ERANGE;
+                }
+
+                value->ul = magnitude;
+            }
+            else if (negative)
+            {
+                if (magnitude > (unsigned long)LONG_MAX + 1)
+                {
+                    return ERANGE;
+                }
+
+                /* negate without overflowing on LONG_MIN */
+                value->l = (0 == magnitude) ? 0 :
+                    -(long)(magnitude - 1) - 1;
+            }
+            else
+            {
+                if (magnitude > (unsigned long)LONG_MAX)
+                {
+                    return ERANGE;
+                }
+
+                value->l = (long)magnitude;
+            }
+
+            return 0;
+
+        case VALUE_DOUBLE:
+            return ParseDouble(str, length, &(value->d));
+
+        case VALUE_BOOL:
+            return ParseBool(str, length, &(value->b));
+
+        case VALUE_SIZE:
+            result = ParseULong(&ptr, end, &magnitude);
+
+            if (0 != result)
+            {
+                return result;
+            }
+
+            if (ptr < end)
+            {
+                /* size suffix */
+                int shift;
+
+                switch (toupper((unsigned char)*ptr))
+                {
+                    case 'K':   shift = 10;     break;
+                    case 'M':   shift = 20;     break;
+                    case 'G':   shift = 30;     break;
+                    case 'T':   shift = 40;     break;
+                    case 'B':   shift = 0;      break;
+                    default:    return EINVAL;
+                }
+
+                if (0 != magnitude)
+                {
+                    if ((shift >= (int)(sizeof(unsigned long) * CHAR_BIT)) ||
+                        (magnitude > (ULONG_MAX >> shift)))
+                    {
+                        return ERANGE;
+                    }
+
+                    magnitude <<= shift;
+                }
+
+                ptr++;
+
+                /* allow K, KB, and KiB */
+                if ((0 != shift) && (ptr < end) &&
+                    (toupper((unsigned char)*ptr) == 'I'))
+                {
+                    ptr++;
+
+                    if ((ptr == end) || (toupper((unsigned char)*ptr) != 'B'))
+                    {
+                        return EINVAL;
+                    }
+                }
+
+                if ((0 != shift) && (ptr < end) &&
+                    (toupper((unsigned char)*ptr) == 'B'))
+                {
+                    ptr++;
+                }
+            }
+
+            if (ptr != end)
+            {
+                return EINVAL;      /* trailing junk */
+            }
+
+            if (magnitude > (unsigned long)((size_t)-1))
+            {
+                return ERANGE;
+            }
+
+            value->size = (size_t)magnitude;
+            return 0;
+
+        default:
+            return EINVAL;
+    }
+}
+
+/**
+ * \fn static int ParseULong(const char **str, const char *end,
+ *      unsigned long *value)
+ *
+ * \brief This function parses an unsigned decimal or 0x prefixed
+ * hexadecimal integer.
+ *
+ * \param str A pointer to a pointer to the first digit.  It will be
+ * advanced past the last digit.
+ *
+ * \param end A pointer to the end of the string being parsed.
+ *
+ * \param value A pointer to the unsigned long that will receive the value.
+ *
+ * \effects None
+ *
+ * \returns 0 for success, EINVAL if there are no digits, ERANGE if the
+ * value doesn't fit in an unsigned long.
+ */
+static int ParseULong(const char **str, const char *end, unsigned long *value)
+{
+    const char *ptr;
+    unsigned long result;
+    unsigned long base;
+    unsigned long digit;
+
+    ptr = *str;
+    base = 10;
+
+    if ((end - ptr > 2) && (ptr[0] == '0') && ((ptr[1] == 'x') ||
+        (ptr[1] == 'X')) && isxdigit((unsigned char)ptr[2]))
+    {
+        base = 16;
+        ptr += 2;
+    }
+
+    if ((ptr == end) || !isxdigit((unsigned char)*ptr))
+    {
+        return EINVAL;
+    }
+
+    result = 0;
+
+    for (; ptr < end; ptr++)
+    {
+        if ((*ptr >= '0') && (*ptr <= '9'))
+        {
+            digit = *ptr - '0';
+        }
+        else if ((16 == base) && isxdigit((unsigned char)*ptr))
+        {
+            digit = toupper((unsigned char)*ptr) - 'A' + 10;
+        }
+        else
+        {
+            break;
+        }
+
+        if (result > (ULONG_MAX - digit) / base)
+        {
+            return ERANGE;
+        }
+
+        result = (result * base) + digit;
+    }
+
+    if (ptr == *str)
+    {
+        return EINVAL;
+    }
+
+    *str = ptr;
+    *value = result;
+    return 0;
+}
+
+/**
+ * \fn static int ParseDouble(const char *str, size_t length, double *value)
+ *
+ * \brief This function parses a decimal floating point number.
+ *
+ * \param str A pointer to the string being parsed.
+ *
+ * \param length The number of characters in str.
+ *
+ * \param value A pointer to the double that will receive the value.
+ *
+ * \effects None
+ *
+ * \returns 0 for success, EINVAL if str isn't a floating point number,
+ * ERANGE if it overflows or underflows to zero.
+ *
+ * Numbers with at most 15 significant digits and a decimal exponent of at
+ * most 22 are computed exactly with one multiplication or division.  Other
+ * numbers (and inf or nan) are passed to strtod, with '.' replaced by the
+ * locale's decimal point.
+ */
+static int ParseDouble(const char *str, size_t length, double *value)
+{
+    static const double powers[] =
+    {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+        1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char *ptr;
+    const char *end;
+    double mantissa;
+    long exponent;
+    int digits;
+    int negative;
+    int any;
+    char *copy;
+    char *stop;
+    char point;
+    size_t i;
+
+    ptr = str;
+    end = str + length;
+    negative = 0;
+    mantissa = 0.0;
+    exponent = 0;
+    digits = 0;
+    any = 0;
+
+    if ((ptr < end) && ((*ptr == '-') || (*ptr == '+')))
+    {
+        negative = (*ptr == '-');
+        ptr++;
+    }
+
+    /* integer part */
+    for (; (ptr < end) && (*ptr >= '0') && (*ptr <= '9'); ptr++)
+    {
+        if ((0.0 != mantissa) || (*ptr != '0'))
+        {
+            digits++;
+        }
+
+        mantissa = (mantissa * 10.0) + (*ptr - '0');
+        any = 1;
+    }
+
+    /* fraction */
+    if ((ptr < end) && (*ptr == '.'))
+    {
+        for (ptr++; (ptr < end) && (*ptr >= '0') && (*ptr <= '9'); ptr++)
+        {
+            if ((0.0 != mantissa) || (*ptr != '0'))
+            {
+                digits++;
+            }
+
+            mantissa = (mantissa * 10.0) + (*ptr - '0');
+            exponent--;
+            any = 1;
+        }
+    }
+
+    if (any && (ptr < end) && ((*ptr == 'e') || (*ptr == 'E')))
+    {
+        long e;
+        int negativeE;
+
+        ptr++;
+        negativeE = 0;
+
+        if ((ptr < end) && ((*ptr == '-') || (*ptr == '+')))
+        {
+            negativeE = (*ptr == '-');
+            ptr++;
+        }
+
+        if ((ptr == end) || (*ptr < '0') || (*ptr > '9'))
+        {
+            return EINVAL;
+        }
+
+        for (e = 0; (ptr < end) && (*ptr >= '0') && (*ptr <= '9'); ptr++)
+        {
+            if (e < 100000)
+            {
+                e = (e * 10) + (*ptr - '0');
+            }
+        }
+
+        exponent += negativeE ? -e : e;
+    }
+
+    if (any && (ptr == end) && (digits <= 15) && (exponent >= -22) &&
+        (exponent <= 22))
+    {
+        /* fast path: both mantissa and power of 10 are exact */
+        if (exponent < 0)
+        {
+            mantissa /= powers[-exponent];
+        }
+        else
+        {
+            mantissa *= powers[exponent];
+        }
+
+        *value = negative ? -mantissa : mantissa;
+        return 0;
+    }
+
+    if (any && (ptr != end))
+    {
+        return EINVAL;      /* trailing junk */
+    }
+
+    /* slow path, let strtod do it in the current locale */
+    copy = (char *)Allocate(length + 1);
+
+    if (NULL == copy)
+    {
+        return ENOMEM;
+    }
+
+    memcpy(copy, str, length);
+    copy[length] = '\0';
+    point = localeconv()->decimal_point[0];
+
+    if (point != '.')
+    {
+        for (i = 0; i < length; i++)
+        {
+            if (copy[i] == '.')
+            {
+                copy[i] = point;
+            }
+        }
+    }
+
+    errno = 0;
+    *value = strtod(copy, &stop);
+
+    if ((stop == copy) || (*stop != '\0'))
+    {
+        Release(copy);
+        return EINVAL;
+    }
+
+    Release(copy);
+
+    /* strtod may report ERANGE for subnormal results, which are usable */
+    if ((ERANGE == errno) && ((0.0 == *value) || (HUGE_VAL == *value) ||
+        (-HUGE_VAL == *value)))
+    {
+        return ERANGE;
+    }
+
+    return 0;
+}
+
+/**
+ * \fn static int ParseBool(const char *str, size_t length, int *value)
+ *
+ * \brief This function parses a boolean value.
+ *
+ * \param str A pointer to the string being parsed.
+ *
+ * \param length The number of characters in str.
+ *
+ * \param value A pointer to the int that will be set to 1 for true and 0
+ * for false.
+ *
+ * \effects None
+ *
+ * \returns 0 for success, EINVAL if str isn't a boolean.
+ *
+ * 1, true, yes, and on are true.  0, false, no, and off are false.  Case
+ * is ignored.
+ */
+static int ParseBool(const char *str, size_t length, int *value)
+{
+    static const char *names[] =
+    {
+        "0", "1", "false", "true", "no", "yes", "off", "on"
+    };
+
+    char lower[6];
+    size_t i;
+
+    if (length >= sizeof(lower))
+    {
+        return EINVAL;
+    }
+
+    for (i = 0; i < length; i++)
+    {
+        lower[i] = (char)tolower((unsigned char)str[i]);
+    }
+
+    lower[length] = '\0';
+
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+    {
+        if (0 == strcmp(lower, names[i]))
+        {
+            *value = (int)(i & 1);      /* odd entries are true */
+            return 0;
+        }
+    }
+
+    return EINVAL;
+}
+
+/**
+ * \fn static int GetEntry(ini_reader_t *reader, ini_entry_t *entry)
+ *
+ * \brief This function reads lines until it finds the next
+ * (section, key, value) triple.
+ *
+ * \param reader A pointer to the reader for the INI file being parsed.
+ *
+ * \param entry A pointer to the entry structure used to store the discovered
+ * (section, key, value) triple.
+ *
+ * \effects
+ * Lines are read from the file until an entry is found.  Section names,
+ * keys, and values are copied into dynamically allocated memory pointed to
+ * by entry.  entry's memory is freed when there are no more entries or an
+ * error occurs.
+ *
+ * \returns 1 when an entry is found\n
+ *          0 when no more entries can be found\n
+ *         -1 for an error.  Error type is contained in errno.
+ */
+static int GetEntry(ini_reader_t *reader, ini_entry_t *entry)
+{
+    ini_entry_view_t parsed;
+    const char *line;
+    size_t length;
+    int result;
+    int type;
+
+    /* handle section names, comments, and blank lines */
+    while ((result = ReadLine(reader, &line, &length)) > 0)
+    {
+        type = ParseLine(line, length, &parsed);
+
+        if (type < 0)
+        {
+            FreeEntry(entry);
+            return -1;
+        }
+        else if (LINE_SECTION == type)
+        {
+            Release(entry->section);
+            entry->section = DupView(&parsed.section);
+        }
+        else if (LINE_ENTRY == type)
+        {
+            break;
+        }
+    }
+
+    /* we either have a key = value line or nothing left to get */
+    if (result <= 0)
+    {
+        /* nothing left to get */
+        FreeEntry(entry);
+        return result;
+    }
+
+    Release(entry->key);       /* free old key */
+    Release(entry->value);     /* free old value */
+    entry->key = DupView(&parsed.key);
+    entry->value = DupView(&parsed.value);
+
+    return 1;
+}
+
+/**
+ * \fn static int GetEntryInto(ini_reader_t *reader,
+ *      ini_entry_buffer_t *buffer)
+ *
+ * \brief This function reads lines until it finds the next
+ * (section, key, value) triple and copies it into an entry buffer.
+ *
+ * \param reader A pointer to the reader for the INI file being parsed.
+ *
+ * \param buffer A pointer to the entry buffer receiving the triple.
+ *
+ * \effects
+ * Lines are read from the file until an entry is found.  Section names,
+ * keys, and values are copied into the buffer's memory, which grows as
+ * needed.  buffer->entry.section is set to NULL when there are no more
+ * entries or an error occurs, but the memory is kept.
+ *
+ * \returns 1 when an entry is found\n
+ *          0 when no more entries can be found\n
+ *         -1 for an error.  Error type is contained in errno.
+ */
+static int GetEntryInto(ini_reader_t *reader, ini_entry_buffer_t *buffer)
+{
+    ini_entry_view_t parsed;
+    const char *line;
+    size_t length;
+    int result;
+    int type;
+
+    /* handle section names, comments, and blank lines */
+    while ((result = ReadLine(reader, &line, &length)) > 0)
+    {
+        type = ParseLine(line, length, &parsed);
+
+        if (type < 0)
+        {
+            result = -1;
+            break;
+        }
+        else if (LINE_SECTION == type)
+        {
+            if (0 != CopyView(&(buffer->section), &(buffer->sectionSize),
+                &parsed.section))
+            {
+                result = -1;
+                break;
+            }
+
+            buffer->entry.section = buffer->section;
+        }
+        else if (LINE_ENTRY == type)
+        {
+            break;
+        }
+    }
+
+    if ((result > 0) &&
+        ((0 != CopyView(&(buffer->entry.key), &(buffer->keySize),
+            &parsed.key)) ||
+        (0 != CopyView(&(buffer->entry.value), &(buffer->valueSize),
+            &parsed.value))))
+    {
+        result = -1;
+    }
+
+    if (result <= 0)
+    {
+        /* the next file starts outside of any section */
+        buffer->entry.section = NULL;
+    }
+
+    return result;
+}
+
+/**
+ * \fn static int CopyView(char **dest, size_t *size, const ini_view_t *src)
+ *
+ * \brief This function copies a string view into a growable buffer as a
+ * NULL terminated string.
+ *
+ * \param dest A pointer to the buffer.  It may point to NULL.
+ *
+ * \param size A pointer to the size of the buffer.
+ *
+ * \param src A pointer to the view being copied.
+ *
+ * \effects The buffer is grown if the string doesn't fit.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ */
+static int CopyView(char **dest, size_t *size, const ini_view_t *src)
+{
+    if (0 != GrowBuffer(dest, size, src->length + 1))
+    {
+        return -1;
+    }
+
+    memcpy(*dest, src->str, src->length);
+    (*dest)[src->length] = '\0';
+    return 0;
+}
+
+/**
+ * \fn static int ParseLine(const char *line, size_t length,
+ *      ini_entry_view_t *parsed)
+ *
+ * \brief This function parses a single line of an INI file.
+ *
+ * \param line A pointer to the line being parsed.  It does not need to be
+ * NULL terminated and should not include the trailing '\\n'.
+ *
+ * \param length The number of characters in line.
+ *
+ * \param parsed A pointer to the entry view that will point to the parts of
+ * the line that were found.  parsed->section is set for section lines,
+ * parsed->key and parsed->value are set for key = value lines.
+ *
+ * \effects None
+ *
+ * \returns LINE_BLANK for blank and comment lines\n
+ *          LINE_SECTION for [section] lines\n
+ *          LINE_ENTRY for key = value lines\n
+ *         -1 for a malformed line.  errno is set to EILSEQ.
+ *
+ * Leading white space is ignored.  Lines starting with ';' or '#' are
+ * comments.  Section names are the characters between '[' and the first ']'
+ * with surrounding white space trimmed, so "[ ]" names the same section as
+ * "[]" and text following the ']' is ignored.  Keys are the characters
+ * before the first '=' (excluding the key's first character) with trailing
+ * white space trimmed.  Values are the characters after the '=' with
+ * leading spaces and tabs and trailing white space trimmed.
+ */
+static int ParseLine(const char *line, size_t length,
+    ini_entry_view_t *parsed)
+{
+    return ParseLineAt(line, length, NULL, parsed);
+}
+
+/**
+ * \fn static int ParseLineAt(const char *line, size_t length,
+ *      const char *equals, ini_entry_view_t *parsed)
+ *
+ * \brief This function parses a single line of an INI file when the
+ * location of its first '=' may already be known.
+ *
+ * \param line A pointer to the line being parsed.  It does not need to be
+ * NULL terminated and should not include the trailing '\\n'.
+ *
+ * \param length The number of characters in line.
+ *
+ * \param equals A pointer to the first '=' in line, line + length if line
+ * has no '=', or NULL if line hasn't been searched for '='.
+ *
+ * \param parsed A pointer to the entry view that will point to the parts of
+ * the line that were found.
+ *
+ * \effects None
+ *
+ * \returns The same values as ParseLine.
+ *
+ * See ParseLine for the line format.  Passing the result of SplitLine as
+ * equals saves searching the key a second time.
+ */
+static int ParseLineAt(const char *line, size_t length, const char *equals,
+    ini_entry_view_t *parsed)
+{
+    const char *ptr;
+    const char *end;
+    const char *found;
+
+    COUNT(STAT_LINES, 1);
+    COUNT(STAT_BYTES, length);
+    ptr = line;
+    end = line + length;
+
+    /* skip leading spaces and blank lines */
+    while ((ptr < end) && isspace((unsigned char)*ptr))
+    {
+        ptr++;
+    }
+
+    /* skip blank lines and lines starting with ';' or '#' */
+    if ((ptr == end) || (*ptr == ';') || (*ptr == '#'))
+    {
+        return LINE_BLANK;
+    }
+
+    if (*ptr == '[')
+    {
+        /* possible new section */
+        found = scanKernel(ptr, end, ']', ']');
+
+        if (found == end)
+        {
+            errno = EILSEQ;
+            return -1;
+        }
+
+        /* we have the full string for a new section, trim white space */
+        ptr++;
+
+        while ((ptr < found) && isspace((unsigned char)*ptr))
+        {
+            ptr++;
+        }
+
+        while ((found > ptr) && isspace((unsigned char)*(found - 1)))
+        {
+            found--;
+        }
+
+        parsed->section.str = ptr;
+        parsed->section.length = found - ptr;
+        return LINE_SECTION;
+    }
+
+    /* the only other allowable lines are of the form key = value */
+    if ((NULL != equals) && (equals > ptr))
+    {
+        found = equals;     /* SplitLine found it */
+    }
+    else
+    {
+        found = scanKernel(ptr + 1, end, '=', '=');
+    }
+
+    if (found == end)
+    {
+        /* didn't find '=' */
+        errno = EILSEQ;
+        return -1;
+    }
+
+    /* we found the '=' separating key and value trim white space */
+    parsed->key.str = ptr;
+    ptr = found;
+
+    while (isspace((unsigned char)*(ptr - 1)))
+    {
+        ptr--;
+    }
+
+    parsed->key.length = ptr - parsed->key.str;
+
+    /* now skip white space after '=' */
+    ptr = found + 1;
+
+    while ((ptr < end) && ((*ptr == ' ') || (*ptr == '\t')))
+    {
+        ptr++;
+    }
+
+    /* we found the start of value, trim trailing white space */
+    while ((end > ptr) && isspace((unsigned char)*(end - 1)))
+    {
+        end--;
+    }
+
+    parsed->value.str = ptr;
+    parsed->value.length = end - ptr;
+    COUNT(STAT_ENTRIES, 1);
+    return LINE_ENTRY;
+}
+
+/**
+ * \fn static const char *SplitLine(const char *line, const char *end,
+ *      const char **equals)
+ *
+ * \brief This function finds the end of a line and the first '=' in it.
+ *
+ * \param line A pointer to the start of the line.
+ *
+ * \param end A pointer to the end of the text containing the line.
+ *
+ * \param equals Set to point to the first '=' in the line, or to the end of
+ * the line if there is none.
+ *
+ * \effects None
+ *
+ * \returns A pointer to the '\\n' ending the line, or end if the line isn't
+ * terminated.
+ *
+ * The line is scanned for '\\n' and '=' at the same time by the split
+ * kernel, so the key of a key = value line is only searched once.  Pass
+ * equals to ParseLineAt.
+ */
+static const char *SplitLine(const char *line, const char *end,
+    const char **equals)
+{
+    return splitKernel(line, end, equals);
+}
+
+/**
+ * \fn static const char *ScanAuto(const char *ptr, const char *end, int c1,
+ *      int c2)
+ *
+ * \brief This is the scan kernel used before one has been chosen.  It
+ * chooses the best kernel for the CPU, then uses it.
+ *
+ * \param ptr A pointer to the first character to be searched.
+ *
+ * \param end A pointer to the end of the characters to be searched.
+ *
+ * \param c1 A character being searched for.
+ *
+ * \param c2 Another character being searched for.  May be the same as c1.
+ *
+ * \effects scanKernel is set to the best supported kernel.
+ *
+ * \returns A pointer to the first c1 or c2 in [ptr, end), or end.
+ */
+static const char *ScanAuto(const char *ptr, const char *end, int c1, int c2)
+{
+    SetScanKernel(INI_SCAN_AUTO);
+    return scanKernel(ptr, end, c1, c2);
+}
+
+/**
+ * \fn static const char *SplitAuto(const char *line, const char *end,
+ *      const char **equals)
+ *
+ * \brief This is the split kernel used before one has been chosen.  It
+ * chooses the best kernels for the CPU, then uses the split kernel.
+ *
+ * \param line A pointer to the start of the line.
+ *
+ * \param end A pointer to the end of the text containing the line.
+ *
+ * \param equals Set as described in SplitLine.
+ *
+ * \effects scanKernel and splitKernel are set to the best supported
+ * kernels.
+ *
+ * \returns A pointer to the '\\n' ending the line, or end.
+ */
+static const char *SplitAuto(const char *line, const char *end,
+    const char **equals)
+{
+    SetScanKernel(INI_SCAN_AUTO);
+    return splitKernel(line, end, equals);
+}
+
+/**
+ * \fn static const char *ScanScalar(const char *ptr, const char *end,
+ *      int c1, int c2)
+ *
+ * \brief This is the portable scan kernel.  It tests a machine word of
+ * characters at a time.
+ *
+ * \param ptr A pointer to the first character to be searched.
+ *
+ * \param end A pointer to the end of the characters to be searched.
+ *
+ * \param c1 A character being searched for.
+ *
+ * \param c2 Another character being searched for.  May be the same as c1.
+ *
+ * \effects None
+ *
+ * \returns A pointer to the first c1 or c2 in [ptr, end), or end.
+ *
+ * A word contains a match if (x - 0x01..01) & ~x & 0x80..80 is non-zero,
+ * where x is the word XORed with the character repeated in every byte.
+ */
+static const char *ScanScalar(const char *ptr, const char *end, int c1,
+    int c2)
+{
+    unsigned long ones;
+    unsigned long highs;
+    unsigned long pattern1;
+    unsigned long pattern2;
+    unsigned long word;
+    unsigned long x1;
+    unsigned long x2;
+
+    if (c1 == c2)
+    {
+        /* the C library is good at this */
+        const char *found;
+
+        found = (const char *)memchr(ptr, c1, end - ptr);
+        return (NULL == found) ? end : found;
+    }
+
+    ones = ((unsigned long)-1) / 0xFF;
+    highs = ones << 7;
+    pattern1 = ones * (unsigned char)c1;
+    pattern2 = ones * (unsigned char)c2;
+
+    while ((size_t)(end - ptr) >= sizeof(unsigned long))
+    {
+        memcpy(&word, ptr, sizeof(unsigned long));
+        x1 = word ^ pattern1;
+        x2 = word ^ pattern2;
+
+        if ((((x1 - ones) & ~x1) | ((x2 - ones) & ~x2)) & highs)
+        {
+            break;      /* match is in this word */
+        }
+
+        ptr += sizeof(unsigned long);
+    }
+
+    while ((ptr < end) && ((unsigned char)*ptr != (unsigned char)c1) &&
+        ((unsigned char)*ptr != (unsigned char)c2))
+    {
+        ptr++;
+    }
+
+    return ptr;
+}
+
+/**
+ * \fn static const char *SplitScalar(const char *line, const char *end,
+ *      const char **equals)
+ *
+ * \brief This is the portable split kernel.
+ *
+ * \param line A pointer to the start of the line.
+ *
+ * \param end A pointer to the end of the text containing the line.
+ *
+ * \param equals Set as described in SplitLine.
+ *
+ * \effects None
+ *
+ * \returns A pointer to the '\\n' ending the line, or end.
+ *
+ * ScanScalar finds the first '\\n' or '='.  If it's an '=', the rest of
+ * the line is searched for '\\n' by memchr.
+ */
+static const char *SplitScalar(const char *line, const char *end,
+    const char **equals)
+{
+    const char *found;
+
+    found = ScanScalar(line, end, '\n', '=');
+    *equals = found;
+
+    if ((found < end) && ('=' == *found))
+    {
+        found = ScanScalar(found + 1, end, '\n', '\n');
+    }
+
+    return found;
+}
+
+/**
+ * \fn static const char *SplitTail(const char *ptr, const char *end,
+ *      const char *found, const char **equals)
+ *
+ * \brief This function finishes splitting a line a character at a time.
+ * The vector split kernels use it for the last few characters of the text.
+ *
+ * \param ptr A pointer to the first character that hasn't been searched.
+ *
+ * \param end A pointer to the end of the text containing the line.
+ *
+ * \param found A pointer to the first '=' in the line if it has already
+ * been found, otherwise NULL.
+ *
+ * \param equals Set as described in SplitLine.
+ *
+ * \effects None
+ *
+ * \returns A pointer to the '\\n' ending the line, or end.
+ */
+static const char *SplitTail(const char *ptr, const char *end,
+    const char *found, const char **equals)
+{
+    while ((ptr < end) && ('\n' != *ptr))
+    {
+        if ((NULL == found) && ('=' == *ptr))
+        {
+            found = ptr;
+        }
+
+        ptr++;
+    }
+
+    *equals = (NULL == found) ? ptr : found;
+    return ptr;
+}
+
+#ifdef EZINI_X86_SIMD
+/**
+ * \fn static const char *ScanSSE2(const char *ptr, const char *end,
+ *      int c1, int c2)
+ *
+ * \brief This is the SSE2 scan kernel.  It tests 16 characters at a time.
+ *
+ * \param ptr A pointer to the first character to be searched.
+ *
+ * \param end A pointer to the end of the characters to be searched.
+ *
+ * \param c1 A character being searched for.
+ *
+ * \param c2 Another character being searched for.  May be the same as c1.
+ *
+ * \effects None
+ *
+ * \returns A pointer to the first c1 or c2 in [ptr, end), or end.
+ *
+ * Fewer than 16 characters at the end are handled by ScanScalar.
+ */
+__attribute__((target("sse2")))
+static const char *ScanSSE2(const char *ptr, const char *end, int c1,
+    int c2)
+{
+    __m128i v1;
+    __m128i v2;
+    __m128i data;
+    int mask;
+
+    v1 = _mm_set1_epi8((char)c1);
+    v2 = _mm_set1_epi8((char)c2);
+
+    while (end - ptr >= 16)
+    {
+        data = _mm_loadu_si128((const __m128i *)ptr);
+        mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(data, v1),
+            _mm_cmpeq_epi8(data, v2)));
+
+        if (0 != mask)
+        {
+            return ptr + __builtin_ctz((unsigned int)mask);
+        }
+
+        ptr += 16;
+    }
+
+    return ScanScalar(ptr, end, c1, c2);
+}
+
+/**
+ * \fn static const char *SplitSSE2(const char *line, const char *end,
+ *      const char **equals)
+ *
+ * \brief This is the SSE2 split kernel.  It finds '\\n' and '=' in 16
+ * characters at a time.
+ *
+ * \param line A pointer to the start of the line.
+ *
+ * \param end A pointer to the end of the text containing the line.
+ *
+ * \param equals Set as described in SplitLine.
+ *
+ * \effects None
+ *
+ * \returns A pointer to the '\\n' ending the line, or end.
+ *
+ * Both characters are tested in a single pass.  Bits for '=' characters
+ * after the first '\\n' in a block are masked off with nl ^ (nl - 1).
+ */
+__attribute__((target("sse2")))
+static const char *SplitSSE2(const char *line, const char *end,
+    const char **equals)
+{
+    __m128i newline;
+    __m128i equal;
+    __m128i data;
+    unsigned int nl;
+    unsigned int eq;
+    const char *found;
+
+    newline = _mm_set1_epi8('\n');
+    equal = _mm_set1_epi8('=');
+    found = NULL;
+
+    while (end - line >= 16)
+    {
+        data = _mm_loadu_si128((const __m128i *)line);
+        nl = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(data, newline));
+
+        if (NULL == found)
+        {
+            eq = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(data, equal));
+            eq &= nl ^ (nl - 1);        /* only those before the '\n' */
+
+            if (0 != eq)
+            {
+                found = line + __builtin_ctz(eq);
+            }
+        }
+
+        if (0 != nl)
+        {
+            line += __builtin_ctz(nl);
+            *equals = (NULL == found) ? line : found;
+            return line;
+        }
+
+        line += 16;
+    }
+
+    return SplitTail(line, end, found, equals);
+}
+
+/**
+ * \fn static const char *ScanAVX2(const char *ptr, const char *end,
+ *      int c1, int c2)
+ *
+ * \brief This is the AVX2 scan kernel.  It tests 32 characters at a time.
+ *
+ * \param ptr A pointer to the first character to be searched.
+ *
+ * \param end A pointer to the end of the characters to be searched.
+ *
+ * \param c1 A character being searched for.
+ *
+ * \param c2 Another character being searched for.  May be the same as c1.
+ *
+ * \effects None
+ *
+ * \returns A pointer to the first c1 or c2 in [ptr, end), or end.
+ *
+ * Fewer than 32 characters at the end are handled by ScanSSE2.
+ */
+__attribute__((target("avx2")))
+static const char *ScanAVX2(const char *ptr, const char *end, int c1,
+    int c2)
+{
+    __m256i v1;
+    __m256i v2;
+    __m256i data;
+    int mask;
+
+    v1 = _mm256_set1_epi8((char)c1);
+    v2 = _mm256_set1_epi8((char)c2);
+
+    while (end - ptr >= 32)
+    {
+        data = _mm256_loadu_si256((const __m256i *)ptr);
+        mask = _mm256_movemask_epi8(_mm256_or_si256(
+            _mm256_cmpeq_epi8(data, v1), _mm256_cmpeq_epi8(data, v2)));
+
+        if (0 != mask)
+        {
+            return ptr + __builtin_ctz((unsigned int)mask);
+        }
+
+        ptr += 32;
+    }
+
+    return ScanSSE2(ptr, end, c1, c2);
+}
+
+/**
+ * \fn static const char *SplitAVX2(const char *line, const char *end,
+ *      const char **equals)
+ *
+ * \brief This is the AVX2 split kernel.  It finds '\\n' and '=' in 32
+ * characters at a time.
+ *
+ * \param line A pointer to the start of the line.
+ *
+ * \param end A pointer to the end of the text containing the line.
+ *
+ * \param equals Set as described in SplitLine.
+ *
+ * \effects None
+ *
+ * \returns A pointer to the '\\n' ending the line, or end.
+ *
+ * This works the same way as SplitSSE2 with twice the width.
+ */
+__attribute__((target("avx2")))
+static const char *SplitAVX2(const char *line, const char *end,
+    const char **equals)
+{
+    __m256i newline;
+    __m256i equal;
+    __m256i data;
+    unsigned int nl;
+    unsigned int eq;
+    const char *found;
+
+    newline = _mm256_set1_epi8('\n');
+    equal = _mm256_set1_epi8('=');
+    found = NULL;
+
+    while (end - line >= 32)
+    {
+        data = _mm256_loadu_si256((const __m256i *)line);
+        nl = (unsigned int)_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(data, newline));
+
+        if (NULL == found)
+        {
+            eq = (unsigned int)_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(data, equal));
+            eq &= nl ^ (nl - 1);        /* only those before the '\n' */
+
+            if (0 != eq)
+            {
+                found = line + __builtin_ctz(eq);
+            }
+        }
+
+        if (0 != nl)
+        {
+            line += __builtin_ctz(nl);
+            *equals = (NULL == found) ? line : found;
+            return line;
+        }
+
+        line += 32;
+    }
+
+    return SplitTail(line, end, found, equals);
+}
+#endif
+
+/**
+ * \fn static char *DupView(const ini_view_t *view)
+ *
+ * \brief This function returns a NULL terminated copy of the string view
+ * passed as a parameter.
+ *
+ * \param view A pointer to the view being being copied.
+ *
+ * \effects Memory is dynamically allocated to hold a copy of the view.
+ *
+ * \returns A copy of the view in malloced memory is returned on success.
+ * NULL is returned on failure.
+ */
+static char *DupView(const ini_view_t *view)
+{
+    char *dest;
+
+    dest = (char *)Allocate(view->length + 1);
+
+    if (NULL != dest)
+    {
+        memcpy(dest, view->str, view->length);
+        dest[view->length] = '\0';
+    }
+
+    return dest;
+}
+
+/**
+ * \fn static int SerializeList(ini_serializer_t *out,
+ *      const ini_section_list_t *list)
+ *
+ * \brief This function serializes the entries of an entry list as INI file
+ * text.
+ *
+ * \param out A pointer to the serializer receiving the text.
+ *
+ * \param list A pointer to the entry list being serialized.
+ *
+ * \effects The text is added to out's buffer, which is passed to out's
+ * writer whenever it fills.
+ *
+ * \returns 0 for success, Non-zero on error.
+ */
+static int SerializeList(ini_serializer_t *out,
+    const ini_section_list_t *list)
+{
+    const ini_section_t *section;
+    const ini_key_list_t *member;
+    int result;
+
+    result = 0;
+
+    for (section = list->first; (0 == result) && (NULL != section);
+        section = section->next)
+    {
+        if ((0 != (result = Emit(out, "[", 1))) ||
+            (0 != (result = Emit(out, section->section, section->length))) ||
+            (0 != (result = Emit(out, "]\n", 2))))
+        {
+            break;
+        }
+
+        for (member = section->members; NULL != member; member = member->next)
+        {
+            if ((0 != (result = Emit(out, member->key, member->keyLength))) ||
+                (0 != (result = Emit(out, " = ", 3))) ||
+                (0 != (result = Emit(out, member->value,
+                    member->valueLength))) ||
+                (0 != (result = Emit(out, "\n", 1))))
+            {
+                break;
+            }
+        }
+
+        if (0 == result)
+        {
+            result = Emit(out, "\n", 1);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * \fn static int Emit(ini_serializer_t *out, const char *str,
+ *      size_t length)
+ *
+ * \brief This function adds a string to a serializer's buffer.
+ *
+ * \param out A pointer to the serializer receiving the string.
+ *
+ * \param str The string being added.  It does not need to be NULL
+ * terminated.
+ *
+ * \param length The number of characters in str.
+ *
+ * \effects
+ * The string is copied into the buffer.  If it doesn't fit the buffer is
+ * flushed first, and strings that are bigger than the buffer are passed to
+ * the writer without being copied.
+ *
+ * \returns 0 for success, Non-zero on error.
+ */
+static int Emit(ini_serializer_t *out, const char *str, size_t length)
+{
+    int result;
+
+    if (length > out->size - out->used)
+    {
+        if (0 != (result = FlushSerializer(out)))
+        {
+            return result;
+        }
+
+        if (length > out->size)
+        {
+            return out->writer(str, length, out->user);
+        }
+    }
+
+    memcpy(out->data + out->used, str, length);
+    out->used += length;
+    return 0;
+}
+
+/**
+ * \fn static int FlushSerializer(ini_serializer_t *out)
+ *
+ * \brief This function passes the contents of a serializer's buffer to its
+ * writer.
+ *
+ * \param out A pointer to the serializer being flushed.
+ *
+ * \effects The buffer is emptied.
+ *
+ * \returns 0 for success, Non-zero on error.
+ */
+static int FlushSerializer(ini_serializer_t *out)
+{
+    int result;
+
+    if (0 == out->used)
+    {
+        return 0;
+    }
+
+    if (NULL == out->writer)
+    {
+        errno = ERANGE;     /* buffer was sized too small */
+        return -1;
+    }
+
+    result = out->writer(out->data, out->used, out->user);
+    out->used = 0;
+    return result;
+}
+
+/**
+ * \fn static int WriteToFile(const char *data, size_t length, void *user)
+ *
+ * \brief This is the ini_writer_t used to write serialized text to a file.
+ *
+ * \param data The text to be written.
+ *
+ * \param length The number of characters in data.
+ *
+ * \param user A pointer to the FILE being written.
+ *
+ * \effects The text is written to the file.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ */
+static int WriteToFile(const char *data, size_t length, void *user)
+{
+    COUNT(STAT_WRITES, 1);
+
+    if (fwrite(data, 1, length, (FILE *)user) != length)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * \fn static int OpenOutput(ini_output_t *out, const char *iniFile,
+ *      int mode)
+ *
+ * \brief This function opens a file that will replace an INI file.
+ *
+ * \param out A pointer to the output structure being opened.
+ *
+ * \param iniFile The name of the INI file being written.
+ *
+ * \param mode The INI_WRITE_... flags to write the file with (usually
+ * writeMode), plus WRITE_BINARY if the file isn't text.
+ *
+ * \effects
+ * In atomic write mode a new, uniquely named file is created in the same
+ * directory as iniFile.  Otherwise iniFile is opened and truncated.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ *
+ * The file must be closed with CloseOutput.
+ */
+static int OpenOutput(ini_output_t *out, const char *iniFile, int mode)
+{
+    static unsigned long tempCount = 0;
+    int tries;
+
+    out->iniFile = iniFile;
+    out->tempName = NULL;
+    out->mode = mode;
+
+    if (!(mode & INI_WRITE_ATOMIC))
+    {
+        out->fp = fopen(iniFile, (mode & WRITE_BINARY) ? "wb" : "w");
+        return (NULL == out->fp) ? -1 : 0;
+    }
+
+    /* room for iniFile.<pid>.<count>.tmp */
+    out->tempName = (char *)Allocate(strlen(iniFile) + 64);
+
+    if (NULL == out->tempName)
+    {
+        return -1;
+    }
+
+    out->fp = NULL;
+
+    for (tries = 0; (NULL == out->fp) && (tries < 100); tries++)
+    {
+#ifdef EZINI_POSIX
+        struct stat status;
+        int fd;
+
+        sprintf(out->tempName, "%s.%lu.%lu.tmp", iniFile,
+            (unsigned long)getpid(), tempCount++);
+        fd = open(out->tempName, O_WRONLY | O_CREAT | O_EXCL, 0666);
+
+        if (fd < 0)
+        {
+            if (EEXIST == errno)
+            {
+                continue;
+            }
+
+            break;
+        }
+
+        if (0 == stat(iniFile, &status))
+        {
+            /* keep the original's permissions */
+            fchmod(fd, status.st_mode & 07777);
+        }
+
+        out->fp = fdopen(fd, (mode & WRITE_BINARY) ? "wb" : "w");
+
+        if (NULL == out->fp)
+        {
+            close(fd);
+            remove(out->tempName);
+            break;
+        }
+#else
+        FILE *fp;
+
+        sprintf(out->tempName, "%s.%lu.tmp", iniFile, tempCount++);
+        fp = fopen(out->tempName, "r");
+
+        if (NULL != fp)
+        {
+            fclose(fp);         /* name is in use */
+            continue;
+        }
+
+        out->fp = fopen(out->tempName, (mode & WRITE_BINARY) ? "wb" : "w");
+
+        if (NULL == out->fp)
+        {
+            break;
+        }
+#endif
+    }
+
+    if (NULL == out->fp)
+    {
+        Release(out->tempName);
+        out->tempName = NULL;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * \fn static int CloseOutput(ini_output_t *out, int failed)
+ *
+ * \brief This function closes a file opened by OpenOutput and, in atomic
+ * write mode, replaces the INI file with it.
+ *
+ * \param out A pointer to the output structure being closed.
+ *
+ * \param failed Non-zero if writing the file failed.
+ *
+ * \effects
+ * The file is synced and closed as required by the write mode.  A
+ * temporary file is renamed over the INI file if everything succeeded and
+ * removed if anything failed.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ */
+static int CloseOutput(ini_output_t *out, int failed)
+{
+    int result;
+    int error;
+
+    result = (failed || ferror(out->fp)) ? -1 : 0;
+
+    if ((0 == result) && (out->mode & INI_WRITE_SYNC))
+    {
+        result = SyncFile(out->fp);
+    }
+
+    if (0 != fclose(out->fp))
+    {
+        result = -1;
+    }
+
+    if (NULL == out->tempName)
+    {
+        return result;
+    }
+
+    if (0 == result)
+    {
+#ifndef EZINI_POSIX
+        /* rename may not replace an existing file */
+        remove(out->iniFile);
+#endif
+        result = rename(out->tempName, out->iniFile);
+    }
+
+    if (0 != result)
+    {
+        error = errno;
+        remove(out->tempName);
+        errno = error;
+    }
+    else if (out->mode & INI_WRITE_SYNC_DIR)
+    {
+        result = SyncDirectory(out->iniFile);
+    }
+
+    Release(out->tempName);
+    out->tempName = NULL;
+    return result;
+}
+
+/**
+ * \fn static int SyncFile(FILE *fp)
+ *
+ * \brief This function flushes a file to disk and adds the time taken to
+ * the sync statistics.
+ *
+ * \param fp A pointer to the file being synced.  It must be open for
+ * writing.
+ *
+ * \effects The file's buffers are flushed and, on POSIX systems, the file
+ * is synced with fsync.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ */
+static int SyncFile(FILE *fp)
+{
+#ifdef EZINI_POSIX
+    double start;
+#endif
+    int result;
+
+#ifdef EZINI_POSIX
+    start = Now();
+#endif
+    result = fflush(fp);
+
+#ifdef EZINI_POSIX
+    /* only a real fsync is counted */
+    if (0 == result)
+    {
+        result = fsync(fileno(fp));
+        AddSync(Now() - start);
+    }
+#endif
+
+    return result;
+}
+
+/**
+ * \fn static int SyncDirectory(const char *path)
+ *
+ * \brief This function flushes the directory containing a file to disk and
+ * adds the time taken to the sync statistics.
+ *
+ * \param path The name of a file in the directory being synced.
+ *
+ * \effects On POSIX systems the directory is synced with fsync.  Nothing is
+ * done on other systems.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ */
+static int SyncDirectory(const char *path)
+{
+#ifdef EZINI_POSIX
+    const char *slash;
+    char *dir;
+    double start;
+    int fd;
+    int result;
+
+    slash = strrchr(path, '/');
+
+    if (NULL == slash)
+    {
+        dir = (char *)Allocate(2);
+
+        if (NULL != dir)
+        {
+            strcpy(dir, ".");
+        }
+    }
+    else
+    {
+        ini_view_t view;
+
+        view.str = path;
+        view.length = (slash == path) ? 1 : (size_t)(slash - path);
+        dir = DupView(&view);
+    }
+
+    if (NULL == dir)
+    {
+        return -1;
+    }
+
+    start = Now();
+    fd = open(dir, O_RDONLY);
+    Release(dir);
+
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    result = fsync(fd);
+    close(fd);
+    AddSync(Now() - start);
+    return result;
+#else
+    (void)path;
+    return 0;
+#endif
+}
+
+#ifdef EZINI_POSIX
+/**
+ * \fn static void AddSync(double seconds)
+ *
+ * \brief This function adds an fsync call to the sync statistics.
+ *
+ * \param seconds The time taken by the call.
+ *
+ * \effects The sync count and time are updated under syncLock, so threads
+ * writing different files don't lose each other's updates.
+ *
+ * \returns Nothing
+ */
+static void AddSync(double seconds)
+{
+    pthread_mutex_lock(&syncLock);
+    syncCount++;
+    syncSeconds += seconds;
+    pthread_mutex_unlock(&syncLock);
+}
+#endif
+
+/**
+ * \fn static double Now(void)
+ *
+ * \brief This function reads a clock used to time operations.
+ *
+ * \effects None
+ *
+ * \returns The current time in seconds.  Only differences between times
+ * are meaningful.
+ */
+static double Now(void)
+{
+#if defined(EZINI_POSIX) && defined(CLOCK_MONOTONIC)
+    struct timespec now;
+
+    if (0 == clock_gettime(CLOCK_MONOTONIC, &now))
+    {
+        return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+    }
+#endif
+
+    return (double)clock() / CLOCKS_PER_SEC;
+}
+
+#ifdef EZINI_STATS
+/**
+ * \fn static void CountStat(stat_counter_t counter, unsigned long n)
+ *
+ * \brief This function adds to one of the statistics counters.
+ *
+ * \param counter The counter.
+ *
+ * \param n The amount to add.
+ *
+ * \effects The counter in this thread's statistics block is increased.
+ *
+ * \returns Nothing
+ */
+static void CountStat(stat_counter_t counter, unsigned long n)
+{
+#ifdef THREAD_STATS
+    ini_stats_block_t *block;
+
+    /* COUNT only calls this before the thread has a block */
+    block = GetStatsBlock();
+
+    if (NULL == block)
+    {
+        return;
+    }
+
+    STORE_RELAXED(&(block->counts[counter]),
+        LOAD_RELAXED(&(block->counts[counter])) + n);
+#else
+    ADD_RELAXED(&(sharedStats.counts[counter]), n);
+#endif
+}
+
+/**
+ * \fn static void AddCallTime(stat_timer_t timer, double seconds)
+ *
+ * \brief This function adds a timed call to the statistics.
+ *
+ * \param timer The function that was called.
+ *
+ * \param seconds The time the call took.
+ *
+ * \effects The function's call count and total time are increased.
+ *
+ * \returns Nothing
+ */
+static void AddCallTime(stat_timer_t timer, double seconds)
+{
+#ifdef THREAD_STATS
+    ini_stats_block_t *block;
+
+    block = threadStats;
+
+    if ((NULL == block) && (NULL == (block = GetStatsBlock())))
+    {
+        return;
+    }
+
+    seconds += block->seconds[timer];
+    __atomic_store(&(block->seconds[timer]), &seconds, __ATOMIC_RELAXED);
+    STORE_RELAXED(&(block->calls[timer]),
+        LOAD_RELAXED(&(block->calls[timer])) + 1);
+#else
+    /* time may be lost if threads race without THREAD_STATS */
+    sharedStats.seconds[timer] += seconds;
+    ADD_RELAXED(&(sharedStats.calls[timer]), 1UL);
+#endif
+}
+
+/**
+ * \fn static void SumStats(ini_stats_block_t *totals)
+ *
+ * \brief This function adds up the statistics of every thread.  The caller
+ * must hold statsLock (LOCK_STATS).
+ *
+ * \param totals A pointer to the block receiving the totals.
+ *
+ * \effects totals is filled in.  Its next and released fields are not
+ * used.
+ *
+ * \returns Nothing
+ */
+static void SumStats(ini_stats_block_t *totals)
+{
+    const ini_stats_block_t *block;
+    double seconds;
+    int i;
+
+    for (i = 0; i < STAT_COUNTERS; i++)
+    {
+        totals->counts[i] = 0;
+    }
+
+    for (i = 0; i < STAT_TIMERS; i++)
+    {
+        totals->calls[i] = 0;
+        totals->seconds[i] = 0.0;
+    }
+
+#ifdef THREAD_STATS
+    for (block = statsBlocks; NULL != block; block = block->next)
+#else
+    block = &sharedStats;
+#endif
+    {
+        for (i = 0; i < STAT_COUNTERS; i++)
+        {
+            totals->counts[i] += LOAD_RELAXED(&(block->counts[i]));
+        }
+
+        for (i = 0; i < STAT_TIMERS; i++)
+        {
+            totals->calls[i] += LOAD_RELAXED(&(block->calls[i]));
+#ifdef RELAXED_ATOMICS
+            __atomic_load(&(block->seconds[i]), &seconds, __ATOMIC_RELAXED);
+#else
+            seconds = block->seconds[i];
+#endif
+            totals->seconds[i] += seconds;
+        }
+    }
+}
+
+#ifdef THREAD_STATS
+/**
+ * \fn static ini_stats_block_t *GetStatsBlock(void)
+ *
+ * \brief This function gives the calling thread a statistics block.
+ *
+ * \effects
+ * The block of a thread that has exited is reused, or a new block is
+ * allocated and added to statsBlocks.  threadStats is set to the block.
+ *
+ * \returns A pointer to the block, or NULL if memory couldn't be
+ * allocated.  The thread's statistics aren't counted until it can be.
+ *
+ * Blocks are never freed, so the counts of threads that have exited are
+ * still reported.  They are allocated with calloc rather than Allocate
+ * because they aren't part of any list or document.
+ */
+static ini_stats_block_t *GetStatsBlock(void)
+{
+    ini_stats_block_t *block;
+
+    pthread_once(&statsOnce, MakeStatsKey);
+    LOCK_STATS();
+
+    for (block = statsBlocks; NULL != block; block = block->next)
+    {
+        if (block->released)
+        {
+            block->released = 0;
+            break;
+        }
+    }
+
+    if (NULL == block)
+    {
+        block = (ini_stats_block_t *)calloc(1, sizeof(ini_stats_block_t));
+
+        if (NULL != block)
+        {
+            block->next = statsBlocks;
+            statsBlocks = block;
+        }
+    }
+
+    UNLOCK_STATS();
+
+    if (NULL != block)
+    {
+        threadStats = block;
+        pthread_setspecific(statsKey, block);
+    }
+
+    return block;
+}
+
+/**
+ * \fn static void MakeStatsKey(void)
+ *
+ * \brief This function creates the thread specific data key used to
+ * release statistics blocks when threads exit.  It is called once.
+ *
+ * \effects statsKey is created.  If it can't be, blocks aren't reused.
+ *
+ * \returns Nothing
+ */
+static void MakeStatsKey(void)
+{
+    pthread_key_create(&statsKey, ReleaseStatsBlock);
+}
+
+/**
+ * \fn static void ReleaseStatsBlock(void *block)
+ *
+ * \brief This function is called when a thread with a statistics block
+ * exits.
+ *
+ * \param block A pointer to the thread's block.
+ *
+ * \effects The block is marked so that another thread may reuse it.  Its
+ * counts are kept.
+ *
+ * \returns Nothing
+ */
+static void ReleaseStatsBlock(void *block)
+{
+    LOCK_STATS();
+    ((ini_stats_block_t *)block)->released = 1;
+    UNLOCK_STATS();
+}
+#endif
+#endif
+
+/**
+ * \fn static void *Allocate(size_t size)
+ *
+ * \brief This function allocates memory.  All of the library's
+ * allocations are made through it, AllocateZeroed, and Reallocate, and the
+ * memory is freed with Release.
+ *
+ * \param size The number of bytes to allocate.
+ *
+ * \effects Memory is allocated by the allocator set with SetINIAllocator.
+ * The allocation is counted in the statistics.
+ *
+ * \returns A pointer to the memory, or NULL on error.
+ */
+static void *Allocate(size_t size)
+{
+    COUNT(STAT_ALLOCS, 1);
+    COUNT(STAT_ALLOC_BYTES, size);
+    return currentAllocator.allocate(size, currentAllocator.user);
+}
+
+/**
+ * \fn static void *AllocateZeroed(size_t count, size_t size)
+ *
+ * \brief This function allocates memory that is set to 0.
+ *
+ * \param count The number of objects to allocate.
+ *
+ * \param size The size of each object.
+ *
+ * \effects Memory is allocated by the allocator set with SetINIAllocator
+ * and cleared.
+ *
+ * \returns A pointer to the memory, or NULL on error.
+ */
+static void *AllocateZeroed(size_t count, size_t size)
+{
+    void *ptr;
+
+    if ((0 != size) && (count > (size_t)-1 / size))
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    ptr = Allocate(count * size);
+
+    if (NULL != ptr)
+    {
+        memset(ptr, 0, count * size);
+    }
+
+    return ptr;
+}
+
+/**
+ * \fn static void *Reallocate(void *ptr, size_t size)
+ *
+ * \brief This function changes the size of allocated memory.
+ *
+ * \param ptr A pointer to the memory, or NULL.
+ *
+ * \param size The new size in bytes.
+ *
+ * \effects The memory is reallocated by the allocator set with
+ * SetINIAllocator, or allocated if ptr is NULL.  The reallocation is counted
+ * in the statistics.
+ *
+ * \returns A pointer to the memory, or NULL on error.
+ */
+static void *Reallocate(void *ptr, size_t size)
+{
+    if (NULL == ptr)
     {
-        /* add the section to the list with this key and value */
-        next->next = NewSectionList(section, key, value);
+        return Allocate(size);
     }
 
-    return 0;
+    COUNT(STAT_ALLOCS, 1);
+    COUNT(STAT_ALLOC_BYTES, size);
+    return currentAllocator.reallocate(ptr, size,
+        currentAllocator.user);
 }
 
-
 /**
- * \fn void FreeList(ini_entry_list_t list)
+ * \fn static void Release(void *ptr)
  *
- * \brief This function frees all of the members of an entry list.
+ * \brief This function frees memory allocated by Allocate, AllocateZeroed,
+ * or Reallocate.
  *
- * \param list A pointer to the head of an ini_entry_list_t
+ * \param ptr A pointer to the memory, or NULL.
  *
- * \effects
- * All of the memory allocated for all of the entries in an entry
- * list will be freed.
+ * \effects The memory is freed by the allocator set with SetINIAllocator.
  *
  * \returns Nothing
- *
- * This function uses recursion to step to the tail of the list and deletes
- * section entries on the way back up.
  */
-void FreeList(ini_entry_list_t list)
+static void Release(void *ptr)
 {
-    /* recurse to the end of the list and free everything on the way back */
-    if (list->next != NULL)
+    if (NULL != ptr)
     {
-        FreeList(list->next);
-    }
-
-    if (list->section != NULL)
-    {
-        /* free the section name */
-        free(list->section);
+        currentAllocator.release(ptr, currentAllocator.user);
     }
+}
 
-    if (list->members != NULL)
-    {
-        FreeKeyList(list->members);
-    }
+/**
+ * \fn static void *DefaultAllocate(size_t size, void *user)
+ *
+ * \brief This is the allocate function of the default allocator.
+ *
+ * \param size The number of bytes to allocate.
+ *
+ * \param user Not Used
+ *
+ * \effects Memory is allocated with malloc.
+ *
+ * \returns A pointer to the memory, or NULL on error.
+ */
+static void *DefaultAllocate(size_t size, void *user)
+{
+    (void)user;
+    return malloc(size);
+}
 
-    free(list);
+/**
+ * \fn static void *DefaultReallocate(void *ptr, size_t size, void *user)
+ *
+ * \brief This is the reallocate function of the default allocator.
+ *
+ * \param ptr A pointer to the memory.
+ *
+ * \param size The new size in bytes.
+ *
+ * \param user Not Used
+ *
+ * \effects The memory is reallocated with realloc.
+ *
+ * \returns A pointer to the memory, or NULL on error.
+ */
+static void *DefaultReallocate(void *ptr, size_t size, void *user)
+{
+    (void)user;
+    return realloc(ptr, size);
 }
 
+/**
+ * \fn static void DefaultRelease(void *ptr, void *user)
+ *
+ * \brief This is the release function of the default allocator.
+ *
+ * \param ptr A pointer to the memory.
+ *
+ * \param user Not Used
+ *
+ * \effects The memory is freed with free.
+ *
+ * \returns Nothing
+ */
+static void DefaultRelease(void *ptr, void *user)
+{
+    (void)user;
+    free(ptr);
+}
 
 /**
- * \fn int MakeINIFile(const char *iniFile, const ini_entry_list_t list)
+ * \fn static int LoadFile(const char *iniFile, char **data, size_t *size)
  *
- * \brief This function creates the specified INI file from the list of
- * entries passed as an argument.
+ * \brief This function reads an entire file into memory.
  *
- * \param iniFile The name of the INI file to be created.  stdout will be
- * used if iniFile is NULL.
+ * \param iniFile The name of the file to be read.
  *
- * \param list A pointer to a list of that will be used to construct
- * (section, key, value) entries.
+ * \param data Set to point to the file's contents.  The contents are
+ * followed by a '\0' that isn't counted in size.
  *
- * \effects
- * The specified file is created and the (section, key, value)
- * triples generated from the entry list are written to the file.  If the
- * specified file already exists, it will be overwritten.
+ * \param size Set to the number of characters in the file.
+ *
+ * \effects Memory is allocated to hold the file's contents.  The caller
+ * must free it.
  *
  * \returns 0 for success, Non-zero on error.  Error type is contained in
  * errno.
- *
- * This function creates the specified INI file from the list of entries
- * passed as an argument.  Any existing INI file with the same name in the
- * same path will be overwritten.
  */
-int MakeINIFile(const char *iniFile, const ini_entry_list_t list)
+static int LoadFile(const char *iniFile, char **data, size_t *size)
 {
-    ini_entry_list_t section;
-    ini_key_list_t *members;
     FILE *fp;
+    long length;
 
-    if (NULL == list)
+    fp = fopen(iniFile, "rb");
+
+    if (NULL == fp)
     {
-        errno = EINVAL;
         return -1;
     }
 
-    if (NULL == iniFile)
-    {
-        fp = stdout;
-    }
-    else
+    if ((0 != fseek(fp, 0, SEEK_END)) || ((length = ftell(fp)) < 0) ||
+        (0 != fseek(fp, 0, SEEK_SET)))
     {
-
-        fp = fopen(iniFile, "w");
-
-        if (NULL == fp)
-        {
-            return -1;
-        }
+        fclose(fp);
+        return -1;
     }
 
-    section = list;
+    *data = (char *)Allocate((size_t)length + 1);
 
-    while (section != NULL)
+    if (NULL == *data)
     {
-        fprintf(fp, "[%s]\n", section->section);
-
-        members = section->members;
-
-        while (members != NULL)
-        {
-            fprintf(fp, "%s = %s\n", members->key, members->value);
-            members = members->next;
-        }
-
-        fprintf(fp, "\n");
-        section = section->next;
+        fclose(fp);
+        return -1;
     }
 
-    if (fp != stdout)
+    if (fread(*data, 1, (size_t)length, fp) != (size_t)length)
     {
+        Release(*data);
         fclose(fp);
+        errno = EIO;
+        return -1;
     }
 
+    fclose(fp);
+    (*data)[length] = '\0';
+    *size = (size_t)length;
     return 0;
 }
 
-
 /**
- * \fn int AddEntryToFile(const char *iniFile, const ini_entry_list_t list)
+ * \fn static size_t SlotOf(const ini_index_t *index, const void *node,
+ *      unsigned long hash)
  *
- * \brief This function adds (section, key, value) entries in an entry list
- * to an INI file.
+ * \brief This function finds the slot holding a node in a hash index.
  *
- * \param iniFile The name of the INI file to be modified.
+ * \param index A pointer to the index containing the node.
  *
- * \param list A pointer to a list of entries to be added to the INI file.
+ * \param node A pointer to the ini_section_t or ini_key_list_t being
+ * searched for.  It must be in the index.
  *
- * \effects
- * The INI file will be re-written containing the results of adding
- * the entries in the entry list to the entries already contained in the INI
- * file.
+ * \param hash The hash the node was indexed with.
  *
- * \returns 0 for success, Non-zero on error.  Error type is contained in
- * errno.
+ * \effects None
  *
- * This function adds (section, key, value) entries in an entry list to an
- * INI file.  Section order will be maintained with new sections added to the
- * end of the INI file.  If an entry containing the same section name and key
- * already exists, the new value will overwrite the old value.
+ * \returns The number of the slot holding node.  Slot numbers are unique
+ * and less than the index size, so they may be used to keep per node data
+ * in an array without changing the nodes.
  */
-int AddEntryToFile(const char *iniFile, const ini_entry_list_t list)
+static size_t SlotOf(const ini_index_t *index, const void *node,
+    unsigned long hash)
 {
-    ini_entry_t entry;
-    ini_entry_list_t merged;
-    ini_entry_list_t here;
-    int result;
-    FILE *fp;
-
-    if (NULL == iniFile)
-    {
-        errno = EINVAL;
-        return -1;
-    }
-
-    if (NULL == list)
-    {
-        errno = EINVAL;
-        return -1;
-    }
-
-    fp = fopen(iniFile, "r");
-
-    if (NULL == fp)
-    {
-        return -1;
-    }
+    size_t i;
 
-    merged = NULL;
-    entry.section = NULL;
-    entry.key = NULL;
-    entry.value = NULL;
+    i = hash & (index->size - 1);
 
-    /* read ini file back into an entry list */
-    while ((result = GetEntryFromFile(fp, &entry)) > 0)
+    while (index->slots[i].node != node)
     {
-        AddEntryToList(&merged, entry.section, entry.key, entry.value);
+        i = (i + 1) & (index->size - 1);
     }
 
-    fclose(fp);
+    return i;
+}
 
-    if (result < 0)
-    {
-        FreeList(merged);
-        return -1;
-    }
+/**
+ * \fn static void InitEdits(ini_edits_t *edits)
+ *
+ * \brief This function initializes an empty list of edits.
+ *
+ * \param edits A pointer to the edit list being initialized.
+ *
+ * \effects edits is set to an empty list.  Nothing is allocated until the
+ * first edit is added.
+ *
+ * \returns Nothing
+ */
+static void InitEdits(ini_edits_t *edits)
+{
+    edits->edits = NULL;
+    edits->count = 0;
+    edits->size = 0;
+    edits->text = NULL;
+    edits->textLength = 0;
+    edits->textSize = 0;
+}
 
-    /* add entries passed into this function to entries from INI file */
-    here = list;
+/**
+ * \fn static int AddEdit(ini_edits_t *edits, size_t offset, size_t length,
+ *      const char *text, size_t textLength)
+ *
+ * \brief This function adds an edit to a list of edits.
+ *
+ * \param edits A pointer to the edit list being added to.
+ *
+ * \param offset The offset of the first file character being replaced.
+ *
+ * \param length The number of file characters being replaced.  Use 0 to
+ * insert text.
+ *
+ * \param text The replacement text.  It does not need to be NULL
+ * terminated.
+ *
+ * \param textLength The number of characters in text.
+ *
+ * \effects The edit list grows geometrically as needed.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ *
+ * More text may be added to the new edit with AppendEditText.
+ */
+static int AddEdit(ini_edits_t *edits, size_t offset, size_t length,
+    const char *text, size_t textLength)
+{
+    ini_edit_t *edit;
 
-    while (here != NULL)
+    if (edits->count == edits->size)
     {
-        ini_key_list_t *members;
+        size_t size;
 
-        members = here->members;
+        size = (0 == edits->size) ? MIN_INDEX_SIZE : 2 * edits->size;
+        edit = (ini_edit_t *)Reallocate(edits->edits,
+            size * sizeof(ini_edit_t));
 
-        while (members != NULL)
+        if (NULL == edit)
         {
-            AddEntryToList(&merged, here->section, members->key,
-                members->value);
-            members = members->next;
+            return -1;
         }
 
-        here = here->next;
+        edits->edits = edit;
+        edits->size = size;
     }
 
-    /* re-write INI file from merged entry list */
-    result = MakeINIFile(iniFile, merged);
-    FreeList(merged);
+    edit = &(edits->edits[edits->count]);
+    edit->offset = offset;
+    edit->length = length;
+    edit->text = edits->textLength;
+    edit->textLength = 0;
+    edit->order = edits->count;
+    edits->count++;
 
-    return result;
+    return AppendEditText(edits, text, textLength);
 }
 
 /**
- * \fn int DeleteEntryFromFile(const char *iniFile, const char *section,
- * const char *key)
+ * \fn static int AppendEditText(ini_edits_t *edits, const char *text,
+ *      size_t textLength)
  *
- * \brief This function deletes all entries from an INI file that match the
- * section and key passed as an argument.
+ * \brief This function appends text to the replacement text of the most
+ * recently added edit.
  *
- * \param iniFile The name of the INI file containing the entry to be
- * deleted.
+ * \param edits A pointer to the edit list being added to.
  *
- * \param section A pointer to a NULL terminated string containing the name
- * of the section of the entry to be deleted.
+ * \param text The text being appended.  It does not need to be NULL
+ * terminated.
  *
- * \param key A pointer to a NULL terminated string containing the name of
- * the key of the entry to be deleted.
+ * \param textLength The number of characters in text.
  *
- * \effects
- * The INI file will be re-written without any entries that match
- * the section and key to be deleted.  Empty sections will not be deleted.
+ * \effects The edit list's text buffer grows geometrically as needed.
  *
  * \returns 0 for success, Non-zero on error.  Error type is contained in
  * errno.
- *
- * This function deletes all entries from an INI file that match the section
- * and key passed as an argument.  Empty sections will not be deleted.
- *
- * \note There will never be more than one matching entry in INI files
- * created by this library.
  */
-int DeleteEntryFromFile(const char *iniFile, const char *section,
-    const char *key)
+static int AppendEditText(ini_edits_t *edits, const char *text,
+    size_t textLength)
 {
-    ini_entry_t entry;
-    ini_entry_list_t list;
-    int result;
-    FILE *fp;
-
-    if (NULL == iniFile)
-    {
-        errno = EINVAL;
-        return -1;
-    }
-
-    if (NULL == section)
-    {
-        errno = EINVAL;
-        return -1;
-    }
-
-    if (NULL == key)
+    if (0 == textLength)
     {
-        errno = EINVAL;
-        return -1;
+        return 0;
     }
 
-    fp = fopen(iniFile, "r");
-
-    if (NULL == fp)
+    if (edits->textLength + textLength > edits->textSize)
     {
-        return -1;
-    }
+        size_t size;
+        char *buffer;
 
-    list = NULL;
-    entry.section = NULL;
-    entry.key = NULL;
-    entry.value = NULL;
+        size = (0 == edits->textSize) ? MIN_LINE_SIZE : edits->textSize;
 
-    /* read ini file back into a structure */
-    while ((result = GetEntryFromFile(fp, &entry)) > 0)
-    {
-        if (0 != strcmp(entry.section, section))
+        while (size < edits->textLength + textLength)
         {
-            /* this isn't one we're supposed to delete */
-            AddEntryToList(&list, entry.section, entry.key, entry.value);
+            size *= 2;
         }
-        else if (0 != strcmp(entry.key, key))
+
+        buffer = (char *)Reallocate(edits->text, size);
+
+        if (NULL == buffer)
         {
-            /* this isn't one we're supposed to delete */
-            AddEntryToList(&list, entry.section, entry.key, entry.value);
+            return -1;
         }
+
+        edits->text = buffer;
+        edits->textSize = size;
     }
 
-    fclose(fp);
+    memcpy(edits->text + edits->textLength, text, textLength);
+    edits->textLength += textLength;
+    edits->edits[edits->count - 1].textLength += textLength;
+    return 0;
+}
 
-    if (result < 0)
+/**
+ * \fn static void FreeEdits(ini_edits_t *edits)
+ *
+ * \brief This function frees the memory used by a list of edits.
+ *
+ * \param edits A pointer to the edit list being freed.
+ *
+ * \effects The memory allocated for the edits is freed and the list is
+ * left empty.
+ *
+ * \returns Nothing
+ */
+static void FreeEdits(ini_edits_t *edits)
+{
+    Release(edits->edits);
+    Release(edits->text);
+    InitEdits(edits);
+}
+
+/**
+ * \fn static int CompareEdits(const void *a, const void *b)
+ *
+ * \brief This is the qsort comparison function used to put edits in file
+ * order.  Edits at the same offset are kept in the order they were added.
+ *
+ * \param a A pointer to an ini_edit_t.
+ *
+ * \param b A pointer to an ini_edit_t.
+ *
+ * \effects None
+ *
+ * \returns < 0, 0, or > 0 if a comes before, is, or comes after b.
+ */
+static int CompareEdits(const void *a, const void *b)
+{
+    const ini_edit_t *editA;
+    const ini_edit_t *editB;
+
+    editA = (const ini_edit_t *)a;
+    editB = (const ini_edit_t *)b;
+
+    if (editA->offset != editB->offset)
     {
-        FreeList(list);
-        return -1;
+        return (editA->offset < editB->offset) ? -1 : 1;
     }
 
-    result = MakeINIFile(iniFile, list);
-    FreeList(list);
+    if (editA->order != editB->order)
+    {
+        return (editA->order < editB->order) ? -1 : 1;
+    }
 
-    return result;
+    return 0;
 }
 
 /**
- * \fn int GetEntryFromFile(FILE *iniFile, ini_entry_t *entry)
+ * \fn static int ApplyEdits(const char *iniFile, const char *data,
+ *      size_t size, ini_edits_t *edits)
  *
- * \brief This function parses an INI file stream passed as an input,
- * searching for the next (section, key, value) triple.
+ * \brief This function applies a list of edits to a file, writing as
+ * little of the file as possible.
  *
- * \param iniFile A pointer to the INI file to be parsed.  It must be
- * opened for reading.
+ * \param iniFile The name of the file being edited.
  *
- * \param entry A pointer to the entry structure used to store the discovered
- * (section, key, value) triple.
+ * \param data A pointer to the current contents of the file.
  *
- * \effects
- * The specified file is read until it discovers an entry.
+ * \param size The number of characters in data.
  *
- * \returns 1 when an entry is found\n
- *          0 when no more entries can be found\n
- *         -1 for an error.  Error type is contained in errno.
+ * \param edits A pointer to the list of edits to be applied.  Edits may
+ * not overlap.
  *
- * This function parses an INI file stream passed as an input, searching for
- * the next (section, key, value) triple.  The resulting triple will be used
- * to populate the entry structure passed as a parameter.
+ * \effects
+ * The edits are sorted into file order and written to the file.  Edits
+ * that don't change the size of the file are written in place.  Starting
+ * with the first edit that changes the size of the file, everything that
+ * follows is rewritten.  The file is truncated if it shrinks.  In atomic
+ * write mode the edited file is written to a temporary file instead.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
  */
-int GetEntryFromFile(FILE *iniFile, ini_entry_t *entry)
+static int ApplyEdits(const char *iniFile, const char *data, size_t size,
+    ini_edits_t *edits)
 {
-    char *line;
-    char *ptr;
+    FILE *fp;
+    ini_edit_t *edit;
+    size_t i;
+    long newSize;
+    int result;
 
-    if (NULL == iniFile)
+    if (0 == edits->count)
     {
-        errno = EINVAL;
-        return -1;
+        return 0;           /* nothing to do */
     }
 
-    if (NULL == entry)
-    {
-        errno = EINVAL;
-        return -1;
-    }
+    qsort(edits->edits, edits->count, sizeof(ini_edit_t), CompareEdits);
 
-    /* handle section names, comments, and blank lines */
-    while ((line = GetLine(iniFile)) != NULL)
+    if (writeMode & INI_WRITE_ATOMIC)
     {
-        /* skip leading spaces and blank lines */
-        ptr = SkipWS(line);
+        ini_output_t out;
 
-        /* skip blank lines and lines starting with ';' or '#' */
-        if (*ptr == '\0' || *ptr == ';' || *ptr == '#')
+        /* can't edit in place, write the whole edited file */
+        if (0 != OpenOutput(&out, iniFile, writeMode))
         {
-            free(line);
-            continue;
+            return -1;
         }
-        else if (*ptr == '[')
-        {
-            /* possible new section */
-            char *end;
 
-            end = strchr(ptr, ']');
+        result = WriteEdits(out.fp, data, size, edits, 0, 0);
+        return CloseOutput(&out, result);
+    }
 
-            if (NULL == end)
-            {
-                FreeEntry(entry);
-                errno = EILSEQ;
-                return -1;
-            }
+    fp = fopen(iniFile, "r+b");
 
-            /* we have the full string for a new section, trim white space */
-            ptr = SkipWS(ptr + 1);
+    if (NULL == fp)
+    {
+        return -1;
+    }
 
-            while (isspace(*(end - 1)))
-            {
-                end--;
-            }
+    result = 0;
 
-            *end = '\0';
+    /* edits that don't change the file size are overwrites */
+    for (i = 0; i < edits->count; i++)
+    {
+        edit = &(edits->edits[i]);
 
-            free(entry->section);
-            entry->section = DupStr(ptr);
-            free(line);
-        }
-        else
+        if (edit->length != edit->textLength)
         {
-            /* this line should be key = value */
             break;
         }
-    }
 
-    /* we either have a non-section line or nothing left to get */
-    if (NULL == line)
-    {
-        /* nothing left to get */
-        FreeEntry(entry);
-        return 0;
-    }
+        /* edits->text is NULL if no edit has text */
+        if ((0 == edit->length) || (0 == memcmp(data + edit->offset,
+            edits->text + edit->text, edit->length)))
+        {
+            continue;       /* no change */
+        }
 
-    /* the only other allowable lines are of the form key = value */
-    free(entry->key);       /* free old key */
-    entry->key = ptr;
-    ptr++;
+        COUNT(STAT_WRITES, 1);
 
-    while (*ptr != '=')
-    {
-        if (*ptr == '\0')
+        if ((0 != fseek(fp, (long)edit->offset, SEEK_SET)) ||
+            (0 != WriteBytes(fp, edits->text + edit->text,
+            edit->textLength)))
         {
-            /* didn't find '=' */
-            entry->key = NULL;
-            FreeEntry(entry);
-            free(line);
-            errno = EILSEQ;
-            return -1;
+            result = -1;
+            break;
         }
-
-        ptr++;
     }
 
-    /* we found the '=' separating key and value trim white space */
-    free(entry->value);     /* free old value */
-    entry->value = ptr + 1;
-    ptr--;
-
-    while (isspace(*ptr))
+    if ((0 == result) && (i < edits->count))
     {
-        ptr--;
-    }
-
-    *(ptr + 1) = '\0';
-    entry->key = DupStr(entry->key);
+        /* rewrite everything from the first change in size on */
+        edit = &(edits->edits[i]);
 
-    ptr = entry->value;
-
-    /* now skip white space after '=' */
-    while (*ptr == ' ' || *ptr =='\t')
-    {
-        if (*ptr == '\0')
+        if (0 != fseek(fp, (long)edit->offset, SEEK_SET))
         {
-            FreeEntry(entry);
-            free(line);
-            errno = EILSEQ;
-            return -1;
+            result = -1;
+        }
+        else
+        {
+            result = WriteEdits(fp, data, size, edits, i, edit->offset);
         }
 
-        ptr++;
-    }
+        if ((0 == result) && ((newSize = ftell(fp)) < (long)size))
+        {
+            /* the file shrank, cut off the old tail */
+#ifdef EZINI_POSIX
+            if ((0 != fflush(fp)) || (0 != ftruncate(fileno(fp), newSize)))
+            {
+                result = -1;
+            }
+#else
+            /* no portable way to truncate, write a new file */
+            fclose(fp);
+            fp = fopen(iniFile, "wb");
 
-    /* we found the start of value, trim trailing white space */
-    entry->value = ptr;
-    ptr = entry->value + strlen(entry->value) - 1;
+            if (NULL == fp)
+            {
+                return -1;
+            }
 
-    while (isspace(*ptr))
+            result = WriteEdits(fp, data, size, edits, 0, 0);
+#endif
+        }
+    }
+
+    if ((0 == result) && (writeMode & INI_WRITE_SYNC))
     {
-        ptr--;
+        result = SyncFile(fp);
     }
 
-    *(ptr + 1) = '\0';
-    entry->value = DupStr(entry->value);
+    if (0 != fclose(fp))
+    {
+        result = -1;
+    }
 
-    free(line);
-    return 1;
+    return result;
 }
 
-
 /**
- * \fn ini_key_list_t *NewKeyList(const char *key, const char *value)
+ * \fn static int WriteEdits(FILE *fp, const char *data, size_t size,
+ *      const ini_edits_t *edits, size_t first, size_t from)
  *
- * \brief This function allocates memory for a new ini_key_list_t type
- * variable and populates it with the data passed as parameters
+ * \brief This function writes a file's contents with edits applied
+ * starting from a point in the file.
  *
- * \param key A pointer to a NULL terminated string containing the key name
+ * \param fp A pointer to the file being written.  It must be positioned at
+ * the output location of from.
  *
- * \param key A pointer to a NULL terminated string containing the value of
- * this key.  Use ASCII strings to represent numbers.
+ * \param data A pointer to the unedited contents of the file.
  *
- * \effects
- * Memory will be allocated for a new ini_key_list_t and copies
- * of the key and value strings passed as a parameter.  key and value are
- * copied into the appropriate fields and the next pointer is set to NULL.
+ * \param size The number of characters in data.
  *
- * \returns A pointer to the ini_key_list_t item that was allocated.  The
- * pointer will be NULL if an error occurs.
+ * \param edits A pointer to a list of edits sorted into file order.
  *
- * This function allocates memory for a new ini_key_list_t and copies
- * of the key and value strings passed as a parameter.  The next pointer
- * will be set to NULL.
+ * \param first The index of the first edit to apply.
+ *
+ * \param from The offset in data of the first character to write.  It may
+ * not be past the offset of edit first.
+ *
+ * \effects The contents of data from offset from on are written to fp
+ * with edits first and later applied.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
  */
-static ini_key_list_t *NewKeyList(const char *key, const char *value)
+static int WriteEdits(FILE *fp, const char *data, size_t size,
+    const ini_edits_t *edits, size_t first, size_t from)
 {
-    ini_key_list_t *item;
+    const ini_edit_t *edit;
+    size_t i;
 
-    item = (ini_key_list_t *)malloc(sizeof(ini_key_list_t));
+    /* text before each edit, each edit, and the text after the last */
+    COUNT(STAT_WRITES, (2 * (edits->count - first)) + 1);
 
-    if (NULL == item)
+    for (i = first; i < edits->count; i++)
     {
-        return NULL;
-    }
-
-    /* allocation succeeded copy key and value */
-    item->next = NULL;
+        edit = &(edits->edits[i]);
 
-    item->key = DupStr(key);
+        /* unchanged text before the edit, then the edit */
+        if ((0 != WriteBytes(fp, data + from, edit->offset - from)) ||
+            ((0 != edit->textLength) && (0 != WriteBytes(fp,
+            edits->text + edit->text, edit->textLength))))
+        {
+            return -1;
+        }
 
-    if (NULL == item->key)
-    {
-        free(item);
-        return NULL;
+        from = edit->offset + edit->length;
     }
 
-    item->value = DupStr(value);
+    return WriteBytes(fp, data + from, size - from);
+}
 
-    if (NULL == item->value)
+/**
+ * \fn static int WriteBytes(FILE *fp, const char *data, size_t length)
+ *
+ * \brief This function writes characters to a file.
+ *
+ * \param fp A pointer to the file being written.
+ *
+ * \param data A pointer to the characters.  It isn't used if length is 0.
+ *
+ * \param length The number of characters to write.
+ *
+ * \effects The characters are written to fp.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ *
+ * Nothing is done for 0 characters, so data may be NULL then, e.g. the text
+ * of an edit list that only deletes.
+ */
+static int WriteBytes(FILE *fp, const char *data, size_t length)
+{
+    if (0 == length)
     {
-        free(item->key);
-        free(item);
-        return NULL;
+        return 0;
     }
 
-    return item;
+    return (fwrite(data, 1, length, fp) == length) ? 0 : -1;
 }
 
-
 /**
- * \fn ini_section_list_t *NewSectionList(const char *section, const char *key,
- *      const char *value)
+ * \fn static int InitReader(ini_reader_t *reader, FILE *fp, int blocks)
  *
- * \brief This function allocates memory for a new ini_section_list_t type
- * variable and populates it with the data passed as parameters
+ * \brief This function initializes a line reader for the file passed as a
+ * parameter.
  *
- * \param section A pointer to a NULL terminated string containing the section
- * name
-
- * \param key A pointer to a NULL terminated string containing the key name
+ * \param reader A pointer to the reader being initialized.
  *
- * \param key A pointer to a NULL terminated string containing the value of
- * this key.  Use ASCII strings to represent numbers.
+ * \param fp A pointer to the file to be read.  It must be open for reading.
  *
- * \effects
- * Memory will be allocated for a new ini_section_list_t and copies
- * of the section, key, value strings passed as a parameter.  section is
- * copied to the appropriate field and a new key list items is created fo
- * the key and value strings.  The next pointer will be set to NULL.
+ * \param blocks Non-zero if the reader may read ahead of the current line
+ * in large blocks.  Zero if the file must not be read past the end of the
+ * line being returned.
  *
- * \returns A pointer to the ini_section_list_t item that was allocated.  The
- * pointer will be NULL if an error occurs.
+ * \effects Memory is allocated for the reader's buffer.
  *
- * This function allocates memory for a new ini_section_list_t and copies
- * of the section, key, value strings passed as a parameter.  A ini_key_list_t
- * is allocated for the key and value strings.  The next pointer is set to NULL.
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
  */
-static ini_section_list_t *NewSectionList(const char *section, const char *key,
-    const char *value)
+static int InitReader(ini_reader_t *reader, FILE *fp, int blocks)
 {
-    ini_section_list_t *item;
-
-    item = (ini_section_list_t *)malloc(sizeof(ini_section_list_t));
-
-    if (NULL == item)
-    {
-        return NULL;
-    }
+    size_t size;
+    char *buffer;
 
-    /* now populate item */
-    item->next = NULL;
-    item->section = DupStr(section);
+    size = blocks ? READ_BLOCK_SIZE : MIN_LINE_SIZE;
+    buffer = (char *)Allocate(size);
 
-    if (NULL == item->section)
+    if (NULL == buffer)
     {
-        free(item);
-        return NULL;
+        return -1;
     }
 
-    /* start a member list with the current key and value */
-    item->members = NewKeyList(key, value);
+    AttachReader(reader, fp, blocks, buffer, size);
+    return 0;
+}
 
-    if (NULL == item->members)
+/**
+ * \fn static int TakeSpareLine(ini_reader_t *reader, FILE *fp)
+ *
+ * \brief This function initializes a reader that reads a line at a time
+ * with the line buffer kept by an earlier call to GetEntryFromFile.
+ *
+ * \param reader A pointer to the reader being initialized.
+ *
+ * \param fp A pointer to the file to be read.  It must be open for reading.
+ *
+ * \effects
+ * The kept line buffer is given to the reader, or a new one is allocated if
+ * there isn't one or another thread is using it.
+ *
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
+ */
+static int TakeSpareLine(ini_reader_t *reader, FILE *fp)
+{
+    char *buffer;
+    size_t size;
+
+#ifdef EZINI_POSIX
+    pthread_mutex_lock(&spareLock);
+#endif
+    buffer = spareLine;
+    size = spareLineSize;
+    spareLine = NULL;
+    spareLineSize = 0;
+#ifdef EZINI_POSIX
+    pthread_mutex_unlock(&spareLock);
+#endif
+
+    if (NULL == buffer)
     {
-        free(item->section);
-        free(item);
-        return NULL;
+        return InitReader(reader, fp, 0);
     }
 
-    return item;
+    AttachReader(reader, fp, 0, buffer, size);
+    return 0;
 }
 
-
 /**
- * \fn void FreeKeyList(ini_key_list_t *list)
+ * \fn static void KeepSpareLine(ini_reader_t *reader, int done)
  *
- * \brief This function frees all of the members of a key list.
+ * \brief This function keeps the line buffer of a reader initialized by
+ * TakeSpareLine for the next call to GetEntryFromFile.
  *
- * \param list A pointer to the head of an ini_key_list_t
+ * \param reader A pointer to the reader.
  *
- * \effects All of the memory allocated for all of the key/value pairs in
- * a key list will be freed.
+ * \param done Non-zero if the end of the file or an error was reached.
  *
- * \returns Nothing
+ * \effects
+ * The reader's buffer is kept, unless the file is done, the buffer has
+ * grown past SPARE_LINE_SIZE, or another buffer is already kept, in which
+ * case it is freed.
  *
- * This function uses recursion to step to the tail of the list and deletes
- * key/value entries on the way back up.
+ * \returns Nothing
  */
-static void FreeKeyList(ini_key_list_t *list)
+static void KeepSpareLine(ini_reader_t *reader, int done)
 {
-    /* recurse to the end of the list and free everything on the way back */
-    if (list->next != NULL)
+    if (!done && (reader->size <= SPARE_LINE_SIZE))
     {
-        FreeKeyList(list->next);
+#ifdef EZINI_POSIX
+        pthread_mutex_lock(&spareLock);
+#endif
+        if (NULL == spareLine)
+        {
+            spareLine = reader->buffer;
+            spareLineSize = reader->size;
+            reader->buffer = NULL;
+        }
+#ifdef EZINI_POSIX
+        pthread_mutex_unlock(&spareLock);
+#endif
     }
 
-    free(list->key);
-    free(list->value);
-    free(list);
+    Release(reader->buffer);
+    reader->buffer = NULL;
 }
 
-
 /**
- * \fn static void FreeEntry(ini_entry_t *entry)
- *
- * \brief This function frees the allocated memory that is pointed to by the
- * members of an ini_entry_t structure.
+ * \fn static void ReleaseSpareLine(void)
  *
- * \param entry A pointer to the entry structure containing the members
- * pointing to the memory to be freed.
+ * \brief This function frees the line buffer kept for GetEntryFromFile.
  *
- * \effects Dynamically allocated memory is freed and entry data is set
- * to NULL.
+ * \effects The kept buffer, if any, is freed with the current allocator.
  *
  * \returns Nothing
  */
-static void FreeEntry(ini_entry_t *entry)
+static void ReleaseSpareLine(void)
 {
-    free(entry->section);
-    free(entry->key);
-    free(entry->value);
-
-    entry->section = NULL;
-    entry->key = NULL;
-    entry->value = NULL;
+    char *buffer;
+
+#ifdef EZINI_POSIX
+    pthread_mutex_lock(&spareLock);
+#endif
+    buffer = spareLine;
+    spareLine = NULL;
+    spareLineSize = 0;
+#ifdef EZINI_POSIX
+    pthread_mutex_unlock(&spareLock);
+#endif
+
+    Release(buffer);
 }
 
 /**
- * \fn static char *SkipWS(const char *str)
+ * \fn static void AttachReader(ini_reader_t *reader, FILE *fp, int blocks,
+ *      char *buffer, size_t size)
+ *
+ * \brief This function initializes a line reader that uses an existing
+ * buffer.
+ *
+ * \param reader A pointer to the reader being initialized.
  *
- * \brief This function returns a pointer to the first non-space in the
- * string passed as a parameter.
+ * \param fp A pointer to the file to be read.  It must be open for reading.
  *
- * \param str A pointer to the string being searched.
+ * \param blocks Non-zero if the reader may read ahead of the current line
+ * in large blocks.
+ *
+ * \param buffer A pointer to memory allocated with malloc.  The reader may
+ * reallocate it, so the caller must take reader->buffer back when done.
+ *
+ * \param size The size of buffer.  It must be at least 2.
  *
  * \effects None
  *
- * \returns A pointer to the first non-space in str.
+ * \returns Nothing
  */
-static char *SkipWS(const char *str)
+static void AttachReader(ini_reader_t *reader, FILE *fp, int blocks,
+    char *buffer, size_t size)
 {
-    char *c;
-
-    c = (char *)str;
-    while(isspace(*c))
-    {
-        c++;
-    }
-
-    return c;
+    reader->fp = fp;
+    reader->blocks = blocks;
+    reader->buffer = buffer;
+    reader->size = size;
+    reader->start = 0;
+    reader->scanned = 0;
+    reader->end = 0;
+    reader->eof = 0;
 }
 
 /**
- * \fn static char *DupStr(const char *src)
- *
- * \brief This function returns a copy of the string passed as a parameter.
+ * \fn static int GrowReader(ini_reader_t *reader)
  *
- * \param str A pointer to the string being being copied.
+ * \brief This function makes room for more data in a reader's buffer.
  *
- * \effects Memory is dynamically allocated to hold a duplicate of the
- * input string.
+ * \param reader A pointer to the reader whose buffer needs more room.
  *
- * \returns A copy of str in malloced memory is returned on success.  NULL
- * is returned on failure.
+ * \effects
+ * Data that has already been returned is discarded by moving the
+ * unreturned data to the start of the buffer.  If that doesn't free any
+ * space, the buffer size is doubled.
  *
- * This function returns a copy of the string passed as a parameter.  The
- * memory for the copy is allocated by malloc() and must be freed by the caller.
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
  */
-static char *DupStr(const char *src)
+static int GrowReader(ini_reader_t *reader)
 {
-    char *dest;
+    char *buffer;
 
-    if (NULL == src)
+    if (reader->start > 0)
     {
-        return NULL;
+        /* discard lines that have already been returned */
+        memmove(reader->buffer, reader->buffer + reader->start,
+            reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->scanned -= reader->start;
+        reader->start = 0;
+    }
+
+    if (reader->size - reader->end > 1)
+    {
+        return 0;
     }
 
-    dest = (char *)malloc(strlen(src) + 1);
+    /* buffer is full, double it */
+    buffer = (char *)Reallocate(reader->buffer, reader->size * 2);
 
-    if (NULL != dest)
+    if (NULL == buffer)
     {
-        strcpy(dest, src);
+        return -1;
     }
 
-    return dest;
+    COUNT(STAT_LINE_REALLOCS, 1);
+
+    reader->buffer = buffer;
+    reader->size *= 2;
+    return 0;
 }
 
 /**
- * \fn static char *GetLine(FILE *fp)
+ * \fn static int FillReader(ini_reader_t *reader)
  *
- * \brief This function returns a NULL terminated array of char containing the
- * next line in the file passed as an argument.
+ * \brief This function reads more data into a reader's buffer.
  *
- * \param fp A pointer to the file being read.
+ * \param reader A pointer to the reader whose buffer is being filled.
  *
- * \effects One line is read from fp and copied into a dynamically allocated
- * string.
- *
- * \returns A NULL terminated array of char containing the next line in fp
- * is retured.  The array must be free by the caller. NULL is returned at end
- * of file.
+ * \effects
+ * Block readers read as much as fits in the buffer.  Line readers read up
+ * to the next end of line, so that the file isn't read past the current
+ * line.  eof is set when there is nothing left to read.
  *
- * This function returns a NULL terminated array of char containing the next
- * line in the file passed as an argument.  The memory for the string returned
- * is allocated by malloc() and must be freed by the caller.
+ * \returns 0 for success, Non-zero on error.  Error type is contained in
+ * errno.
  */
-static char *GetLine(FILE *fp)
+static int FillReader(ini_reader_t *reader)
 {
-    char *line;         /* string to read line into */
-    char *next;         /* where to write the next characters into */
-    const size_t chunkSize = 32;
-    size_t lineSize;
+    size_t count;
 
-    if ((NULL == fp) || feof(fp))
+    if (0 != GrowReader(reader))
     {
-        return NULL;
+        return -1;
     }
 
-    lineSize = chunkSize;
-    line = (char *)malloc(lineSize * sizeof(char));
+    if (reader->blocks)
+    {
+        count = fread(reader->buffer + reader->end, 1,
+            reader->size - reader->end, reader->fp);
+    }
+    else if (NULL != fgets(reader->buffer + reader->end,
+        (int)(reader->size - reader->end), reader->fp))
+    {
+        /* only measure the characters that were just read */
+        count = strlen(reader->buffer + reader->end);
+    }
+    else
+    {
+        count = 0;
+    }
 
-    if (NULL == line)
+    if (0 == count)
     {
-        /* allocation failed */
-        return NULL;
+        if (ferror(reader->fp))
+        {
+            errno = EIO;
+            return -1;
+        }
+
+        reader->eof = 1;
     }
 
-    line[0] = '\0';
-    next = line;
+    reader->end += count;
+    return 0;
+}
+
+/**
+ * \fn static int ReadLine(ini_reader_t *reader, const char **line,
+ *      size_t *length)
+ *
+ * \brief This function returns the next line in the file being read by a
+ * line reader.
+ *
+ * \param reader A pointer to the reader for the file being read.
+ *
+ * \param line Set to point to the start of the line in the reader's buffer.
+ * It is not NULL terminated and is only valid until the next call.
+ *
+ * \param length Set to the number of characters in the line, excluding the
+ * trailing '\\n'.
+ *
+ * \effects
+ * Data is read from the file as needed.  The reader's buffer grows
+ * geometrically to hold lines longer than it.
+ *
+ * \returns 1 when a line is returned\n
+ *          0 at end of file\n
+ *         -1 for an error.  Error type is contained in errno.
+ *
+ * Only data that hasn't been scanned for the end of line is searched, so
+ * the time to read a line is linear in its length.
+ */
+static int ReadLine(ini_reader_t *reader, const char **line, size_t *length)
+{
+    char *eol;
 
-    while (NULL != fgets(next, lineSize - strlen(line), fp))
+    while (1)
     {
-        if ('\n' == line[strlen(line) - 1])
+        eol = (char *)scanKernel(reader->buffer + reader->scanned,
+            reader->buffer + reader->end, '\n', '\n');
+
+        if (eol < reader->buffer + reader->end)
         {
-            /* we got to the EOL strip off the trailing '\n' and exit */
-            line[strlen(line) - 1] = '\0';
-            break;
+            *line = reader->buffer + reader->start;
+            *length = eol - *line;
+            reader->start = (eol - reader->buffer) + 1;
+            reader->scanned = reader->start;
+            return 1;
         }
-        else
-        {
-            /* there's still more on this line */
-            lineSize += chunkSize;
-            line = (char *)realloc(line, lineSize);
 
-            if (NULL == line)
+        reader->scanned = reader->end;
+
+        if (reader->eof)
+        {
+            if (reader->start == reader->end)
             {
-                return NULL;
+                return 0;
             }
 
-            next = line + strlen(line);
+            /* last line doesn't end with '\n' */
+            *line = reader->buffer + reader->start;
+            *length = reader->end - reader->start;
+            reader->start = reader->end;
+            return 1;
         }
-    }
 
-    return line;
+        if (0 != FillReader(reader))
+        {
+            return -1;
+        }
+    }
 }
 
 /**@}*/
@@ -62,6 +62,55 @@
 extern "C" {
 #endif
 
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+
+/*!
+  \def INI_WRITE_ATOMIC
+  \brief Write mode flag: files are written to a temporary file in the same
+  directory, which is renamed over the original when it is complete.
+*/
+#define INI_WRITE_ATOMIC    0x01
+
+/*!
+  \def INI_WRITE_SYNC
+  \brief Write mode flag: written files are flushed to disk (fsync) before
+  they are closed or renamed.
+*/
+#define INI_WRITE_SYNC      0x02
+
+/*!
+  \def INI_WRITE_SYNC_DIR
+  \brief Write mode flag: the directory containing a renamed file is
+  flushed to disk, so the rename itself is durable.
+*/
+#define INI_WRITE_SYNC_DIR  0x04
+
+/*!
+  \def INI_SCAN_AUTO
+  \brief Scan kernel: use the fastest kernel supported by the CPU.
+*/
+#define INI_SCAN_AUTO       0
+
+/*!
+  \def INI_SCAN_SCALAR
+  \brief Scan kernel: portable C, a machine word at a time.
+*/
+#define INI_SCAN_SCALAR     1
+
+/*!
+  \def INI_SCAN_SSE2
+  \brief Scan kernel: x86 SSE2, 16 bytes at a time.
+*/
+#define INI_SCAN_SSE2       2
+
+/*!
+  \def INI_SCAN_AVX2
+  \brief Scan kernel: x86 AVX2, 32 bytes at a time.
+*/
+#define INI_SCAN_AVX2       3
+
 /***************************************************************************
 *                            TYPE DEFINITIONS
 ***************************************************************************/
@@ -81,12 +130,222 @@ typedef struct
                             value.  Use ASCII strings to represent numbers */
 } ini_entry_t;
 
+/**
+ * \struct ini_entry_buffer_t
+ * \brief An entry whose strings are kept in buffers that are reused from
+ * read to read, so that reading entries doesn't allocate memory once the
+ * buffers are big enough.
+ */
+typedef struct
+{
+    ini_entry_t entry;  /*!< the entry that was read.  Its strings belong to
+                            the buffer and are overwritten by the next read.
+                            entry.section is NULL before the first section */
+    char *section;      /*!< private: memory holding the section name */
+    size_t sectionSize; /*!< private: bytes allocated for section */
+    size_t keySize;     /*!< private: bytes allocated for entry.key */
+    size_t valueSize;   /*!< private: bytes allocated for entry.value */
+    char *line;         /*!< private: line buffer used by ReadEntryFromFile */
+    size_t lineSize;    /*!< private: bytes allocated for line */
+} ini_entry_buffer_t;
+
+/**
+ * \struct ini_view_t
+ * \brief A string that is not NULL terminated.  Views typically point into
+ * a buffer containing INI file text.
+ */
+typedef struct
+{
+    const char *str;    /*!< pointer to the first character of the string */
+    size_t length;      /*!< number of characters in the string */
+} ini_view_t;
+
+/**
+ * \struct ini_entry_view_t
+ * \brief A structure containing views of the section, key, and value of an
+ * INI file entry
+ */
+typedef struct
+{
+    ini_view_t section; /*!< section name, str is NULL for entries that
+                            precede the first section */
+    ini_view_t key;     /*!< key name */
+    ini_view_t value;   /*!< entry value */
+} ini_entry_view_t;
+
+/**
+ * \typedef ini_filter_t
+ * \brief A function called with each entry of a file by
+ * DeleteEntriesFromFile.  It returns non-zero if the entry should be deleted.
+ */
+typedef int (*ini_filter_t)(const ini_entry_view_t *entry, void *user);
+
+/**
+ * \typedef ini_callback_t
+ * \brief A function called by a push parser with each entry it finds.  It
+ * returns 0 to continue parsing or a positive value to stop.
+ */
+typedef int (*ini_callback_t)(const ini_entry_view_t *entry, void *user);
+
+/**
+ * \typedef ini_writer_t
+ * \brief A function called by WriteINIList with each block of serialized
+ * INI file text.  It returns 0 on success and non-zero to stop writing.
+ */
+typedef int (*ini_writer_t)(const char *data, size_t length, void *user);
+
+/**
+ * \struct ini_buffer_t
+ * \brief A structure used to parse INI file text that is in memory
+ */
+typedef struct
+{
+    const char *data;   /*!< pointer to the INI file text */
+    size_t size;        /*!< number of characters in data */
+    size_t offset;      /*!< offset of the next line to be parsed */
+    ini_view_t section; /*!< view of the current section name */
+    void *map;          /*!< memory to be released by CloseINIBuffer, NULL
+                            if data was supplied by the caller */
+    size_t mapSize;     /*!< size of the memory pointed to by map */
+} ini_buffer_t;
+
 /**
  * \typedef ini_entry_list_t
  * \brief A shortcut for forward referenced struct ini_section_list_t*
  */
 typedef struct ini_section_list_t* ini_entry_list_t;
 
+/**
+ * \typedef ini_reader_t
+ * \brief A shortcut for the opaque struct ini_reader_t, used to read
+ * entries from a file in large blocks
+ */
+typedef struct ini_reader_t ini_reader_t;
+
+/**
+ * \typedef ini_document_t
+ * \brief A shortcut for the opaque struct ini_document_t, a parsed INI file
+ * that may be queried by section and key
+ */
+typedef struct ini_document_t ini_document_t;
+
+/**
+ * \typedef ini_parser_t
+ * \brief An opaque push parser that is fed INI file text in chunks
+ */
+typedef struct ini_parser_t ini_parser_t;
+
+/**
+ * \typedef ini_watcher_t
+ * \brief An opaque watcher that reloads an INI file when it changes and
+ * publishes each version as a read only snapshot
+ */
+typedef struct ini_watcher_t ini_watcher_t;
+
+/**
+ * \struct ini_cursor_t
+ * \brief A structure used to enumerate the key/value pairs of a section
+ */
+typedef struct
+{
+    const void *next;   /*!< private: the next key/value pair to return */
+    const void *image;  /*!< private: the binary cache image being
+                            enumerated, or NULL */
+} ini_cursor_t;
+
+/**
+ * \struct ini_section_cursor_t
+ * \brief A structure used to enumerate the sections of an entry list or
+ * document
+ */
+typedef struct
+{
+    const void *next;           /*!< private: the next section of an entry
+                                    list to return, or NULL */
+    const ini_document_t *doc;  /*!< private: the lazily parsed or binary
+                                    cache document being enumerated, or
+                                    NULL */
+    size_t index;               /*!< private: the index of doc's next
+                                    section */
+} ini_section_cursor_t;
+
+/**
+ * \struct ini_allocator_t
+ * \brief Functions used by the library to allocate and free memory.  See
+ * SetINIAllocator.
+ */
+typedef struct
+{
+    void *(*allocate)(size_t size, void *user);     /*!< allocates memory
+                                                        like malloc */
+    void *(*reallocate)(void *ptr, size_t size, void *user);
+                                                    /*!< resizes memory like
+                                                        realloc, ptr is never
+                                                        NULL */
+    void (*release)(void *ptr, void *user);         /*!< frees memory like
+                                                        free, ptr is never
+                                                        NULL */
+    void *user;                                     /*!< passed to each of
+                                                        the functions */
+} ini_allocator_t;
+
+/**
+ * \struct ini_handler_t
+ * \brief Functions called by ParseINIFile, ParseINIBuffer, and
+ * ParseINIStream with each section line and entry they find.  The strings
+ * are not NULL terminated and are only valid during the call.  Each
+ * function returns 0 to continue parsing or a positive value to stop.
+ */
+typedef struct
+{
+    int (*onSection)(const char *name, size_t length, void *user);
+                                                    /*!< called with each
+                                                        section name, may be
+                                                        NULL */
+    int (*onEntry)(const char *key, size_t keyLength, const char *value,
+        size_t valueLength, void *user);            /*!< called with each
+                                                        key and value, may
+                                                        be NULL */
+    void *user;                                     /*!< passed to each of
+                                                        the functions */
+} ini_handler_t;
+
+/**
+ * \struct ini_call_stats_t
+ * \brief The number of calls made to a function and the time spent in them
+ */
+typedef struct
+{
+    unsigned long calls;    /*!< number of calls */
+    double seconds;         /*!< total seconds spent in the calls */
+} ini_call_stats_t;
+
+/**
+ * \struct ini_stats_t
+ * \brief Counters and timers kept by the library when it is built with
+ * EZINI_STATS defined.  See GetINIStats.
+ */
+typedef struct
+{
+    unsigned long linesRead;        /*!< lines parsed */
+    unsigned long bytesScanned;     /*!< characters in the lines parsed */
+    unsigned long entriesEmitted;   /*!< key = value lines parsed */
+    unsigned long allocations;      /*!< heap allocations and reallocations */
+    unsigned long bytesAllocated;   /*!< bytes requested by them */
+    unsigned long lineReallocs;     /*!< times a line or entry buffer was
+                                        enlarged */
+    unsigned long writes;           /*!< blocks written to files */
+    unsigned long syncs;            /*!< files and directories synced
+                                        (fsync calls), kept even without
+                                        EZINI_STATS */
+    double syncSeconds;             /*!< seconds spent syncing */
+    ini_call_stats_t getEntryFromFile;      /*!< GetEntryFromFile calls */
+    ini_call_stats_t addEntryToList;        /*!< AddEntryToList calls */
+    ini_call_stats_t makeINIFile;           /*!< MakeINIFile calls */
+    ini_call_stats_t addEntryToFile;        /*!< AddEntryToFile calls */
+    ini_call_stats_t deleteEntryFromFile;   /*!< DeleteEntryFromFile calls */
+} ini_stats_t;
+
 /***************************************************************************
 *                               PROTOTYPES
 ***************************************************************************/
@@ -95,25 +354,183 @@ typedef struct ini_section_list_t* ini_entry_list_t;
 int AddEntryToList(ini_entry_list_t *list, const char *section,
     const char *key, const char *value);
 
+/* remove a single entry from a list of INI entries */
+int DeleteEntryFromList(ini_entry_list_t *list, const char *section,
+    const char *key);
+
 /* free all of the entries in an entry list */
 void FreeList(ini_entry_list_t list);
 
+/* create an empty entry list with entries allocated from an arena */
+int NewArenaList(ini_entry_list_t *list);
+
+/* number of heap allocations made to build an entry list */
+unsigned long GetListAllocCount(const ini_entry_list_t list);
+
 /* create/add entries to an INI file from a sorted entry list */
 int MakeINIFile(const char *iniFile, const ini_entry_list_t list);
 int AddEntryToFile(const char *iniFile, const ini_entry_list_t list);
 
+/* serialize an entry list through a callback or into memory */
+int WriteINIList(const ini_entry_list_t list, ini_writer_t writer,
+    void *user);
+char *MakeINIString(const ini_entry_list_t list, size_t *length);
+
+/* choose how functions that create or modify INI files write them */
+void SetINIWriteMode(int mode);
+int GetINIWriteMode(void);
+
+/* number of file syncs and the seconds spent in them, see GetINIStats */
+void GetINISyncStats(unsigned long *count, double *seconds);
+void ResetINISyncStats(void);
+
+/* counters and timers, kept when the library is built with EZINI_STATS */
+int GetINIStats(ini_stats_t *stats);
+void ResetINIStats(void);
+
+/* choose the functions used to allocate and free the library's memory */
+int SetINIAllocator(const ini_allocator_t *allocator);
+void GetINIAllocator(ini_allocator_t *allocator);
+void *AllocateINIMemory(size_t size);
+void FreeINIMemory(void *ptr);
+
 /* remove a single entry from an INI file */
 int DeleteEntryFromFile(const char *iniFile, const char *section,
     const char *key);
 
+/* remove a batch of entries and/or sections from an INI file in one pass */
+int DeleteEntriesFromFile(const char *iniFile, const ini_entry_list_t pairs,
+    const char *const *sections, ini_filter_t filter, void *user);
+
 /***************************************************************************
 * get the next entry in INI file.
 * returns:  1 if an entry is found
 *           0 if there are no more entries
 *           -1 on error
+* the file is read a line at a time and each entry's key and value are
+* allocated.  use NewReader and GetEntryFromReader or ReadEntryFromReader
+* to read many entries quickly.
 ***************************************************************************/
 int GetEntryFromFile(FILE *iniFile, ini_entry_t *entry);
 
+/* read entries from a file through a reusable, block buffered reader */
+ini_reader_t *NewReader(FILE *iniFile);
+int GetEntryFromReader(ini_reader_t *reader, ini_entry_t *entry);
+void FreeReader(ini_reader_t *reader);
+
+/* read entries into reusable buffers without allocating for each entry */
+void InitEntryBuffer(ini_entry_buffer_t *buffer);
+int ReadEntryFromFile(FILE *iniFile, ini_entry_buffer_t *buffer);
+int ReadEntryFromReader(ini_reader_t *reader, ini_entry_buffer_t *buffer);
+void FreeEntryBuffer(ini_entry_buffer_t *buffer);
+
+/* zero-copy parsing of INI file text in memory */
+int OpenINIBuffer(const char *iniFile, ini_buffer_t *buffer);
+void InitINIBuffer(ini_buffer_t *buffer, const char *data, size_t size);
+int GetEntryFromBuffer(ini_buffer_t *buffer, ini_entry_view_t *entry);
+void CloseINIBuffer(ini_buffer_t *buffer);
+
+/* choose the kernel used to scan INI file text for structural characters */
+int SetScanKernel(int kernel);
+int GetScanKernel(void);
+
+/* push parsing of INI file text that arrives in arbitrary chunks */
+ini_parser_t *NewParser(ini_callback_t callback, void *user);
+int FeedParser(ini_parser_t *parser, const char *data, size_t length);
+int FinishParser(ini_parser_t *parser);
+void FreeParser(ini_parser_t *parser);
+
+/* parse INI file text with handler functions, without copying entries */
+int ParseINIFile(const char *iniFile, const ini_handler_t *handler);
+int ParseINIBuffer(const char *data, size_t size,
+    const ini_handler_t *handler);
+int ParseINIStream(FILE *iniFile, const ini_handler_t *handler);
+
+/* load an INI file once and look up entries by section and key */
+ini_document_t *LoadDocument(const char *iniFile);
+void FreeDocument(ini_document_t *doc);
+
+/* scan an INI file's sections once, parse each section when it is used */
+ini_document_t *LoadLazyDocument(const char *iniFile);
+
+/* precompile an INI file into a binary cache that loads without parsing */
+int CompileINICache(const char *iniFile, const char *cacheFile);
+int CheckINICache(const char *iniFile, const char *cacheFile);
+ini_document_t *LoadCachedDocument(const char *iniFile,
+    const char *cacheFile);
+
+/* parse a large INI file on several threads */
+int LoadListParallel(const char *iniFile, int threads,
+    ini_entry_list_t *list);
+ini_document_t *LoadDocumentParallel(const char *iniFile, int threads);
+const char *GetValueFromDocument(const ini_document_t *doc,
+    const char *section, const char *key);
+int FindSectionInDocument(const ini_document_t *doc, const char *section,
+    ini_cursor_t *cursor);
+int GetKeyFromSection(ini_cursor_t *cursor, const char **key,
+    const char **value);
+
+/* find entries and enumerate sections and keys as views, without copying */
+int GetViewFromList(const ini_entry_list_t list, const ini_view_t *section,
+    const ini_view_t *key, ini_view_t *value);
+int GetViewFromDocument(const ini_document_t *doc, const ini_view_t *section,
+    const ini_view_t *key, ini_view_t *value);
+int FindSectionViewInList(const ini_entry_list_t list,
+    const ini_view_t *section, ini_cursor_t *cursor);
+int FindSectionViewInDocument(const ini_document_t *doc,
+    const ini_view_t *section, ini_cursor_t *cursor);
+int GetKeyViewFromSection(ini_cursor_t *cursor, ini_view_t *key,
+    ini_view_t *value);
+void EnumerateListSections(const ini_entry_list_t list,
+    ini_section_cursor_t *cursor);
+void EnumerateDocumentSections(const ini_document_t *doc,
+    ini_section_cursor_t *cursor);
+int GetSectionFromCursor(ini_section_cursor_t *cursor, ini_view_t *section,
+    ini_cursor_t *keys);
+
+/* typed values of entries, converted values are cached */
+int GetLongFromList(const ini_entry_list_t list, const char *section,
+    const char *key, long *value);
+int GetULongFromList(const ini_entry_list_t list, const char *section,
+    const char *key, unsigned long *value);
+int GetDoubleFromList(const ini_entry_list_t list, const char *section,
+    const char *key, double *value);
+int GetBoolFromList(const ini_entry_list_t list, const char *section,
+    const char *key, int *value);
+int GetSizeFromList(const ini_entry_list_t list, const char *section,
+    const char *key, size_t *value);
+int GetLongFromDocument(const ini_document_t *doc,
+    const char *section, const char *key, long *value);
+int GetULongFromDocument(const ini_document_t *doc,
+    const char *section, const char *key, unsigned long *value);
+int GetDoubleFromDocument(const ini_document_t *doc,
+    const char *section, const char *key, double *value);
+int GetBoolFromDocument(const ini_document_t *doc,
+    const char *section, const char *key, int *value);
+int GetSizeFromDocument(const ini_document_t *doc,
+    const char *section, const char *key, size_t *value);
+
+/***************************************************************************
+* convert value strings (e.g. passed to handlers) like the typed getters.
+* values may not start or end with white space.  long and unsigned long are
+* the platform's width (32 bits on 64 bit Windows).
+***************************************************************************/
+int ConvertINILong(const char *str, size_t length, long *value);
+int ConvertINIULong(const char *str, size_t length, unsigned long *value);
+int ConvertINIDouble(const char *str, size_t length, double *value);
+int ConvertINIBool(const char *str, size_t length, int *value);
+int ConvertINISize(const char *str, size_t length, size_t *value);
+
+/* reload a changed INI file in the background, readers use snapshots */
+ini_watcher_t *StartWatcher(const char *iniFile, unsigned int pollMs);
+void StopWatcher(ini_watcher_t *watcher);
+const ini_document_t *AcquireSnapshot(ini_watcher_t *watcher, int *token);
+void ReleaseSnapshot(ini_watcher_t *watcher, int token);
+unsigned long GetSnapshotVersion(ini_watcher_t *watcher);
+unsigned long GetWatcherErrors(ini_watcher_t *watcher);
+int WaitForSnapshot(ini_watcher_t *watcher, unsigned long version,
+    unsigned int timeoutMs);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,694 @@
+/**
+ * \brief C++ ownership and iteration of INI file entry lists and documents
+ * \file ezini.hpp
+ * \author Michael Dipperstein (mdipperstein@gmail.com)
+ * \date October 15, 2026
+ *
+ * This file is a C++17 header layered over ezini.h.  Entry lists and
+ * documents are held by move only handles that free them when they go out
+ * of scope.  Values, section names, and keys are returned as
+ * std::string_view views of the strings held by the list or document, and
+ * sections and keys may be iterated with range-based for loops.  Nothing is
+ * allocated or copied to look up or iterate over entries.
+ *
+ * \copyright Copyright (C) 2026 by Michael Dipperstein
+ * (mdipperstein@gmail.com)
+ *
+ * \par
+ * This file is part of the ezini library.
+ *
+ * \license
+ * The ezini library is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * \par
+ * The ezini library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+ * General Public License for more details.
+ *
+ * \par
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __EZINI_HPP
+#define __EZINI_HPP
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include "ezini.h"
+
+namespace ezini
+{
+
+namespace detail
+{
+
+/**
+ * \brief Returns a view of the same characters as a string_view.
+ */
+inline ini_view_t MakeView(std::string_view str) noexcept
+{
+    ini_view_t view;
+
+    view.str = str.data();
+    view.length = str.size();
+    return view;
+}
+
+/**
+ * \brief Returns a string_view of the same characters as a view.
+ */
+inline std::string_view MakeStringView(const ini_view_t &view) noexcept
+{
+    return std::string_view(view.str, view.length);
+}
+
+}   /* namespace detail */
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+
+/**
+ * \struct entry_t
+ * \brief A key/value pair of a section.  The views belong to the list or
+ * document holding the entry, and are NULL terminated.
+ */
+struct entry_t
+{
+    std::string_view key;       /*!< key name */
+    std::string_view value;     /*!< entry value */
+};
+
+/**
+ * \class keys_t
+ * \brief The key/value pairs of a section, as a range of entry_t.  It is
+ * valid until the list holding it is changed or freed, or the document
+ * holding it is freed.
+ */
+class keys_t
+{
+public:
+    /**
+     * \class iterator
+     * \brief A forward iterator over the key/value pairs of a section.
+     */
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = entry_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const entry_t *;
+        using reference = const entry_t &;
+
+        /**
+         * \brief Makes the end iterator.
+         */
+        iterator() noexcept : cursor_{nullptr, nullptr}, entry_{}
+        {
+        }
+
+        /**
+         * \brief Makes an iterator at the key/value pair a cursor is at.
+         */
+        explicit iterator(const ini_cursor_t &cursor) noexcept :
+            cursor_(cursor), entry_{}
+        {
+            Next();
+        }
+
+        reference operator*() const noexcept
+        {
+            return entry_;
+        }
+
+        pointer operator->() const noexcept
+        {
+            return &entry_;
+        }
+
+        iterator &operator++() noexcept
+        {
+            Next();
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            iterator before = *this;
+
+            Next();
+            return before;
+        }
+
+        bool operator==(const iterator &other) const noexcept
+        {
+            return entry_.key.data() == other.entry_.key.data();
+        }
+
+        bool operator!=(const iterator &other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+    private:
+        void Next() noexcept
+        {
+            ini_view_t key;
+            ini_view_t value;
+
+            if (0 == GetKeyViewFromSection(&cursor_, &key, &value))
+            {
+                entry_ = entry_t{};
+            }
+            else
+            {
+                entry_.key = detail::MakeStringView(key);
+                entry_.value = detail::MakeStringView(value);
+            }
+        }
+
+        ini_cursor_t cursor_;       /*!< next key/value pair */
+        entry_t entry_;             /*!< current key/value pair */
+    };
+
+    /**
+     * \brief Makes an empty range.
+     */
+    keys_t() noexcept : cursor_{nullptr, nullptr}
+    {
+    }
+
+    /**
+     * \brief Makes the range of key/value pairs starting at a cursor.
+     */
+    explicit keys_t(const ini_cursor_t &cursor) noexcept : cursor_(cursor)
+    {
+    }
+
+    iterator begin() const noexcept
+    {
+        return iterator(cursor_);
+    }
+
+    iterator end() const noexcept
+    {
+        return iterator();
+    }
+
+    bool empty() const noexcept
+    {
+        return nullptr == cursor_.next;
+    }
+
+private:
+    ini_cursor_t cursor_;           /*!< first key/value pair */
+};
+
+/**
+ * \struct section_t
+ * \brief A section and its key/value pairs.
+ */
+struct section_t
+{
+    std::string_view name;      /*!< section name, empty for entries
+                                    preceding the first section */
+    keys_t keys;                /*!< key/value pairs of the section */
+};
+
+/**
+ * \class sections_t
+ * \brief The sections of an entry list or document, as a range of
+ * section_t.  It is valid until the list is changed or freed, or the
+ * document is freed.
+ */
+class sections_t
+{
+public:
+    /**
+     * \class iterator
+     * \brief A forward iterator over sections.
+     *
+     * Iterating over the sections of a lazily parsed document parses them.
+     * If one can't be parsed, iteration stops there with errno set.
+     */
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = section_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const section_t *;
+        using reference = const section_t &;
+
+        /**
+         * \brief Makes the end iterator.
+         */
+        iterator() noexcept : cursor_{nullptr, nullptr, 0}, section_{}
+        {
+        }
+
+        /**
+         * \brief Makes an iterator at the section a cursor is at.
+         */
+        explicit iterator(const ini_section_cursor_t &cursor) noexcept :
+            cursor_(cursor), section_{}
+        {
+            Next();
+        }
+
+        reference operator*() const noexcept
+        {
+            return section_;
+        }
+
+        pointer operator->() const noexcept
+        {
+            return &section_;
+        }
+
+        iterator &operator++() noexcept
+        {
+            Next();
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            iterator before = *this;
+
+            Next();
+            return before;
+        }
+
+        bool operator==(const iterator &other) const noexcept
+        {
+            return section_.name.data() == other.section_.name.data();
+        }
+
+        bool operator!=(const iterator &other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+    private:
+        void Next() noexcept
+        {
+            ini_view_t name;
+            ini_cursor_t keys;
+
+            if (1 == GetSectionFromCursor(&cursor_, &name, &keys))
+            {
+                section_.name = detail::MakeStringView(name);
+                section_.keys = keys_t(keys);
+            }
+            else
+            {
+                section_ = section_t{};
+            }
+        }
+
+        ini_section_cursor_t cursor_;   /*!< next section */
+        section_t section_;             /*!< current section */
+    };
+
+    /**
+     * \brief Makes the range of sections starting at a cursor.
+     */
+    explicit sections_t(const ini_section_cursor_t &cursor) noexcept :
+        cursor_(cursor)
+    {
+    }
+
+    iterator begin() const noexcept
+    {
+        return iterator(cursor_);
+    }
+
+    iterator end() const noexcept
+    {
+        return iterator();
+    }
+
+private:
+    ini_section_cursor_t cursor_;   /*!< first section */
+};
+
+/**
+ * \class list_t
+ * \brief The owner of an entry list (ini_entry_list_t).  It frees the list
+ * when it is destroyed, and may be moved but not copied.
+ */
+class list_t
+{
+public:
+    /**
+     * \brief Makes an empty list.  Memory is allocated when the first
+     * entry is added.
+     */
+    list_t() noexcept : list_(nullptr)
+    {
+    }
+
+    /**
+     * \brief Takes ownership of an entry list.
+     */
+    explicit list_t(ini_entry_list_t list) noexcept : list_(list)
+    {
+    }
+
+    list_t(list_t &&other) noexcept : list_(other.Release())
+    {
+    }
+
+    list_t &operator=(list_t &&other) noexcept
+    {
+        if (this != &other)
+        {
+            FreeList(list_);
+            list_ = other.Release();
+        }
+
+        return *this;
+    }
+
+    list_t(const list_t &) = delete;
+    list_t &operator=(const list_t &) = delete;
+
+    ~list_t()
+    {
+        FreeList(list_);
+    }
+
+    /**
+     * \brief Makes an empty list whose entries are allocated from large
+     * blocks (see NewArenaList).  It is empty (and errno is set) if there
+     * is no memory.
+     */
+    static list_t Arena() noexcept
+    {
+        ini_entry_list_t list = nullptr;
+
+        NewArenaList(&list);
+        return list_t(list);
+    }
+
+    /**
+     * \brief Adds an entry, or replaces the value of an existing one, as
+     * AddEntryToList does.  Returns true for success, or false with errno
+     * set.
+     */
+    bool Add(const char *section, const char *key, const char *value)
+        noexcept
+    {
+        return 0 == AddEntryToList(&list_, section, key, value);
+    }
+
+    /**
+     * \brief Returns the value of a (section, key) pair, or nothing if the
+     * list doesn't have it.
+     */
+    std::optional<std::string_view> Get(std::string_view section,
+        std::string_view key) const noexcept
+    {
+        ini_view_t sectionView = detail::MakeView(section);
+        ini_view_t keyView = detail::MakeView(key);
+        ini_view_t value;
+
+        if (0 != GetViewFromList(list_, &sectionView, &keyView, &value))
+        {
+            return std::nullopt;
+        }
+
+        return detail::MakeStringView(value);
+    }
+
+    /**
+     * \brief Returns true if the list has a section.
+     */
+    bool HasSection(std::string_view section) const noexcept
+    {
+        ini_view_t view = detail::MakeView(section);
+
+        return 1 == FindSectionViewInList(list_, &view, nullptr);
+    }
+
+    /**
+     * \brief Returns the key/value pairs of a section (none if the list
+     * doesn't have the section).
+     */
+    keys_t Keys(std::string_view section) const noexcept
+    {
+        ini_view_t view = detail::MakeView(section);
+        ini_cursor_t cursor;
+
+        FindSectionViewInList(list_, &view, &cursor);
+        return keys_t(cursor);
+    }
+
+    /**
+     * \brief Returns the sections of the list, in the order they were
+     * added.
+     */
+    sections_t Sections() const noexcept
+    {
+        ini_section_cursor_t cursor;
+
+        EnumerateListSections(list_, &cursor);
+        return sections_t(cursor);
+    }
+
+    /**
+     * \brief Writes the list to an INI file (stdout if iniFile is NULL).
+     * Returns true for success, or false with errno set.
+     */
+    bool Write(const char *iniFile) const noexcept
+    {
+        return 0 == MakeINIFile(iniFile, list_);
+    }
+
+    /**
+     * \brief Returns the list, which still belongs to this object.
+     */
+    ini_entry_list_t Handle() const noexcept
+    {
+        return list_;
+    }
+
+    /**
+     * \brief Returns the list, which now belongs to the caller.  This
+     * object is left empty.
+     */
+    ini_entry_list_t Release() noexcept
+    {
+        return std::exchange(list_, nullptr);
+    }
+
+private:
+    ini_entry_list_t list_;         /*!< list owned by this object */
+};
+
+/**
+ * \class document_view_t
+ * \brief A document (ini_document_t) that belongs to something else, such
+ * as a watcher's snapshot.  It may be copied, and like std::string_view it
+ * is only valid while the document is.
+ */
+class document_view_t
+{
+public:
+    /**
+     * \brief Makes a view of no document.
+     */
+    document_view_t() noexcept : doc_(nullptr)
+    {
+    }
+
+    /**
+     * \brief Makes a view of a document.
+     */
+    explicit document_view_t(const ini_document_t *doc) noexcept : doc_(doc)
+    {
+    }
+
+    /**
+     * \brief Returns true if there is a document (e.g. it was loaded).
+     */
+    explicit operator bool() const noexcept
+    {
+        return nullptr != doc_;
+    }
+
+    /**
+     * \brief Returns the value of a (section, key) pair, or nothing if the
+     * document doesn't have it (or its section couldn't be parsed, with
+     * errno set).
+     */
+    std::optional<std::string_view> Get(std::string_view section,
+        std::string_view key) const noexcept
+    {
+        ini_view_t sectionView = detail::MakeView(section);
+        ini_view_t keyView = detail::MakeView(key);
+        ini_view_t value;
+
+        if (0 != GetViewFromDocument(doc_, &sectionView, &keyView, &value))
+        {
+            return std::nullopt;
+        }
+
+        return detail::MakeStringView(value);
+    }
+
+    /**
+     * \brief Returns true if the document has a section.
+     */
+    bool HasSection(std::string_view section) const noexcept
+    {
+        ini_view_t view = detail::MakeView(section);
+
+        return 1 == FindSectionViewInDocument(doc_, &view, nullptr);
+    }
+
+    /**
+     * \brief Returns the key/value pairs of a section (none if the
+     * document doesn't have the section).
+     */
+    keys_t Keys(std::string_view section) const noexcept
+    {
+        ini_view_t view = detail::MakeView(section);
+        ini_cursor_t cursor;
+
+        FindSectionViewInDocument(doc_, &view, &cursor);
+        return keys_t(cursor);
+    }
+
+    /**
+     * \brief Returns the sections of the document, in the order they were
+     * first found in the INI file.
+     */
+    sections_t Sections() const noexcept
+    {
+        ini_section_cursor_t cursor;
+
+        EnumerateDocumentSections(doc_, &cursor);
+        return sections_t(cursor);
+    }
+
+    /**
+     * \brief Returns the document, which doesn't belong to this object.
+     */
+    const ini_document_t *Handle() const noexcept
+    {
+        return doc_;
+    }
+
+protected:
+    const ini_document_t *doc_;     /*!< document being viewed */
+};
+
+/**
+ * \class document_t
+ * \brief The owner of a document (ini_document_t).  It frees the document
+ * when it is destroyed, and may be moved but not copied.  It has all of
+ * document_view_t's accessors.
+ */
+class document_t : public document_view_t
+{
+public:
+    /**
+     * \brief Makes an owner of no document.
+     */
+    document_t() noexcept = default;
+
+    /**
+     * \brief Takes ownership of a document.
+     */
+    explicit document_t(ini_document_t *doc) noexcept :
+        document_view_t(doc)
+    {
+    }
+
+    document_t(document_t &&other) noexcept :
+        document_view_t(other.Release())
+    {
+    }
+
+    document_t &operator=(document_t &&other) noexcept
+    {
+        if (this != &other)
+        {
+            FreeDocument(const_cast<ini_document_t *>(doc_));
+            doc_ = other.Release();
+        }
+
+        return *this;
+    }
+
+    document_t(const document_t &) = delete;
+    document_t &operator=(const document_t &) = delete;
+
+    ~document_t()
+    {
+        FreeDocument(const_cast<ini_document_t *>(doc_));
+    }
+
+    /**
+     * \brief Loads a document with LoadDocument.  It is empty (and errno
+     * is set) if the file can't be loaded.
+     */
+    static document_t Load(const char *iniFile) noexcept
+    {
+        return document_t(LoadDocument(iniFile));
+    }
+
+    /**
+     * \brief Loads a document with LoadLazyDocument.
+     */
+    static document_t LoadLazy(const char *iniFile) noexcept
+    {
+        return document_t(LoadLazyDocument(iniFile));
+    }
+
+    /**
+     * \brief Loads a document with LoadCachedDocument.
+     */
+    static document_t LoadCached(const char *iniFile,
+        const char *cacheFile = nullptr) noexcept
+    {
+        return document_t(LoadCachedDocument(iniFile, cacheFile));
+    }
+
+    /**
+     * \brief Loads a document with LoadDocumentParallel.
+     */
+    static document_t LoadParallel(const char *iniFile, int threads)
+        noexcept
+    {
+        return document_t(LoadDocumentParallel(iniFile, threads));
+    }
+
+    /**
+     * \brief Returns the document, which now belongs to the caller.  This
+     * object is left empty.
+     */
+    ini_document_t *Release() noexcept
+    {
+        return const_cast<ini_document_t *>(std::exchange(doc_, nullptr));
+    }
+};
+
+}   /* namespace ezini */
+
+#endif  /* ndef __EZINI_HPP */
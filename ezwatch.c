@@ -0,0 +1,887 @@
+/**
+ * \brief INI File watching and reloading
+ * \file ezwatch.c
+ * \author Michael Dipperstein (mdipperstein@gmail.com)
+ * \date October 15, 2026
+ *
+ * This file implements a watcher that reloads an INI file in the background
+ * when it changes, and publishes each version as an immutable document
+ * that any number of threads may read without locking.
+ *
+ * \copyright Copyright (C) 2026 by Michael Dipperstein
+ * (mdipperstein@gmail.com)
+ *
+ * \par
+ * This file is part of the ezini library.
+ *
+ * \license
+ * The ezini library is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * \par
+ * The ezini library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+ * General Public License for more details.
+ *
+ * \par
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \defgroup watcher Watcher Code
+ * \brief This module contains the code for watching and reloading INI files
+ * @{
+ */
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#if defined(__unix__) || defined(__unix) || \
+    (defined(__APPLE__) && defined(__MACH__))
+/*!
+  \def EZINI_POSIX
+  \brief Defined when POSIX functions (threads, poll) are available.
+*/
+#define EZINI_POSIX
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#ifdef EZINI_POSIX
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef __linux__
+/*!
+  \def EZINI_INOTIFY
+  \brief Defined when changes can be watched for with inotify instead of by
+  polling.
+*/
+#define EZINI_INOTIFY
+#include <sys/inotify.h>
+#endif
+#endif
+
+#include "ezini.h"
+
+/***************************************************************************
+*                                 MACROS
+***************************************************************************/
+#if defined(__GNUC__)
+/*!
+  \def ATOMIC_LOAD
+  \brief Sequentially consistent atomic load.
+*/
+#define ATOMIC_LOAD(p)          __atomic_load_n((p), __ATOMIC_SEQ_CST)
+
+/*!
+  \def ATOMIC_LOAD_PTR
+  \brief Sequentially consistent atomic load of a pointer.
+*/
+#define ATOMIC_LOAD_PTR(p)      __atomic_load_n((p), __ATOMIC_SEQ_CST)
+
+/*!
+  \def ATOMIC_STORE
+  \brief Sequentially consistent atomic store.
+*/
+#define ATOMIC_STORE(p, v)      __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+
+/*!
+  \def ATOMIC_ADD
+  \brief Sequentially consistent atomic addition.
+*/
+#define ATOMIC_ADD(p, v)        __atomic_add_fetch((p), (v), __ATOMIC_SEQ_CST)
+#else
+/* no atomics, serialize everything through one lock */
+#define ATOMIC_LOAD(p)          (LockAtomics(), UnlockAtomics(*(p)))
+#define ATOMIC_LOAD_PTR(p)      (LockAtomics(), UnlockPointer(*(p)))
+#define ATOMIC_STORE(p, v)      (LockAtomics(), (*(p) = (v)), \
+                                    UnlockAtomics(0))
+#define ATOMIC_ADD(p, v)        (LockAtomics(), UnlockAtomics(*(p) += (v)))
+#endif
+
+/*!
+  \def DEFAULT_POLL_MS
+  \brief Milliseconds between checks of a file when polling, if none is
+  specified.
+*/
+#define DEFAULT_POLL_MS     1000
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+#ifdef EZINI_POSIX
+/**
+ * \struct ini_watcher_t
+ * \brief A structure holding the state of a watcher and the snapshot it
+ * has published.
+ *
+ * Readers are counted in one of two epochs.  Publishing a new snapshot
+ * flips the epoch, then waits for the readers counted in the old epoch to
+ * leave before freeing the old snapshot.
+ */
+
+struct ini_watcher_t
+{
+    char *iniFile;                      /*!< name of the watched file */
+    const char *name;                   /*!< file name without directories */
+    unsigned int pollMs;                /*!< milliseconds between polls */
+    ini_document_t *current;            /*!< published snapshot */
+    long epoch;                         /*!< epoch new readers join, 0 or 1 */
+    long readers[2];                    /*!< readers in each epoch */
+    unsigned long version;              /*!< number of snapshots published */
+    unsigned long errors;               /*!< number of failed reloads */
+    struct stat status;                 /*!< file status at last load */
+    time_t loaded;                      /*!< time of last load */
+    int stopPipe[2];                    /*!< written to stop the thread */
+    int notify;                         /*!< inotify descriptor, or -1 when
+                                            polling */
+    pthread_t thread;                   /*!< thread watching the file */
+    pthread_mutex_t lock;               /*!< protects version and errors */
+    pthread_cond_t published;           /*!< signaled for each snapshot */
+};
+#endif
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+#ifdef EZINI_POSIX
+static void *WatchFile(void *watcher);
+static int WaitForChange(ini_watcher_t *watcher);
+static void Publish(ini_watcher_t *watcher, ini_document_t *doc);
+static int SameFile(const struct stat *a, const struct stat *b);
+
+#ifdef EZINI_INOTIFY
+static int WatchDirectory(const char *iniFile);
+#endif
+
+#if !defined(__GNUC__)
+static void LockAtomics(void);
+static long UnlockAtomics(long value);
+static void *UnlockPointer(void *value);
+#endif
+#endif
+
+/***************************************************************************
+*                            GLOBAL VARIABLES
+***************************************************************************/
+#if defined(EZINI_POSIX) && !defined(__GNUC__)
+static pthread_mutex_t atomicLock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+#ifdef EZINI_POSIX
+
+/**
+ * \fn ini_watcher_t *StartWatcher(const char *iniFile, unsigned int pollMs)
+ *
+ * \brief This function loads an INI file and starts a thread that reloads
+ * it whenever it changes.
+ *
+ * \param iniFile The name of the INI file to be watched.
+ *
+ * \param pollMs The number of milliseconds between checks of the file when
+ * it can't be watched with inotify.  0 uses the default of 1 second.
+ *
+ * \effects
+ * The file is loaded into the first snapshot and a thread is started to
+ * watch it.
+ *
+ * \returns A pointer to the new watcher, or NULL on error.  Error type is
+ * contained in errno.
+ *
+ * On Linux the directory containing the file is watched with inotify, so
+ * files that are replaced by renaming a new file over them (as editors and
+ * INI_WRITE_ATOMIC do) are seen as well as files written in place.  Other
+ * systems poll the file's inode, size, and modification time.
+ *
+ * If a reload fails (the file is missing or malformed), the previous
+ * snapshot stays published.  Call StopWatcher when done.
+ */
+ini_watcher_t *StartWatcher(const char *iniFile, unsigned int pollMs)
+{
+    ini_watcher_t *watcher;
+    const char *slash;
+    int result;
+
+    if (NULL == iniFile)
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    watcher = (ini_watcher_t *)AllocateINIMemory(sizeof(ini_watcher_t));
+
+    if (NULL == watcher)
+    {
+        return NULL;
+    }
+
+    memset(watcher, 0, sizeof(ini_watcher_t));
+    watcher->iniFile = (char *)AllocateINIMemory(strlen(iniFile) + 1);
+
+    if (NULL == watcher->iniFile)
+    {
+        FreeINIMemory(watcher);
+        return NULL;
+    }
+
+    strcpy(watcher->iniFile, iniFile);
+    slash = strrchr(watcher->iniFile, '/');
+    watcher->name = (NULL == slash) ? watcher->iniFile : slash + 1;
+    watcher->pollMs = (0 == pollMs) ? DEFAULT_POLL_MS : pollMs;
+    watcher->notify = -1;
+
+    /* status first, so a change during the load is seen later */
+    watcher->loaded = time(NULL);
+
+    if ((0 != stat(iniFile, &(watcher->status))) ||
+        (NULL == (watcher->current = LoadDocument(iniFile))))
+    {
+        FreeINIMemory(watcher->iniFile);
+        FreeINIMemory(watcher);
+        return NULL;
+    }
+
+    if (0 != pipe(watcher->stopPipe))
+    {
+        FreeDocument(watcher->current);
+        FreeINIMemory(watcher->iniFile);
+        FreeINIMemory(watcher);
+        return NULL;
+    }
+
+#ifdef EZINI_INOTIFY
+    watcher->notify = WatchDirectory(watcher->iniFile);
+#endif
+
+    pthread_mutex_init(&(watcher->lock), NULL);
+    pthread_cond_init(&(watcher->published), NULL);
+
+    result = pthread_create(&(watcher->thread), NULL, WatchFile, watcher);
+
+    if (0 != result)
+    {
+        if (watcher->notify >= 0)
+        {
+            close(watcher->notify);
+        }
+
+        close(watcher->stopPipe[0]);
+        close(watcher->stopPipe[1]);
+        pthread_mutex_destroy(&(watcher->lock));
+        pthread_cond_destroy(&(watcher->published));
+        FreeDocument(watcher->current);
+        FreeINIMemory(watcher->iniFile);
+        FreeINIMemory(watcher);
+        errno = result;
+        return NULL;
+    }
+
+    return watcher;
+}
+
+
+/**
+ * \fn void StopWatcher(ini_watcher_t *watcher)
+ *
+ * \brief This function stops a watcher and frees it along with its
+ * snapshot.
+ *
+ * \param watcher A pointer to the watcher being stopped.  May be NULL.
+ *
+ * \effects
+ * The watching thread is stopped and all memory allocated for the watcher
+ * and its snapshot is freed.  All snapshots must have been released.
+ *
+ * \returns Nothing
+ */
+void StopWatcher(ini_watcher_t *watcher)
+{
+    if (NULL == watcher)
+    {
+        return;
+    }
+
+    /* wake the thread and wait for it to finish */
+    while ((write(watcher->stopPipe[1], "x", 1) < 0) && (EINTR == errno))
+    {
+        /* try again */
+    }
+
+    pthread_join(watcher->thread, NULL);
+
+    if (watcher->notify >= 0)
+    {
+        close(watcher->notify);
+    }
+
+    close(watcher->stopPipe[0]);
+    close(watcher->stopPipe[1]);
+    pthread_mutex_destroy(&(watcher->lock));
+    pthread_cond_destroy(&(watcher->published));
+    FreeDocument(watcher->current);
+    FreeINIMemory(watcher->iniFile);
+    FreeINIMemory(watcher);
+}
+
+
+/**
+ * \fn const ini_document_t *AcquireSnapshot(ini_watcher_t *watcher,
+ *      int *token)
+ *
+ * \brief This function returns the most recently published snapshot of a
+ * watched file and keeps it from being freed until it is released.
+ *
+ * \param watcher A pointer to the watcher of the file.
+ *
+ * \param token Set to a value that must be passed to ReleaseSnapshot.
+ *
+ * \effects The reader is counted in the current epoch.
+ *
+ * \returns A pointer to a document containing the file's entries.  It may
+ * be queried with any of the ...FromDocument functions until it is
+ * released.
+ *
+ * Acquiring and releasing a snapshot never blocks or takes a lock; it
+ * costs a few atomic operations.  A reload can't finish freeing the
+ * previous snapshot while it is held, so snapshots should be held briefly
+ * and reacquired for the next batch of lookups.
+ */
+const ini_document_t *AcquireSnapshot(ini_watcher_t *watcher, int *token)
+{
+    long epoch;
+
+    while (1)
+    {
+        epoch = ATOMIC_LOAD(&(watcher->epoch));
+        ATOMIC_ADD(&(watcher->readers[epoch]), 1);
+
+        if (ATOMIC_LOAD(&(watcher->epoch)) == epoch)
+        {
+            break;
+        }
+
+        /* a snapshot was published while joining, join the new epoch */
+        ATOMIC_ADD(&(watcher->readers[epoch]), -1);
+    }
+
+    *token = (int)epoch;
+    return (const ini_document_t *)ATOMIC_LOAD_PTR(&(watcher->current));
+}
+
+
+/**
+ * \fn void ReleaseSnapshot(ini_watcher_t *watcher, int token)
+ *
+ * \brief This function releases a snapshot returned by AcquireSnapshot.
+ *
+ * \param watcher A pointer to the watcher of the file.
+ *
+ * \param token The token set by AcquireSnapshot.
+ *
+ * \effects The snapshot may no longer be used.  It will be freed once it
+ * has been replaced and nobody else holds it.
+ *
+ * \returns Nothing
+ */
+void ReleaseSnapshot(ini_watcher_t *watcher, int token)
+{
+    ATOMIC_ADD(&(watcher->readers[token]), -1);
+}
+
+
+/**
+ * \fn unsigned long GetSnapshotVersion(ini_watcher_t *watcher)
+ *
+ * \brief This function returns the number of snapshots a watcher has
+ * published since the first one.
+ *
+ * \param watcher A pointer to the watcher of the file.
+ *
+ * \effects None
+ *
+ * \returns The number of times the file has been reloaded.
+ */
+unsigned long GetSnapshotVersion(ini_watcher_t *watcher)
+{
+    unsigned long version;
+
+    pthread_mutex_lock(&(watcher->lock));
+    version = watcher->version;
+    pthread_mutex_unlock(&(watcher->lock));
+    return version;
+}
+
+
+/**
+ * \fn unsigned long GetWatcherErrors(ini_watcher_t *watcher)
+ *
+ * \brief This function returns the number of times a watcher has failed to
+ * reload its file.
+ *
+ * \param watcher A pointer to the watcher of the file.
+ *
+ * \effects None
+ *
+ * \returns The number of failed reloads.
+ *
+ * A file that can't be loaded, because it is missing or malformed, leaves
+ * the previous snapshot published.  This count is the only sign of it.
+ */
+unsigned long GetWatcherErrors(ini_watcher_t *watcher)
+{
+    unsigned long errors;
+
+    pthread_mutex_lock(&(watcher->lock));
+    errors = watcher->errors;
+    pthread_mutex_unlock(&(watcher->lock));
+    return errors;
+}
+
+
+/**
+ * \fn int WaitForSnapshot(ini_watcher_t *watcher, unsigned long version,
+ *      unsigned int timeoutMs)
+ *
+ * \brief This function waits for a watcher to publish a snapshot newer
+ * than a version.
+ *
+ * \param watcher A pointer to the watcher of the file.
+ *
+ * \param version A version returned by GetSnapshotVersion.
+ *
+ * \param timeoutMs The maximum number of milliseconds to wait.
+ *
+ * \effects The calling thread blocks until a newer snapshot is published
+ * or the time runs out.
+ *
+ * \returns 1 if a newer snapshot has been published, 0 if not.
+ *
+ * Readers don't need to call this, AcquireSnapshot always returns the
+ * newest snapshot.  It is for threads that need to act on a reload.
+ */
+int WaitForSnapshot(ini_watcher_t *watcher, unsigned long version,
+    unsigned int timeoutMs)
+{
+    struct timespec until;
+    int result;
+
+    clock_gettime(CLOCK_REALTIME, &until);
+    until.tv_sec += timeoutMs / 1000;
+    until.tv_nsec += (long)(timeoutMs % 1000) * 1000000L;
+
+    if (until.tv_nsec >= 1000000000L)
+    {
+        until.tv_sec++;
+        until.tv_nsec -= 1000000000L;
+    }
+
+    result = 0;
+    pthread_mutex_lock(&(watcher->lock));
+
+    while ((watcher->version <= version) && (0 == result))
+    {
+        result = pthread_cond_timedwait(&(watcher->published),
+            &(watcher->lock), &until);
+    }
+
+    result = (watcher->version > version) ? 1 : 0;
+    pthread_mutex_unlock(&(watcher->lock));
+    return result;
+}
+
+
+/**
+ * \fn static void *WatchFile(void *watcher)
+ *
+ * \brief This function is the watching thread.  It reloads the file each
+ * time it changes until it is told to stop.
+ *
+ * \param watcher A pointer to the ini_watcher_t of the file.
+ *
+ * \effects New snapshots are published as the file changes.
+ *
+ * \returns NULL
+ */
+static void *WatchFile(void *watcher)
+{
+    ini_watcher_t *here;
+    ini_document_t *doc;
+    int changed;
+
+    here = (ini_watcher_t *)watcher;
+
+    while ((changed = WaitForChange(here)) >= 0)
+    {
+        if (0 == changed)
+        {
+            continue;
+        }
+
+        doc = LoadDocument(here->iniFile);
+
+        if (NULL == doc)
+        {
+            /* keep the old snapshot */
+            pthread_mutex_lock(&(here->lock));
+            here->errors++;
+            pthread_mutex_unlock(&(here->lock));
+            continue;
+        }
+
+        Publish(here, doc);
+    }
+
+    return NULL;
+}
+
+
+/**
+ * \fn static int WaitForChange(ini_watcher_t *watcher)
+ *
+ * \brief This function waits for a watched file to change.
+ *
+ * \param watcher A pointer to the watcher of the file.
+ *
+ * \effects
+ * With inotify, blocks until the file is written or replaced.  Otherwise
+ * waits pollMs and compares the file's status to the status when it was
+ * last loaded.  Modification times only have a resolution of a second, so
+ * a file modified in the second it was last loaded is treated as changed.
+ *
+ * \returns 1 if the file changed\n
+ *          0 if it didn't\n
+ *         -1 if the watcher is being stopped.
+ */
+static int WaitForChange(ini_watcher_t *watcher)
+{
+    struct pollfd fds[2];
+    struct stat status;
+    int count;
+
+    fds[0].fd = watcher->stopPipe[0];
+    fds[0].events = POLLIN;
+    fds[1].fd = watcher->notify;
+    fds[1].events = POLLIN;
+    count = (watcher->notify >= 0) ? 2 : 1;
+
+    if (poll(fds, count, (2 == count) ? -1 : (int)watcher->pollMs) < 0)
+    {
+        return (EINTR == errno) ? 0 : -1;
+    }
+
+    if (fds[0].revents)
+    {
+        return -1;
+    }
+
+#ifdef EZINI_INOTIFY
+    if (2 == count)
+    {
+        union
+        {
+            struct inotify_event event;
+            char data[4096];
+        } events;
+        ssize_t length;
+        ssize_t offset;
+        int changed;
+
+        if (0 == fds[1].revents)
+        {
+            return 0;
+        }
+
+        length = read(watcher->notify, &events, sizeof(events));
+        changed = 0;
+
+        for (offset = 0; offset < length; )
+        {
+            struct inotify_event *event;
+
+            event = (struct inotify_event *)(events.data + offset);
+
+            if ((event->len > 0) && (0 == strcmp(event->name, watcher->name)))
+            {
+                changed = 1;
+            }
+
+            offset += sizeof(struct inotify_event) + event->len;
+        }
+
+        return changed;
+    }
+#endif
+
+    if (0 != stat(watcher->iniFile, &status))
+    {
+        return 0;       /* missing, maybe being replaced */
+    }
+
+    if (SameFile(&status, &(watcher->status)) &&
+        (status.st_mtime < watcher->loaded))
+    {
+        return 0;
+    }
+
+    watcher->status = status;
+    watcher->loaded = time(NULL);
+    return 1;
+}
+
+
+/**
+ * \fn static void Publish(ini_watcher_t *watcher, ini_document_t *doc)
+ *
+ * \brief This function publishes a new snapshot and frees the old one once
+ * its readers are gone.
+ *
+ * \param watcher A pointer to the watcher of the file.
+ *
+ * \param doc A pointer to the new snapshot.
+ *
+ * \effects
+ * New readers get doc.  After the readers counted in the old epoch release
+ * their snapshots, the old snapshot is freed and waiters are woken.
+ *
+ * \returns Nothing
+ *
+ * A reader that joined the old epoch may hold either snapshot.  A reader
+ * that joined the new epoch did so after the flip, which follows the
+ * pointer store, so it can only hold doc.
+ */
+static void Publish(ini_watcher_t *watcher, ini_document_t *doc)
+{
+    ini_document_t *old;
+    long epoch;
+
+    old = watcher->current;
+    ATOMIC_STORE(&(watcher->current), doc);
+
+    epoch = watcher->epoch;     /* only this thread changes it */
+    ATOMIC_STORE(&(watcher->epoch), 1 - epoch);
+
+    while (0 != ATOMIC_LOAD(&(watcher->readers[epoch])))
+    {
+        poll(NULL, 0, 1);       /* wait for old readers to leave */
+    }
+
+    FreeDocument(old);
+
+    pthread_mutex_lock(&(watcher->lock));
+    watcher->version++;
+    pthread_cond_broadcast(&(watcher->published));
+    pthread_mutex_unlock(&(watcher->lock));
+}
+
+
+/**
+ * \fn static int SameFile(const struct stat *a, const struct stat *b)
+ *
+ * \brief This function compares the status of a file at two times.
+ *
+ * \param a A pointer to the first status.
+ *
+ * \param b A pointer to the second status.
+ *
+ * \effects None
+ *
+ * \returns Non-zero if the file appears unchanged.
+ */
+static int SameFile(const struct stat *a, const struct stat *b)
+{
+    return (a->st_dev == b->st_dev) && (a->st_ino == b->st_ino) &&
+        (a->st_size == b->st_size) && (a->st_mtime == b->st_mtime);
+}
+
+#ifdef EZINI_INOTIFY
+/**
+ * \fn static int WatchDirectory(const char *iniFile)
+ *
+ * \brief This function creates an inotify descriptor watching the
+ * directory containing a file for files being written or moved into it.
+ *
+ * \param iniFile The name of the file.
+ *
+ * \effects An inotify descriptor is opened.
+ *
+ * \returns The inotify descriptor, or -1 if the directory can't be watched
+ * (the caller should poll instead).
+ *
+ * The directory is watched rather than the file, so that a file replaced
+ * by renaming another file over it is still seen.
+ */
+static int WatchDirectory(const char *iniFile)
+{
+    const char *slash;
+    char *dir;
+    size_t length;
+    int notify;
+    int result;
+
+    slash = strrchr(iniFile, '/');
+
+    if (NULL == slash)
+    {
+        dir = NULL;
+        length = 0;
+    }
+    else
+    {
+        /* keep the slash if it is the root directory */
+        length = (slash == iniFile) ? 1 : (size_t)(slash - iniFile);
+        dir = (char *)AllocateINIMemory(length + 1);
+
+        if (NULL == dir)
+        {
+            return -1;
+        }
+
+        memcpy(dir, iniFile, length);
+        dir[length] = '\0';
+    }
+
+    notify = inotify_init();
+
+    if (notify < 0)
+    {
+        FreeINIMemory(dir);
+        return -1;
+    }
+
+    result = inotify_add_watch(notify, (NULL == dir) ? "." : dir,
+        IN_CLOSE_WRITE | IN_MOVED_TO);
+    FreeINIMemory(dir);
+
+    if (result < 0)
+    {
+        close(notify);
+        return -1;
+    }
+
+    return notify;
+}
+#endif
+
+#if !defined(__GNUC__)
+/**
+ * \fn static void LockAtomics(void)
+ *
+ * \brief This function begins an "atomic" operation on compilers without
+ * atomic builtins.
+ *
+ * \effects The lock serializing atomic operations is taken.
+ *
+ * \returns Nothing
+ */
+static void LockAtomics(void)
+{
+    pthread_mutex_lock(&atomicLock);
+}
+
+/**
+ * \fn static long UnlockAtomics(long value)
+ *
+ * \brief This function ends an "atomic" operation on compilers without
+ * atomic builtins.
+ *
+ * \param value The result of the operation.
+ *
+ * \effects The lock serializing atomic operations is released.
+ *
+ * \returns value
+ */
+static long UnlockAtomics(long value)
+{
+    pthread_mutex_unlock(&atomicLock);
+    return value;
+}
+
+/**
+ * \fn static void *UnlockPointer(void *value)
+ *
+ * \brief This function ends an "atomic" load of a pointer on compilers
+ * without atomic builtins.
+ *
+ * \param value The pointer loaded.
+ *
+ * \effects The lock serializing atomic operations is released.
+ *
+ * \returns value
+ */
+static void *UnlockPointer(void *value)
+{
+    pthread_mutex_unlock(&atomicLock);
+    return value;
+}
+#endif
+
+#else   /* EZINI_POSIX */
+
+/* watching needs threads, these versions always fail */
+ini_watcher_t *StartWatcher(const char *iniFile, unsigned int pollMs)
+{
+    (void)iniFile;
+    (void)pollMs;
+    errno = EINVAL;
+    return NULL;
+}
+
+void StopWatcher(ini_watcher_t *watcher)
+{
+    (void)watcher;
+}
+
+const ini_document_t *AcquireSnapshot(ini_watcher_t *watcher, int *token)
+{
+    (void)watcher;
+    *token = 0;
+    return NULL;
+}
+
+void ReleaseSnapshot(ini_watcher_t *watcher, int token)
+{
+    (void)watcher;
+    (void)token;
+}
+
+unsigned long GetSnapshotVersion(ini_watcher_t *watcher)
+{
+    (void)watcher;
+    return 0;
+}
+
+unsigned long GetWatcherErrors(ini_watcher_t *watcher)
+{
+    (void)watcher;
+    return 0;
+}
+
+int WaitForSnapshot(ini_watcher_t *watcher, unsigned long version,
+    unsigned int timeoutMs)
+{
+    (void)watcher;
+    (void)version;
+    (void)timeoutMs;
+    return 0;
+}
+
+#endif  /* EZINI_POSIX */
+
+/**@}*/
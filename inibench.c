@@ -0,0 +1,1499 @@
+/**
+ * \brief A benchmark suite for the ezini INI file handling library
+ * \file inibench.c
+ * \author Michael Dipperstein (mdipperstein@gmail.com)
+ * \date October 15, 2026
+ *
+ * This file generates synthetic INI files and times reading, building,
+ * writing, and modifying them with the ezini library.  Results are
+ * printed as JSON so that they may be saved and compared between versions.
+ *
+ * \copyright Copyright (C) 2026 by Michael Dipperstein
+ * (mdipperstein@gmail.com)
+ *
+ * \par
+ * This file is part of the ezini library.
+ *
+ * \license
+ * The ezini library is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * \par
+ * The ezini library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+ * General Public License for more details.
+ *
+ * \par
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \defgroup inibench Benchmark Suite
+ * \brief This module contains a program that generates synthetic INI files
+ * and measures the speed of the ezini INI file handling library.
+ * @{
+ */
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#if defined(__unix__) || defined(__unix) || \
+    (defined(__APPLE__) && defined(__MACH__))
+#define _POSIX_C_SOURCE 200112L
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+/*!
+  \def BENCH_POSIX
+  \brief Defined when benchmarks can be run in child processes and their
+  peak memory use measured.
+*/
+#define BENCH_POSIX
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include "ezini.h"
+
+/*!
+  \def inibench_main
+  \brief Hack so that Doxygen doesn't confuse this with sample.c's main
+*/
+#define inibench_main main
+
+/*!
+  \def CORPUS_FILE
+  \brief Name of the generated INI file that is benchmarked.
+*/
+#define CORPUS_FILE     "inibench.tmp.ini"
+
+/*!
+  \def OUTPUT_FILE
+  \brief Name of the INI file written by the writing benchmarks.
+*/
+#define OUTPUT_FILE     "inibench.out.ini"
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+
+/**
+ * \enum length_dist_t
+ * \brief Distributions of the lengths of generated values.
+ */
+typedef enum
+{
+    DIST_FIXED,         /*!< every value is the mean length */
+    DIST_UNIFORM,       /*!< uniform from 1 to twice the mean */
+    DIST_GEOMETRIC      /*!< geometric (many short, few long) */
+} length_dist_t;
+
+/**
+ * \struct corpus_t
+ * \brief A structure describing a synthetic INI file and holding its
+ * entries.
+ */
+typedef struct
+{
+    unsigned long sections;     /*!< number of sections */
+    unsigned long keys;         /*!< number of keys in each section */
+    unsigned long valueLength;  /*!< mean value length */
+    length_dist_t dist;         /*!< distribution of value lengths */
+    double commentDensity;      /*!< fraction of lines that are comments */
+    double longRatio;           /*!< fraction of values that are long */
+    unsigned long longLength;   /*!< length of long values */
+    unsigned long seed;         /*!< random number seed */
+    unsigned long edits;        /*!< entries changed by the file editing
+                                    benchmarks */
+    int reps;                   /*!< times each benchmark is repeated */
+
+    char **values;              /*!< generated values, sections * keys */
+    unsigned long bytes;        /*!< size of the generated file */
+} corpus_t;
+
+/**
+ * \struct result_t
+ * \brief A structure holding the measurements of a benchmark.
+ */
+typedef struct
+{
+    unsigned long ops;          /*!< operations performed in each rep */
+    unsigned long bytes;        /*!< bytes processed in each rep */
+    double seconds;             /*!< time taken by the fastest rep */
+} result_t;
+
+/**
+ * \typedef bench_t
+ * \brief A benchmark.  It runs reps times and fills in the result, returning
+ * 0 for success.
+ */
+typedef int (*bench_t)(const corpus_t *corpus, result_t *result);
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static int ParseOptions(int argc, char *argv[], corpus_t *corpus,
+    const char **output);
+static void ShowUsage(const char *name);
+static unsigned long Random(void);
+static double RandomFraction(void);
+static int Generate(corpus_t *corpus);
+static int WriteCorpus(corpus_t *corpus, const char *name);
+static void FreeCorpus(corpus_t *corpus);
+static void SectionName(char *name, unsigned long section);
+static void KeyName(char *name, unsigned long key);
+static double Now(void);
+static long PeakRSS(void);
+static int RunBench(const char *name, bench_t bench, const corpus_t *corpus,
+    int first);
+static void Keep(result_t *result, double start);
+static int BuildList(const corpus_t *corpus, ini_entry_list_t *list,
+    int arena);
+
+static int BenchGetEntryFromFile(const corpus_t *corpus, result_t *result);
+static int BenchGetEntryFromReader(const corpus_t *corpus, result_t *result);
+static int BenchReadEntryFromReader(const corpus_t *corpus,
+    result_t *result);
+static int BenchParseINIFile(const corpus_t *corpus, result_t *result);
+static int CountEntry(const char *key, size_t keyLength, const char *value,
+    size_t valueLength, void *user);
+static int BenchLoadDocument(const corpus_t *corpus, result_t *result);
+static int BenchLoadLazyDocument(const corpus_t *corpus, result_t *result);
+static int BenchAddEntryToList(const corpus_t *corpus, result_t *result);
+static int BenchAddEntryToArena(const corpus_t *corpus, result_t *result);
+static int BenchMakeINIFile(const corpus_t *corpus, result_t *result);
+static int BenchAddEntryToFile(const corpus_t *corpus, result_t *result);
+static int BenchDeleteEntryFromFile(const corpus_t *corpus,
+    result_t *result);
+
+/***************************************************************************
+*                            GLOBAL VARIABLES
+***************************************************************************/
+static unsigned long randomState = 1;   /* state of Random */
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/**
+ * \fn int inibench_main(int argc, char *argv[])
+ *
+ * \brief This function generates a synthetic INI file and either saves it
+ * or runs the benchmarks on it.
+ *
+ * \param argc The number of arguments.
+ *
+ * \param argv The options.  See ShowUsage.
+ *
+ * \effects
+ * With -o the generated file is saved.  Otherwise each benchmark is run and
+ * the results are printed as JSON.
+ *
+ * \returns 0 for success, 1 on error.
+ */
+int inibench_main(int argc, char *argv[])
+{
+    static const struct
+    {
+        const char *name;
+        bench_t bench;
+    } benches[] =
+    {
+        {"GetEntryFromFile", BenchGetEntryFromFile},
+        {"GetEntryFromReader", BenchGetEntryFromReader},
+        {"ReadEntryFromReader", BenchReadEntryFromReader},
+        {"ParseINIFile", BenchParseINIFile},
+        {"LoadDocument", BenchLoadDocument},
+        {"LoadLazyDocument", BenchLoadLazyDocument},
+        {"AddEntryToList", BenchAddEntryToList},
+        {"AddEntryToList (arena)", BenchAddEntryToArena},
+        {"MakeINIFile", BenchMakeINIFile},
+        {"AddEntryToFile", BenchAddEntryToFile},
+        {"DeleteEntryFromFile", BenchDeleteEntryFromFile}
+    };
+    static const char *dists[] = {"fixed", "uniform", "geometric"};
+    corpus_t corpus;
+    const char *output;
+    int failures;
+    size_t i;
+
+    if (0 != ParseOptions(argc, argv, &corpus, &output))
+    {
+        ShowUsage(argv[0]);
+        return 1;
+    }
+
+    if ((0 != Generate(&corpus)) ||
+        (0 != WriteCorpus(&corpus, (NULL == output) ? CORPUS_FILE : output)))
+    {
+        fprintf(stderr, "Error generating INI file\n");
+        FreeCorpus(&corpus);
+        return 1;
+    }
+
+    if (NULL != output)
+    {
+        FreeCorpus(&corpus);
+        return 0;
+    }
+
+    printf("{\n  \"corpus\": {\"sections\": %lu, \"keys_per_section\": %lu, "
+        "\"entries\": %lu, \"bytes\": %lu,\n", corpus.sections, corpus.keys,
+        corpus.sections * corpus.keys, corpus.bytes);
+    printf("    \"value_length\": %lu, \"value_distribution\": \"%s\", "
+        "\"comment_density\": %g,\n", corpus.valueLength, dists[corpus.dist],
+        corpus.commentDensity);
+    printf("    \"long_line_ratio\": %g, \"long_line_length\": %lu, "
+        "\"seed\": %lu, \"edits\": %lu, \"reps\": %d},\n", corpus.longRatio,
+        corpus.longLength, corpus.seed, corpus.edits, corpus.reps);
+    printf("  \"results\": [\n");
+
+    failures = 0;
+
+    for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++)
+    {
+        failures += RunBench(benches[i].name, benches[i].bench, &corpus,
+            (0 == i));
+    }
+
+    printf("\n  ]\n}\n");
+    remove(CORPUS_FILE);
+    remove(OUTPUT_FILE);
+    FreeCorpus(&corpus);
+    return (0 == failures) ? 0 : 1;
+}
+
+/**
+ * \fn static int ParseOptions(int argc, char *argv[], corpus_t *corpus,
+ *      const char **output)
+ *
+ * \brief This function sets the corpus parameters from the command line.
+ *
+ * \param argc The number of arguments.
+ *
+ * \param argv The arguments.
+ *
+ * \param corpus A pointer to the corpus being described.
+ *
+ * \param output Set to the name of the file to save the corpus in, or NULL
+ * if the benchmarks should be run.
+ *
+ * \effects corpus is initialized.
+ *
+ * \returns 0 for success, Non-zero if the arguments are invalid.
+ */
+static int ParseOptions(int argc, char *argv[], corpus_t *corpus,
+    const char **output)
+{
+    const char *arg;
+    int i;
+
+    corpus->sections = 2000;
+    corpus->keys = 50;
+    corpus->valueLength = 16;
+    corpus->dist = DIST_UNIFORM;
+    corpus->commentDensity = 0.1;
+    corpus->longRatio = 0.001;
+    corpus->longLength = 4096;
+    corpus->seed = 1;
+    corpus->edits = 50;
+    corpus->reps = 3;
+    corpus->values = NULL;
+    corpus->bytes = 0;
+    *output = NULL;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (('-' != argv[i][0]) || ('\0' == argv[i][1]) ||
+            ('\0' != argv[i][2]) || (i + 1 == argc))
+        {
+            return -1;
+        }
+
+        arg = argv[i + 1];
+
+        switch (argv[i][1])
+        {
+            case 's':
+                corpus->sections = strtoul(arg, NULL, 10);
+                break;
+
+            case 'k':
+                corpus->keys = strtoul(arg, NULL, 10);
+                break;
+
+            case 'v':
+                corpus->valueLength = strtoul(arg, NULL, 10);
+                break;
+
+            case 'd':
+                if (0 == strcmp(arg, "fixed"))
+                {
+                    corpus->dist = DIST_FIXED;
+                }
+                else if (0 == strcmp(arg, "uniform"))
+                {
+                    corpus->dist = DIST_UNIFORM;
+                }
+                else if (0 == strcmp(arg, "geometric"))
+                {
+                    corpus->dist = DIST_GEOMETRIC;
+                }
+                else
+                {
+                    return -1;
+                }
+                break;
+
+            case 'c':
+                corpus->commentDensity = atof(arg);
+                break;
+
+            case 'l':
+                corpus->longRatio = atof(arg);
+                break;
+
+            case 'L':
+                corpus->longLength = strtoul(arg, NULL, 10);
+                break;
+
+            case 'S':
+                corpus->seed = strtoul(arg, NULL, 10);
+                break;
+
+            case 'e':
+                corpus->edits = strtoul(arg, NULL, 10);
+                break;
+
+            case 'r':
+                corpus->reps = atoi(arg);
+                break;
+
+            case 'o':
+                *output = arg;
+                break;
+
+            default:
+                return -1;
+        }
+
+        i++;
+    }
+
+    if ((0 == corpus->sections) || (0 == corpus->keys) ||
+        (0 == corpus->valueLength) || (corpus->commentDensity < 0.0) ||
+        (corpus->commentDensity >= 1.0) || (corpus->longRatio < 0.0) ||
+        (corpus->longRatio > 1.0) || (corpus->reps < 1))
+    {
+        return -1;
+    }
+
+    if (corpus->edits > corpus->sections * corpus->keys)
+    {
+        corpus->edits = corpus->sections * corpus->keys;
+    }
+
+    return 0;
+}
+
+/**
+ * \fn static void ShowUsage(const char *name)
+ *
+ * \brief This function prints the command line options.
+ *
+ * \param name The name the program was run as.
+ *
+ * \effects The usage message is printed.
+ *
+ * \returns Nothing
+ */
+static void ShowUsage(const char *name)
+{
+    printf("Usage: %s [options]\n\n", name);
+    printf("Generates an INI file and prints benchmark results as JSON\n");
+    printf("  -s n     sections (2000)\n");
+    printf("  -k n     keys per section (50)\n");
+    printf("  -v n     mean value length (16)\n");
+    printf("  -d dist  value lengths: fixed, uniform, or geometric "
+        "(uniform)\n");
+    printf("  -c f     fraction of lines that are comments (0.1)\n");
+    printf("  -l f     fraction of values that are long (0.001)\n");
+    printf("  -L n     length of long values (4096)\n");
+    printf("  -S n     random number seed (1)\n");
+    printf("  -e n     entries changed by the file editing benchmarks (50)\n");
+    printf("  -r n     repetitions of each benchmark, the fastest is "
+        "reported (3)\n");
+    printf("  -o file  save the generated INI file instead of benchmarking\n");
+}
+
+/**
+ * \fn static unsigned long Random(void)
+ *
+ * \brief This function returns a pseudo-random number, so that corpora are
+ * the same on every system for a given seed.
+ *
+ * \effects The generator's state is advanced.
+ *
+ * \returns A pseudo-random number from 0 to 2^31 - 1.
+ */
+static unsigned long Random(void)
+{
+    /* 64 bit LCG computed in 32 bit halves, long may be 32 bits */
+    randomState = (randomState * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+    return randomState >> 1;
+}
+
+/**
+ * \fn static double RandomFraction(void)
+ *
+ * \brief This function returns a pseudo-random fraction.
+ *
+ * \effects The generator's state is advanced.
+ *
+ * \returns A pseudo-random number in [0, 1).
+ */
+static double RandomFraction(void)
+{
+    return (double)Random() / 2147483648.0;
+}
+
+/**
+ * \fn static int Generate(corpus_t *corpus)
+ *
+ * \brief This function generates the values of a corpus.
+ *
+ * \param corpus A pointer to the corpus.
+ *
+ * \effects Memory is allocated for the values.
+ *
+ * \returns 0 for success, Non-zero on error.
+ */
+static int Generate(corpus_t *corpus)
+{
+    unsigned long count;
+    unsigned long length;
+    unsigned long i;
+    unsigned long j;
+
+    randomState = corpus->seed;
+    count = corpus->sections * corpus->keys;
+    corpus->values = (char **)calloc(count, sizeof(char *));
+
+    if (NULL == corpus->values)
+    {
+        return -1;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if (RandomFraction() < corpus->longRatio)
+        {
+            length = corpus->longLength;
+        }
+        else if (DIST_FIXED == corpus->dist)
+        {
+            length = corpus->valueLength;
+        }
+        else if (DIST_UNIFORM == corpus->dist)
+        {
+            length = 1 + (Random() % (2 * corpus->valueLength));
+        }
+        else
+        {
+            /* geometric with the requested mean */
+            for (length = 1; (length < 64 * corpus->valueLength) &&
+                (RandomFraction() * corpus->valueLength >= 1.0); length++)
+            {
+            }
+        }
+
+        corpus->values[i] = (char *)malloc(length + 1);
+
+        if (NULL == corpus->values[i])
+        {
+            return -1;
+        }
+
+        for (j = 0; j < length; j++)
+        {
+            corpus->values[i][j] = "abcdefghijklmnopqrstuvwxyz0123456789 "
+                [Random() % 37];
+        }
+
+        /* values are trimmed when read, so don't start or end with ' ' */
+        corpus->values[i][0] = 'v';
+        corpus->values[i][length - 1] = 'v';
+        corpus->values[i][length] = '\0';
+    }
+
+    return 0;
+}
+
+/**
+ * \fn static int WriteCorpus(corpus_t *corpus, const char *name)
+ *
+ * \brief This function writes a corpus as an INI file, with comments mixed
+ * in.
+ *
+ * \param corpus A pointer to the corpus.
+ *
+ * \param name The name of the file to write.
+ *
+ * \effects The file is written and corpus->bytes is set to its size.
+ *
+ * \returns 0 for success, Non-zero on error.
+ */
+static int WriteCorpus(corpus_t *corpus, const char *name)
+{
+    FILE *fp;
+    char section[32];
+    char key[32];
+    unsigned long i;
+    unsigned long j;
+    long size;
+
+    fp = fopen(name, "w");
+
+    if (NULL == fp)
+    {
+        return -1;
+    }
+
+    for (i = 0; i < corpus->sections; i++)
+    {
+        SectionName(section, i);
+        fprintf(fp, "[%s]\n", section);
+
+        for (j = 0; j < corpus->keys; j++)
+        {
+            /* each line is a comment with probability commentDensity */
+            while (RandomFraction() < corpus->commentDensity)
+            {
+                fprintf(fp, "; comment %lu\n", Random());
+            }
+
+            KeyName(key, j);
+            fprintf(fp, "%s = %s\n", key,
+                corpus->values[(i * corpus->keys) + j]);
+        }
+
+        fputc('\n', fp);
+    }
+
+    size = ftell(fp);
+
+    if ((0 != fclose(fp)) || (size < 0))
+    {
+        return -1;
+    }
+
+    corpus->bytes = (unsigned long)size;
+    return 0;
+}
+
+/**
+ * \fn static void FreeCorpus(corpus_t *corpus)
+ *
+ * \brief This function frees the values of a corpus.
+ *
+ * \param corpus A pointer to the corpus.
+ *
+ * \effects The memory allocated by Generate is freed.
+ *
+ * \returns Nothing
+ */
+static void FreeCorpus(corpus_t *corpus)
+{
+    unsigned long i;
+
+    if (NULL == corpus->values)
+    {
+        return;
+    }
+
+    for (i = 0; i < corpus->sections * corpus->keys; i++)
+    {
+        free(corpus->values[i]);
+    }
+
+    free(corpus->values);
+    corpus->values = NULL;
+}
+
+/**
+ * \fn static void SectionName(char *name, unsigned long section)
+ *
+ * \brief This function makes the name of a corpus section.
+ *
+ * \param name A buffer of at least 32 characters receiving the name.
+ *
+ * \param section The number of the section.
+ *
+ * \effects name is written.
+ *
+ * \returns Nothing
+ */
+static void SectionName(char *name, unsigned long section)
+{
+    sprintf(name, "section_%lu", section);
+}
+
+/**
+ * \fn static void KeyName(char *name, unsigned long key)
+ *
+ * \brief This function makes the name of a corpus key.
+ *
+ * \param name A buffer of at least 32 characters receiving the name.
+ *
+ * \param key The number of the key within its section.
+ *
+ * \effects name is written.
+ *
+ * \returns Nothing
+ */
+static void KeyName(char *name, unsigned long key)
+{
+    sprintf(name, "key_%lu", key);
+}
+
+/**
+ * \fn static double Now(void)
+ *
+ * \brief This function returns the current time for measuring intervals.
+ *
+ * \effects None
+ *
+ * \returns The time in seconds.  Only differences are meaningful.
+ */
+static double Now(void)
+{
+#ifdef BENCH_POSIX
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + ((double)now.tv_nsec / 1e9);
+#else
+    return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+/**
+ * \fn static long PeakRSS(void)
+ *
+ * \brief This function returns the peak resident set size of the process.
+ *
+ * \effects None
+ *
+ * \returns The peak resident set size in kilobytes, or -1 if it can't be
+ * measured.
+ */
+static long PeakRSS(void)
+{
+#ifdef BENCH_POSIX
+    struct rusage usage;
+
+    if (0 != getrusage(RUSAGE_SELF, &usage))
+    {
+        return -1;
+    }
+
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024;          /* bytes on macOS */
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return -1;
+#endif
+}
+
+/**
+ * \fn static int RunBench(const char *name, bench_t bench,
+ *      const corpus_t *corpus, int first)
+ *
+ * \brief This function runs a benchmark and prints its results as a JSON
+ * object.
+ *
+ * \param name The name of the benchmark.
+ *
+ * \param bench The benchmark function.
+ *
+ * \param corpus A pointer to the corpus being benchmarked.
+ *
+ * \param first Non-zero for the first benchmark (no separating comma).
+ *
+ * \effects
+ * The benchmark is run in a child process, so that the peak memory use
+ * reported is its own.  Without POSIX it runs in this process and the peak
+ * covers everything run so far.
+ *
+ * \returns 0 for success, 1 if the benchmark failed.
+ */
+static int RunBench(const char *name, bench_t bench, const corpus_t *corpus,
+    int first)
+{
+    result_t result;
+    ini_stats_t stats;
+    int failed;
+#ifdef BENCH_POSIX
+    pid_t child;
+    int status;
+#endif
+
+    printf("%s    {\"name\": \"%s\", ", first ? "" : ",\n", name);
+    fflush(stdout);
+
+#ifdef BENCH_POSIX
+    child = fork();
+
+    if (child < 0)
+    {
+        printf("\"error\": \"fork failed\"}");
+        return 1;
+    }
+
+    if (child > 0)
+    {
+        if ((waitpid(child, &status, 0) != child) || !WIFEXITED(status) ||
+            (0 != WEXITSTATUS(status)))
+        {
+            printf("\"error\": \"failed\"}");
+            return 1;
+        }
+
+        return 0;
+    }
+#endif
+
+    result.ops = 0;
+    result.bytes = 0;
+    result.seconds = -1.0;
+    ResetINIStats();
+    failed = bench(corpus, &result);
+
+    if (failed || (result.seconds <= 0.0))
+    {
+        /* let the parent report it */
+        fflush(stdout);
+#ifdef BENCH_POSIX
+        _exit(1);
+#else
+        printf("\"error\": \"failed\"}");
+        return 1;
+#endif
+    }
+
+    printf("\"ops\": %lu, \"bytes\": %lu, \"seconds\": %.6f, "
+        "\"ns_per_op\": %.1f, \"mb_per_s\": %.1f, \"peak_rss_kb\": %ld",
+        result.ops, result.bytes, result.seconds,
+        (result.seconds * 1e9) / result.ops,
+        (result.bytes / result.seconds) / 1e6, PeakRSS());
+
+    /* library statistics of every rep and its setup (make STATS=1) */
+    if (0 == GetINIStats(&stats))
+    {
+        printf(",\n      \"stats\": {\"lines_read\": %lu, "
+            "\"bytes_scanned\": %lu, \"entries_emitted\": %lu, "
+            "\"allocations\": %lu,\n        \"bytes_allocated\": %lu, "
+            "\"line_reallocs\": %lu, \"writes\": %lu, \"syncs\": %lu, "
+            "\"sync_seconds\": %.6f}",
+            stats.linesRead, stats.bytesScanned, stats.entriesEmitted,
+            stats.allocations, stats.bytesAllocated, stats.lineReallocs,
+            stats.writes, stats.syncs, stats.syncSeconds);
+    }
+
+    printf("}");
+    fflush(stdout);
+
+#ifdef BENCH_POSIX
+    _exit(0);
+#else
+    return 0;
+#endif
+}
+
+/**
+ * \fn static void Keep(result_t *result, double start)
+ *
+ * \brief This function records the time of a rep if it is the fastest.
+ *
+ * \param result A pointer to the benchmark's result.
+ *
+ * \param start The time the rep started.
+ *
+ * \effects result->seconds is updated.
+ *
+ * \returns Nothing
+ */
+static void Keep(result_t *result, double start)
+{
+    double seconds;
+
+    seconds = Now() - start;
+
+    if ((result->seconds < 0.0) || (seconds < result->seconds))
+    {
+        result->seconds = seconds;
+    }
+}
+
+/**
+ * \fn static int BuildList(const corpus_t *corpus, ini_entry_list_t *list,
+ *      int arena)
+ *
+ * \brief This function builds an entry list holding a corpus.
+ *
+ * \param corpus A pointer to the corpus.
+ *
+ * \param list A pointer to the ini_entry_list_t that will point to the list.
+ *
+ * \param arena Non-zero if the list should be arena backed.
+ *
+ * \effects The list is built.
+ *
+ * \returns 0 for success, Non-zero on error.
+ */
+static int BuildList(const corpus_t *corpus, ini_entry_list_t *list,
+    int arena)
+{
+    char section[32];
+    char key[32];
+    unsigned long i;
+    unsigned long j;
+
+    *list = NULL;
+
+    if (arena && (0 != NewArenaList(list)))
+    {
+        return -1;
+    }
+
+    for (i = 0; i < corpus->sections; i++)
+    {
+        SectionName(section, i);
+
+        for (j = 0; j < corpus->keys; j++)
+        {
+            KeyName(key, j);
+
+            if (0 != AddEntryToList(list, section, key,
+                corpus->values[(i * corpus->keys) + j]))
+            {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * \fn static int BenchGetEntryFromFile(const corpus_t *corpus,
+ *      result_t *result)
+ *
+ * \brief This function times streaming the corpus with GetEntryFromFile.
+ *
+ * \param corpus A pointer to the corpus.
+ *
+ * \param result A pointer to the result being measured.
+ *
+ * \effects The corpus file is read.
+ *
+ * \returns 0 for success, Non-zero on error.
+ */
+static int BenchGetEntryFromFile(const corpus_t *corpus, result_t *result)
+{
+    ini_entry_t entry;
+    FILE *fp;
+    double start;
+    int rep;
+
+    for (rep = 0; rep < corpus->reps; rep++)
+    {
+        fp = fopen(CORPUS_FILE, "r");
+
+        if (NULL == fp)
+        {
+            return -1;
+        }
+
+        entry.section = NULL;
+        entry.key = NULL;
+        entry.value = NULL;
+        result->ops = 0;
+        start = Now();
+
+        while (GetEntryFromFile(fp, &entry) > 0)
+        {
+            result->ops++;
+        }
+
+        Keep(result, start);
+        fclose(fp);
+    }
+
+    result->bytes = corpus->bytes;
+    return 0;
+}
+
+/**
+ * \fn static int BenchGetEntryFromReader(const corpus_t *corpus,
+ *      result_t *result)
+ *
+ * \brief This function times streaming the corpus with GetEntryFromReader.
+ *
+ * \param corpus A pointer to the corpus.
+ *
+ * \param result A pointer to the result being measured.
+ *
+ * \effects The corpus file is read.
+ *
+ * \returns 0 for success, Non-zero on error.
+ */
+static int BenchGetEntryFromReader(const corpus_t *corpus, result_t *result)
+{
+    ini_entry_t entry;
+    ini_reader_t *reader;
+    FILE *fp;
+    double start;
+    int rep;
+
+    for (rep = 0; rep < corpus->reps; rep++)
+    {
+        fp = fopen(CORPUS_FILE, "r");
+
+        if (NULL == fp)
+        {
+            return -1;
+        }
+
+        entry.section = NULL;
+        entry.key = NULL;
+        entry.value = NULL;
+        result->ops = 0;
+        start = Now();
+        reader = NewReader(fp);
+
+        while ((NULL != reader) && (GetEntryFromReader(reader, &entry) > 0))
+        {
+            result->ops++;
+        }
+
+        FreeReader(reader);
+        Keep(result, start);
+        fclose(fp);
+    }
+
+    result->bytes = corpus->bytes;
+    return 0;
+}
+
+/**
+ * \fn static int BenchReadEntryFromReader(const corpus_t *corpus,
+ *      result_t *result)
+ *
+ * \brief This function times streaming the corpus into an entry buffer
+ * with ReadEntryFromReader.
+ *
+ * \param corpus A pointer to the corpus.
+ *
+ * \param result A pointer to the result being measured.
+ *
+ * \effects The corpus file is read.
+ *
+ * \returns 0 for success, Non-zero on error.
+ */
+static int BenchReadEntryFromReader(const corpus_t *corpus,
+    result_t *result)
+{
+    ini_entry_buffer_t buffer;
+    ini_reader_t *reader;
+    FILE *fp;
+    double start;
+    int rep;
+
+    InitEntryBuffer(&buffer);
+
+    for (rep = 0; rep < corpus->reps; rep++)
+    {
+        fp = fopen(CORPUS_FILE, "r");
+
+        if (NULL == fp)
+        {
+            return -1;
+        }
+
+        result->ops = 0;
+        start = Now();
+        reader = NewReader(fp);
+
+        while ((NULL != reader) && (ReadEntryFromReader(reader, &buffer) > 0))
+        {
+            result->ops++;
+        }
+
+        FreeReader(reader);
+        Keep(result, start);
+        fclose(fp);
+    }
+
+    FreeEntryBuffer(&buffer);
+    result->bytes = corpus->bytes;
+    return 0;
+}
+
+/**
+ * \fn static int BenchParseINIFile(const corpus_t *corpus,
+ *      result_t *result)
+ *
+ * \brief This function times passing the corpus entries to a handler with
+ * ParseINIFile.
+ *
+ * \param corpus A pointer to the corpus.
+ *
+ * \param result A pointer to the result being measured.
+ *
+ * \effects The corpus file is read.
+ *
+ * \returns 0 for success, Non-zero on error.
+ */
+static int BenchParseINIFile(const corpus_t *corpus, result_t *result)
+{
+    ini_handler_t handler;
+    double start;
+    int rep;
+
+    handler.onSection = NULL;
+    handler.onEntry = CountEntry;
+    handler.user = &(result->ops);
+
+    for (rep = 0; rep < corpus->reps; rep++)
+    {
+        result->ops = 0;
+        start = Now();
+
+        if (0 != ParseINIFile(CORPUS_FILE, &handler))
+        {
+            return -1;
+        }
+
+        Keep(result, start);
+    }
+
+    result->bytes = corpus->bytes;
+    return 0;
+}
+
+/**
+ * \fn static int CountEntry(const char *key, size_t keyLength,
+ *      const char *value, size_t valueLength, void *user)
+ *
+ * \brief This function is the ParseINIFile handler that counts entries.
+ *
+ * \param key The key of the entry (unused).
+ *
+ * \param keyLength The number of characters in key (unused).
+ *
+ * \param value The value of the entry (unused).
+ *
+ * \param valueLength The number of characters in value (unused).
+ *
+ * \param user A pointer to the unsigned long count of entries.
+ *
+ * \effects The count is incremented.
+ *
+ * \returns 0 to continue parsing.
+ */
+static int CountEntry(const char *key, size_t keyLength, const char *value,
+    size_t valueLength, void *user)
+{
+    (void)key;
+    (void)keyLength;
+    (void)value;
+    (void)valueLength;
+    (*(unsigned long *)user)++;
+    return 0;
+}
+
+/**
+ * \fn static int BenchLoadDocument(const corpus_t *corpus,
+ *      result_t *result)
+ *
+ * \brief This function times loading the corpus with LoadDocument.
+ *
+ * \param corpus A pointer to the corpus.
+ *
+ * \param result A pointer to the result being measured.
+ *
+ * \effects The corpus file is read.
+ *
+ * \returns 0 for success, Non-zero on error.
+ */
+static int BenchLoadDocument(const corpus_t *corpus, result_t *result)
+{
+    ini_document_t *doc;
+    double start;
+    int rep;
+
+    for (rep = 0; rep < corpus->reps; rep++)
+    {
+        start = Now();
+        doc = LoadDocument(CORPUS_FILE);
+        Keep(result, start);
+
+        if (NULL == doc)
+        {
+            return -1;
+        }
+
+        FreeDocument(doc);
+    }
+
+    result->ops = corpus->sections * corpus->keys;
+    result->bytes = corpus->bytes;
+    return 0;
+}
+
+/**
+ * \fn static int BenchLoadLazyDocument(const corpus_t *corpus,
+ *      result_t *result)
+ *
+ * \brief This function times loading the corpus with LoadLazyDocument and
+ * reading every key of its first and middle sections.
+ *
+ * \param corpus A pointer to the corpus.
+ *
+ * \param result A pointer to the result being measured.
+ *
+ * \effects The corpus file is read.
+ *
+ * \returns 0 for success, Non-zero on error.
+ */
+static int BenchLoadLazyDocument(const corpus_t *corpus, result_t *result)
+{
+    ini_document_t *doc;
+    char section[32];
+    char key[32];
+    double start;
+    unsigned long i;
+    unsigned long j;
+    int rep;
+
+    for (rep = 0; rep < corpus->reps; rep++)
+    {
+        start = Now();
+        doc = LoadLazyDocument(CORPUS_FILE);
+
+        for (i = 0; (NULL != doc) && (i < 2); i++)
+        {
+            SectionName(section, i * (corpus->sections / 2));
+
+            for (j = 0; j < corpus->keys; j++)
+            {
+                KeyName(key, j);
+
+                if (NULL == GetValueFromDocument(doc, section, key))
+                {
+                    FreeDocument(doc);
+                    return -1;
+                }
+            }
+        }
+
+        Keep(result, start);
+
+        if (NULL == doc)
+        {
+            return -1;
+        }
+
+        FreeDocument(doc);
+    }
+
+    result->ops = 2 * corpus->keys;
+    result->bytes = corpus->bytes;
+    return 0;
+}
+
+/**
+ * \fn static int BenchAddEntryToList(const corpus_t *corpus,
+ *      result_t *result)
+ *
+ * \brief This function times building a list of the corpus entries with
+ * AddEntryToList.
+ *
+ * \param corpus A pointer to the corpus.
+ *
+ * \param result A pointer to the result being measured.
+ *
+ * \effects None
+ *
+ * \returns 0 for success, Non-zero on error.
+ */
+static int BenchAddEntryToList(const corpus_t *corpus, result_t *result)
+{
+    ini_entry_list_t list;
+    double start;
+    int rep;
+
+    for (rep = 0; rep < corpus->reps; rep++)
+    {
+        start = Now();
+
+        if (0 != BuildList(corpus, &list, 0))
+        {
+            FreeList(list);
+            return -1;
+        }
+
+        Keep(result, start);
+        FreeList(list);
+    }
+
+    result->ops = corpus->sections * corpus->keys;
+    result->bytes = corpus->bytes;
+    return 0;
+}
+
+/**
+ * \fn static int BenchAddEntryToArena(const corpus_t *corpus,
+ *      result_t *result)
+ *
+ * \brief This function times building an arena backed list of the corpus
+ * entries with AddEntryToList.
+ *
+ * \param corpus A pointer to the corpus.
+ *
+ * \param result A pointer to the result being measured.
+ *
+ * \effects None
+ *
+ * \returns 0 for success, Non-zero on error.
+ */
+static int BenchAddEntryToArena(const corpus_t *corpus, result_t *result)
+{
+    ini_entry_list_t list;
+    double start;
+    int rep;
+
+    for (rep = 0; rep < corpus->reps; rep++)
+    {
+        start = Now();
+
+        if (0 != BuildList(corpus, &list, 1))
+        {
+            FreeList(list);
+            return -1;
+        }
+
+        Keep(result, start);
+        FreeList(list);
+    }
+
+    result->ops = corpus->sections * corpus->keys;
+    result->bytes = corpus->bytes;
+    return 0;
+}
+
+/**
+ * \fn static int BenchMakeINIFile(const corpus_t *corpus, result_t *result)
+ *
+ * \brief This function times writing a list of the corpus entries with
+ * MakeINIFile.
+ *
+ * \param corpus A pointer to the corpus.
+ *
+ * \param result A pointer to the result being measured.
+ *
+ * \effects OUTPUT_FILE is written.
+ *
+ * \returns 0 for success, Non-zero on error.
+ */
+static int BenchMakeINIFile(const corpus_t *corpus, result_t *result)
+{
+    ini_entry_list_t list;
+    double start;
+    int rep;
+
+    if (0 != BuildList(corpus, &list, 1))
+    {
+        FreeList(list);
+        return -1;
+    }
+
+    for (rep = 0; rep < corpus->reps; rep++)
+    {
+        start = Now();
+
+        if (0 != MakeINIFile(OUTPUT_FILE, list))
+        {
+            FreeList(list);
+            return -1;
+        }
+
+        Keep(result, start);
+    }
+
+    FreeList(list);
+    result->ops = corpus->sections * corpus->keys;
+    result->bytes = corpus->bytes;
+    return 0;
+}
+
+/**
+ * \fn static int BenchAddEntryToFile(const corpus_t *corpus,
+ *      result_t *result)
+ *
+ * \brief This function times changing values spread through a copy of the
+ * corpus file with AddEntryToFile.
+ *
+ * \param corpus A pointer to the corpus.
+ *
+ * \param result A pointer to the result being measured.
+ *
+ * \effects OUTPUT_FILE is written and modified.
+ *
+ * \returns 0 for success, Non-zero on error.  Each operation is one changed
+ * entry, all of them are written by a single call.
+ */
+static int BenchAddEntryToFile(const corpus_t *corpus, result_t *result)
+{
+    ini_entry_list_t list;
+    char section[32];
+    char key[32];
+    char value[48];
+    unsigned long count;
+    unsigned long entry;
+    unsigned long i;
+    double start;
+    int rep;
+
+    count = corpus->sections * corpus->keys;
+
+    for (rep = 0; rep < corpus->reps; rep++)
+    {
+        if (0 != BuildList(corpus, &list, 1))
+        {
+            FreeList(list);
+            return -1;
+        }
+
+        if (0 != MakeINIFile(OUTPUT_FILE, list))
+        {
+            FreeList(list);
+            return -1;
+        }
+
+        FreeList(list);
+        list = NULL;
+
+        for (i = 0; i < corpus->edits; i++)
+        {
+            /* spread the changes evenly through the file */
+            entry = (i * count) / corpus->edits;
+            SectionName(section, entry / corpus->keys);
+            KeyName(key, entry % corpus->keys);
+            sprintf(value, "changed %d %lu", rep, i);
+
+            if (0 != AddEntryToList(&list, section, key, value))
+            {
+                FreeList(list);
+                return -1;
+            }
+        }
+
+        start = Now();
+
+        if (0 != AddEntryToFile(OUTPUT_FILE, list))
+        {
+            FreeList(list);
+            return -1;
+        }
+
+        Keep(result, start);
+        FreeList(list);
+    }
+
+    result->ops = corpus->edits;
+    result->bytes = corpus->bytes;
+    return 0;
+}
+
+/**
+ * \fn static int BenchDeleteEntryFromFile(const corpus_t *corpus,
+ *      result_t *result)
+ *
+ * \brief This function times deleting entries spread through a copy of the
+ * corpus file with DeleteEntryFromFile.
+ *
+ * \param corpus A pointer to the corpus.
+ *
+ * \param result A pointer to the result being measured.
+ *
+ * \effects OUTPUT_FILE is written and modified.
+ *
+ * \returns 0 for success, Non-zero on error.  Each operation is one call
+ * deleting one entry.
+ */
+static int BenchDeleteEntryFromFile(const corpus_t *corpus,
+    result_t *result)
+{
+    ini_entry_list_t list;
+    char section[32];
+    char key[32];
+    unsigned long count;
+    unsigned long entry;
+    unsigned long i;
+    double start;
+    int rep;
+
+    count = corpus->sections * corpus->keys;
+
+    for (rep = 0; rep < corpus->reps; rep++)
+    {
+        if (0 != BuildList(corpus, &list, 1))
+        {
+            FreeList(list);
+            return -1;
+        }
+
+        if (0 != MakeINIFile(OUTPUT_FILE, list))
+        {
+            FreeList(list);
+            return -1;
+        }
+
+        FreeList(list);
+        start = Now();
+
+        for (i = 0; i < corpus->edits; i++)
+        {
+            entry = (i * count) / corpus->edits;
+            SectionName(section, entry / corpus->keys);
+            KeyName(key, entry % corpus->keys);
+
+            if (0 != DeleteEntryFromFile(OUTPUT_FILE, section, key))
+            {
+                return -1;
+            }
+        }
+
+        Keep(result, start);
+    }
+
+    /* every call rewrites the file */
+    result->ops = corpus->edits;
+    result->bytes = corpus->bytes * corpus->edits;
+    return 0;
+}
+
+/**@}*/
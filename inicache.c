@@ -0,0 +1,168 @@
+/**
+ * \brief A program that compiles INI files into binary caches
+ * \file inicache.c
+ * \author Michael Dipperstein (mdipperstein@gmail.com)
+ * \date October 15, 2026
+ *
+ * This file compiles INI files into the binary cache images loaded by
+ * LoadCachedDocument, or checks whether existing caches are up to date.
+ *
+ * \copyright Copyright (C) 2026 by Michael Dipperstein
+ * (mdipperstein@gmail.com)
+ *
+ * \par
+ * This file is part of the ezini library.
+ *
+ * \license
+ * The ezini library is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * \par
+ * The ezini library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+ * General Public License for more details.
+ *
+ * \par
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \defgroup inicache INI Cache Compiler
+ * \brief This module contains a program that compiles INI files into binary
+ * cache images.
+ * @{
+ */
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include "ezini.h"
+
+/*!
+  \def inicache_main
+  \brief Hack so that Doxygen doesn't confuse this with sample.c's main
+*/
+#define inicache_main main
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static void ShowUsage(const char *name);
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/**
+ * \fn int inicache_main(int argc, char *argv[])
+ *
+ * \brief This function compiles or checks the cache of each INI file named
+ * on the command line.
+ *
+ * \param argc The number of arguments.
+ *
+ * \param argv The options followed by the names of the INI files.\n
+ * -c checks that the caches are up to date instead of compiling them.\n
+ * -o file names the cache file (only with a single INI file).  Otherwise
+ * each cache is named after its INI file with ".bin" appended.
+ *
+ * \effects
+ * Cache files are written (or checked) and the result for each INI file
+ * is printed.
+ *
+ * \returns 0 if every cache was compiled (or is up to date), 1 otherwise.
+ */
+int inicache_main(int argc, char *argv[])
+{
+    const char *output;
+    int check;
+    int failures;
+    int result;
+    int i;
+
+    output = NULL;
+    check = 0;
+
+    for (i = 1; (i < argc) && ('-' == argv[i][0]); i++)
+    {
+        if (0 == strcmp(argv[i], "-c"))
+        {
+            check = 1;
+        }
+        else if ((0 == strcmp(argv[i], "-o")) && (i + 1 < argc))
+        {
+            i++;
+            output = argv[i];
+        }
+        else
+        {
+            ShowUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if ((i == argc) || ((NULL != output) && (i + 1 != argc)))
+    {
+        ShowUsage(argv[0]);
+        return 1;
+    }
+
+    failures = 0;
+
+    for (; i < argc; i++)
+    {
+        if (check)
+        {
+            result = CheckINICache(argv[i], output);
+
+            if (result < 0)
+            {
+                printf("%s: %s\n", argv[i], strerror(errno));
+            }
+            else
+            {
+                printf("%s: cache is %s\n", argv[i],
+                    result ? "up to date" : "stale or missing");
+            }
+
+            failures += (1 != result);
+        }
+        else if (0 != CompileINICache(argv[i], output))
+        {
+            printf("%s: %s\n", argv[i], strerror(errno));
+            failures++;
+        }
+    }
+
+    return (0 == failures) ? 0 : 1;
+}
+
+/**
+ * \fn static void ShowUsage(const char *name)
+ *
+ * \brief This function prints the command line options.
+ *
+ * \param name The name the program was run as.
+ *
+ * \effects The usage message is printed.
+ *
+ * \returns Nothing
+ */
+static void ShowUsage(const char *name)
+{
+    printf("Usage: %s [-c] [-o cache] file.ini [file.ini ...]\n\n", name);
+    printf("Compiles each INI file into a binary cache (file.ini.bin)\n");
+    printf("  -c        check that the caches are up to date\n");
+    printf("  -o cache  name of the cache file for a single INI file\n");
+}
+
+/**@}*/
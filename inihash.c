@@ -0,0 +1,1498 @@
+/**
+ * \brief A program that generates perfect hash tables of INI file keys
+ * \file inihash.c
+ * \author Michael Dipperstein (mdipperstein@gmail.com)
+ * \date October 15, 2026
+ *
+ * This file reads a template INI file and writes a C source file and header
+ * with a minimal perfect hash table of its (section, key) pairs.  The
+ * generated lookup function maps each pair to a dense ID (0 to count - 1)
+ * with one hash and one comparison, so programs with a fixed set of entries
+ * may keep their values in a flat array indexed by ID.
+ *
+ * \copyright Copyright (C) 2026 by Michael Dipperstein
+ * (mdipperstein@gmail.com)
+ *
+ * \par
+ * This file is part of the ezini library.
+ *
+ * \license
+ * The ezini library is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * \par
+ * The ezini library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+ * General Public License for more details.
+ *
+ * \par
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \defgroup inihash INI Key Hash Generator
+ * \brief This module contains a program that generates minimal perfect hash
+ * tables of the (section, key) pairs in template INI files.
+ * @{
+ */
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <errno.h>
+#include "ezini.h"
+
+/*!
+  \def inihash_main
+  \brief Hack so that Doxygen doesn't confuse this with sample.c's main
+*/
+#define inihash_main main
+
+/***************************************************************************
+*                                CONSTANTS
+***************************************************************************/
+
+/*!
+  \def HASH_SEED
+  \brief The first seed tried for the FNV-1a hash of names.
+*/
+#define HASH_SEED       2166136261UL
+
+/*!
+  \def HASH_PRIME
+  \brief The 32 bit FNV prime, which multiplies the bucket hash.
+*/
+#define HASH_PRIME      16777619UL
+
+/*!
+  \def SLOT_PRIME
+  \brief The multiplier of the slot hash, which differs from HASH_PRIME so
+  that pairs with equal bucket hashes almost never have equal slot hashes.
+*/
+#define SLOT_PRIME      0x5BD1E995UL
+
+/*!
+  \def MAX_SEEDS
+  \brief The number of seeds tried before giving up on a table.
+*/
+#define MAX_SEEDS       32
+
+/*!
+  \def MAX_DISPLACEMENT
+  \brief The number of displacements tried for each bucket with a seed.
+*/
+#define MAX_DISPLACEMENT    (1UL << 22)
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+
+/**
+ * \struct name_t
+ * \brief A (section, key) pair read from the template.
+ */
+typedef struct
+{
+    char *section;          /*!< section name ("" before any section) */
+    size_t sectionLength;   /*!< length of section */
+    char *key;              /*!< key name */
+    size_t keyLength;       /*!< length of key */
+    size_t order;           /*!< position in the template */
+    unsigned long bucketHash;   /*!< hash choosing the pair's bucket */
+    unsigned long slotHash;     /*!< hash choosing the pair's slot */
+    char *macro;            /*!< name of the ID's macro */
+} name_t;
+
+/**
+ * \struct template_t
+ * \brief The pairs read from the template, in template order.
+ */
+typedef struct
+{
+    name_t *names;          /*!< array of pairs */
+    size_t count;           /*!< number of pairs in names */
+    size_t size;            /*!< number of pairs allocated for names */
+    char *section;          /*!< current section while reading */
+    size_t sectionLength;   /*!< length of section */
+} template_t;
+
+/**
+ * \struct table_t
+ * \brief A minimal perfect hash table.  The ID of a pair with hashes b and
+ * s is ids[Mix(s, displacements[b % buckets]) % count].
+ */
+typedef struct
+{
+    unsigned long seed;             /*!< seed of the bucket hash */
+    unsigned long slotSeed;         /*!< seed of the slot hash */
+    size_t buckets;                 /*!< number of displacements */
+    unsigned long *displacements;   /*!< displacement of each bucket */
+    size_t *ids;                    /*!< ID in each slot */
+} table_t;
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static void ShowUsage(const char *name);
+static int ReadTemplate(const char *iniFile, template_t *names);
+static int OnSection(const char *name, size_t length, void *user);
+static int OnEntry(const char *key, size_t keyLength, const char *value,
+    size_t valueLength, void *user);
+static char *CopyName(const char *name, size_t length);
+static void RemoveDuplicates(template_t *names);
+static int CompareNames(const void *a, const void *b);
+static int CompareOrder(const void *a, const void *b);
+static int MakeTable(template_t *names, table_t *table);
+static int TryTable(template_t *names, table_t *table, size_t *sizes,
+    size_t *starts, size_t *members, size_t *buckets);
+static int MakeMacros(template_t *names, const char *prefix);
+static int CompareMacros(const void *a, const void *b);
+static void Hash(const char *str, size_t length,
+    unsigned long *bucketHash, unsigned long *slotHash);
+static unsigned long Mix(unsigned long hash, unsigned long displacement);
+static char *MakePrefix(const char *iniFile);
+static int WriteHeader(const char *fileName, const char *prefix,
+    const template_t *names);
+static int WriteSource(const char *fileName, const char *header,
+    const char *prefix, const template_t *names, const table_t *table);
+static void WriteString(FILE *fp, const char *str, size_t length);
+static void WriteUpper(FILE *fp, const char *str);
+static void WriteLower(FILE *fp, const char *str);
+static void FreeTemplate(template_t *names);
+
+/***************************************************************************
+*                            GLOBAL VARIABLES
+***************************************************************************/
+
+static const name_t *sortNames;         /* names sorted by CompareMacros */
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/**
+ * \fn int inihash_main(int argc, char *argv[])
+ *
+ * \brief This function generates the perfect hash table of the template
+ * INI file named on the command line.
+ *
+ * \param argc The number of arguments.
+ *
+ * \param argv The options followed by the name of the template.\n
+ * -o name names the generated files (name.c and name.h).  Otherwise they
+ * are named after the template, with "_keys" in place of ".ini".\n
+ * -p prefix starts the name of everything that is generated.  Otherwise
+ * it is made from the template's name, e.g. "Server" for server.ini.
+ *
+ * \effects
+ * The source file and header are written and the number of IDs is printed.
+ *
+ * \returns 0 if the files were written, 1 otherwise.
+ */
+int inihash_main(int argc, char *argv[])
+{
+    const char *output;
+    const char *header;
+    char *prefix;
+    char *base;
+    char *fileName;
+    size_t length;
+    template_t names;
+    table_t table;
+    int result;
+    int i;
+
+    output = NULL;
+    prefix = NULL;
+
+    for (i = 1; (i < argc) && ('-' == argv[i][0]); i++)
+    {
+        if ((0 == strcmp(argv[i], "-o")) && (i + 1 < argc))
+        {
+            i++;
+            output = argv[i];
+        }
+        else if ((0 == strcmp(argv[i], "-p")) && (i + 1 < argc))
+        {
+            i++;
+            prefix = argv[i];
+        }
+        else
+        {
+            ShowUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (i + 1 != argc)
+    {
+        ShowUsage(argv[0]);
+        return 1;
+    }
+
+    /* name.c and name.h, where name defaults to the template's _keys */
+    length = strlen(argv[i]);
+
+    if (NULL != output)
+    {
+        base = CopyName(output, strlen(output));
+    }
+    else
+    {
+        if ((length > 4) && (0 == strcmp(argv[i] + length - 4, ".ini")))
+        {
+            length -= 4;
+        }
+
+        base = (char *)malloc(length + sizeof("_keys"));
+
+        if (NULL != base)
+        {
+            memcpy(base, argv[i], length);
+            strcpy(base + length, "_keys");
+        }
+    }
+
+    if (NULL == prefix)
+    {
+        prefix = MakePrefix(argv[i]);
+    }
+    else
+    {
+        prefix = CopyName(prefix, strlen(prefix));
+    }
+
+    length = (NULL == base) ? 0 : strlen(base);
+    fileName = (char *)malloc(length + 3);
+
+    if ((NULL == base) || (NULL == prefix) || (NULL == fileName))
+    {
+        printf("%s: %s\n", argv[i], strerror(ENOMEM));
+        free(base);
+        free(prefix);
+        free(fileName);
+        return 1;
+    }
+
+    memset(&names, 0, sizeof(names));
+    memset(&table, 0, sizeof(table));
+    result = 1;
+
+    if (0 != ReadTemplate(argv[i], &names))
+    {
+        printf("%s: %s\n", argv[i], strerror(errno));
+    }
+    else if (0 == names.count)
+    {
+        printf("%s: the template has no keys\n", argv[i]);
+    }
+    else if (0 != MakeTable(&names, &table))
+    {
+        printf("%s: %s\n", argv[i], strerror(errno));
+    }
+    else if (0 != MakeMacros(&names, prefix))
+    {
+        printf("%s: %s\n", argv[i], strerror(errno));
+    }
+    else
+    {
+        sprintf(fileName, "%s.h", base);
+
+        if (0 != WriteHeader(fileName, prefix, &names))
+        {
+            printf("%s: %s\n", fileName, strerror(errno));
+        }
+        else
+        {
+            /* the source includes the header by its name alone */
+            header = strrchr(fileName, '/');
+            header = (NULL == header) ? fileName : header + 1;
+            header = CopyName(header, strlen(header));
+            sprintf(fileName, "%s.c", base);
+
+            if (NULL == header)
+            {
+                printf("%s: %s\n", fileName, strerror(ENOMEM));
+            }
+            else if (0 != WriteSource(fileName, header, prefix, &names,
+                &table))
+            {
+                printf("%s: %s\n", fileName, strerror(errno));
+            }
+            else
+            {
+                printf("%s: %lu IDs in %s.c and %s.h\n", argv[i],
+                    (unsigned long)names.count, base, base);
+                result = 0;
+            }
+
+            free((char *)header);
+        }
+    }
+
+    FreeTemplate(&names);
+    free(table.displacements);
+    free(table.ids);
+    free(base);
+    free(prefix);
+    free(fileName);
+    return result;
+}
+
+/**
+ * \fn static void ShowUsage(const char *name)
+ *
+ * \brief This function prints the command line options.
+ *
+ * \param name The name the program was run as.
+ *
+ * \effects The usage message is printed.
+ *
+ * \returns Nothing
+ */
+static void ShowUsage(const char *name)
+{
+    printf("Usage: %s [-o name] [-p prefix] template.ini\n\n", name);
+    printf("Generates a minimal perfect hash table of the template's "
+        "(section, key) pairs\n");
+    printf("  -o name    name of the generated files (name.c and name.h)\n");
+    printf("  -p prefix  prefix of the generated functions, types, and "
+        "macros\n");
+}
+
+/**
+ * \fn static int ReadTemplate(const char *iniFile, template_t *names)
+ *
+ * \brief This function reads the (section, key) pairs of a template.
+ *
+ * \param iniFile The name of the template INI file.
+ *
+ * \param names The structure receiving the pairs.
+ *
+ * \effects Every pair in the template is copied into names, once, in the
+ * order it first appears.  Values are ignored.
+ *
+ * \returns 0 for success, -1 with errno set for failure.
+ */
+static int ReadTemplate(const char *iniFile, template_t *names)
+{
+    ini_handler_t handler;
+    int result;
+
+    handler.onSection = OnSection;
+    handler.onEntry = OnEntry;
+    handler.user = names;
+
+    names->section = CopyName("", 0);
+
+    if (NULL == names->section)
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    result = ParseINIFile(iniFile, &handler);
+
+    if (result > 0)
+    {
+        /* a handler ran out of memory */
+        errno = ENOMEM;
+        result = -1;
+    }
+
+    if (0 == result)
+    {
+        RemoveDuplicates(names);
+    }
+
+    return result;
+}
+
+/**
+ * \fn static int OnSection(const char *name, size_t length, void *user)
+ *
+ * \brief ParseINIFile handler function recording the current section.
+ *
+ * \param name The section name.
+ *
+ * \param length The length of name.
+ *
+ * \param user The template_t being read.
+ *
+ * \effects The section becomes the section of the following keys.
+ *
+ * \returns 0 to keep parsing, 1 if there is no memory for the name.
+ */
+static int OnSection(const char *name, size_t length, void *user)
+{
+    template_t *names;
+    char *section;
+
+    names = (template_t *)user;
+    section = CopyName(name, length);
+
+    if (NULL == section)
+    {
+        return 1;
+    }
+
+    free(names->section);
+    names->section = section;
+    names->sectionLength = length;
+    return 0;
+}
+
+/**
+ * \fn static int OnEntry(const char *key, size_t keyLength,
+ *      const char *value, size_t valueLength, void *user)
+ *
+ * \brief ParseINIFile handler function recording each key.
+ *
+ * \param key The key.
+ *
+ * \param keyLength The length of key.
+ *
+ * \param value Not Used
+ *
+ * \param valueLength Not Used
+ *
+ * \param user The template_t being read.
+ *
+ * \effects The (current section, key) pair is added to the template.
+ *
+ * \returns 0 to keep parsing, 1 if there is no memory for the pair.
+ */
+static int OnEntry(const char *key, size_t keyLength, const char *value,
+    size_t valueLength, void *user)
+{
+    template_t *names;
+    name_t *name;
+
+    ((void)(value));
+    ((void)(valueLength));
+    names = (template_t *)user;
+
+    if (names->count == names->size)
+    {
+        size_t size;
+        name_t *grown;
+
+        size = (0 == names->size) ? 64 : (2 * names->size);
+        grown = (name_t *)realloc(names->names, size * sizeof(name_t));
+
+        if (NULL == grown)
+        {
+            return 1;
+        }
+
+        names->names = grown;
+        names->size = size;
+    }
+
+    name = &(names->names[names->count]);
+    memset(name, 0, sizeof(name_t));
+    name->section = CopyName(names->section, names->sectionLength);
+    name->key = CopyName(key, keyLength);
+
+    if ((NULL == name->section) || (NULL == name->key))
+    {
+        free(name->section);
+        free(name->key);
+        return 1;
+    }
+
+    name->sectionLength = names->sectionLength;
+    name->keyLength = keyLength;
+    name->order = names->count;
+    names->count++;
+    return 0;
+}
+
+/**
+ * \fn static char *CopyName(const char *name, size_t length)
+ *
+ * \brief This function copies a name into a NULL terminated string.
+ *
+ * \param name The name.
+ *
+ * \param length The length of name.
+ *
+ * \effects Memory is allocated for the copy.
+ *
+ * \returns A pointer to the copy, or NULL if there is no memory.
+ */
+static char *CopyName(const char *name, size_t length)
+{
+    char *copy;
+
+    copy = (char *)malloc(length + 1);
+
+    if (NULL != copy)
+    {
+        memcpy(copy, name, length);
+        copy[length] = '\0';
+    }
+
+    return copy;
+}
+
+/**
+ * \fn static void RemoveDuplicates(template_t *names)
+ *
+ * \brief This function removes pairs that appear in a template more than
+ * once.
+ *
+ * \param names The pairs read from the template.
+ *
+ * \effects The first appearance of each pair is kept, and the pairs stay
+ * in template order.
+ *
+ * \returns Nothing
+ */
+static void RemoveDuplicates(template_t *names)
+{
+    size_t kept;
+    size_t i;
+
+    if (names->count < 2)
+    {
+        return;
+    }
+
+    /* equal pairs are adjacent and in template order after sorting */
+    qsort(names->names, names->count, sizeof(name_t), CompareNames);
+    kept = 1;
+
+    for (i = 1; i < names->count; i++)
+    {
+        name_t *last;
+        name_t *name;
+
+        last = &(names->names[kept - 1]);
+        name = &(names->names[i]);
+
+        if ((0 == strcmp(last->section, name->section)) &&
+            (0 == strcmp(last->key, name->key)) &&
+            (last->sectionLength == name->sectionLength) &&
+            (last->keyLength == name->keyLength))
+        {
+            free(name->section);
+            free(name->key);
+        }
+        else
+        {
+            names->names[kept] = *name;
+            kept++;
+        }
+    }
+
+    names->count = kept;
+    qsort(names->names, names->count, sizeof(name_t), CompareOrder);
+
+    for (i = 0; i < names->count; i++)
+    {
+        names->names[i].order = i;
+    }
+}
+
+/**
+ * \fn static int CompareNames(const void *a, const void *b)
+ *
+ * \brief qsort comparison function ordering pairs by section, key, then
+ * template order.
+ *
+ * \param a A pointer to a name_t.
+ *
+ * \param b A pointer to a name_t.
+ *
+ * \effects None
+ *
+ * \returns < 0, 0, or > 0 as a is before, the same as, or after b.
+ */
+static int CompareNames(const void *a, const void *b)
+{
+    const name_t *nameA;
+    const name_t *nameB;
+    int result;
+
+    nameA = (const name_t *)a;
+    nameB = (const name_t *)b;
+    result = strcmp(nameA->section, nameB->section);
+
+    if (0 == result)
+    {
+        result = strcmp(nameA->key, nameB->key);
+    }
+
+    if (0 == result)
+    {
+        result = (nameA->order > nameB->order) -
+            (nameA->order < nameB->order);
+    }
+
+    return result;
+}
+
+/**
+ * \fn static int CompareOrder(const void *a, const void *b)
+ *
+ * \brief qsort comparison function ordering pairs by template order.
+ *
+ * \param a A pointer to a name_t.
+ *
+ * \param b A pointer to a name_t.
+ *
+ * \effects None
+ *
+ * \returns < 0, 0, or > 0 as a is before, the same as, or after b.
+ */
+static int CompareOrder(const void *a, const void *b)
+{
+    const name_t *nameA;
+    const name_t *nameB;
+
+    nameA = (const name_t *)a;
+    nameB = (const name_t *)b;
+    return (nameA->order > nameB->order) - (nameA->order < nameB->order);
+}
+
+/**
+ * \fn static int MakeTable(template_t *names, table_t *table)
+ *
+ * \brief This function makes a minimal perfect hash table of a template's
+ * pairs.
+ *
+ * \param names The pairs read from the template.  The ID of each pair is
+ * its index.
+ *
+ * \param table The table being made.
+ *
+ * \effects The table is built by hash and displace: each pair's bucket
+ * hash puts it in a bucket, and buckets are given displacements, largest
+ * bucket first, that send the slot hashes of all of their pairs to free
+ * slots.  There are as many slots as pairs.  If no displacement fits a
+ * bucket (e.g. two pairs in it have equal slot hashes), other seeds are
+ * tried.  The hashes of each pair are stored in names.
+ *
+ * \returns 0 for success, -1 with errno set for failure.
+ */
+static int MakeTable(template_t *names, table_t *table)
+{
+    size_t *sizes;
+    size_t *starts;
+    size_t *members;
+    size_t *buckets;
+    int attempt;
+    int result;
+
+    /* about 2 hashes per bucket */
+    table->buckets = (names->count / 2) + 1;
+    table->displacements = (unsigned long *)malloc(table->buckets *
+        sizeof(unsigned long));
+    table->ids = (size_t *)malloc(names->count * sizeof(size_t));
+    sizes = (size_t *)malloc(table->buckets * sizeof(size_t));
+    starts = (size_t *)malloc((table->buckets + 1) * sizeof(size_t));
+    buckets = (size_t *)malloc(table->buckets * sizeof(size_t));
+    members = (size_t *)malloc(names->count * sizeof(size_t));
+
+    if ((NULL == table->displacements) || (NULL == table->ids) ||
+        (NULL == sizes) || (NULL == starts) || (NULL == buckets) ||
+        (NULL == members))
+    {
+        free(sizes);
+        free(starts);
+        free(buckets);
+        free(members);
+        errno = ENOMEM;
+        return -1;
+    }
+
+    result = -1;
+
+    for (attempt = 0; (0 != result) && (attempt < MAX_SEEDS); attempt++)
+    {
+        table->seed = Mix(HASH_SEED, (unsigned long)attempt);
+        table->slotSeed = Mix(table->seed, 1);
+        result = TryTable(names, table, sizes, starts, members, buckets);
+    }
+
+    free(sizes);
+    free(starts);
+    free(buckets);
+    free(members);
+
+    if (0 != result)
+    {
+        errno = EDOM;
+    }
+
+    return result;
+}
+
+/**
+ * \fn static int TryTable(template_t *names, table_t *table,
+ *      size_t *sizes, size_t *starts, size_t *members, size_t *buckets)
+ *
+ * \brief This function tries to make a minimal perfect hash table with
+ * the table's seed.
+ *
+ * \param names The pairs read from the template.
+ *
+ * \param table The table being made.
+ *
+ * \param sizes Space for the size of each bucket.
+ *
+ * \param starts Space for the start of each bucket in members (and the
+ * end of the last one).
+ *
+ * \param members Space for the IDs in each bucket.
+ *
+ * \param buckets Space for the buckets in the order they are placed.
+ *
+ * \effects See MakeTable.
+ *
+ * \returns 0 if the table was made, -1 if the seed doesn't work.
+ */
+static int TryTable(template_t *names, table_t *table, size_t *sizes,
+    size_t *starts, size_t *members, size_t *buckets)
+{
+    size_t count;
+    size_t largest;
+    size_t placed;
+    size_t size;
+    size_t i;
+    size_t j;
+
+    count = names->count;
+    memset(sizes, 0, table->buckets * sizeof(size_t));
+
+    for (i = 0; i < count; i++)
+    {
+        name_t *name;
+
+        name = &(names->names[i]);
+        name->bucketHash = table->seed;
+        name->slotHash = table->slotSeed;
+        Hash(name->section, name->sectionLength, &(name->bucketHash),
+            &(name->slotHash));
+        Hash(name->key, name->keyLength, &(name->bucketHash),
+            &(name->slotHash));
+        sizes[name->bucketHash % table->buckets]++;
+        table->ids[i] = count;      /* free */
+    }
+
+    /* sort the IDs by bucket and the buckets by size */
+    largest = 0;
+    starts[0] = 0;
+
+    for (i = 0; i < table->buckets; i++)
+    {
+        largest = (sizes[i] > largest) ? sizes[i] : largest;
+        starts[i + 1] = starts[i] + sizes[i];
+        sizes[i] = 0;
+        table->displacements[i] = 0;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        size_t bucket;
+
+        bucket = names->names[i].bucketHash % table->buckets;
+        members[starts[bucket] + sizes[bucket]] = i;
+        sizes[bucket]++;
+    }
+
+    placed = 0;
+
+    for (size = largest; size > 0; size--)
+    {
+        for (i = 0; i < table->buckets; i++)
+        {
+            if (sizes[i] == size)
+            {
+                buckets[placed] = i;
+                placed++;
+            }
+        }
+    }
+
+    for (i = 0; i < placed; i++)
+    {
+        const size_t *bucket;
+        unsigned long d;
+        int fits;
+
+        bucket = &(members[starts[buckets[i]]]);
+        size = sizes[buckets[i]];
+
+        /* equal slot hashes always share a slot, so don't search */
+        for (j = 0; j < size; j++)
+        {
+            size_t k;
+
+            for (k = j + 1; k < size; k++)
+            {
+                if (names->names[bucket[j]].slotHash ==
+                    names->names[bucket[k]].slotHash)
+                {
+                    return -1;
+                }
+            }
+        }
+
+        fits = 0;
+
+        for (d = 0; (!fits) && (d < MAX_DISPLACEMENT); d++)
+        {
+            fits = 1;
+
+            for (j = 0; fits && (j < size); j++)
+            {
+                size_t slot;
+
+                slot = Mix(names->names[bucket[j]].slotHash, d) % count;
+
+                if (count == table->ids[slot])
+                {
+                    table->ids[slot] = bucket[j];
+                }
+                else
+                {
+                    fits = 0;
+                }
+            }
+
+            if (!fits)
+            {
+                /* free the slots this displacement took */
+                while (j > 1)
+                {
+                    j--;
+                    table->ids[Mix(names->names[bucket[j - 1]].slotHash,
+                        d) % count] = count;
+                }
+            }
+            else
+            {
+                table->displacements[buckets[i]] = d;
+            }
+        }
+
+        if (!fits)
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * \fn static int MakeMacros(template_t *names, const char *prefix)
+ *
+ * \brief This function names the macro for the ID of each pair.
+ *
+ * \param names The pairs read from the template.
+ *
+ * \param prefix The prefix of everything generated.
+ *
+ * \effects Each macro is named PREFIX_SECTION_KEY, in upper case with
+ * every character that can't be in a C identifier replaced by '_' (and
+ * without _SECTION for keys preceding the first section).  When pairs
+ * would have the same name, all but the first have their ID appended.
+ *
+ * \returns 0 for success, -1 with errno set for failure.
+ */
+static int MakeMacros(template_t *names, const char *prefix)
+{
+    size_t *sorted;
+    size_t i;
+    char *c;
+
+    for (i = 0; i < names->count; i++)
+    {
+        name_t *name;
+
+        name = &(names->names[i]);
+        name->macro = (char *)malloc(strlen(prefix) + name->sectionLength +
+            name->keyLength + 24);
+
+        if (NULL == name->macro)
+        {
+            errno = ENOMEM;
+            return -1;
+        }
+
+        if (0 == name->sectionLength)
+        {
+            sprintf(name->macro, "%s_%s", prefix, name->key);
+        }
+        else
+        {
+            sprintf(name->macro, "%s_%s_%s", prefix, name->section,
+                name->key);
+        }
+
+        for (c = name->macro; '\0' != *c; c++)
+        {
+            *c = isalnum((unsigned char)*c) ? toupper((unsigned char)*c) :
+                '_';
+        }
+    }
+
+    sorted = (size_t *)malloc(names->count * sizeof(size_t));
+
+    if (NULL == sorted)
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    for (i = 0; i < names->count; i++)
+    {
+        sorted[i] = i;
+    }
+
+    sortNames = names->names;
+    qsort(sorted, names->count, sizeof(size_t), CompareMacros);
+
+    for (i = 1; i < names->count; i++)
+    {
+        name_t *name;
+
+        name = &(names->names[sorted[i]]);
+
+        if (0 == strcmp(names->names[sorted[i - 1]].macro, name->macro))
+        {
+            sprintf(name->macro + strlen(name->macro), "_%lu",
+                (unsigned long)sorted[i]);
+        }
+    }
+
+    free(sorted);
+    return 0;
+}
+
+/**
+ * \fn static int CompareMacros(const void *a, const void *b)
+ *
+ * \brief qsort comparison function ordering IDs by the names of their
+ * macros, then by ID.
+ *
+ * \param a A pointer to an ID in sortNames.
+ *
+ * \param b A pointer to an ID in sortNames.
+ *
+ * \effects None
+ *
+ * \returns < 0, 0, or > 0 as a is before, the same as, or after b.
+ */
+static int CompareMacros(const void *a, const void *b)
+{
+    size_t idA;
+    size_t idB;
+    int result;
+
+    idA = *(const size_t *)a;
+    idB = *(const size_t *)b;
+    result = strcmp(sortNames[idA].macro, sortNames[idB].macro);
+
+    if (0 == result)
+    {
+        result = (idA > idB) - (idA < idB);
+    }
+
+    return result;
+}
+
+/**
+ * \fn static void Hash(const char *str, size_t length,
+ *      unsigned long *bucketHash, unsigned long *slotHash)
+ *
+ * \brief This function adds a string to the two 32 bit hashes of a pair.
+ * The generated source file contains the same function.
+ *
+ * \param str The string.
+ *
+ * \param length The length of str.
+ *
+ * \param bucketHash The FNV-1a hash choosing the pair's bucket.
+ *
+ * \param slotHash The hash choosing the pair's slot, which is the same
+ * as FNV-1a with SLOT_PRIME in place of the FNV prime.
+ *
+ * \effects Both hashes are updated with each character of str.
+ *
+ * \returns Nothing
+ */
+static void Hash(const char *str, size_t length,
+    unsigned long *bucketHash, unsigned long *slotHash)
+{
+    const unsigned char *c;
+    unsigned long bucket;
+    unsigned long slot;
+
+    bucket = *bucketHash;
+    slot = *slotHash;
+
+    for (c = (const unsigned char *)str; length > 0; c++, length--)
+    {
+        bucket = ((bucket ^ *c) * HASH_PRIME) & 0xFFFFFFFFUL;
+        slot = ((slot ^ *c) * SLOT_PRIME) & 0xFFFFFFFFUL;
+    }
+
+    *bucketHash = bucket;
+    *slotHash = slot;
+}
+
+/**
+ * \fn static unsigned long Mix(unsigned long hash,
+ *      unsigned long displacement)
+ *
+ * \brief This function scrambles a hash with a bucket's displacement,
+ * giving the slot candidate for the displacement.  The generated source
+ * file contains the same function.
+ *
+ * \param hash A 32 bit hash.
+ *
+ * \param displacement The displacement.
+ *
+ * \effects None
+ *
+ * \returns The scrambled 32 bit hash.
+ */
+static unsigned long Mix(unsigned long hash, unsigned long displacement)
+{
+    hash ^= (displacement * 0x9E3779B9UL) & 0xFFFFFFFFUL;
+    hash ^= hash >> 16;
+    hash = (hash * 0x85EBCA6BUL) & 0xFFFFFFFFUL;
+    hash ^= hash >> 13;
+    hash = (hash * 0xC2B2AE35UL) & 0xFFFFFFFFUL;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+/**
+ * \fn static char *MakePrefix(const char *iniFile)
+ *
+ * \brief This function makes the default prefix from the name of the
+ * template.
+ *
+ * \param iniFile The name of the template INI file.
+ *
+ * \effects Memory is allocated for the prefix, made of the letters and
+ * digits in the file's name (without its directory and ".ini"), with the
+ * first of each run capitalized, e.g. "ServerOpts" for server_opts.ini.
+ * "Ini" is added to the start of names that don't start with a letter.
+ *
+ * \returns A pointer to the prefix, or NULL if there is no memory.
+ */
+static char *MakePrefix(const char *iniFile)
+{
+    const char *start;
+    const char *end;
+    char *prefix;
+    char *c;
+    int capital;
+
+    start = strrchr(iniFile, '/');
+    start = (NULL == start) ? iniFile : start + 1;
+    end = start + strlen(start);
+
+    if ((end - start > 4) && (0 == strcmp(end - 4, ".ini")))
+    {
+        end -= 4;
+    }
+
+    prefix = (char *)malloc((end - start) + 4);
+
+    if (NULL == prefix)
+    {
+        return NULL;
+    }
+
+    c = prefix;
+
+    if ((start == end) || !isalpha((unsigned char)*start))
+    {
+        strcpy(c, "Ini");
+        c += 3;
+    }
+
+    for (capital = 1; start < end; start++)
+    {
+        if (isalnum((unsigned char)*start))
+        {
+            *c = capital ? toupper((unsigned char)*start) : *start;
+            c++;
+            capital = 0;
+        }
+        else
+        {
+            capital = 1;
+        }
+    }
+
+    *c = '\0';
+    return prefix;
+}
+
+/**
+ * \fn static int WriteHeader(const char *fileName, const char *prefix,
+ *      const template_t *names)
+ *
+ * \brief This function writes the generated header.
+ *
+ * \param fileName The name of the header.
+ *
+ * \param prefix The prefix of everything generated.
+ *
+ * \param names The pairs read from the template.
+ *
+ * \effects The header is written.  It defines PREFIX_COUNT, a macro with
+ * the ID of each pair, the prefix_name_t type, and declares the
+ * PrefixNames table and PrefixLookup function.
+ *
+ * \returns 0 for success, -1 with errno set for failure.
+ */
+static int WriteHeader(const char *fileName, const char *prefix,
+    const template_t *names)
+{
+    FILE *fp;
+    size_t i;
+
+    fp = fopen(fileName, "w");
+
+    if (NULL == fp)
+    {
+        return -1;
+    }
+
+    fprintf(fp, "/* Generated by inihash.  Do not edit. */\n");
+    fprintf(fp, "#ifndef ");
+    WriteUpper(fp, prefix);
+    fprintf(fp, "_KEYS_H\n#define ");
+    WriteUpper(fp, prefix);
+    fprintf(fp, "_KEYS_H\n\n#include <stddef.h>\n\n");
+
+    fprintf(fp, "/* the number of IDs, which are 0 to COUNT - 1 */\n");
+    fprintf(fp, "#define ");
+    WriteUpper(fp, prefix);
+    fprintf(fp, "_COUNT %lu\n\n", (unsigned long)names->count);
+
+    for (i = 0; i < names->count; i++)
+    {
+        fprintf(fp, "#define %s %lu\n", names->names[i].macro,
+            (unsigned long)i);
+    }
+
+    fprintf(fp, "\n/* the section and key with each ID */\n");
+    fprintf(fp, "typedef struct\n{\n");
+    fprintf(fp, "    const char *section;\n    size_t sectionLength;\n");
+    fprintf(fp, "    const char *key;\n    size_t keyLength;\n} ");
+    WriteLower(fp, prefix);
+    fprintf(fp, "_name_t;\n\n");
+
+    fprintf(fp, "extern const ");
+    WriteLower(fp, prefix);
+    fprintf(fp, "_name_t %sNames[", prefix);
+    WriteUpper(fp, prefix);
+    fprintf(fp, "_COUNT];\n\n");
+
+    fprintf(fp, "/* returns the ID of (section, key), or -1 if it isn't "
+        "one */\n");
+    fprintf(fp, "int %sLookup(const char *section, size_t sectionLength,\n"
+        "    const char *key, size_t keyLength);\n\n", prefix);
+    fprintf(fp, "#endif\n");
+
+    if (ferror(fp))
+    {
+        fclose(fp);
+        errno = EIO;
+        return -1;
+    }
+
+    return (0 == fclose(fp)) ? 0 : -1;
+}
+
+/**
+ * \fn static int WriteSource(const char *fileName, const char *header,
+ *      const char *prefix, const template_t *names, const table_t *table)
+ *
+ * \brief This function writes the generated source file.
+ *
+ * \param fileName The name of the source file.
+ *
+ * \param header The name of the generated header, as it is included.
+ *
+ * \param prefix The prefix of everything generated.
+ *
+ * \param names The pairs read from the template.
+ *
+ * \param table The perfect hash table of names.
+ *
+ * \effects The source file is written.  It contains the table, the names
+ * of the pairs, the hash functions, and PrefixLookup.
+ *
+ * \returns 0 for success, -1 with errno set for failure.
+ */
+static int WriteSource(const char *fileName, const char *header,
+    const char *prefix, const template_t *names, const table_t *table)
+{
+    FILE *fp;
+    size_t i;
+
+    fp = fopen(fileName, "w");
+
+    if (NULL == fp)
+    {
+        return -1;
+    }
+
+    fprintf(fp, "/* Generated by inihash.  Do not edit. */\n");
+    fprintf(fp, "#include <string.h>\n#include \"%s\"\n\n", header);
+
+    fprintf(fp, "#define SEED %luUL\n", table->seed);
+    fprintf(fp, "#define SLOT_SEED %luUL\n", table->slotSeed);
+    fprintf(fp, "#define BUCKETS %luUL\n\n", (unsigned long)table->buckets);
+
+    fprintf(fp, "const ");
+    WriteLower(fp, prefix);
+    fprintf(fp, "_name_t %sNames[", prefix);
+    WriteUpper(fp, prefix);
+    fprintf(fp, "_COUNT] =\n{\n");
+
+    for (i = 0; i < names->count; i++)
+    {
+        fprintf(fp, "    {");
+        WriteString(fp, names->names[i].section,
+            names->names[i].sectionLength);
+        fprintf(fp, ", %lu, ", (unsigned long)names->names[i].sectionLength);
+        WriteString(fp, names->names[i].key, names->names[i].keyLength);
+        fprintf(fp, ", %lu}%s\n", (unsigned long)names->names[i].keyLength,
+            (i + 1 < names->count) ? "," : "");
+    }
+
+    fprintf(fp, "};\n\n");
+
+    /* displacement of each bucket */
+    fprintf(fp, "static const unsigned long displacements[BUCKETS] =\n{");
+
+    for (i = 0; i < table->buckets; i++)
+    {
+        fprintf(fp, "%s%lu%s", (0 == i % 8) ? "\n    " : " ",
+            table->displacements[i], (i + 1 < table->buckets) ? "," : "");
+    }
+
+    fprintf(fp, "\n};\n\n");
+
+    /* ID in each slot */
+    fprintf(fp, "static const unsigned long ids[");
+    WriteUpper(fp, prefix);
+    fprintf(fp, "_COUNT] =\n{");
+
+    for (i = 0; i < names->count; i++)
+    {
+        fprintf(fp, "%s%lu%s", (0 == i % 8) ? "\n    " : " ",
+            (unsigned long)table->ids[i], (i + 1 < names->count) ? "," : "");
+    }
+
+    fprintf(fp, "\n};\n\n");
+
+    fprintf(fp,
+        "static void Hash(const char *str, size_t length,\n"
+        "    unsigned long *bucketHash, unsigned long *slotHash)\n"
+        "{\n"
+        "    const unsigned char *c;\n"
+        "    unsigned long bucket;\n"
+        "    unsigned long slot;\n\n"
+        "    bucket = *bucketHash;\n"
+        "    slot = *slotHash;\n\n"
+        "    for (c = (const unsigned char *)str; length > 0; c++, "
+        "length--)\n"
+        "    {\n"
+        "        bucket = ((bucket ^ *c) * %luUL) & 0xFFFFFFFFUL;\n"
+        "        slot = ((slot ^ *c) * %luUL) & 0xFFFFFFFFUL;\n"
+        "    }\n\n"
+        "    *bucketHash = bucket;\n"
+        "    *slotHash = slot;\n"
+        "}\n\n", HASH_PRIME, SLOT_PRIME);
+
+    fprintf(fp,
+        "static unsigned long Mix(unsigned long hash, "
+        "unsigned long displacement)\n"
+        "{\n"
+        "    hash ^= (displacement * 0x9E3779B9UL) & 0xFFFFFFFFUL;\n"
+        "    hash ^= hash >> 16;\n"
+        "    hash = (hash * 0x85EBCA6BUL) & 0xFFFFFFFFUL;\n"
+        "    hash ^= hash >> 13;\n"
+        "    hash = (hash * 0xC2B2AE35UL) & 0xFFFFFFFFUL;\n"
+        "    hash ^= hash >> 16;\n"
+        "    return hash;\n"
+        "}\n\n");
+
+    fprintf(fp,
+        "int %sLookup(const char *section, size_t sectionLength,\n"
+        "    const char *key, size_t keyLength)\n"
+        "{\n"
+        "    const ", prefix);
+    WriteLower(fp, prefix);
+    fprintf(fp,
+        "_name_t *name;\n"
+        "    unsigned long bucketHash;\n"
+        "    unsigned long slotHash;\n"
+        "    unsigned long id;\n\n"
+        "    bucketHash = SEED;\n"
+        "    slotHash = SLOT_SEED;\n"
+        "    Hash(section, sectionLength, &bucketHash, &slotHash);\n"
+        "    Hash(key, keyLength, &bucketHash, &slotHash);\n"
+        "    id = ids[Mix(slotHash, displacements[bucketHash %% BUCKETS]) "
+        "%%\n        ");
+    WriteUpper(fp, prefix);
+    fprintf(fp,
+        "_COUNT];\n"
+        "    name = &%sNames[id];\n\n"
+        "    if ((name->sectionLength == sectionLength) &&\n"
+        "        (name->keyLength == keyLength) &&\n"
+        "        ((0 == sectionLength) ||\n"
+        "        (0 == memcmp(name->section, section, sectionLength))) &&\n"
+        "        ((0 == keyLength) ||\n"
+        "        (0 == memcmp(name->key, key, keyLength))))\n"
+        "    {\n"
+        "        return (int)id;\n"
+        "    }\n\n"
+        "    return -1;\n"
+        "}\n", prefix);
+
+    if (ferror(fp))
+    {
+        fclose(fp);
+        errno = EIO;
+        return -1;
+    }
+
+    return (0 == fclose(fp)) ? 0 : -1;
+}
+
+/**
+ * \fn static void WriteString(FILE *fp, const char *str, size_t length)
+ *
+ * \brief This function writes a string as a C string literal.
+ *
+ * \param fp The file being written.
+ *
+ * \param str The string.
+ *
+ * \param length The length of str.
+ *
+ * \effects The quoted string is written, with '"', '\\', and '?' (which
+ * could start a trigraph) escaped, and other characters that aren't
+ * printable written as octal escapes.
+ *
+ * \returns Nothing
+ */
+static void WriteString(FILE *fp, const char *str, size_t length)
+{
+    const unsigned char *c;
+
+    fputc('"', fp);
+
+    for (c = (const unsigned char *)str; length > 0; c++, length--)
+    {
+        if (('"' == *c) || ('\\' == *c) || ('?' == *c))
+        {
+            fputc('\\', fp);
+            fputc(*c, fp);
+        }
+        else if (isprint(*c))
+        {
+            fputc(*c, fp);
+        }
+        else
+        {
+            fprintf(fp, "\\%03o", *c);
+        }
+    }
+
+    fputc('"', fp);
+}
+
+/**
+ * \fn static void WriteUpper(FILE *fp, const char *str)
+ *
+ * \brief This function writes a string in upper case.
+ *
+ * \param fp The file being written.
+ *
+ * \param str The NULL terminated string.
+ *
+ * \effects The string is written in upper case.
+ *
+ * \returns Nothing
+ */
+static void WriteUpper(FILE *fp, const char *str)
+{
+    for (; '\0' != *str; str++)
+    {
+        fputc(toupper((unsigned char)*str), fp);
+    }
+}
+
+/**
+ * \fn static void WriteLower(FILE *fp, const char *str)
+ *
+ * \brief This function writes a string in lower case.
+ *
+ * \param fp The file being written.
+ *
+ * \param str The NULL terminated string.
+ *
+ * \effects The string is written in lower case.
+ *
+ * \returns Nothing
+ */
+static void WriteLower(FILE *fp, const char *str)
+{
+    for (; '\0' != *str; str++)
+    {
+        fputc(tolower((unsigned char)*str), fp);
+    }
+}
+
+/**
+ * \fn static void FreeTemplate(template_t *names)
+ *
+ * \brief This function frees the pairs read from a template.
+ *
+ * \param names The pairs.
+ *
+ * \effects All memory allocated for names is freed.
+ *
+ * \returns Nothing
+ */
+static void FreeTemplate(template_t *names)
+{
+    size_t i;
+
+    for (i = 0; i < names->count; i++)
+    {
+        free(names->names[i].section);
+        free(names->names[i].key);
+        free(names->names[i].macro);
+    }
+
+    free(names->names);
+    free(names->section);
+    memset(names, 0, sizeof(template_t));
+}
+
+/**@}*/
@@ -0,0 +1,2980 @@
+/**
+ * \brief Regression tests for the ezini library
+ * \file regress.c
+ * \author Michael Dipperstein (mdipperstein@gmail.com)
+ * \date October 15, 2026
+ *
+ * This file tests behaviors of the ezini library that have been broken
+ * before: damaged binary caches, the order of sections in each kind of
+ * document, and similar cases that are easy to miss.
+ *
+ * \copyright Copyright (C) 2026 by Michael Dipperstein
+ * (mdipperstein@gmail.com)
+ *
+ * \par
+ * This file is part of the ezini library.
+ *
+ * \license
+ * The ezini library is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * \par
+ * The ezini library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+ * General Public License for more details.
+ *
+ * \par
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \defgroup regress Regression Tests
+ * \brief This module contains regression tests for the ezini INI file
+ * handling library.
+ * @{
+ */
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#if defined(__unix__) || defined(__unix) || \
+    (defined(__APPLE__) && defined(__MACH__))
+#define _POSIX_C_SOURCE 200112L
+#include <pthread.h>
+#include <time.h>
+#define REGRESS_THREADS
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include "ezini.h"
+
+/*!
+  \def regress_main
+  \brief Hack so that Doxygen doesn't confuse this with sample.c's main
+*/
+#define regress_main main
+
+/*!
+  \def INI_NAME
+  \brief The INI file made by the tests
+*/
+#define INI_NAME        "regress.ini"
+
+/*!
+  \def CACHE_NAME
+  \brief The binary cache made by the tests
+*/
+#define CACHE_NAME      "regress.ini.bin"
+
+/*!
+  \def LISTING_SIZE
+  \brief The size of the buffers holding a listing of a document
+*/
+#define LISTING_SIZE    1024
+
+/*!
+  \def ENTRY_COUNT
+  \brief The number of entries read by TestGetEntryFromFile
+*/
+#define ENTRY_COUNT     100
+
+/*!
+  \def SYNC_THREADS
+  \brief The number of threads writing files in TestSyncStats
+*/
+#define SYNC_THREADS    4
+
+/*!
+  \def SYNC_WRITES
+  \brief The number of files written by each thread in TestSyncStats
+*/
+#define SYNC_WRITES     25
+
+/*!
+  \def PARALLEL_SIZE
+  \brief The approximate size of the file loaded by TestParallelLoad.  It
+  is large enough for 8 chunks of ezini.c's MIN_CHUNK_SIZE (256K).
+*/
+#define PARALLEL_SIZE   (3 * 1024 * 1024)
+
+/*!
+  \def SCAN_PADDING
+  \brief The number of different line lengths used by TestScanKernels.  It
+  is more than twice the width of the widest (AVX2) kernel.
+*/
+#define SCAN_PADDING    70
+
+/*!
+  \def INDEX_SECTIONS
+  \brief The number of sections used by TestHashIndex.
+*/
+#define INDEX_SECTIONS  40
+
+/*!
+  \def INDEX_KEYS
+  \brief The number of keys in each section used by TestHashIndex.  There
+  are enough pairs to grow the key index from 16 slots to 4096.
+*/
+#define INDEX_KEYS      60
+
+/*!
+  \def ARENA_SECTIONS
+  \brief The number of sections in the lists built by TestArenaList.
+*/
+#define ARENA_SECTIONS  100
+
+/*!
+  \def ARENA_KEYS
+  \brief The number of keys in each section of the lists built by
+  TestArenaList.
+*/
+#define ARENA_KEYS      100
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+
+/**
+ * \brief The allocations counted by the counting allocator
+ */
+typedef struct
+{
+    unsigned long allocs;       /*!< number of allocations */
+    long outstanding;           /*!< allocations not yet freed */
+} alloc_count_t;
+
+/**
+ * \brief Entries recorded as text, so that parses may be compared
+ */
+typedef struct
+{
+    char *text;                 /*!< one line per entry */
+    size_t length;              /*!< number of characters in text */
+    size_t size;                /*!< number of characters allocated */
+    int entries;                /*!< number of entries recorded */
+    int stopAt;                 /*!< stop after this many, 0 for never */
+} entry_record_t;
+
+/**
+ * \brief The blocks passed to a writer by WriteINIList
+ */
+typedef struct
+{
+    char *text;                 /*!< the blocks joined together */
+    size_t length;              /*!< number of characters in text */
+    int calls;                  /*!< number of times the writer was called */
+    int failAt;                 /*!< call to fail, 0 for never */
+    const char *big;            /*!< a value too big for the buffer */
+    size_t bigLength;           /*!< number of characters in big */
+    int bigPassed;              /*!< big was passed to the writer as is */
+    size_t largest;             /*!< largest other block */
+} write_record_t;
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static int TestDamagedCache(void);
+static int TestLoaderOrder(void);
+static int TestGetEntryFromFile(void);
+static int TestBlankSectionName(void);
+static int TestConversions(void);
+static int TestUnterminatedLastLine(void);
+static int TestDeleteOnly(void);
+static int TestDeleteEntries(void);
+static int TestSyncStats(void);
+static int TestParallelLoad(void);
+static int TestScanKernels(void);
+static int TestPushParser(void);
+static int TestWatcher(void);
+static int TestHashIndex(void);
+static int TestArenaList(void);
+static int TestSerializer(void);
+static int TestHandlers(void);
+static int RunHandlers(int how, const char *text, size_t length,
+    entry_record_t *record);
+static int RecordSection(const char *name, size_t length, void *user);
+static int RecordPair(const char *key, size_t keyLength, const char *value,
+    size_t valueLength, void *user);
+static int RecordWrite(const char *data, size_t length, void *user);
+static int BuildArenaTest(int arena, ini_entry_list_t *list,
+    alloc_count_t *counts);
+static int CheckIndexPair(ini_entry_list_t list, const int *model, int pair);
+static int CheckIndexList(ini_entry_list_t list, const int *model);
+static int HasWatchValue(const ini_document_t *doc, const char *expected);
+static int FeedInChunks(ini_parser_t *parser, const char *text,
+    size_t length, int mode, unsigned long seed);
+static int RecordEntry(const ini_entry_view_t *entry, void *user);
+static int Append(char **text, size_t *length, size_t *size,
+    const char *line);
+static char *MakeScanText(size_t *length);
+static int SameEntry(const ini_entry_view_t *a, const ini_entry_view_t *b);
+static void *WriteSynced(void *arg);
+static int FilterSixes(const ini_entry_view_t *entry, void *user);
+static int CheckFile(const char *test, const char *expected);
+static int CheckViews(const ini_document_t *doc);
+static int ListDocument(ini_document_t *doc, char *listing);
+static void AppendView(char *listing, size_t *used, const char *before,
+    const ini_view_t *view);
+static int WriteText(const char *fileName, const char *data, size_t size);
+static char *ReadText(const char *fileName, size_t *size);
+static void *CountAllocate(size_t size, void *user);
+static void *CountReallocate(void *ptr, size_t size, void *user);
+static void CountRelease(void *ptr, void *user);
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/**
+ * \fn int regress_main(int argc, char *argv[])
+ *
+ * \brief This function runs the regression tests.
+ *
+ * \param argc Not Used
+ *
+ * \param argv Not Used
+ *
+ * \effects
+ * The result of each test is printed.  The files made by the tests are
+ * deleted.
+ *
+ * \returns 0 if every test passed, 1 otherwise.
+ */
+int regress_main(int argc, char *argv[])
+{
+    int failures;
+
+    ((void)(argc));
+    ((void)(argv));
+
+    failures = 0;
+    failures += TestDamagedCache();
+    failures += TestLoaderOrder();
+    failures += TestGetEntryFromFile();
+    failures += TestBlankSectionName();
+    failures += TestConversions();
+    failures += TestUnterminatedLastLine();
+    failures += TestDeleteOnly();
+    failures += TestDeleteEntries();
+    failures += TestSyncStats();
+    failures += TestParallelLoad();
+    failures += TestScanKernels();
+    failures += TestPushParser();
+    failures += TestWatcher();
+    failures += TestHashIndex();
+    failures += TestArenaList();
+    failures += TestSerializer();
+    failures += TestHandlers();
+
+    remove(INI_NAME);
+    remove(CACHE_NAME);
+
+    printf("%s\n", (0 == failures) ? "All regression tests passed" :
+        "Regression tests FAILED");
+    return (0 == failures) ? 0 : 1;
+}
+
+/**
+ * \fn static int TestDamagedCache(void)
+ *
+ * \brief This function loads copies of a binary cache that have been
+ * truncated or have had a byte changed.
+ *
+ * \effects
+ * INI_NAME and CACHE_NAME are written.  The result is printed.
+ *
+ * \returns 0 if every damaged cache was either rejected (and the INI file
+ * parsed instead) or only returned valid views, 1 otherwise.
+ */
+static int TestDamagedCache(void)
+{
+    static const char text[] =
+        "top = 1\n"
+        "[network]\n"
+        "host = example.com\n"
+        "port = 8080\n"
+        "[paths]\n"
+        "log = /var/log/app\n"
+        "data = /srv/data\n";
+    ini_document_t *doc;
+    char *cache;
+    size_t size;
+    size_t i;
+    int failed;
+
+    failed = 0;
+
+    if ((0 != WriteText(INI_NAME, text, sizeof(text) - 1)) ||
+        (0 != CompileINICache(INI_NAME, CACHE_NAME)))
+    {
+        printf("damaged caches: error making the cache\n");
+        return 1;
+    }
+
+    cache = ReadText(CACHE_NAME, &size);
+
+    if (NULL == cache)
+    {
+        printf("damaged caches: error reading the cache\n");
+        return 1;
+    }
+
+    for (i = 0; (i < 2 * size) && !failed; i++)
+    {
+        if (i < size)
+        {
+            /* truncated to i bytes */
+            failed = (0 != WriteText(CACHE_NAME, cache, i));
+        }
+        else
+        {
+            /* every bit of byte i - size flipped */
+            cache[i - size] ^= 0xFF;
+            failed = (0 != WriteText(CACHE_NAME, cache, size));
+            cache[i - size] ^= 0xFF;
+        }
+
+        doc = LoadCachedDocument(INI_NAME, CACHE_NAME);
+        failed = failed || (NULL == doc) || (0 != CheckViews(doc));
+        FreeDocument(doc);
+
+        if (failed)
+        {
+            printf("damaged caches: bad views with %s byte %lu\n",
+                (i < size) ? "truncation at" : "change to",
+                (unsigned long)(i % size));
+        }
+    }
+
+    free(cache);
+    printf("damaged caches: %s\n", failed ? "FAILED" : "OK");
+    return failed;
+}
+
+/**
+ * \fn static int TestLoaderOrder(void)
+ *
+ * \brief This function checks that every kind of document lists the same
+ * sections and keys in the same order.
+ *
+ * \effects
+ * INI_NAME and CACHE_NAME are written.  The result is printed.
+ *
+ * \returns 0 if the listings of every document match LoadDocument's, 1
+ * otherwise.
+ */
+static int TestLoaderOrder(void)
+{
+    static const char *texts[] =
+    {
+        /* a section whose first header has no entries */
+        "[a]\n[b]\nk=v\n[a]\nx=1\n",
+        /* the same with comments and blank lines under the first header */
+        "[a]\n; nothing yet\n\n[b]\nk=v\n[a]\nx=1\n",
+        /* the unnamed section after a named one */
+        "[a]\n[]\ntop=1\n[a]\nx=1\n",
+        /* sections split across the file */
+        "top=0\n[a]\nx=1\n[b]\ny=2\n[a]\nz=3\n[]\nw=4\n",
+        /* no entries at all */
+        "[a]\n[b]\n# comment\n",
+        NULL
+    };
+    char expected[LISTING_SIZE];
+    char listing[LISTING_SIZE];
+    const char *kind;
+    int failed;
+    int i;
+
+    failed = 0;
+
+    for (i = 0; (NULL != texts[i]) && !failed; i++)
+    {
+        if ((0 != WriteText(INI_NAME, texts[i], strlen(texts[i]))) ||
+            (0 != CompileINICache(INI_NAME, CACHE_NAME)) ||
+            (0 != ListDocument(LoadDocument(INI_NAME), expected)))
+        {
+            printf("loader order: error loading text %d\n", i);
+            failed = 1;
+            break;
+        }
+
+        kind = NULL;
+
+        if (0 != ListDocument(LoadLazyDocument(INI_NAME), listing) ||
+            (0 != strcmp(expected, listing)))
+        {
+            kind = "lazy";
+        }
+        else if (0 != ListDocument(LoadCachedDocument(INI_NAME, CACHE_NAME),
+            listing) || (0 != strcmp(expected, listing)))
+        {
+            kind = "cached";
+        }
+        else if (0 != ListDocument(LoadDocumentParallel(INI_NAME, 2),
+            listing) || (0 != strcmp(expected, listing)))
+        {
+            kind = "parallel";
+        }
+
+        if (NULL != kind)
+        {
+            printf("loader order: %s document of text %d differs\n",
+                kind, i);
+            printf("expected:\n%sfound:\n%s", expected, listing);
+            failed = 1;
+        }
+    }
+
+    printf("loader order: %s\n", failed ? "FAILED" : "OK");
+    return failed;
+}
+
+/**
+ * \fn static int TestGetEntryFromFile(void)
+ *
+ * \brief This function counts the allocations made while reading a file
+ * with GetEntryFromFile.
+ *
+ * \effects
+ * INI_NAME is written.  The result is printed.
+ *
+ * \returns 0 if the file is read a line at a time, each entry allocates
+ * only its key and value, and nothing is left allocated at the end of the
+ * file, 1 otherwise.
+ */
+static int TestGetEntryFromFile(void)
+{
+    ini_allocator_t allocator;
+    alloc_count_t counts;
+    ini_entry_t entry;
+    FILE *fp;
+    char line[64];
+    long position;
+    int entries;
+    int result;
+    int failed;
+    int i;
+
+    fp = fopen(INI_NAME, "w");
+
+    if (NULL == fp)
+    {
+        printf("GetEntryFromFile: error writing %s\n", INI_NAME);
+        return 1;
+    }
+
+    fprintf(fp, "[section]\n");
+
+    for (i = 0; i < ENTRY_COUNT; i++)
+    {
+        fprintf(fp, "key%d = value%d\n", i, i);
+    }
+
+    fclose(fp);
+    fp = fopen(INI_NAME, "r");
+
+    if (NULL == fp)
+    {
+        printf("GetEntryFromFile: error reading %s\n", INI_NAME);
+        return 1;
+    }
+
+    counts.allocs = 0;
+    counts.outstanding = 0;
+    allocator.allocate = CountAllocate;
+    allocator.reallocate = CountReallocate;
+    allocator.release = CountRelease;
+    allocator.user = &counts;
+    SetINIAllocator(&allocator);
+
+    entry.section = NULL;
+    entry.key = NULL;
+    entry.value = NULL;
+    entries = 0;
+    failed = 0;
+    position = (long)strlen("[section]\n");
+
+    while ((result = GetEntryFromFile(fp, &entry)) > 0)
+    {
+        /* the file must not be read past the entry's line */
+        sprintf(line, "key%d = value%d\n", entries, entries);
+        position += (long)strlen(line);
+        failed = failed || (ftell(fp) != position);
+        entries++;
+    }
+
+    SetINIAllocator(NULL);
+    fclose(fp);
+
+    /* one line buffer, one section, and a key and value for each entry */
+    if ((result < 0) || (ENTRY_COUNT != entries) ||
+        (counts.allocs > 2 + 2 * ENTRY_COUNT) || (0 != counts.outstanding))
+    {
+        printf("GetEntryFromFile: %d entries, %lu allocations, "
+            "%ld not freed\n", entries, counts.allocs, counts.outstanding);
+        failed = 1;
+    }
+
+    printf("GetEntryFromFile: %s\n", failed ? "FAILED" : "OK");
+    return failed;
+}
+
+/**
+ * \fn static int TestBlankSectionName(void)
+ *
+ * \brief This function checks the name of sections whose brackets hold
+ * only white space.
+ *
+ * \effects
+ * INI_NAME is written.  The result is printed.
+ *
+ * \returns 0 if "[ ]" names the unnamed section when read by
+ * GetEntryFromFile and LoadDocument, 1 otherwise.
+ *
+ * Before ParseLine was shared, trimming "[ ]" stepped back past the '['
+ * and the section was named "]" followed by the rest of the line.  Blank
+ * names now trim to "" like "[]".
+ */
+static int TestBlankSectionName(void)
+{
+    static const char text[] =
+        "[ ]\n"
+        "a = 1\n"
+        "[\t ] ; comment\n"
+        "b = 2\n";
+    static const char expected[] =
+        "[]\n"
+        "a=1\n"
+        "b=2\n";
+    char listing[LISTING_SIZE];
+    ini_entry_t entry;
+    FILE *fp;
+    int result;
+    int failed;
+
+    if (0 != WriteText(INI_NAME, text, sizeof(text) - 1))
+    {
+        printf("blank section names: error writing %s\n", INI_NAME);
+        return 1;
+    }
+
+    failed = 0;
+    fp = fopen(INI_NAME, "r");
+    entry.section = NULL;
+    entry.key = NULL;
+    entry.value = NULL;
+
+    while ((NULL != fp) && ((result = GetEntryFromFile(fp, &entry)) > 0))
+    {
+        failed = failed || (NULL == entry.section) ||
+            ('\0' != entry.section[0]);
+    }
+
+    failed = failed || (NULL == fp) || (0 != result);
+
+    if (NULL != fp)
+    {
+        fclose(fp);
+    }
+
+    if ((0 != ListDocument(LoadDocument(INI_NAME), listing)) ||
+        (0 != strcmp(expected, listing)))
+    {
+        failed = 1;
+    }
+
+    printf("blank section names: %s\n", failed ? "FAILED" : "OK");
+    return failed;
+}
+
+/**
+ * \fn static int TestConversions(void)
+ *
+ * \brief This function checks that the conversion functions treat white
+ * space the same way, and accept subnormal doubles.
+ *
+ * \effects The result is printed.
+ *
+ * \returns 0 if every conversion returned the expected result, 1
+ * otherwise.
+ */
+static int TestConversions(void)
+{
+    static const char *spaced[] =
+    {
+        " 5", "5 ", "\t5", "  2.5", "2.5 ", " yes", " 4K", NULL
+    };
+    static const char *outOfRange[] =
+    {
+        "1e400", "-1e400", "1e-400", NULL
+    };
+    long l;
+    unsigned long ul;
+    double d;
+    int b;
+    size_t size;
+    int failed;
+    int i;
+
+    failed = 0;
+
+    /* leading or trailing white space is malformed for every type */
+    for (i = 0; NULL != spaced[i]; i++)
+    {
+        const char *str;
+        size_t length;
+
+        str = spaced[i];
+        length = strlen(str);
+
+        if ((-1 != ConvertINILong(str, length, &l)) || (EINVAL != errno) ||
+            (-1 != ConvertINIULong(str, length, &ul)) || (EINVAL != errno) ||
+            (-1 != ConvertINIDouble(str, length, &d)) || (EINVAL != errno) ||
+            (-1 != ConvertINIBool(str, length, &b)) || (EINVAL != errno) ||
+            (-1 != ConvertINISize(str, length, &size)) || (EINVAL != errno))
+        {
+            printf("conversions: \"%s\" was accepted\n", str);
+            failed = 1;
+        }
+    }
+
+    /* subnormal numbers are values, not range errors */
+    if ((0 != ConvertINIDouble("4.9e-324", 8, &d)) || !(d > 0.0) ||
+        (0 != ConvertINIDouble("-2.5e-310", 9, &d)) || !(d < 0.0))
+    {
+        printf("conversions: subnormal numbers were rejected\n");
+        failed = 1;
+    }
+
+    for (i = 0; NULL != outOfRange[i]; i++)
+    {
+        if ((-1 != ConvertINIDouble(outOfRange[i], strlen(outOfRange[i]),
+            &d)) || (ERANGE != errno))
+        {
+            printf("conversions: %s was in range\n", outOfRange[i]);
+            failed = 1;
+        }
+    }
+
+    printf("conversions: %s\n", failed ? "FAILED" : "OK");
+    return failed;
+}
+
+/**
+ * \fn static int TestUnterminatedLastLine(void)
+ *
+ * \brief This function adds entries to files whose last line doesn't end
+ * with a new line.
+ *
+ * \effects
+ * INI_NAME is written.  The result is printed.
+ *
+ * \returns 0 if a new line is only added when text is added after the last
+ * line, 1 otherwise.
+ */
+static int TestUnterminatedLastLine(void)
+{
+    static const struct
+    {
+        const char *before;
+        const char *section;
+        const char *key;
+        const char *value;
+        const char *after;
+    } cases[] =
+    {
+        /* replaced in place, nothing follows the last line */
+        {"[a]\nk=1", "a", "k", "2", "[a]\nk=2"},
+        {"[a]\nk=1\n[b]\nj=2", "a", "k", "10", "[a]\nk=10\n[b]\nj=2"},
+        {"[a]\nk=1\n[b]\nj=2", "a", "x", "3",
+            "[a]\nk=1\nx = 3\n[b]\nj=2"},
+        /* added after the last line */
+        {"[a]\nk=1", "a", "x", "3", "[a]\nk=1\nx = 3\n"},
+        {"[a]\nk=1", "b", "x", "3", "[a]\nk=1\n[b]\nx = 3\n\n"},
+        {NULL, NULL, NULL, NULL, NULL}
+    };
+    ini_entry_list_t list;
+    char *data;
+    size_t size;
+    int failed;
+    int i;
+
+    failed = 0;
+
+    for (i = 0; NULL != cases[i].before; i++)
+    {
+        list = NULL;
+        data = NULL;
+
+        if ((0 == WriteText(INI_NAME, cases[i].before,
+            strlen(cases[i].before))) &&
+            (0 == AddEntryToList(&list, cases[i].section, cases[i].key,
+            cases[i].value)) &&
+            (0 == AddEntryToFile(INI_NAME, list)))
+        {
+            data = ReadText(INI_NAME, &size);
+        }
+
+        if ((NULL == data) || (0 != strcmp(cases[i].after, data)))
+        {
+            printf("unterminated last line: case %d gave \"%s\"\n", i,
+                (NULL == data) ? "(error)" : data);
+            failed = 1;
+        }
+
+        free(data);
+        FreeList(list);
+    }
+
+    printf("unterminated last line: %s\n", failed ? "FAILED" : "OK");
+    return failed;
+}
+
+/**
+ * \fn static int TestDeleteOnly(void)
+ *
+ * \brief This function deletes entries from a file without adding any
+ * text, in place and with atomic writes.
+ *
+ * \effects
+ * INI_NAME is written.  The write mode is changed and restored.  The result
+ * is printed.
+ *
+ * \returns 0 if the deleted lines and nothing else were removed, 1
+ * otherwise.
+ *
+ * An edit list that only deletes has no text, which once passed a NULL
+ * pointer to fwrite and memcmp.
+ */
+static int TestDeleteOnly(void)
+{
+    static const char text[] =
+        "[a]\n"
+        "k = 1\n"
+        "j = 2\n"
+        "[b]\n"
+        "k = 3\n";
+    int failed;
+    int mode;
+
+    failed = 0;
+
+    for (mode = 0; mode < 2; mode++)
+    {
+        SetINIWriteMode(mode ? INI_WRITE_ATOMIC : 0);
+
+        if ((0 != WriteText(INI_NAME, text, sizeof(text) - 1)) ||
+            (0 != DeleteEntryFromFile(INI_NAME, "a", "k")) ||
+            (0 != CheckFile("delete only", "[a]\nj = 2\n[b]\nk = 3\n")) ||
+            (0 != DeleteEntryFromFile(INI_NAME, "b", "k")) ||
+            (0 != CheckFile("delete only", "[a]\nj = 2\n[b]\n")) ||
+            (0 != DeleteEntryFromFile(INI_NAME, "c", "k")) ||
+            (0 != CheckFile("delete only", "[a]\nj = 2\n[b]\n")))
+        {
+            failed = 1;
+        }
+    }
+
+    SetINIWriteMode(0);
+    printf("delete only: %s\n", failed ? "FAILED" : "OK");
+    return failed;
+}
+
+/**
+ * \fn static int TestDeleteEntries(void)
+ *
+ * \brief This function deletes batches of entries with each of
+ * DeleteEntriesFromFile's selectors and with all of them at once.
+ *
+ * \effects
+ * INI_NAME is written.  The result is printed.
+ *
+ * \returns 0 if each batch removed exactly the selected lines, 1
+ * otherwise.
+ */
+static int TestDeleteEntries(void)
+{
+    static const char text[] =
+        "; head\n"
+        "[a]\n"
+        "k = 1\n"
+        "; between\n"
+        "j = 2\n"
+        "x = 3\n"
+        "[b]\n"
+        "y = 4\n"
+        "; b comment\n"
+        "[c]\n"
+        "z = 5\n"
+        "q = 6";
+    static const char adjacent[] = "[a]\nk = 1\nj = 2\n[b]\nk = 1\n";
+    static const char *sectionB[] = {"b", NULL};
+    static const char *sectionC[] = {"c", NULL};
+    static const struct
+    {
+        int pairs;                  /* delete (a, k) and (a, j) */
+        const char *const *sections;
+        int filter;                 /* delete values of 6 */
+        int calls;                  /* expected calls of the filter */
+        const char *after;
+    } cases[] =
+    {
+        /* the comment between the deleted lines stays */
+        {1, NULL, 0, 0,
+            "; head\n[a]\n; between\nx = 3\n[b]\ny = 4\n; b comment\n"
+            "[c]\nz = 5\nq = 6"},
+        /* a section goes with every line up to the next header */
+        {0, sectionB, 0, 0,
+            "; head\n[a]\nk = 1\n; between\nj = 2\nx = 3\n[c]\nz = 5\n"
+            "q = 6"},
+        {0, sectionC, 0, 0,
+            "; head\n[a]\nk = 1\n; between\nj = 2\nx = 3\n[b]\ny = 4\n"
+            "; b comment\n"},
+        /* the last line has no new line, the one before keeps its own */
+        {0, NULL, 1, 6,
+            "; head\n[a]\nk = 1\n; between\nj = 2\nx = 3\n[b]\ny = 4\n"
+            "; b comment\n[c]\nz = 5\n"},
+        /* the filter only sees entries that the others don't delete */
+        {1, sectionB, 1, 3,
+            "; head\n[a]\n; between\nx = 3\n[c]\nz = 5\n"},
+        {0, NULL, 0, 0, text}
+    };
+    ini_entry_list_t pairs;
+    int calls;
+    int failed;
+    int i;
+
+    pairs = NULL;
+
+    if ((0 != AddEntryToList(&pairs, "a", "k", "")) ||
+        (0 != AddEntryToList(&pairs, "a", "j", "")))
+    {
+        printf("delete entries: error building pairs\n");
+        FreeList(pairs);
+        return 1;
+    }
+
+    failed = 0;
+
+    for (i = 0; i < (int)(sizeof(cases) / sizeof(cases[0])); i++)
+    {
+        calls = 0;
+
+        if ((0 != WriteText(INI_NAME, text, sizeof(text) - 1)) ||
+            (0 != DeleteEntriesFromFile(INI_NAME,
+            cases[i].pairs ? pairs : NULL, cases[i].sections,
+            cases[i].filter ? FilterSixes : NULL, &calls)) ||
+            (0 != CheckFile("delete entries", cases[i].after)) ||
+            (calls != cases[i].calls))
+        {
+            printf("delete entries: case %d failed, %d filter calls\n", i,
+                calls);
+            failed = 1;
+        }
+    }
+
+    /* adjacent deleted lines, then everything in a section */
+    if ((0 != WriteText(INI_NAME, adjacent, sizeof(adjacent) - 1)) ||
+        (0 != DeleteEntriesFromFile(INI_NAME, pairs, NULL, NULL, NULL)) ||
+        (0 != CheckFile("delete entries", "[a]\n[b]\nk = 1\n")))
+    {
+        failed = 1;
+    }
+
+    FreeList(pairs);
+    printf("delete entries: %s\n", failed ? "FAILED" : "OK");
+    return failed;
+}
+
+/**
+ * \fn static int TestSyncStats(void)
+ *
+ * \brief This function counts the syncs made by threads writing different
+ * files at the same time.
+ *
+ * \effects
+ * Files are written and deleted.  The write mode and sync statistics are
+ * changed and restored.  The result is printed.
+ *
+ * \returns 0 if every fsync was counted once (none without POSIX) and
+ * GetINIStats agrees with GetINISyncStats, 1 otherwise.
+ */
+static int TestSyncStats(void)
+{
+    ini_stats_t stats;
+    int ids[SYNC_THREADS];
+    unsigned long count;
+    unsigned long expected;
+    double seconds;
+    int failed;
+    int i;
+#ifdef REGRESS_THREADS
+    pthread_t threads[SYNC_THREADS];
+    int started;
+#endif
+
+    SetINIWriteMode(INI_WRITE_SYNC);
+    ResetINISyncStats();
+    failed = 0;
+
+#ifdef REGRESS_THREADS
+    /* one fsync per file written, made by several threads at once */
+    expected = SYNC_THREADS * SYNC_WRITES;
+
+    for (started = 0; started < SYNC_THREADS; started++)
+    {
+        ids[started] = started;
+
+        if (0 != pthread_create(&threads[started], NULL, WriteSynced,
+            &ids[started]))
+        {
+            failed = 1;
+            break;
+        }
+    }
+
+    for (i = 0; i < started; i++)
+    {
+        failed = (0 != pthread_join(threads[i], NULL)) || failed;
+    }
+#else
+    /* files are only flushed, there is no fsync to count */
+    expected = 0;
+
+    for (i = 0; i < SYNC_THREADS; i++)
+    {
+        ids[i] = i;
+        WriteSynced(&ids[i]);
+    }
+#endif
+
+    GetINISyncStats(&count, &seconds);
+    SetINIWriteMode(0);
+
+    /* both interfaces report the same counters, and both reset them */
+    GetINIStats(&stats);
+    failed = failed || (stats.syncs != count) ||
+        (stats.syncSeconds != seconds);
+    ResetINIStats();
+    GetINIStats(&stats);
+    failed = failed || (0 != stats.syncs);
+
+    if (failed || (count != expected) || (seconds < 0.0))
+    {
+        printf("sync statistics: %lu syncs counted, %lu expected\n", count,
+            expected);
+        failed = 1;
+    }
+
+    printf("sync statistics: %s\n", failed ? "FAILED" : "OK");
+    return failed;
+}
+
+/**
+ * \fn static void *WriteSynced(void *arg)
+ *
+ * \brief This function writes a file of its own SYNC_WRITES times.
+ *
+ * \param arg A pointer to the int identifying the file.
+ *
+ * \effects The file is written and deleted.
+ *
+ * \returns NULL
+ */
+static void *WriteSynced(void *arg)
+{
+    ini_entry_list_t list;
+    char name[32];
+    int i;
+
+    sprintf(name, "regress_sync%d.ini", *(int *)arg);
+    list = NULL;
+    AddEntryToList(&list, "section", "key", "value");
+
+    for (i = 0; i < SYNC_WRITES; i++)
+    {
+        MakeINIFile(name, list);
+    }
+
+    FreeList(list);
+    remove(name);
+    return NULL;
+}
+
+/**
+ * \fn static int TestParallelLoad(void)
+ *
+ * \brief This function loads a file split into chunks by several threads,
+ * and compares the list to one built from the same entries with
+ * AddEntryToList.
+ *
+ * \effects
+ * INI_NAME is written.  The result is printed.
+ *
+ * \returns 0 if MakeINIString gives the same text for both lists with
+ * every number of threads tried, 1 otherwise.
+ *
+ * The file has entries before the first section, sections that repeat
+ * throughout the file (so they span chunks), keys that repeat so that
+ * later values win, and values full of '[' so that the split points land
+ * inside values.
+ */
+static int TestParallelLoad(void)
+{
+    static const int threads[] = {1, 2, 3, 4, 7, 8};
+    ini_entry_list_t expected;
+    ini_entry_list_t loaded;
+    char *text;
+    char *want;
+    char *got;
+    char line[160];
+    char section[32];
+    char key[32];
+    char value[96];
+    size_t length;
+    size_t size;
+    size_t split;
+    unsigned long seed;
+    int landed;
+    int failed;
+    int i;
+    int j;
+
+    text = NULL;
+    length = 0;
+    size = 0;
+    expected = NULL;
+    failed = 0;
+    seed = 1;
+    strcpy(section, "");
+
+    /* a fixed pseudo random sequence, so every run tests the same file */
+    for (i = 0; (length < PARALLEL_SIZE) && !failed; i++)
+    {
+        seed = (seed * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+
+        if ((i >= 20) && (0 == (seed >> 8) % 8))
+        {
+            sprintf(section, "section %lu", (seed >> 12) % 50);
+            sprintf(line, "[%s]\n", section);
+        }
+        else
+        {
+            sprintf(key, "key %lu", (seed >> 12) % 40);
+            sprintf(value, "%d [[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[]", i);
+            sprintf(line, "%s = %s\n", key, value);
+            failed = (0 != AddEntryToList(&expected, section, key, value));
+        }
+
+        failed = failed || (0 != Append(&text, &length, &size, line));
+    }
+
+    failed = failed || (0 != WriteText(INI_NAME, text, length));
+    want = failed ? NULL : MakeINIString(expected, NULL);
+    failed = failed || (NULL == want);
+
+    for (i = 0; (i < (int)(sizeof(threads) / sizeof(threads[0]))) &&
+        !failed; i++)
+    {
+        /* where LoadListParallel starts looking for a section line */
+        landed = (1 == threads[i]);
+
+        for (j = 1; j < threads[i]; j++)
+        {
+            split = (length / threads[i]) * j;
+            landed = landed || (('[' == text[split]) &&
+                ('\n' != text[split - 1]));
+        }
+
+        loaded = NULL;
+        got = NULL;
+
+        if (0 == LoadListParallel(INI_NAME, threads[i], &loaded))
+        {
+            got = MakeINIString(loaded, NULL);
+        }
+
+        if (!landed || (NULL == got) || (0 != strcmp(want, got)))
+        {
+            printf("parallel load: %d threads %s\n", threads[i],
+                landed ? "differ" : "never split in a value");
+            failed = 1;
+        }
+
+        FreeINIMemory(got);
+        FreeList(loaded);
+    }
+
+    FreeINIMemory(want);
+    FreeList(expected);
+    free(text);
+    printf("parallel load: %s\n", failed ? "FAILED" : "OK");
+    return failed;
+}
+
+/**
+ * \fn static int Append(char **text, size_t *length, size_t *size,
+ *      const char *line)
+ *
+ * \brief This function appends a line to a growing text buffer.
+ *
+ * \param text A pointer to the buffer, which may point to NULL.
+ *
+ * \param length A pointer to the number of characters in the buffer.
+ *
+ * \param size A pointer to the number of characters allocated.
+ *
+ * \param line The NULL terminated line to append.
+ *
+ * \effects The buffer is doubled in size when it is full.
+ *
+ * \returns 0 for success, -1 if memory couldn't be allocated.
+ */
+static int Append(char **text, size_t *length, size_t *size,
+    const char *line)
+{
+    size_t add;
+    char *grown;
+
+    add = strlen(line);
+
+    if (*length + add + 1 > *size)
+    {
+        *size = (0 == *size) ? 4096 : 2 * *size;
+        grown = (char *)realloc(*text, *size);
+
+        if (NULL == grown)
+        {
+            return -1;
+        }
+
+        *text = grown;
+    }
+
+    memcpy(*text + *length, line, add + 1);
+    *length += add;
+    return 0;
+}
+
+/**
+ * \fn static int TestScanKernels(void)
+ *
+ * \brief This function parses the same text with the scalar kernel and with
+ * each of the other supported scan kernels, and compares the results.
+ *
+ * \effects
+ * The scan kernel is changed and then restored to INI_SCAN_AUTO.  The
+ * result is printed.
+ *
+ * \returns 0 if every kernel returns the same entries and errors as the
+ * scalar kernel, 1 otherwise.
+ *
+ * The two buffers are parsed in lock step, switching kernels between calls
+ * to GetEntryFromBuffer.  The text is parsed whole and with each of its
+ * last 64 characters removed, so that the final line is unterminated and
+ * ends at every position within a vector.
+ */
+static int TestScanKernels(void)
+{
+    static const char *names[] = {"auto", "scalar", "sse2", "avx2"};
+    ini_buffer_t scalar;
+    ini_buffer_t other;
+    ini_entry_view_t expected;
+    ini_entry_view_t found;
+    char *text;
+    size_t length;
+    size_t cut;
+    int want;
+    int got;
+    int kernel;
+    int failed;
+
+    text = MakeScanText(&length);
+    failed = (NULL == text) || (0 != SetScanKernel(INI_SCAN_SCALAR));
+
+    for (kernel = INI_SCAN_SSE2; (kernel <= INI_SCAN_AVX2) && !failed;
+        kernel++)
+    {
+        if (0 != SetScanKernel(kernel))
+        {
+            printf("scan kernels: %s not supported\n", names[kernel]);
+            continue;
+        }
+
+        for (cut = 0; (cut < 64) && !failed; cut++)
+        {
+            InitINIBuffer(&scalar, text, length - cut);
+            InitINIBuffer(&other, text, length - cut);
+
+            do
+            {
+                SetScanKernel(INI_SCAN_SCALAR);
+                want = GetEntryFromBuffer(&scalar, &expected);
+                SetScanKernel(kernel);
+                got = GetEntryFromBuffer(&other, &found);
+
+                failed = (want != got) || (scalar.offset != other.offset) ||
+                    ((1 == want) && !SameEntry(&expected, &found));
+            } while ((0 != want) && !failed);
+
+            if (failed)
+            {
+                printf("scan kernels: %s differs at offset %lu\n",
+                    names[kernel], (unsigned long)scalar.offset);
+            }
+        }
+    }
+
+    SetScanKernel(INI_SCAN_AUTO);
+    free(text);
+    printf("scan kernels: %s\n", failed ? "FAILED" : "OK");
+    return failed;
+}
+
+/**
+ * \fn static char *MakeScanText(size_t *length)
+ *
+ * \brief This function generates INI text that puts each structural
+ * character at every position within 16 and 32 byte vectors.
+ *
+ * \param length Set to the number of characters generated.
+ *
+ * \effects Memory is allocated for the text.
+ *
+ * \returns A pointer to the NULL terminated text, or NULL on error.
+ *
+ * Each kind of line is repeated with SCAN_PADDING different amounts of
+ * padding before its ']', '=', ';', '#', '\r', or '\n', first with LF line
+ * ends and then with CRLF.  Malformed lines are included so that errors are
+ * compared too.
+ */
+static char *MakeScanText(size_t *length)
+{
+    char line[SCAN_PADDING + 64];
+    char pad[SCAN_PADDING + 1];
+    char *text;
+    const char *eol;
+    size_t size;
+    int pass;
+    int kind;
+    int p;
+    int failed;
+
+    text = NULL;
+    *length = 0;
+    size = 0;
+    failed = 0;
+
+    for (pass = 0; (pass < 2) && !failed; pass++)
+    {
+        eol = (0 == pass) ? "\n" : "\r\n";
+
+        for (p = 0; (p < SCAN_PADDING) && !failed; p++)
+        {
+            memset(pad, 'x', p);
+            pad[p] = '\0';
+
+            for (kind = 0; (kind < 8) && !failed; kind++)
+            {
+                switch (kind)
+                {
+                    case 0:
+                        sprintf(line, "[%s]%s", pad, eol);
+                        break;
+
+                    case 1:
+                        sprintf(line, "%s; %s = [a]%s", pad + p / 2, pad,
+                            eol);
+                        break;
+
+                    case 2:
+                        sprintf(line, "\t#%s [b] = c%s", pad, eol);
+                        break;
+
+                    case 3:
+                        sprintf(line, "\t%s\t=\t[v];#\xe9%s\t%s", pad,
+                            pad + p / 2, eol);
+                        break;
+
+                    case 4:
+                        sprintf(line, "k%s=%s", pad, eol);
+                        break;
+
+                    case 5:
+                        sprintf(line, "%s%s", pad, "  \t\r\n");
+                        break;
+
+                    case 6:
+                        sprintf(line, "k = %s=\r=%s", pad, eol);
+                        break;
+
+                    default:
+                        /* malformed, no '=' or no ']' */
+                        sprintf(line, "%s%s%s", (p & 1) ? "[" : "k", pad,
+                            eol);
+                        break;
+                }
+
+                failed = (0 != Append(&text, length, &size, line));
+            }
+        }
+    }
+
+    if (failed)
+    {
+        free(text);
+        text = NULL;
+    }
+
+    return text;
+}
+
+/**
+ * \fn static int SameEntry(const ini_entry_view_t *a,
+ *      const ini_entry_view_t *b)
+ *
+ * \brief This function compares two entry views field by field.
+ *
+ * \param a A pointer to one entry view.
+ *
+ * \param b A pointer to the other entry view.
+ *
+ * \effects None
+ *
+ * \returns Non-zero if the views point to the same characters.
+ */
+static int SameEntry(const ini_entry_view_t *a, const ini_entry_view_t *b)
+{
+    return (a->section.str == b->section.str) &&
+        (a->section.length == b->section.length) &&
+        (a->key.str == b->key.str) && (a->key.length == b->key.length) &&
+        (a->value.str == b->value.str) &&
+        (a->value.length == b->value.length);
+}
+
+/**
+ * \fn static int TestPushParser(void)
+ *
+ * \brief This function feeds the same text to a push parser in chunks of
+ * different sizes, and compares the entries with those found by
+ * GetEntryFromBuffer.
+ *
+ * \effects
+ * The result is printed.
+ *
+ * \returns 0 if every way of feeding the text finds the same entries, 1
+ * otherwise.
+ *
+ * The text has entries before the first section, CRLF line ends, and a
+ * last line without a newline.  It is fed whole, a byte at a time, split
+ * between every '\r' and '\n', and in chunks of random sizes.  One parser
+ * is used throughout, so it is also checked that FinishParser resets it.
+ * Finally the callback stops the parse and later feeds are checked to
+ * return its value.
+ */
+static int TestPushParser(void)
+{
+    static const char head[] =
+        "top = 1\r\n"
+        "; a comment = [not a section]\r\n"
+        "\t also top\t=\tvalue with spaces  \r\n"
+        "[one]\r\n"
+        "a = b\r\n"
+        "\r\n"
+        "  [ two ]\n"
+        "key=\tx = y\r\n"
+        "# another = comment\n"
+        "[]\r\n"
+        "empty =\r\n";
+    static const char tail[] = "[last]\r\nfinal = no newline";
+    ini_parser_t *parser;
+    ini_buffer_t buffer;
+    ini_entry_view_t entry;
+    entry_record_t expected;
+    entry_record_t found;
+    char *text;
+    char line[64];
+    size_t length;
+    size_t size;
+    int mode;
+    int result;
+    int failed;
+    int i;
+
+    text = NULL;
+    length = 0;
+    size = 0;
+    failed = (0 != Append(&text, &length, &size, head));
+
+    for (i = 0; (i < 200) && !failed; i++)
+    {
+        sprintf(line, (0 == i % 25) ? "[section %d]\r\n" :
+            "key %d = value %d\r\n", i, i * 7);
+        failed = (0 != Append(&text, &length, &size, line));
+    }
+
+    failed = failed || (0 != Append(&text, &length, &size, tail));
+    memset(&expected, 0, sizeof(expected));
+    InitINIBuffer(&buffer, text, length);
+
+    while (!failed && (1 == (result = GetEntryFromBuffer(&buffer, &entry))))
+    {
+        failed = (0 != RecordEntry(&entry, &expected));
+    }
+
+    failed = failed || (0 != result);
+    parser = failed ? NULL : NewParser(RecordEntry, &found);
+    failed = failed || (NULL == parser);
+
+    /* modes 0-2 are whole, bytes, and CRLF splits, the rest are random */
+    for (mode = 0; (mode < 23) && !failed; mode++)
+    {
+        memset(&found, 0, sizeof(found));
+        result = FeedInChunks(parser, text, length, mode, mode);
+
+        if ((0 != result) || (found.length != expected.length) ||
+            (0 != memcmp(found.text, expected.text, expected.length)))
+        {
+            printf("push parser: feed mode %d found:\n%.*s\n", mode,
+                (int)found.length, (NULL == found.text) ? "" : found.text);
+            failed = 1;
+        }
+
+        free(found.text);
+    }
+
+    if (!failed)
+    {
+        /* stop after the third entry, a byte at a time */
+        memset(&found, 0, sizeof(found));
+        found.stopAt = 3;
+        result = FeedInChunks(parser, text, length, 1, 0);
+        failed = (7 != result) || (3 != found.entries) ||
+            (7 != FeedParser(parser, "x = y\n", 6)) ||
+            (7 != FinishParser(parser)) ||
+            (0 != FeedParser(parser, "x = y\n", 6)) ||
+            (0 != FinishParser(parser)) || (4 != found.entries);
+        free(found.text);
+
+        if (failed)
+        {
+            printf("push parser: stopping returned %d\n", result);
+        }
+    }
+
+    FreeParser(parser);
+    free(expected.text);
+    free(text);
+    printf("push parser: %s\n", failed ? "FAILED" : "OK");
+    return failed;
+}
+
+/**
+ * \fn static int FeedInChunks(ini_parser_t *parser, const char *text,
+ *      size_t length, int mode, unsigned long seed)
+ *
+ * \brief This function feeds text to a push parser in chunks and then
+ * finishes the parse.
+ *
+ * \param parser A pointer to the parser being fed.
+ *
+ * \param text A pointer to the text.
+ *
+ * \param length The number of characters in text.
+ *
+ * \param mode 0 to feed the text whole, 1 to feed it a byte at a time, 2
+ * to split it after every '\r', or anything else for chunks of random
+ * sizes.
+ *
+ * \param seed The seed for the random chunk sizes.
+ *
+ * \effects The parser's callback is called with each entry.
+ *
+ * \returns The first non-zero value returned by FeedParser, or the value
+ * returned by FinishParser.
+ */
+static int FeedInChunks(ini_parser_t *parser, const char *text,
+    size_t length, int mode, unsigned long seed)
+{
+    const char *cr;
+    size_t offset;
+    size_t chunk;
+    int result;
+
+    result = 0;
+
+    for (offset = 0; (offset < length) && (0 == result); offset += chunk)
+    {
+        if (0 == mode)
+        {
+            chunk = length;
+        }
+        else if (1 == mode)
+        {
+            chunk = 1;
+        }
+        else if (2 == mode)
+        {
+            cr = (const char *)memchr(text + offset, '\r', length - offset);
+            chunk = (NULL == cr) ? length - offset : (cr - text) - offset + 1;
+        }
+        else
+        {
+            seed = (seed * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+            chunk = 1 + (seed >> 8) % 40;
+        }
+
+        if (chunk > length - offset)
+        {
+            chunk = length - offset;
+        }
+
+        result = FeedParser(parser, text + offset, chunk);
+    }
+
+    return (0 != result) ? result : FinishParser(parser);
+}
+
+/**
+ * \fn static int RecordEntry(const ini_entry_view_t *entry, void *user)
+ *
+ * \brief This function is a push parser callback that records each entry
+ * as a line of text.
+ *
+ * \param entry A pointer to the entry being recorded.
+ *
+ * \param user A pointer to the entry_record_t being added to.
+ *
+ * \effects A line is appended to the record's text.
+ *
+ * \returns 0 to continue, 7 when the record's stopAt entries have been
+ * recorded, or 1 if memory couldn't be allocated.
+ */
+static int RecordEntry(const ini_entry_view_t *entry, void *user)
+{
+    entry_record_t *record;
+    char line[256];
+
+    record = (entry_record_t *)user;
+
+    if ((entry->section.length > 64) || (entry->key.length > 64) ||
+        (entry->value.length > 64))
+    {
+        return 1;
+    }
+
+    if (NULL == entry->section.str)
+    {
+        strcpy(line, "(none)");
+    }
+    else
+    {
+        sprintf(line, "[%.*s]", (int)entry->section.length,
+            entry->section.str);
+    }
+
+    sprintf(line + strlen(line), " <%.*s> = <%.*s>\n",
+        (int)entry->key.length, entry->key.str, (int)entry->value.length,
+        entry->value.str);
+
+    if (0 != Append(&(record->text), &(record->length), &(record->size),
+        line))
+    {
+        return 1;
+    }
+
+    record->entries++;
+    return (record->entries == record->stopAt) ? 7 : 0;
+}
+
+/**
+ * \fn static int TestWatcher(void)
+ *
+ * \brief This function rewrites a watched file while a reader holds its
+ * snapshot, then replaces it with a file that can't be loaded.
+ *
+ * \effects
+ * INI_NAME is written and watched.  The result is printed.
+ *
+ * \returns 0 if the new snapshot is published while the old one is still
+ * held and readable, and the failed reload is counted without replacing
+ * the snapshot, 1 otherwise.
+ *
+ * Without threads StartWatcher must fail.
+ */
+static int TestWatcher(void)
+{
+    static const char first[] = "[w]\nk = 1\n";
+    static const char second[] = "[w]\nk = 2\n";
+    static const char broken[] = "[w]\nno equals sign\n";
+    ini_watcher_t *watcher;
+    int failed;
+#ifdef REGRESS_THREADS
+    const ini_document_t *old;
+    const ini_document_t *doc;
+    struct timespec pause;
+    unsigned long version;
+    int held;
+    int token;
+    int newer;
+    int tries;
+#endif
+
+    failed = (0 != WriteText(INI_NAME, first, sizeof(first) - 1));
+    watcher = failed ? NULL : StartWatcher(INI_NAME, 20);
+
+#ifdef REGRESS_THREADS
+    failed = failed || (NULL == watcher);
+
+    if (!failed)
+    {
+        pause.tv_sec = 0;
+        pause.tv_nsec = 10000000L;
+        version = GetSnapshotVersion(watcher);
+        old = AcquireSnapshot(watcher, &held);
+        failed = !HasWatchValue(old, "1") ||
+            (0 != WriteText(INI_NAME, second, sizeof(second) - 1));
+
+        /* new readers get the new snapshot while the old one is held */
+        newer = 0;
+
+        for (tries = 0; (tries < 500) && !newer && !failed; tries++)
+        {
+            doc = AcquireSnapshot(watcher, &token);
+            newer = (doc != old) && HasWatchValue(doc, "2");
+            ReleaseSnapshot(watcher, token);
+
+            if (!newer)
+            {
+                nanosleep(&pause, NULL);
+            }
+        }
+
+        if (!newer || !HasWatchValue(old, "1"))
+        {
+            printf("watcher: no new snapshot while the old one was held\n");
+            failed = 1;
+        }
+
+        /* the reload completes once the old snapshot is released */
+        ReleaseSnapshot(watcher, held);
+        failed = failed || !WaitForSnapshot(watcher, version, 5000) ||
+            (0 != GetWatcherErrors(watcher));
+
+        if (!failed)
+        {
+            failed = (0 != WriteText(INI_NAME, broken, sizeof(broken) - 1));
+
+            for (tries = 0; (tries < 500) && !failed &&
+                (0 == GetWatcherErrors(watcher)); tries++)
+            {
+                nanosleep(&pause, NULL);
+            }
+
+            doc = AcquireSnapshot(watcher, &token);
+            failed = failed || (0 == GetWatcherErrors(watcher)) ||
+                !HasWatchValue(doc, "2");
+            ReleaseSnapshot(watcher, token);
+
+            if (failed)
+            {
+                printf("watcher: failed reload not counted\n");
+            }
+        }
+    }
+#else
+    /* watching needs threads */
+    failed = failed || (NULL != watcher);
+#endif
+
+    StopWatcher(watcher);
+    printf("watcher: %s\n", failed ? "FAILED" : "OK");
+    return failed;
+}
+
+/**
+ * \fn static int HasWatchValue(const ini_document_t *doc,
+ *      const char *expected)
+ *
+ * \brief This function checks the value of key k in section w of a
+ * snapshot.
+ *
+ * \param doc A pointer to the snapshot.  May be NULL.
+ *
+ * \param expected The NULL terminated value expected.
+ *
+ * \effects None
+ *
+ * \returns Non-zero if the snapshot has the expected value.
+ */
+static int HasWatchValue(const ini_document_t *doc, const char *expected)
+{
+    ini_view_t section;
+    ini_view_t key;
+    ini_view_t value;
+
+    section.str = "w";
+    section.length = 1;
+    key.str = "k";
+    key.length = 1;
+
+    return (NULL != doc) &&
+        (0 == GetViewFromDocument(doc, &section, &key, &value)) &&
+        (value.length == strlen(expected)) &&
+        (0 == memcmp(value.str, expected, value.length));
+}
+
+/**
+ * \fn static int TestHashIndex(void)
+ *
+ * \brief This function adds, updates, and deletes entries of a list in an
+ * order that grows its hash indices several times and deletes from them
+ * between lookups, checking the list against a model after each step.
+ *
+ * \effects
+ * The result is printed.
+ *
+ * \returns 0 if every lookup and the list's contents match the model, 1
+ * otherwise.
+ *
+ * The model holds the round in which each (section, key) pair was last
+ * written, or 0 if the pair isn't in the list.  Deleting every key of a
+ * section deletes the section, so the section index is deleted from too.
+ */
+static int TestHashIndex(void)
+{
+    static int model[INDEX_SECTIONS * INDEX_KEYS];
+    ini_entry_list_t list;
+    char section[32];
+    char key[32];
+    char value[32];
+    unsigned long seed;
+    int pair;
+    int other;
+    int round;
+    int failed;
+
+    list = NULL;
+    memset(model, 0, sizeof(model));
+    failed = 0;
+
+    /* add every pair, growing both indices, in an order mixing sections */
+    for (pair = 0; (pair < INDEX_SECTIONS * INDEX_KEYS) && !failed; pair++)
+    {
+        other = (pair % INDEX_SECTIONS) * INDEX_KEYS + pair / INDEX_SECTIONS;
+        sprintf(section, "section %d", other / INDEX_KEYS);
+        sprintf(key, "key %d", other % INDEX_KEYS);
+        sprintf(value, "%d", 1);
+        failed = (0 != AddEntryToList(&list, section, key, value));
+        model[other] = 1;
+    }
+
+    failed = failed || (0 != CheckIndexList(list, model));
+
+    /* delete a third of the pairs, and every pair of every 8th section */
+    for (pair = 0; (pair < INDEX_SECTIONS * INDEX_KEYS) && !failed; pair++)
+    {
+        if ((0 == pair % 3) || (0 == (pair / INDEX_KEYS) % 8))
+        {
+            sprintf(section, "section %d", pair / INDEX_KEYS);
+            sprintf(key, "key %d", pair % INDEX_KEYS);
+            failed = (0 != DeleteEntryFromList(&list, section, key)) ||
+                (0 == DeleteEntryFromList(&list, section, key)) ||
+                (ENOENT != errno);
+            model[pair] = 0;
+        }
+    }
+
+    failed = failed || (0 != CheckIndexList(list, model));
+    seed = 1;
+
+    /* random deletes, re-adds, and updates, each followed by lookups */
+    for (round = 2; (round < 20002) && !failed; round++)
+    {
+        seed = (seed * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+        pair = (int)((seed >> 8) % (INDEX_SECTIONS * INDEX_KEYS));
+        sprintf(section, "section %d", pair / INDEX_KEYS);
+        sprintf(key, "key %d", pair % INDEX_KEYS);
+
+        if ((0 != model[pair]) && (0 == (seed >> 4) % 2))
+        {
+            failed = (0 != DeleteEntryFromList(&list, section, key));
+            model[pair] = 0;
+        }
+        else
+        {
+            sprintf(value, "%d", round);
+            failed = (0 != AddEntryToList(&list, section, key, value));
+            model[pair] = round;
+        }
+
+        other = (int)((seed >> 12) % (INDEX_SECTIONS * INDEX_KEYS));
+        failed = failed || (0 != CheckIndexPair(list, model, pair)) ||
+            (0 != CheckIndexPair(list, model, other));
+    }
+
+    failed = failed || (0 != CheckIndexList(list, model));
+
+    /* empty the list, then use it again */
+    for (pair = 0; (pair < INDEX_SECTIONS * INDEX_KEYS) && !failed; pair++)
+    {
+        if (0 != model[pair])
+        {
+            sprintf(section, "section %d", pair / INDEX_KEYS);
+            sprintf(key, "key %d", pair % INDEX_KEYS);
+            failed = (0 != DeleteEntryFromList(&list, section, key));
+            model[pair] = 0;
+        }
+    }
+
+    failed = failed || (0 != CheckIndexList(list, model)) ||
+        (0 != AddEntryToList(&list, "section 0", "key 0", "20002"));
+    model[0] = 20002;
+    failed = failed || (0 != CheckIndexList(list, model));
+
+    FreeList(list);
+    printf("hash index: %s\n", failed ? "FAILED" : "OK");
+    return failed;
+}
+
+/**
+ * \fn static int CheckIndexPair(ini_entry_list_t list, const int *model,
+ *      int pair)
+ *
+ * \brief This function looks up a pair of TestHashIndex's list and
+ * compares it with the model.
+ *
+ * \param list The list being checked.
+ *
+ * \param model The round in which each pair was last written, 0 for
+ * pairs that aren't in the list.
+ *
+ * \param pair The index of the pair in the model.
+ *
+ * \effects A difference is printed.
+ *
+ * \returns 0 if the lookup matches the model, 1 otherwise.
+ */
+static int CheckIndexPair(ini_entry_list_t list, const int *model, int pair)
+{
+    ini_view_t section;
+    ini_view_t key;
+    ini_view_t value;
+    char sectionName[32];
+    char keyName[32];
+    char expected[32];
+    int result;
+
+    sprintf(sectionName, "section %d", pair / INDEX_KEYS);
+    sprintf(keyName, "key %d", pair % INDEX_KEYS);
+    sprintf(expected, "%d", model[pair]);
+    section.str = sectionName;
+    section.length = strlen(sectionName);
+    key.str = keyName;
+    key.length = strlen(keyName);
+
+    result = GetViewFromList(list, &section, &key, &value);
+
+    if (0 == model[pair])
+    {
+        result = (0 == result) ? 1 : 0;
+    }
+    else
+    {
+        result = (0 != result) || (value.length != strlen(expected)) ||
+            (0 != memcmp(value.str, expected, value.length));
+    }
+
+    if (0 != result)
+    {
+        printf("hash index: [%s] %s should be %s\n", sectionName, keyName,
+            (0 == model[pair]) ? "missing" : expected);
+    }
+
+    return result;
+}
+
+/**
+ * \fn static int CheckIndexList(ini_entry_list_t list, const int *model)
+ *
+ * \brief This function checks every pair of TestHashIndex's list against
+ * the model, both by lookup and by serializing the list.
+ *
+ * \param list The list being checked.
+ *
+ * \param model The round in which each pair was last written, 0 for
+ * pairs that aren't in the list.
+ *
+ * \effects Differences are printed.
+ *
+ * \returns 0 if the list matches the model, 1 otherwise.
+ */
+static int CheckIndexList(ini_entry_list_t list, const int *model)
+{
+    static char listed[INDEX_SECTIONS * INDEX_KEYS];
+    ini_buffer_t buffer;
+    ini_entry_view_t entry;
+    char *text;
+    size_t length;
+    int pair;
+    int section;
+    int key;
+    int failed;
+    int result;
+
+    failed = 0;
+
+    for (pair = 0; pair < INDEX_SECTIONS * INDEX_KEYS; pair++)
+    {
+        failed = (0 != CheckIndexPair(list, model, pair)) || failed;
+    }
+
+    /* the linked lists must hold exactly the indexed entries, once each */
+    memset(listed, 0, sizeof(listed));
+    text = MakeINIString(list, &length);
+    failed = failed || (NULL == text);
+    InitINIBuffer(&buffer, (NULL == text) ? "" : text,
+        (NULL == text) ? 0 : length);
+
+    while (!failed && (1 == (result = GetEntryFromBuffer(&buffer, &entry))))
+    {
+        failed = (NULL == entry.section.str) ||
+            (1 != sscanf(entry.section.str, "section %d", &section)) ||
+            (1 != sscanf(entry.key.str, "key %d", &key)) ||
+            (section < 0) || (section >= INDEX_SECTIONS) || (key < 0) ||
+            (key >= INDEX_KEYS);
+
+        if (!failed)
+        {
+            pair = section * INDEX_KEYS + key;
+            failed = (0 != listed[pair]) || (0 == model[pair]) ||
+                (atoi(entry.value.str) != model[pair]);
+            listed[pair] = 1;
+        }
+    }
+
+    for (pair = 0; (pair < INDEX_SECTIONS * INDEX_KEYS) && !failed; pair++)
+    {
+        failed = ((0 != model[pair]) != (0 != listed[pair]));
+    }
+
+    if (failed)
+    {
+        printf("hash index: the listed entries differ\n");
+    }
+
+    FreeINIMemory(text);
+    return failed;
+}
+
+/**
+ * \fn static int TestArenaList(void)
+ *
+ * \brief This function counts the allocations made building, deleting
+ * from, and freeing an arena backed list and a heap backed list of the
+ * same entries.
+ *
+ * \effects
+ * The result is printed.
+ *
+ * \returns 0 if the arena list allocates a block at a time, deletions
+ * free exactly the memory of the deleted entries of the heap list, and
+ * neither list leaks, 1 otherwise.
+ */
+static int TestArenaList(void)
+{
+    ini_allocator_t allocator;
+    alloc_count_t arenaCounts;
+    alloc_count_t heapCounts;
+    ini_entry_list_t arena;
+    ini_entry_list_t heap;
+    int failed;
+
+    allocator.allocate = CountAllocate;
+    allocator.reallocate = CountReallocate;
+    allocator.release = CountRelease;
+    allocator.user = &arenaCounts;
+    SetINIAllocator(&allocator);
+    arenaCounts.allocs = 0;
+    arenaCounts.outstanding = 0;
+    arena = NULL;
+    failed = (0 != BuildArenaTest(1, &arena, &arenaCounts));
+    FreeList(arena);
+    SetINIAllocator(NULL);
+
+    allocator.user = &heapCounts;
+    SetINIAllocator(&allocator);
+    heapCounts.allocs = 0;
+    heapCounts.outstanding = 0;
+    heap = NULL;
+    failed = (0 != BuildArenaTest(0, &heap, &heapCounts)) || failed;
+    FreeList(heap);
+    SetINIAllocator(NULL);
+
+    if (failed || (0 != arenaCounts.outstanding) ||
+        (0 != heapCounts.outstanding))
+    {
+        printf("arena list: %ld arena and %ld heap allocations not freed\n",
+            arenaCounts.outstanding, heapCounts.outstanding);
+        failed = 1;
+    }
+
+    printf("arena list: %s\n", failed ? "FAILED" : "OK");
+    return failed;
+}
+
+/**
+ * \fn static int BuildArenaTest(int arena, ini_entry_list_t *list,
+ *      alloc_count_t *counts)
+ *
+ * \brief This function builds a list of ARENA_SECTIONS * ARENA_KEYS
+ * entries under the counting allocator, then deletes and overwrites some
+ * of them.
+ *
+ * \param arena Non-zero to build an arena backed list.
+ *
+ * \param list A pointer to the list being built.  It must point to NULL.
+ *
+ * \param counts A pointer to the counts of the allocator in use.
+ *
+ * \effects The list is built and modified, but not freed.  Differences
+ * are printed.
+ *
+ * \returns 0 if the allocations are as expected, 1 otherwise.
+ *
+ * GetListAllocCount must agree with the allocator.  An arena list must
+ * make fewer than one allocation per 20 entries, a heap list at least 3
+ * per entry.  Deleting an entry from a heap list frees its node, key, and
+ * value, and deleting the last entry of a section frees the section and
+ * its name; deleting from an arena list frees nothing.
+ */
+static int BuildArenaTest(int arena, ini_entry_list_t *list,
+    alloc_count_t *counts)
+{
+    const char *name;
+    char section[32];
+    char key[32];
+    char value[64];
+    unsigned long entries;
+    long before;
+    long freed;
+    int failed;
+    int i;
+    int j;
+
+    name = arena ? "arena" : "heap";
+    entries = ARENA_SECTIONS * ARENA_KEYS;
+    failed = arena && (0 != NewArenaList(list));
+
+    for (i = 0; (i < ARENA_SECTIONS) && !failed; i++)
+    {
+        sprintf(section, "section %d", i);
+
+        for (j = 0; (j < ARENA_KEYS) && !failed; j++)
+        {
+            sprintf(key, "key %d", j);
+            sprintf(value, "value %d.%d", i, j);
+            failed = (0 != AddEntryToList(list, section, key, value));
+        }
+    }
+
+    if (failed || (GetListAllocCount(*list) != counts->allocs) ||
+        (arena ? (counts->allocs * 20 >= entries) :
+        (counts->allocs < 3 * entries)))
+    {
+        printf("arena list: %lu allocations for %lu %s entries (%lu "
+            "counted by the list)\n", counts->allocs, entries, name,
+            GetListAllocCount(*list));
+        failed = 1;
+    }
+
+    /* delete every other key, and every key of every 10th section */
+    before = counts->outstanding;
+    freed = 0;
+
+    for (i = 0; (i < ARENA_SECTIONS) && !failed; i++)
+    {
+        sprintf(section, "section %d", i);
+
+        for (j = 0; (j < ARENA_KEYS) && !failed; j++)
+        {
+            if ((0 == j % 2) || (0 == i % 10))
+            {
+                sprintf(key, "key %d", j);
+                failed = (0 != DeleteEntryFromList(list, section, key));
+                freed += 3;
+            }
+        }
+
+        freed += (0 == i % 10) ? 2 : 0;
+    }
+
+    if (failed || (before - counts->outstanding != (arena ? 0 : freed)))
+    {
+        printf("arena list: deleting from the %s list freed %ld "
+            "allocations\n", name, before - counts->outstanding);
+        failed = 1;
+    }
+
+    /* overwrite values with longer ones, then re-add deleted entries */
+    for (i = 0; (i < ARENA_SECTIONS) && !failed; i += 3)
+    {
+        sprintf(section, "section %d", i);
+
+        for (j = 0; (j < ARENA_KEYS) && !failed; j++)
+        {
+            sprintf(key, "key %d", j);
+            sprintf(value, "a longer value than before %d.%d", i, j);
+            failed = (0 != AddEntryToList(list, section, key, value));
+        }
+    }
+
+    return failed;
+}
+
+/**
+ * \fn static int TestSerializer(void)
+ *
+ * \brief This function serializes a list with a value bigger than
+ * WriteINIList's buffer with MakeINIFile, MakeINIString, and WriteINIList,
+ * and with writers that fail.
+ *
+ * \effects
+ * INI_NAME is written.  The result is printed.
+ *
+ * \returns 0 if all three make the same text, the big value is passed to
+ * the writer without being copied, and a failing writer stops WriteINIList
+ * and has its value returned without leaking, 1 otherwise.
+ */
+static int TestSerializer(void)
+{
+    ini_allocator_t allocator;
+    alloc_count_t counts;
+    ini_entry_list_t list;
+    write_record_t record;
+    ini_view_t section;
+    ini_view_t key;
+    ini_view_t big;
+    char *value;
+    char *file;
+    char *text;
+    char name[32];
+    size_t fileLength;
+    size_t length;
+    int result;
+    int calls;
+    int failed;
+    int i;
+
+    list = NULL;
+    file = NULL;
+    text = NULL;
+    calls = 0;
+    value = (char *)malloc(200001);
+    failed = (NULL == value);
+
+    if (!failed)
+    {
+        /* values that fill the 64K buffer unevenly, then a huge one */
+        for (i = 0; (i < 3000) && !failed; i++)
+        {
+            sprintf(name, "key %d", i);
+            memset(value, 'a' + i % 26, i % 97);
+            value[i % 97] = '\0';
+            failed = (0 != AddEntryToList(&list, (i < 1500) ? "first" :
+                "second", name, value));
+        }
+
+        memset(value, 'z', 200000);
+        value[200000] = '\0';
+        failed = failed ||
+            (0 != AddEntryToList(&list, "second", "big", value)) ||
+            (0 != AddEntryToList(&list, "third", "after", "big"));
+    }
+
+    /* MakeINIFile and MakeINIString make the same text */
+    failed = failed || (0 != MakeINIFile(INI_NAME, list));
+    file = failed ? NULL : ReadText(INI_NAME, &fileLength);
+    text = failed ? NULL : MakeINIString(list, &length);
+
+    if (failed || (NULL == file) || (NULL == text) ||
+        (length != fileLength) || (length != strlen(text)) ||
+        (0 != memcmp(file, text, length)))
+    {
+        printf("serializer: MakeINIString differs from MakeINIFile\n");
+        failed = 1;
+    }
+
+    /* so does WriteINIList, passing the big value as is */
+    if (!failed)
+    {
+        section.str = "second";
+        section.length = 6;
+        key.str = "big";
+        key.length = 3;
+        failed = (0 != GetViewFromList(list, &section, &key, &big));
+        memset(&record, 0, sizeof(record));
+        record.big = big.str;
+        record.bigLength = big.length;
+        result = WriteINIList(list, RecordWrite, &record);
+
+        if (failed || (0 != result) || (record.length != length) ||
+            (0 != memcmp(record.text, text, length)) || !record.bigPassed ||
+            (record.largest > 65536))
+        {
+            printf("serializer: WriteINIList returned %d in %d calls, "
+                "big value %s\n", result, record.calls,
+                record.bigPassed ? "passed" : "copied");
+            failed = 1;
+        }
+
+        calls = record.calls;
+        free(record.text);
+    }
+
+    /* a writer that fails stops the serialization, without leaks */
+    allocator.allocate = CountAllocate;
+    allocator.reallocate = CountReallocate;
+    allocator.release = CountRelease;
+    allocator.user = &counts;
+
+    for (i = 1; (i <= calls) && !failed; i++)
+    {
+        memset(&record, 0, sizeof(record));
+        record.failAt = i;
+        counts.allocs = 0;
+        counts.outstanding = 0;
+        SetINIAllocator(&allocator);
+        result = WriteINIList(list, RecordWrite, &record);
+        SetINIAllocator(NULL);
+        free(record.text);
+
+        if ((7 != result) || (i != record.calls) ||
+            (0 != counts.outstanding))
+        {
+            printf("serializer: failing call %d returned %d after %d "
+                "calls\n", i, result, record.calls);
+            failed = 1;
+        }
+    }
+
+    failed = failed || (0 == WriteINIList(NULL, RecordWrite, &record)) ||
+        (0 == WriteINIList(list, NULL, &record));
+
+    FreeINIMemory(text);
+    free(file);
+    free(value);
+    FreeList(list);
+    printf("serializer: %s\n", failed ? "FAILED" : "OK");
+    return failed;
+}
+
+/**
+ * \fn static int RecordWrite(const char *data, size_t length, void *user)
+ *
+ * \brief This is an ini_writer_t that records the blocks it is passed.
+ *
+ * \param data The block of text.
+ *
+ * \param length The number of characters in data.
+ *
+ * \param user A pointer to the write_record_t being added to.
+ *
+ * \effects The block is appended to the record's text, and it is noted
+ * whether the record's big value was passed as is.
+ *
+ * \returns 7 on the record's failAt call or if memory couldn't be
+ * allocated, 0 otherwise.
+ */
+static int RecordWrite(const char *data, size_t length, void *user)
+{
+    write_record_t *record;
+    char *grown;
+
+    record = (write_record_t *)user;
+    record->calls++;
+
+    if (record->calls == record->failAt)
+    {
+        return 7;
+    }
+
+    if ((data == record->big) && (length == record->bigLength))
+    {
+        record->bigPassed = 1;
+    }
+    else if (length > record->largest)
+    {
+        record->largest = length;
+    }
+
+    grown = (char *)realloc(record->text, record->length + length);
+
+    if (NULL == grown)
+    {
+        return 7;
+    }
+
+    memcpy(grown + record->length, data, length);
+    record->text = grown;
+    record->length += length;
+    return 0;
+}
+
+/**
+ * \fn static int TestHandlers(void)
+ *
+ * \brief This function parses the same text with ParseINIFile,
+ * ParseINIBuffer, and ParseINIStream, and stops each of them at several
+ * events.
+ *
+ * \effects
+ * INI_NAME is written.  The result is printed.
+ *
+ * \returns 0 if the three functions make the same sequence of calls to
+ * the handler, entries before the first section are passed without a
+ * section, and a handler's non-zero return stops each of them at the same
+ * call and is returned, 1 otherwise.
+ *
+ * The text is longer than ParseINIStream's 64K read blocks, has CRLF line
+ * ends, comments, a repeated section, and a last line without a newline.
+ */
+static int TestHandlers(void)
+{
+    static const char head[] =
+        "top = 1\r\n"
+        "; comment = [not a section]\n"
+        "  also top\t= value with spaces \r\n"
+        "[first]\n"
+        "a = b\n"
+        "\n"
+        "[]\r\n"
+        "empty =\n";
+    static const char tail[] = "[first]\r\nlast = no newline";
+    entry_record_t expected;
+    entry_record_t found;
+    char *text;
+    char line[64];
+    size_t length;
+    size_t size;
+    int sections;
+    int events;
+    int stops[5];
+    int how;
+    int result;
+    int want;
+    int failed;
+    int i;
+
+    text = NULL;
+    length = 0;
+    size = 0;
+    sections = 3;
+    failed = (0 != Append(&text, &length, &size, head));
+
+    for (i = 0; (i < 5000) && !failed; i++)
+    {
+        if (0 == i % 100)
+        {
+            sprintf(line, "[section %d]\r\n", i / 100);
+            sections++;
+        }
+        else
+        {
+            sprintf(line, "key %d = value %d\n", i, i * 3);
+        }
+
+        failed = (0 != Append(&text, &length, &size, line));
+    }
+
+    failed = failed || (0 != Append(&text, &length, &size, tail)) ||
+        (0 != WriteText(INI_NAME, text, length));
+
+    /* the whole text, the buffer's events are the reference */
+    memset(&expected, 0, sizeof(expected));
+    failed = failed || (0 != RunHandlers(1, text, length, &expected));
+    events = expected.entries;
+
+    if (failed || (0 != strncmp(expected.text, "E<top> = <1>\nE<", 15)) ||
+        (NULL == strstr(expected.text, "S<>\nE<empty> = <>\n")) ||
+        (events != 4 + 4950 + 1 + sections))
+    {
+        printf("handlers: %d events, %d expected\n", events,
+            4 + 4950 + 1 + sections);
+        failed = 1;
+    }
+
+    for (how = 0; (how < 3) && !failed; how += 2)
+    {
+        memset(&found, 0, sizeof(found));
+        result = RunHandlers(how, text, length, &found);
+
+        if ((0 != result) || (found.length != expected.length) ||
+            (0 != memcmp(found.text, expected.text, expected.length)))
+        {
+            printf("handlers: %s differs from ParseINIBuffer\n",
+                (0 == how) ? "ParseINIFile" : "ParseINIStream");
+            failed = 1;
+        }
+
+        free(found.text);
+    }
+
+    /* stop at the first event, a section, an entry, and the last event */
+    stops[0] = 1;
+    stops[1] = 4;
+    stops[2] = 5;
+    stops[3] = events / 2;
+    stops[4] = events;
+
+    for (i = 0; (i < 5) && !failed; i++)
+    {
+        for (how = 0; (how < 3) && !failed; how++)
+        {
+            memset(&found, 0, sizeof(found));
+            found.stopAt = stops[i];
+            result = RunHandlers(how, text, length, &found);
+            failed = (found.entries != stops[i]) ||
+                (found.length > expected.length) ||
+                (0 != memcmp(found.text, expected.text, found.length));
+
+            if (!failed)
+            {
+                /* the value returned by the handler of the last event */
+                for (want = (int)found.length - 1;
+                    (want > 0) && ('\n' != found.text[want - 1]); want--)
+                {
+                    /* find the start of the last line */
+                }
+
+                want = ('S' == found.text[want]) ? 7 : 9;
+                failed = (result != want);
+            }
+
+            if (failed)
+            {
+                printf("handlers: stopping at event %d returned %d after "
+                    "%d events\n", stops[i], result, found.entries);
+            }
+
+            free(found.text);
+        }
+    }
+
+    free(expected.text);
+    free(text);
+    printf("handlers: %s\n", failed ? "FAILED" : "OK");
+    return failed;
+}
+
+/**
+ * \fn static int RunHandlers(int how, const char *text, size_t length,
+ *      entry_record_t *record)
+ *
+ * \brief This function parses INI text with handlers that record each
+ * event.
+ *
+ * \param how 0 for ParseINIFile of INI_NAME, 1 for ParseINIBuffer of text,
+ * or 2 for ParseINIStream of INI_NAME.
+ *
+ * \param text The text in INI_NAME.
+ *
+ * \param length The number of characters in text.
+ *
+ * \param record A pointer to the record of the events.
+ *
+ * \effects The events are recorded.
+ *
+ * \returns The value returned by the parsing function.
+ */
+static int RunHandlers(int how, const char *text, size_t length,
+    entry_record_t *record)
+{
+    ini_handler_t handler;
+    FILE *fp;
+    int result;
+
+    handler.onSection = RecordSection;
+    handler.onEntry = RecordPair;
+    handler.user = record;
+
+    if (0 == how)
+    {
+        result = ParseINIFile(INI_NAME, &handler);
+    }
+    else if (1 == how)
+    {
+        result = ParseINIBuffer(text, length, &handler);
+    }
+    else
+    {
+        fp = fopen(INI_NAME, "rb");
+        result = (NULL == fp) ? -1 : ParseINIStream(fp, &handler);
+
+        if (NULL != fp)
+        {
+            fclose(fp);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * \fn static int RecordSection(const char *name, size_t length,
+ *      void *user)
+ *
+ * \brief This is a handler function that records a section line as
+ * "S<name>".
+ *
+ * \param name The section name.
+ *
+ * \param length The number of characters in name.
+ *
+ * \param user A pointer to the entry_record_t being added to.
+ *
+ * \effects The event is recorded.
+ *
+ * \returns 7 when the record's stopAt events have been recorded, 1 if
+ * memory couldn't be allocated, and 0 otherwise.
+ */
+static int RecordSection(const char *name, size_t length, void *user)
+{
+    entry_record_t *record;
+    char line[128];
+
+    record = (entry_record_t *)user;
+
+    if ((length > 64) ||
+        (sprintf(line, "S<%.*s>\n", (int)length, name) < 0) ||
+        (0 != Append(&(record->text), &(record->length), &(record->size),
+        line)))
+    {
+        return 1;
+    }
+
+    record->entries++;
+    return (record->entries == record->stopAt) ? 7 : 0;
+}
+
+/**
+ * \fn static int RecordPair(const char *key, size_t keyLength,
+ *      const char *value, size_t valueLength, void *user)
+ *
+ * \brief This is a handler function that records an entry as
+ * "E<key> = <value>".
+ *
+ * \param key The key.
+ *
+ * \param keyLength The number of characters in key.
+ *
+ * \param value The value.
+ *
+ * \param valueLength The number of characters in value.
+ *
+ * \param user A pointer to the entry_record_t being added to.
+ *
+ * \effects The event is recorded.
+ *
+ * \returns 9 when the record's stopAt events have been recorded, 1 if
+ * memory couldn't be allocated, and 0 otherwise.
+ */
+static int RecordPair(const char *key, size_t keyLength, const char *value,
+    size_t valueLength, void *user)
+{
+    entry_record_t *record;
+    char line[160];
+
+    record = (entry_record_t *)user;
+
+    if ((keyLength > 64) || (valueLength > 64) ||
+        (sprintf(line, "E<%.*s> = <%.*s>\n", (int)keyLength, key,
+        (int)valueLength, value) < 0) ||
+        (0 != Append(&(record->text), &(record->length), &(record->size),
+        line)))
+    {
+        return 1;
+    }
+
+    record->entries++;
+    return (record->entries == record->stopAt) ? 9 : 0;
+}
+
+/**
+ * \fn static int FilterSixes(const ini_entry_view_t *entry, void *user)
+ *
+ * \brief This function is a DeleteEntriesFromFile filter that selects
+ * entries whose value is 6.
+ *
+ * \param entry A pointer to the entry being considered.
+ *
+ * \param user A pointer to an int counting the calls.
+ *
+ * \effects The count is incremented.
+ *
+ * \returns Non-zero if the entry should be deleted.
+ */
+static int FilterSixes(const ini_entry_view_t *entry, void *user)
+{
+    (*(int *)user)++;
+    return (1 == entry->value.length) && ('6' == entry->value.str[0]);
+}
+
+/**
+ * \fn static int CheckFile(const char *test, const char *expected)
+ *
+ * \brief This function compares the contents of INI_NAME to the expected
+ * text.
+ *
+ * \param test The name of the test, printed if the contents differ.
+ *
+ * \param expected The expected contents.
+ *
+ * \effects The contents are printed if they differ.
+ *
+ * \returns 0 if the contents match, 1 otherwise.
+ */
+static int CheckFile(const char *test, const char *expected)
+{
+    char *data;
+    size_t size;
+    int failed;
+
+    data = ReadText(INI_NAME, &size);
+    failed = (NULL == data) || (size != strlen(expected)) ||
+        (0 != memcmp(data, expected, size));
+
+    if (failed)
+    {
+        printf("%s: expected \"%s\" found \"%s\"\n", test, expected,
+            (NULL == data) ? "(error)" : data);
+    }
+
+    free(data);
+    return failed;
+}
+
+/**
+ * \fn static int CheckViews(const ini_document_t *doc)
+ *
+ * \brief This function checks every view returned by enumerating a
+ * document.
+ *
+ * \param doc A pointer to the document.
+ *
+ * \effects None
+ *
+ * \returns 0 if every section, key, and value view is a NULL terminated
+ * string of its length, 1 otherwise.
+ */
+static int CheckViews(const ini_document_t *doc)
+{
+    ini_section_cursor_t sections;
+    ini_cursor_t keys;
+    ini_view_t section;
+    ini_view_t key;
+    ini_view_t value;
+    ini_view_t found;
+
+    EnumerateDocumentSections(doc, &sections);
+
+    while (1 == GetSectionFromCursor(&sections, &section, &keys))
+    {
+        if ((NULL == section.str) || (strlen(section.str) != section.length))
+        {
+            return 1;
+        }
+
+        while (1 == GetKeyViewFromSection(&keys, &key, &value))
+        {
+            if ((NULL == key.str) || (NULL == value.str) ||
+                (strlen(key.str) != key.length) ||
+                (strlen(value.str) != value.length))
+            {
+                return 1;
+            }
+
+            /* the lookup may miss if an index was changed, but not crash */
+            if ((0 == GetViewFromDocument(doc, &section, &key, &found)) &&
+                ((NULL == found.str) || (strlen(found.str) != found.length)))
+            {
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * \fn static int ListDocument(ini_document_t *doc, char *listing)
+ *
+ * \brief This function lists every section and key of a document, then
+ * frees the document.
+ *
+ * \param doc A pointer to the document.  It may be NULL.
+ *
+ * \param listing A buffer of LISTING_SIZE characters for the listing.
+ *
+ * \effects
+ * listing is set to the document's entries as lines of INI text.  The
+ * document is freed.
+ *
+ * \returns 0 for success, -1 if the document is NULL, couldn't be
+ * enumerated, or doesn't fit in listing.
+ */
+static int ListDocument(ini_document_t *doc, char *listing)
+{
+    ini_section_cursor_t sections;
+    ini_cursor_t keys;
+    ini_view_t section;
+    ini_view_t key;
+    ini_view_t value;
+    size_t used;
+    int result;
+
+    listing[0] = '\0';
+
+    if (NULL == doc)
+    {
+        return -1;
+    }
+
+    used = 0;
+    EnumerateDocumentSections(doc, &sections);
+
+    while (1 == (result = GetSectionFromCursor(&sections, &section, &keys)))
+    {
+        AppendView(listing, &used, "[", &section);
+        AppendView(listing, &used, "]", NULL);
+
+        while (1 == GetKeyViewFromSection(&keys, &key, &value))
+        {
+            AppendView(listing, &used, "", &key);
+            AppendView(listing, &used, "=", &value);
+            AppendView(listing, &used, "", NULL);
+        }
+    }
+
+    FreeDocument(doc);
+    return ((0 == result) && (used < LISTING_SIZE)) ? 0 : -1;
+}
+
+/**
+ * \fn static void AppendView(char *listing, size_t *used,
+ *      const char *before, const ini_view_t *view)
+ *
+ * \brief This function appends text to a document listing.
+ *
+ * \param listing A buffer of LISTING_SIZE characters.
+ *
+ * \param used A pointer to the number of characters in listing.
+ *
+ * \param before The text preceding the view.
+ *
+ * \param view A pointer to the view to append, or NULL to end the line.
+ *
+ * \effects
+ * The text is appended to listing, followed by a new line if view is NULL.
+ * used is set to LISTING_SIZE if the listing doesn't fit.
+ *
+ * \returns Nothing
+ */
+static void AppendView(char *listing, size_t *used, const char *before,
+    const ini_view_t *view)
+{
+    size_t length;
+    size_t viewLength;
+
+    length = strlen(before);
+    viewLength = (NULL == view) ? 1 : view->length;
+
+    if (*used + length + viewLength >= LISTING_SIZE)
+    {
+        *used = LISTING_SIZE;
+        return;
+    }
+
+    memcpy(listing + *used, before, length);
+    *used += length;
+
+    if (NULL == view)
+    {
+        listing[(*used)++] = '\n';
+    }
+    else
+    {
+        memcpy(listing + *used, view->str, view->length);
+        *used += view->length;
+    }
+
+    listing[*used] = '\0';
+}
+
+/**
+ * \fn static int WriteText(const char *fileName, const char *data,
+ *      size_t size)
+ *
+ * \brief This function writes a file.
+ *
+ * \param fileName The name of the file.
+ *
+ * \param data The file's contents.
+ *
+ * \param size The number of bytes in data.
+ *
+ * \effects The file is created or replaced.
+ *
+ * \returns 0 for success, -1 on error.
+ */
+static int WriteText(const char *fileName, const char *data, size_t size)
+{
+    FILE *fp;
+    int result;
+
+    fp = fopen(fileName, "wb");
+
+    if (NULL == fp)
+    {
+        return -1;
+    }
+
+    result = (fwrite(data, 1, size, fp) == size) ? 0 : -1;
+    return ((0 == fclose(fp)) && (0 == result)) ? 0 : -1;
+}
+
+/**
+ * \fn static char *ReadText(const char *fileName, size_t *size)
+ *
+ * \brief This function reads a whole file.
+ *
+ * \param fileName The name of the file.
+ *
+ * \param size Set to the number of bytes read.
+ *
+ * \effects Memory is allocated for the file's contents, followed by a NULL.
+ *
+ * \returns A pointer to the contents, or NULL on error.
+ */
+static char *ReadText(const char *fileName, size_t *size)
+{
+    FILE *fp;
+    char *data;
+    long length;
+
+    fp = fopen(fileName, "rb");
+
+    if (NULL == fp)
+    {
+        return NULL;
+    }
+
+    data = NULL;
+
+    if ((0 == fseek(fp, 0, SEEK_END)) && ((length = ftell(fp)) >= 0) &&
+        (0 == fseek(fp, 0, SEEK_SET)))
+    {
+        data = (char *)malloc((size_t)length + 1);
+
+        if ((NULL != data) &&
+            (fread(data, 1, (size_t)length, fp) != (size_t)length))
+        {
+            free(data);
+            data = NULL;
+        }
+    }
+
+    fclose(fp);
+
+    if (NULL != data)
+    {
+        data[length] = '\0';
+        *size = (size_t)length;
+    }
+
+    return data;
+}
+
+/**
+ * \fn static void *CountAllocate(size_t size, void *user)
+ *
+ * \brief This is the allocate function of the counting allocator.
+ *
+ * \param size The number of bytes to allocate.
+ *
+ * \param user A pointer to the alloc_count_t being updated.
+ *
+ * \effects The allocation is counted.
+ *
+ * \returns The result of malloc.
+ */
+static void *CountAllocate(size_t size, void *user)
+{
+    void *ptr;
+
+    ptr = malloc(size);
+
+    if (NULL != ptr)
+    {
+        ((alloc_count_t *)user)->allocs++;
+        ((alloc_count_t *)user)->outstanding++;
+    }
+
+    return ptr;
+}
+
+/**
+ * \fn static void *CountReallocate(void *ptr, size_t size, void *user)
+ *
+ * \brief This is the reallocate function of the counting allocator.
+ *
+ * \param ptr A pointer to the memory being resized.
+ *
+ * \param size The new size in bytes.
+ *
+ * \param user A pointer to the alloc_count_t being updated.
+ *
+ * \effects The reallocation is counted as an allocation.
+ *
+ * \returns The result of realloc.
+ */
+static void *CountReallocate(void *ptr, size_t size, void *user)
+{
+    ptr = realloc(ptr, size);
+
+    if (NULL != ptr)
+    {
+        ((alloc_count_t *)user)->allocs++;
+    }
+
+    return ptr;
+}
+
+/**
+ * \fn static void CountRelease(void *ptr, void *user)
+ *
+ * \brief This is the release function of the counting allocator.
+ *
+ * \param ptr A pointer to the memory being freed.
+ *
+ * \param user A pointer to the alloc_count_t being updated.
+ *
+ * \effects The memory is freed.
+ *
+ * \returns Nothing
+ */
+static void CountRelease(void *ptr, void *user)
+{
+    free(ptr);
+    ((alloc_count_t *)user)->outstanding--;
+}
+
+/**@}*/
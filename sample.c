@@ -97,6 +97,9 @@ static int PopulateMyStruct(my_struct_t *my_struct, const ini_entry_t *entry);
  * This creates test_struct.ini and calls GetEntryFromFile() to read it.
  * PopulateMyStruct() is called to load the entry values into an array of
  * my_struct_t.  The contents of the populated struct array are printed.
+ * The file is loaded as a document with LoadDocument() and queried by
+ * section and key.  Finally the file is watched with StartWatcher() and
+ * changed, and the reloaded snapshot is queried.
  */
 int main(int argc, char *argv[])
 {
@@ -107,6 +110,9 @@ int main(int argc, char *argv[])
 
     ini_entry_t entry;
     ini_entry_list_t list;
+    ini_document_t *doc;
+    ini_cursor_t cursor;
+    ini_watcher_t *watcher;
 
     ((void)(argc));
     ((void)(argv));
@@ -182,6 +188,8 @@ int main(int argc, char *argv[])
         printf("Error deleting entry from test_struct.ini file\n");
     }
 
+    FreeList(list);
+
     fp = fopen("test_struct.ini", "r");
 
     /* read ini file back into a structure */
@@ -205,6 +213,92 @@ int main(int argc, char *argv[])
         printf("\tmyString %s\n", my_structs[i].myString);
     }
 
+    printf("\nQuerying test_struct.ini\n");
+    printf("=======================\n");
+    doc = LoadDocument("test_struct.ini");
+
+    if (NULL == doc)
+    {
+        printf("Error loading test_struct.ini\n");
+    }
+    else
+    {
+        const char *key;
+        const char *value;
+        long intField;
+        double floatField;
+
+        printf("struct 2, str field = %s\n",
+            GetValueFromDocument(doc, "struct 2", "str field"));
+
+        if ((0 == GetLongFromDocument(doc, "struct 2", "int field",
+            &intField)) &&
+            (0 == GetDoubleFromDocument(doc, "struct 2", "float field",
+            &floatField)))
+        {
+            printf("struct 2, int field = %ld, float field = %f\n",
+                intField, floatField);
+        }
+
+        if (!FindSectionInDocument(doc, "struct 3", NULL))
+        {
+            printf("struct 3 not found\n");
+        }
+
+        if (FindSectionInDocument(doc, "struct 1", &cursor))
+        {
+            printf("struct 1\n");
+
+            while (GetKeyFromSection(&cursor, &key, &value))
+            {
+                printf("\t%s = %s\n", key, value);
+            }
+        }
+
+        FreeDocument(doc);
+    }
+
+    printf("\nWatching test_struct.ini\n");
+    printf("========================\n");
+    watcher = StartWatcher("test_struct.ini", 100);
+
+    if (NULL == watcher)
+    {
+        printf("Error watching test_struct.ini\n");
+    }
+    else
+    {
+        const ini_document_t *snapshot;
+        unsigned long version;
+        int token;
+
+        snapshot = AcquireSnapshot(watcher, &token);
+        printf("struct 2, str field = %s\n",
+            GetValueFromDocument(snapshot, "struct 2", "str field"));
+        ReleaseSnapshot(watcher, token);
+
+        /* change the file, the watcher reloads it */
+        version = GetSnapshotVersion(watcher);
+        list = NULL;
+        AddEntryToList(&list, "struct 2", "str field", "changed string");
+        result = AddEntryToFile("test_struct.ini", list);
+        FreeList(list);
+
+        if ((0 == result) && WaitForSnapshot(watcher, version, 5000))
+        {
+            snapshot = AcquireSnapshot(watcher, &token);
+            printf("reloaded, struct 2, str field = %s\n",
+                GetValueFromDocument(snapshot, "struct 2", "str field"));
+            ReleaseSnapshot(watcher, token);
+        }
+        else
+        {
+            printf("Error reloading test_struct.ini\n");
+        }
+
+        StopWatcher(watcher);
+    }
+
     remove("test_struct.ini");
     return 0;
 }
@@ -0,0 +1,220 @@
+/**
+ * \brief A benchmark of the ezini INI file handling library's scan kernels
+ * \file scanbench.c
+ * \author Michael Dipperstein (mdipperstein@gmail.com)
+ * \date October 15, 2026
+ *
+ * This file generates a large INI file in memory and reports how fast it
+ * is parsed with each of the scan kernels supported by the CPU.
+ *
+ * \copyright Copyright (C) 2026 by Michael Dipperstein
+ * (mdipperstein@gmail.com)
+ *
+ * \par
+ * This file is part of the ezini library.
+ *
+ * \license
+ * The ezini library is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * \par
+ * The ezini library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+ * General Public License for more details.
+ *
+ * \par
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \defgroup scanbench Scan Kernel Benchmark
+ * \brief This module contains code measuring the parsing speed of the
+ * ezini INI file handling library with each of its scan kernels.
+ * @{
+ */
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include "ezini.h"
+
+/*!
+  \def scanbench_main
+  \brief Hack so that Doxygen doesn't confuse this with sample.c's main
+*/
+#define scanbench_main main
+
+/*!
+  \def DEFAULT_MB
+  \brief Size of the generated INI file in megabytes if none is specified
+*/
+#define DEFAULT_MB      32
+
+/*!
+  \def PASSES
+  \brief Number of times the generated file is parsed with each kernel
+*/
+#define PASSES          5
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static char *MakeText(size_t size, size_t *length);
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/**
+ * \fn int scanbench_main(int argc, char *argv[])
+ *
+ * \brief This function parses a generated INI file with GetEntryFromBuffer
+ * using each of the supported scan kernels and prints the parsing speed.
+ *
+ * \param argc The number of arguments.
+ *
+ * \param argv argv[1] may be the size of the generated file in megabytes.
+ *
+ * \effects
+ * The parsing speed of each kernel is printed in MB/s.
+ *
+ * \returns 0 for success, 1 on error or if the kernels don't find the same
+ * number of entries.  regress compares the entries themselves.
+ */
+int scanbench_main(int argc, char *argv[])
+{
+    static const char *names[] = {"auto", "scalar", "sse2", "avx2"};
+    ini_buffer_t buffer;
+    ini_entry_view_t entry;
+    char *text;
+    size_t length;
+    unsigned long entries;
+    unsigned long first;
+    clock_t start;
+    double seconds;
+    int kernel;
+    int pass;
+    int failed;
+
+    text = MakeText((size_t)((argc > 1) ? atoi(argv[1]) : DEFAULT_MB) << 20,
+        &length);
+
+    if (NULL == text)
+    {
+        printf("Error generating INI text\n");
+        return 1;
+    }
+
+    printf("Parsing %lu bytes %d times\n", (unsigned long)length, PASSES);
+    first = 0;
+    failed = 0;
+
+    for (kernel = INI_SCAN_SCALAR; kernel <= INI_SCAN_AVX2; kernel++)
+    {
+        if (0 != SetScanKernel(kernel))
+        {
+            printf("%-8s not supported\n", names[kernel]);
+            continue;
+        }
+
+        entries = 0;
+        start = clock();
+
+        for (pass = 0; pass < PASSES; pass++)
+        {
+            InitINIBuffer(&buffer, text, length);
+
+            while (GetEntryFromBuffer(&buffer, &entry) > 0)
+            {
+                entries++;
+            }
+        }
+
+        seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+        if (seconds <= 0.0)
+        {
+            seconds = 1.0 / CLOCKS_PER_SEC;
+        }
+
+        printf("%-8s %8.1f MB/s  (%lu entries)\n", names[kernel],
+            ((double)length * PASSES) / seconds / 1e6, entries / PASSES);
+
+        if (0 == first)
+        {
+            first = entries;
+        }
+        else if (entries != first)
+        {
+            printf("%-8s found a different number of entries\n",
+                names[kernel]);
+            failed = 1;
+        }
+    }
+
+    SetScanKernel(INI_SCAN_AUTO);
+    printf("auto selects %s\n", names[GetScanKernel()]);
+    free(text);
+    return failed;
+}
+
+/**
+ * \fn static char *MakeText(size_t size, size_t *length)
+ *
+ * \brief This function generates INI file text with sections, comments,
+ * and key = value entries.
+ *
+ * \param size The approximate number of characters to generate.
+ *
+ * \param length Set to the number of characters generated.
+ *
+ * \effects Memory is allocated for the text.
+ *
+ * \returns A pointer to the text, or NULL on error.
+ */
+static char *MakeText(size_t size, size_t *length)
+{
+    char *text;
+    size_t used;
+    unsigned long i;
+
+    text = (char *)malloc(size + 256);
+
+    if (NULL == text)
+    {
+        return NULL;
+    }
+
+    used = 0;
+
+    for (i = 0; used < size; i++)
+    {
+        if (0 == (i % 40))
+        {
+            used += sprintf(text + used, "\n; settings group %lu\n"
+                "[section_%lu]\n", i / 40, i / 40);
+        }
+
+        used += sprintf(text + used,
+            "  key_number_%lu = value %lu with some words in it\n", i,
+            i * 31);
+    }
+
+    *length = used;
+    return text;
+}
+
+/**@}*/
@@ -0,0 +1,273 @@
+/**
+ * \brief A stress test of the ezini INI file handling library
+ * \file stress.c
+ * \author Michael Dipperstein (mdipperstein@gmail.com)
+ * \date October 15, 2026
+ *
+ * This file builds, serializes, and frees entry lists with millions of
+ * entries on a thread with a small stack, to make sure that nothing in
+ * the library needs stack space proportional to the size of a list.
+ *
+ * \copyright Copyright (C) 2026 by Michael Dipperstein
+ * (mdipperstein@gmail.com)
+ *
+ * \par
+ * This file is part of the ezini library.
+ *
+ * \license
+ * The ezini library is free software; you can redistribute it
+ * and/or modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * \par
+ * The ezini library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser
+ * General Public License for more details.
+ *
+ * \par
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \defgroup stress Entry List Stress Test
+ * \brief This module contains code that stress tests the ezini INI file
+ * handling library with very large entry lists.
+ * @{
+ */
+
+/***************************************************************************
+*                             INCLUDED FILES
+***************************************************************************/
+#if defined(__unix__) || defined(__unix) || \
+    (defined(__APPLE__) && defined(__MACH__))
+#define _POSIX_C_SOURCE 200112L
+#include <pthread.h>
+#define STRESS_THREAD
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "ezini.h"
+
+/*!
+  \def stress_main
+  \brief Hack so that Doxygen doesn't confuse this with sample.c's main
+*/
+#define stress_main main
+
+/*!
+  \def ENTRIES
+  \brief Number of entries in each list
+*/
+#define ENTRIES         2000000UL
+
+/*!
+  \def STACK_SIZE
+  \brief Stack size of the thread running the tests
+*/
+#define STACK_SIZE      (256 * 1024)
+
+/***************************************************************************
+*                            TYPE DEFINITIONS
+***************************************************************************/
+
+/***************************************************************************
+*                               PROTOTYPES
+***************************************************************************/
+static void *RunTests(void *failures);
+static int StressList(const char *name, int useArena, unsigned long perSection);
+static int CountChars(const char *data, size_t length, void *user);
+
+/***************************************************************************
+*                                FUNCTIONS
+***************************************************************************/
+
+/**
+ * \fn int stress_main(int argc, char *argv[])
+ *
+ * \brief This function runs the stress tests on a thread with a 256K stack
+ * (or on the main thread if threads aren't available).
+ *
+ * \param argc Not Used
+ *
+ * \param argv Not Used
+ *
+ * \effects
+ * The result of each test is printed.
+ *
+ * \returns 0 if every test passed, 1 otherwise.
+ */
+int stress_main(int argc, char *argv[])
+{
+    int failures;
+#ifdef STRESS_THREAD
+    pthread_attr_t attr;
+    pthread_t thread;
+#endif
+
+    ((void)(argc));
+    ((void)(argv));
+
+    failures = 0;
+
+#ifdef STRESS_THREAD
+    if ((0 != pthread_attr_init(&attr)) ||
+        (0 != pthread_attr_setstacksize(&attr, STACK_SIZE)) ||
+        (0 != pthread_create(&thread, &attr, RunTests, &failures)))
+    {
+        printf("Error creating test thread\n");
+        return 1;
+    }
+
+    pthread_join(thread, NULL);
+    pthread_attr_destroy(&attr);
+#else
+    RunTests(&failures);
+#endif
+
+    printf("%s\n", (0 == failures) ? "All stress tests passed" :
+        "Stress tests FAILED");
+    return (0 == failures) ? 0 : 1;
+}
+
+/**
+ * \fn static void *RunTests(void *failures)
+ *
+ * \brief This function runs each of the stress tests.
+ *
+ * \param failures A pointer to an int that is incremented for each test
+ * that fails.
+ *
+ * \effects
+ * Lists with one huge section, with millions of small sections, and with
+ * and without an arena are built, serialized, and freed.
+ *
+ * \returns NULL
+ */
+static void *RunTests(void *failures)
+{
+    int *count;
+
+    count = (int *)failures;
+    *count += StressList("one section", 0, ENTRIES);
+    *count += StressList("one section, arena", 1, ENTRIES);
+    *count += StressList("one key per section", 0, 1);
+    *count += StressList("one key per section, arena", 1, 1);
+    return NULL;
+}
+
+/**
+ * \fn static int StressList(const char *name, int useArena,
+ *      unsigned long perSection)
+ *
+ * \brief This function builds an entry list with ENTRIES entries, checks
+ * that it serializes to the expected size, and frees it.
+ *
+ * \param name The name of the test.
+ *
+ * \param useArena Non-zero if the list should be arena backed.
+ *
+ * \param perSection The number of keys in each section.
+ *
+ * \effects
+ * The result of the test is printed.
+ *
+ * \returns 0 if the test passed, 1 if it failed.
+ */
+static int StressList(const char *name, int useArena, unsigned long perSection)
+{
+    ini_entry_list_t list;
+    char section[32];
+    char key[32];
+    char value[32];
+    unsigned long i;
+    unsigned long expected;
+    unsigned long written;
+    long last;
+
+    list = NULL;
+    expected = 0;
+
+    if (useArena && (0 != NewArenaList(&list)))
+    {
+        printf("%s: error creating list\n", name);
+        return 1;
+    }
+
+    for (i = 0; i < ENTRIES; i++)
+    {
+        sprintf(section, "section%lu", i / perSection);
+        sprintf(key, "key%lu", i);
+        sprintf(value, "%lu", i);
+
+        if (0 != AddEntryToList(&list, section, key, value))
+        {
+            printf("%s: error adding entry %lu\n", name, i);
+            FreeList(list);
+            return 1;
+        }
+
+        /* "[section]\n" ... "\n" and "key = value\n" */
+        if (0 == (i % perSection))
+        {
+            expected += strlen(section) + 4;
+        }
+
+        expected += strlen(key) + strlen(value) + 4;
+    }
+
+    written = 0;
+
+    if ((0 != WriteINIList(list, CountChars, &written)) ||
+        (written != expected))
+    {
+        printf("%s: wrote %lu characters, expected %lu\n", name, written,
+            expected);
+        FreeList(list);
+        return 1;
+    }
+
+    sprintf(section, "section%lu", (ENTRIES - 1) / perSection);
+
+    if ((0 != GetLongFromList(list, section, key, &last)) ||
+        (last != (long)(ENTRIES - 1)))
+    {
+        printf("%s: last entry not found\n", name);
+        FreeList(list);
+        return 1;
+    }
+
+    FreeList(list);
+    printf("%s: %lu entries OK\n", name, ENTRIES);
+    return 0;
+}
+
+/**
+ * \fn static int CountChars(const char *data, size_t length, void *user)
+ *
+ * \brief This is the ini_writer_t used to count the characters written by
+ * WriteINIList.
+ *
+ * \param data Not Used
+ *
+ * \param length The number of characters written.
+ *
+ * \param user A pointer to the unsigned long count of characters.
+ *
+ * \effects length is added to the count.
+ *
+ * \returns 0
+ */
+static int CountChars(const char *data, size_t length, void *user)
+{
+    ((void)(data));
+    *((unsigned long *)user) += length;
+    return 0;
+}
+
+/**@}*/